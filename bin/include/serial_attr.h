@@ -0,0 +1,137 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'serial'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        serial_attr.h
+ *
+ *  @brief       Serial transmission attributes.
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @addtogroup  serial
+ *  @{
+ */
+#ifndef SERIAL_ATTR_H_INCLUDED
+#define SERIAL_ATTR_H_INCLUDED
+
+#include <stdint.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** @brief       Number of data bits (5, 6, 7, 8)
+ */
+typedef enum sio_bytesize_t_ {
+    BYTESIZE5 = 5,
+    BYTESIZE6 = 6,
+    BYTESIZE7 = 7,
+    BYTESIZE8 = 8,
+} sio_bytesize_t;
+
+/** @brief       Parity bit (none, odd, even, mark, space)
+ */
+typedef enum sio_parity_t_ {
+    PARITYNONE = 0,
+    PARITYODD = 1,
+    PARITYEVEN = 2,
+    PARITYMARK = 3,
+    PARITYSPACE = 4
+} sio_parity_t;
+
+/** @brief       Number of stop bits (1 or 1.5 or 2)
+ */
+typedef enum sio_stopbits_t_ {
+    STOPBITS1 = 0,
+    STOPBITS1_5 = 1,
+    STOPBITS2 = 2
+} sio_stopbits_t;
+
+/** @brief       Serial port attributes
+ */
+typedef struct sio_attr_t_ {            /* serial port attributes: */
+    uint32_t baudrate;                  /**<  baud rate (in [bps]) */
+    sio_bytesize_t bytesize;            /**<  number of data bits (5, 6, 7, 8) */
+    sio_parity_t parity;                /**<  parity bit (none, odd, even, mark, space) */
+    sio_stopbits_t stopbits;            /**<  number of stop bits (1 or 1.5 or 2) */
+    uint8_t latency;                    /**<  low-latency mode (0 = off, 1 = on) */
+    uint8_t vmin;                       /**<  low-latency mode: minimum bytes per read (0 = 1) */
+    uint8_t vtime;                      /**<  low-latency mode: inter-byte timeout (in [1/10 s]) */
+    uint16_t readsize;                  /**<  maximum bytes per read (0 = default, POSIX only) */
+} sio_attr_t;
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SERIAL_ATTR_H_INCLUDED */
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -79,6 +79,9 @@ else
 	LIB_CURSES_LIBFLAGS := $(shell pkg-config --libs ncurses)
 endif
 
+# Flags for using the zlib library (required by libmdf)
+LIB_ZLIB_LIBFLAGS := -lz
+
 # Flags for using the GTK library
 LIB_GTK_CFLAGS := $(shell pkg-config --cflags gtk4)
 LIB_GTK_LIBFLAGS := $(shell pkg-config --libs gtk4)
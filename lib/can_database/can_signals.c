@@ -15,7 +15,7 @@ uint64_t signalEncode (canSignal_t* signal, float value)
 	return buffer;
 }
 
-float signalDecode (canSignal_t* signal, uint64_t payload)
+uint64_t signalDecodeRaw (canSignal_t* signal, uint64_t payload)
 {
 	payload >>= signal->bitPosition;
 	payload &= signal->bitmask;
@@ -34,6 +34,13 @@ float signalDecode (canSignal_t* signal, uint64_t payload)
 	if (negative)
 		payload |= ((uint64_t) -1) - signal->bitmask;
 
+	return payload;
+}
+
+float signalDecode (canSignal_t* signal, uint64_t payload)
+{
+	payload = signalDecodeRaw (signal, payload);
+
 	float value = (signal->signedness ? (float) ((int64_t) payload) : (float) payload);
 	return value * signal->scaleFactor + signal->offset;
 }
\ No newline at end of file
@@ -93,6 +93,15 @@ struct canSignal
  */
 uint64_t signalEncode (canSignal_t* signal, float value);
 
+/**
+ * @brief Decodes the raw value of the specified signal from a payload, that is, the value before the scale factor and offset
+ * are applied.
+ * @param signal The signal to decode.
+ * @param payload The payload to decode from.
+ * @return The raw value. Signed signals are sign-extended, so the value may be cast to @c int64_t .
+ */
+uint64_t signalDecodeRaw (canSignal_t* signal, uint64_t payload);
+
 /**
  * @brief Decodes the specified signal from a payload.
  * @param signal The signal to decoded.
@@ -14,6 +14,24 @@
 #include <errno.h>
 #include <stdlib.h>
 
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The maximum number of device types that may be registered by @c canRegisterDevice .
+#define REGISTERED_DEVICE_COUNT_MAX 8
+
+// Globals --------------------------------------------------------------------------------------------------------------------
+
+/// @brief The device types registered by @c canRegisterDevice .
+static struct
+{
+	canNameDomain_t* nameDomain;
+	canDeviceInit_t* init;
+} registeredDevices [REGISTERED_DEVICE_COUNT_MAX];
+
+static size_t registeredDeviceCount = 0;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
 /**
  * @brief Prompts the user to select a CAN device from a list of enumerated options.
  * @param devices The array of CAN devices to select from.
@@ -142,6 +160,11 @@ canDevice_t* canInit (char* deviceName, char* userContext)
 		return slcanInit(deviceName, baudrate);
 	}
 
+	// Handle registered devices
+	for (size_t index = 0; index < registeredDeviceCount; ++index)
+		if (registeredDevices [index].nameDomain (deviceName))
+			return registeredDevices [index].init (deviceName, baudrate);
+
 	// Handle null device
 	if (canNullNameDomain (deviceName))
 		return canNullInit (deviceName, baudrate);
@@ -151,6 +174,25 @@ canDevice_t* canInit (char* deviceName, char* userContext)
 	return NULL;
 }
 
+int canRegisterDevice (canNameDomain_t* nameDomain, canDeviceInit_t* init)
+{
+	// Registering the same device twice is harmless.
+	for (size_t index = 0; index < registeredDeviceCount; ++index)
+		if (registeredDevices [index].nameDomain == nameDomain)
+			return 0;
+
+	if (registeredDeviceCount == REGISTERED_DEVICE_COUNT_MAX)
+	{
+		errno = ENOMEM;
+		return errno;
+	}
+
+	registeredDevices [registeredDeviceCount].nameDomain = nameDomain;
+	registeredDevices [registeredDeviceCount].init = init;
+	++registeredDeviceCount;
+	return 0;
+}
+
 bool canCheckBusError (int code)
 {
 	return
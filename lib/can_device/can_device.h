@@ -18,6 +18,7 @@
 // C Standard Library
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 // Datatypes ------------------------------------------------------------------------------------------------------------------
 
@@ -53,6 +54,9 @@ typedef unsigned int canBaudrate_t;
 /// @brief Function signature for the @c canTransmit function.
 typedef int canTransmit_t (void* device, canFrame_t* frame);
 
+/// @brief Function signature for the @c canTransmitBatch function.
+typedef int canTransmitBatch_t (void* device, canFrame_t* frames, size_t frameCount, size_t* transmitCount);
+
 /// @brief Function signature for the @c canReceive function.
 typedef int canReceive_t (void* device, canFrame_t* frame);
 
@@ -82,6 +86,9 @@ typedef struct
 	/// @brief A device's specific implementation of the @c canTransmit function.
 	canTransmit_t* transmit;
 
+	/// @brief A device's specific implementation of the @c canTransmitBatch function.
+	canTransmitBatch_t* transmitBatch;
+
 	/// @brief A device's specific implementation of the @c canReceive function.
 	canReceive_t* receive;
 
@@ -113,12 +120,19 @@ typedef struct
 	canDeviceVmt_t vmt;
 } canDevice_t;
 
+/// @brief Function signature for checking whether a device name belongs to a type of CAN device.
+typedef bool canNameDomain_t (const char* name);
+
+/// @brief Function signature for initializing a type of CAN device.
+typedef canDevice_t* canDeviceInit_t (char* name, canBaudrate_t baudrate);
+
 // Functions ------------------------------------------------------------------------------------------------------------------
 
 /**
  * @brief Identifies and initializes a CAN device based on its name handle. This function will attempt to identify the type of
  * adapter based on context in the provided name.
- * @param deviceName The name of the CAN device. Note this should either be a SocketCAN name or an SLCAN name.
+ * @param deviceName The name of the CAN device. Note this should either be a SocketCAN name, an SLCAN name, or the name of a
+ * device registered using @c canRegisterDevice .
  * @param userContext User-friendly string for providing context to the user. Used in the text:
  *   "Select a CAN device to use for <User Context>:"
  * May be set to @c NULL for default context.
@@ -126,6 +140,16 @@ typedef struct
  */
 canDevice_t* canInit (char* deviceName, char* userContext);
 
+/**
+ * @brief Registers an additional type of CAN device with @c canInit . This allows devices implemented outside of this library
+ * (ex. the MDF replay device, see mdf/mdf_can_replay.h) to be used without this library depending on them. Note this function
+ * is not thread-safe, devices should be registered before the first call to @c canInit .
+ * @param nameDomain Function checking whether a device name belongs to the type of device.
+ * @param init Function initializing a device of the type.
+ * @return 0 if successful, the error code otherwise.
+ */
+int canRegisterDevice (canNameDomain_t* nameDomain, canDeviceInit_t* init);
+
 /**
  * @brief Closes and deallocates and CAN device. The @c device pointer is no longer usable after a call to this function.
  * @param device The device to deallocate.
@@ -146,6 +170,22 @@ static inline int canTransmit (canDevice_t* device, canFrame_t* frame)
 	return device->vmt.transmit (device, frame);
 }
 
+/**
+ * @brief Function for transmitting multiple CAN frames at once. Unlike repeated calls to @c canTransmit , a device may queue
+ * the frames and return before all of them have been put on the bus, hence this is the preferred method of transmitting a
+ * burst of frames.
+ * @param device The device to transmit with.
+ * @param frames The array of frames to transmit.
+ * @param frameCount The number of elements in @c frames .
+ * @param transmitCount Buffer to write the number of frames transmitted into. Only meaningful on failure, as all frames are
+ * transmitted when successful. May be @c NULL .
+ * @return 0 if successful, the error code otherwise. Note @c errno is set on failure.
+ */
+static inline int canTransmitBatch (canDevice_t* device, canFrame_t* frames, size_t frameCount, size_t* transmitCount)
+{
+	return device->vmt.transmitBatch (device, frames, frameCount, transmitCount);
+}
+
 /**
  * @brief Function for receiving a CAN frame.
  * @param device The device to receive from.
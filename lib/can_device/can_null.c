@@ -37,6 +37,7 @@ canDevice_t* canNullInit (char* name, canBaudrate_t baudrate)
 
 	// Setup the device's VMT
 	device->vmt.transmit		= canNullTransmit;
+	device->vmt.transmitBatch	= canNullTransmitBatch;
 	device->vmt.receive			= canNullReceive;
 	device->vmt.flushRx			= canNullFlushRx;
 	device->vmt.setTimeout		= canNullSetTimeout;
@@ -67,6 +68,17 @@ int canNullTransmit (void* device, canFrame_t* frame)
 	return 0;
 }
 
+int canNullTransmitBatch (void* device, canFrame_t* frames, size_t frameCount, size_t* transmitCount)
+{
+	(void) device;
+	(void) frames;
+
+	// Always succeeds
+	if (transmitCount != NULL)
+		*transmitCount = frameCount;
+	return 0;
+}
+
 int canNullReceive (void* device, canFrame_t* frame)
 {
 	(void) frame;
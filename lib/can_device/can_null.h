@@ -44,6 +44,9 @@ void canNullDealloc (void* device);
 /// @brief Null implementation of the @c canTransmit function.
 int canNullTransmit (void* device, canFrame_t* frame);
 
+/// @brief Null implementation of the @c canTransmitBatch function.
+int canNullTransmitBatch (void* device, canFrame_t* frames, size_t frameCount, size_t* transmitCount);
+
 /// @brief Null implementation of the @c canReceive function.
 int canNullReceive (void* device, canFrame_t* frame);
 
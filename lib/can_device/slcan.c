@@ -6,6 +6,7 @@
 #include "slcan.h"
 
 // Includes
+#include "slcan_ring.h"
 #include "list.h"
 #include "debug.h"
 #include "error_codes.h"
@@ -33,6 +34,9 @@
 #define ERRNO_MISSING	-102
 #define ERRNO_PERM		-113
 
+/// @brief The capacity of the reception ring, in frames. Matches the SerialCAN message queue it replaces.
+#define SLCAN_RING_SIZE 65536
+
 // Datatypes ------------------------------------------------------------------------------------------------------------------
 
 // Defines the datatype for a list of canDevice_t pointers
@@ -46,8 +50,18 @@ typedef struct
 	char* name;
 	long int timeoutMs;
 	canBaudrate_t baudrate;
+
+	#ifdef ZRE_CANTOOLS_OS_linux
+	/// @brief Ring that received frames are decoded into, bypassing SerialCAN's message queue.
+	slcanRing_t ring;
+	#endif // ZRE_CANTOOLS_OS_linux
 } slcan_t;
 
+// Globals --------------------------------------------------------------------------------------------------------------------
+
+/// @brief The serial port configuration of newly initialized devices.
+static slcanSerialConfig_t serialConfig = SLCAN_SERIAL_CONFIG_DEFAULT;
+
 // Functions ------------------------------------------------------------------------------------------------------------------
 
 static int getErrorCode (int code)
@@ -94,6 +108,11 @@ bool slcanWildcard (const char* name)
 	return false;
 }
 
+void slcanSetSerialConfig (const slcanSerialConfig_t* config)
+{
+	serialConfig = *config;
+}
+
 canDevice_t* slcanInit (char* name, canBaudrate_t baudrate)
 {
 	// Map the baudrate to one of the available options.
@@ -142,7 +161,11 @@ canDevice_t* slcanInit (char* name, canBaudrate_t baudrate)
 			.baudrate = CANSIO_BD57600,
 			.bytesize = CANSIO_8DATABITS,
 			.parity = CANSIO_NOPARITY,
-			.stopbits = CANSIO_1STOPBIT
+			.stopbits = CANSIO_1STOPBIT,
+			.latency = serialConfig.lowLatency,
+			.vmin = serialConfig.vmin,
+			.vtime = serialConfig.vtime,
+			.readsize = serialConfig.readSize
 		}
 	};
 
@@ -153,20 +176,53 @@ canDevice_t* slcanInit (char* name, canBaudrate_t baudrate)
 		return NULL;
 	}
 
-	int code = can_start (handle, &slcanBaudrate);
+	// Device must be dynamically allocated
+	slcan_t* device = malloc (sizeof (slcan_t));
+	if (device == NULL)
+	{
+		can_exit (handle);
+		return NULL;
+	}
+
+	int code;
+
+	#ifdef ZRE_CANTOOLS_OS_linux
+
+	// Install the reception ring before the channel is opened, so no frames are placed in SerialCAN's queue.
+	if (slcanRingInit (&device->ring, SLCAN_RING_SIZE) != 0)
+	{
+		can_exit (handle);
+		free (device);
+		return NULL;
+	}
+
+	code = can_sio_receiver (handle, slcanRingReceive, &device->ring);
 	if (code < 0)
 	{
+		can_exit (handle);
+		slcanRingDealloc (&device->ring);
+		free (device);
 		errno = getErrorCode (code);
 		return NULL;
 	}
 
-	// Device must be dynamically allocated
-	slcan_t* device = malloc (sizeof (slcan_t));
-	if (device == NULL)
+	#endif // ZRE_CANTOOLS_OS_linux
+
+	code = can_start (handle, &slcanBaudrate);
+	if (code < 0)
+	{
+		can_exit (handle);
+		#ifdef ZRE_CANTOOLS_OS_linux
+		slcanRingDealloc (&device->ring);
+		#endif // ZRE_CANTOOLS_OS_linux
+		free (device);
+		errno = getErrorCode (code);
 		return NULL;
+	}
 
 	// Setup the device's VMT
 	device->vmt.transmit		= slcanTransmit;
+	device->vmt.transmitBatch	= slcanTransmitBatch;
 	device->vmt.receive			= slcanReceive;
 	device->vmt.flushRx			= slcanFlushRx;
 	device->vmt.setTimeout		= slcanSetTimeout;
@@ -376,6 +432,11 @@ void slcanDealloc (void* device)
 	can_reset (slcan->handle);
 	can_exit (slcan->handle);
 
+	#ifdef ZRE_CANTOOLS_OS_linux
+	// The reception thread is stopped, so the ring can be safely deallocated.
+	slcanRingDealloc (&slcan->ring);
+	#endif // ZRE_CANTOOLS_OS_linux
+
 	// Free the device's memory
 	free(slcan->name);
 	free (device);
@@ -405,10 +466,61 @@ int slcanTransmit (void* device, canFrame_t* frame)
 	return 0;
 }
 
+int slcanTransmitBatch (void* device, canFrame_t* frames, size_t frameCount, size_t* transmitCount)
+{
+	slcan_t* can = device;
+
+	// Convert to SLCAN frames in chunks, each of which is packed into as few serial writes as possible.
+	can_message_t slcanFrames [CAN_SIO_BATCH_MAX];
+
+	size_t transmitted = 0;
+	while (transmitted < frameCount)
+	{
+		size_t count = frameCount - transmitted;
+		if (count > CAN_SIO_BATCH_MAX)
+			count = CAN_SIO_BATCH_MAX;
+
+		for (size_t index = 0; index < count; ++index)
+		{
+			canFrame_t* frame = &frames [transmitted + index];
+			slcanFrames [index] = (can_message_t)
+			{
+				.id = frame->id,
+				.dlc = frame->dlc,
+				.xtd = frame->ide,
+				.rtr = frame->rtr
+			};
+			memcpy (slcanFrames [index].data, frame->data, frame->dlc);
+		}
+
+		size_t written;
+		int code = can_sio_write_batch (can->handle, slcanFrames, count, &written, can->timeoutMs);
+		transmitted += written;
+		if (code != 0)
+		{
+			if (transmitCount != NULL)
+				*transmitCount = transmitted;
+			errno = getErrorCode (code);
+			return errno;
+		}
+	}
+
+	if (transmitCount != NULL)
+		*transmitCount = transmitted;
+	return 0;
+}
+
 int slcanReceive (void* device, canFrame_t* frame)
 {
 	slcan_t* can = device;
 
+	#ifdef ZRE_CANTOOLS_OS_linux
+
+	// Frames are decoded directly into the ring by the reception thread. Note a timeout of 65535 indicates blocking.
+	return slcanRingPop (&can->ring, frame, can->timeoutMs == 65535 ? 0 : can->timeoutMs);
+
+	#else // ZRE_CANTOOLS_OS_linux
+
 	can_message_t slcanFrame;
 
 	// Read the CAN frame.
@@ -435,16 +547,27 @@ int slcanReceive (void* device, canFrame_t* frame)
 	frame->rtr = slcanFrame.rtr;
 	memcpy (frame->data, slcanFrame.data, slcanFrame.dlc);
 	return 0;
+
+	#endif // ZRE_CANTOOLS_OS_linux
 }
 
 int slcanFlushRx (void* device)
 {
 	slcan_t* can = device;
 
+	#ifdef ZRE_CANTOOLS_OS_linux
+
+	// Discard all frames in the ring.
+	slcanRingFlush (&can->ring);
+
+	#else // ZRE_CANTOOLS_OS_linux
+
 	// Read all available data from the device.
 	can_message_t slcanFrame;
 	while (can_read (can->handle, &slcanFrame, 0) == 0);
 
+	#endif // ZRE_CANTOOLS_OS_linux
+
 	return 0;
 }
 
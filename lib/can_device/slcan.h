@@ -24,6 +24,32 @@
 // C Standard Library
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief Configuration of the serial port underlying an SLCAN device.
+typedef struct
+{
+	/// @brief Indicates the port should be tuned for latency (Linux only). The port is read with blocking reads governed by
+	/// @c vmin and @c vtime and, if the driver supports it, flagged as @c ASYNC_LOW_LATENCY . Otherwise, the port is polled
+	/// with non-blocking reads.
+	bool lowLatency;
+
+	/// @brief In low-latency mode, the minimum number of bytes a read waits for. 0 is treated as 1.
+	uint8_t vmin;
+
+	/// @brief In low-latency mode, the inter-byte timeout of a read, in tenths of a second. Only relevant if @c vmin is
+	/// greater than 1.
+	uint8_t vtime;
+
+	/// @brief The maximum number of bytes read at once (Linux only). 0 for the default (1024 bytes).
+	uint16_t readSize;
+} slcanSerialConfig_t;
+
+/// @brief The default serial port configuration. Low-latency mode is opt-in, as it changes how every read of the port behaves
+/// and not every driver supports it.
+#define SLCAN_SERIAL_CONFIG_DEFAULT ((slcanSerialConfig_t) { .lowLatency = false, .vmin = 1, .vtime = 0, .readSize = 0 })
 
 // Functions ------------------------------------------------------------------------------------------------------------------
 
@@ -41,6 +67,12 @@ bool slcanNameDomain (const char* name);
  */
 bool slcanWildcard (const char* name);
 
+/**
+ * @brief Sets the serial port configuration used by all subsequently initialized SLCAN devices.
+ * @param config The configuration to use.
+ */
+void slcanSetSerialConfig (const slcanSerialConfig_t* config);
+
 /**
  * @brief Initializes an SLCAN device.
  * @param name The name (handler) of the device. Note the serial port handler is OS-dependent.
@@ -67,6 +99,9 @@ void slcanDealloc (void* device);
 /// @brief SLCAN implementation of the @c canTransmit function.
 int slcanTransmit (void* device, canFrame_t* frame);
 
+/// @brief SLCAN implementation of the @c canTransmitBatch function.
+int slcanTransmitBatch (void* device, canFrame_t* frames, size_t frameCount, size_t* transmitCount);
+
 /// @brief SLCAN implementation of the @c canReceive function.
 int slcanReceive (void* device, canFrame_t* frame);
 
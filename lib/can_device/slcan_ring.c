@@ -0,0 +1,248 @@
+// Header
+#include "slcan_ring.h"
+
+// Includes
+#include "error_codes.h"
+
+// SerialCAN
+#include "CANAPI_Types.h"
+#include "SerialCAN_Defines.h"
+
+// C Standard Library
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ZRE_CANTOOLS_OS_linux
+
+// POSIX
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#endif // ZRE_CANTOOLS_OS_linux
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of times the consumer polls the ring before sleeping on the eventfd.
+#define SPIN_COUNT 256
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool slcanDecodeFrame (canFrame_t* frame, const uint8_t* line, size_t length)
+{
+	size_t idLength;
+	switch (line [0])
+	{
+	case 't':
+		frame->ide = false;
+		frame->rtr = false;
+		idLength = 3;
+		break;
+	case 'T':
+		frame->ide = true;
+		frame->rtr = false;
+		idLength = 8;
+		break;
+	case 'r':
+		frame->ide = false;
+		frame->rtr = true;
+		idLength = 3;
+		break;
+	case 'R':
+		frame->ide = true;
+		frame->rtr = true;
+		idLength = 8;
+		break;
+	default:
+		return false;
+	}
+
+	// Command, ID and DLC
+	if (length < 1 + idLength + 1)
+		return false;
+
+	// Invalid digits are accumulated into the upper bits of 'invalid', so validation is done once at the end.
+	uint8_t invalid = 0;
+	uint32_t id = 0;
+	for (size_t index = 1; index <= idLength; ++index)
+	{
+		uint8_t digit = slcan_hex_values [line [index]];
+		invalid |= digit;
+		id = (id << 4) | (digit & 0xF);
+	}
+
+	uint8_t dlc = slcan_hex_values [line [idLength + 1]];
+	if ((invalid & 0xF0) != 0 || dlc > 8)
+		return false;
+
+	// Note the digits of a standard ID may encode up to 0xFFF, and those of an extended ID up to 0xFFFFFFFF.
+	if (id > (frame->ide ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID))
+		return false;
+
+	frame->id = id;
+	frame->dlc = dlc;
+
+	// Note RTR frames have no payload.
+	if (frame->rtr)
+		return true;
+
+	const uint8_t* payload = line + idLength + 2;
+	if (length < idLength + 2 + dlc * 2u)
+		return false;
+
+	for (uint8_t index = 0; index < dlc; ++index)
+	{
+		uint8_t high = slcan_hex_values [payload [index * 2]];
+		uint8_t low = slcan_hex_values [payload [index * 2 + 1]];
+		invalid |= high | low;
+		frame->data [index] = (high << 4) | (low & 0xF);
+	}
+
+	return (invalid & 0xF0) == 0;
+}
+
+#ifdef ZRE_CANTOOLS_OS_linux
+
+int slcanRingInit (slcanRing_t* ring, size_t capacity)
+{
+	// Round the capacity up to a power of 2, so indices can be masked rather than wrapped.
+	size_t powerCapacity = 1;
+	while (powerCapacity < capacity)
+		powerCapacity <<= 1;
+
+	ring->frames = malloc (sizeof (canFrame_t) * powerCapacity);
+	if (ring->frames == NULL)
+		return errno;
+
+	ring->eventFd = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (ring->eventFd < 0)
+	{
+		int code = errno;
+		free (ring->frames);
+		return errno = code;
+	}
+
+	ring->mask = powerCapacity - 1;
+	atomic_init (&ring->head, 0);
+	atomic_init (&ring->tail, 0);
+	atomic_init (&ring->waiting, false);
+	atomic_init (&ring->overflowCount, 0);
+	atomic_init (&ring->malformedCount, 0);
+	return 0;
+}
+
+void slcanRingDealloc (slcanRing_t* ring)
+{
+	close (ring->eventFd);
+	free (ring->frames);
+}
+
+void slcanRingReceive (void* ringPtr, const uint8_t* line, size_t length)
+{
+	slcanRing_t* ring = ringPtr;
+
+	// Only the producer writes the head, so it can be read relaxed.
+	size_t head = atomic_load_explicit (&ring->head, memory_order_relaxed);
+	size_t tail = atomic_load_explicit (&ring->tail, memory_order_acquire);
+	if (head - tail > ring->mask)
+	{
+		atomic_fetch_add_explicit (&ring->overflowCount, 1, memory_order_relaxed);
+		return;
+	}
+
+	// Decode directly into the ring's slot, it is not visible to the consumer until the head is published.
+	if (!slcanDecodeFrame (&ring->frames [head & ring->mask], line, length))
+	{
+		atomic_fetch_add_explicit (&ring->malformedCount, 1, memory_order_relaxed);
+		return;
+	}
+
+	// Publish the frame. This must be sequentially consistent with the load of the waiting flag, otherwise the consumer could
+	// go to sleep on a frame it did not see. Only the first frame published after the consumer starts waiting signals it.
+	atomic_store (&ring->head, head + 1);
+	if (atomic_load (&ring->waiting) && atomic_exchange (&ring->waiting, false))
+	{
+		uint64_t value = 1;
+		if (write (ring->eventFd, &value, sizeof (value)) < 0)
+			return;
+	}
+}
+
+int slcanRingPop (slcanRing_t* ring, canFrame_t* frame, unsigned long timeoutMs)
+{
+	struct timespec timeDeadline;
+	if (timeoutMs != 0)
+	{
+		clock_gettime (CLOCK_MONOTONIC, &timeDeadline);
+		timeDeadline.tv_sec += timeoutMs / 1000;
+		timeDeadline.tv_nsec += (timeoutMs % 1000) * 1000000;
+		if (timeDeadline.tv_nsec >= 1000000000)
+		{
+			timeDeadline.tv_nsec -= 1000000000;
+			++timeDeadline.tv_sec;
+		}
+	}
+
+	// Only the consumer writes the tail, so it can be read relaxed.
+	size_t tail = atomic_load_explicit (&ring->tail, memory_order_relaxed);
+	while (true)
+	{
+		// Fast path, a frame is available. Spin briefly before sleeping, as frames typically arrive in bursts (one serial read).
+		for (size_t spin = 0; spin < SPIN_COUNT; ++spin)
+		{
+			if (atomic_load_explicit (&ring->head, memory_order_acquire) != tail)
+			{
+				*frame = ring->frames [tail & ring->mask];
+				atomic_store_explicit (&ring->tail, tail + 1, memory_order_release);
+				return 0;
+			}
+		}
+
+		// Announce we are waiting, then re-check the ring to avoid missing a frame published in between.
+		atomic_store (&ring->waiting, true);
+		if (atomic_load (&ring->head) != tail)
+		{
+			atomic_store (&ring->waiting, false);
+			continue;
+		}
+
+		int pollTimeoutMs = -1;
+		if (timeoutMs != 0)
+		{
+			struct timespec timeCurrent;
+			clock_gettime (CLOCK_MONOTONIC, &timeCurrent);
+			long long remainingNs = (timeDeadline.tv_sec - timeCurrent.tv_sec) * 1000000000LL +
+				(timeDeadline.tv_nsec - timeCurrent.tv_nsec);
+			pollTimeoutMs = remainingNs > 0 ? (int) ((remainingNs + 999999) / 1000000) : 0;
+		}
+
+		struct pollfd pollFd = { .fd = ring->eventFd, .events = POLLIN };
+		int code = pollTimeoutMs == 0 ? 0 : poll (&pollFd, 1, pollTimeoutMs);
+		atomic_store (&ring->waiting, false);
+
+		if (code < 0 && errno != EINTR)
+			return errno;
+
+		// Clear the eventfd's counter. Failure (EAGAIN) just means it was not signalled.
+		uint64_t value;
+		if (code > 0 && read (ring->eventFd, &value, sizeof (value)) < 0)
+			errno = 0;
+
+		// Timeout, only if the ring is still empty.
+		if (code == 0 && atomic_load_explicit (&ring->head, memory_order_acquire) == tail)
+		{
+			errno = ERRNO_CAN_DEVICE_TIMEOUT;
+			return errno;
+		}
+	}
+}
+
+void slcanRingFlush (slcanRing_t* ring)
+{
+	size_t head = atomic_load_explicit (&ring->head, memory_order_acquire);
+	atomic_store_explicit (&ring->tail, head, memory_order_release);
+}
+
+#endif // ZRE_CANTOOLS_OS_linux
@@ -0,0 +1,121 @@
+#ifndef SLCAN_RING_H
+#define SLCAN_RING_H
+
+// SLCAN Reception Ring -------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: Fast reception path for SLCAN devices. Message lines received by the SerialCAN reception thread are decoded
+//   (via a lookup table, rather than per-character branching) directly into a single-producer, single-consumer ring of CAN
+//   frames. Neither side takes a lock: the producer (reception thread) and consumer (caller of canReceive) only share the ring
+//   indices. When the ring is empty, the consumer blocks on an eventfd, which the producer only signals if the consumer is
+//   actually waiting, so bulk reception does not cost a system call per frame.
+//
+// References:
+// - http://www.can232.com/docs/can232_v3.pdf (SLCAN ASCII protocol)
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "can_device.h"
+
+// C Standard Library
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The frames of the ring. The capacity is always a power of 2.
+	canFrame_t* frames;
+
+	/// @brief Mask for converting a ring index into an array index, that is capacity - 1.
+	size_t mask;
+
+	/// @brief The eventfd used to wake the consumer.
+	int eventFd;
+
+	/// @brief Index of the next frame to be written by the producer. The producer and consumer indices are padded apart by
+	/// a cache line, so they do not falsely share one.
+	atomic_size_t head;
+	char headPadding [64];
+
+	/// @brief Index of the next frame to be read by the consumer.
+	atomic_size_t tail;
+	char tailPadding [64];
+
+	/// @brief Indicates the consumer is waiting on the eventfd.
+	atomic_bool waiting;
+
+	/// @brief The number of frames dropped due to the ring being full.
+	atomic_size_t overflowCount;
+
+	/// @brief The number of message lines that failed to decode.
+	atomic_size_t malformedCount;
+} slcanRing_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Decodes an SLCAN message line into a CAN frame. Accepts standard ('t'), extended ('T') and RTR ('r', 'R') frames.
+ * Any trailing characters (ex. timestamp) after the payload are ignored.
+ * @param frame Buffer to write the frame into.
+ * @param line The message line to decode. Need not be null-terminated.
+ * @param length The length of the line, in bytes.
+ * @return True if successful, false if the line is malformed.
+ */
+bool slcanDecodeFrame (canFrame_t* frame, const uint8_t* line, size_t length);
+
+#ifdef ZRE_CANTOOLS_OS_linux
+
+/**
+ * @brief Initializes an SLCAN reception ring.
+ * @param ring The ring to initialize.
+ * @param capacity The minimum number of frames the ring should hold. Rounded up to the next power of 2.
+ * @return 0 if successful, the error code otherwise.
+ */
+int slcanRingInit (slcanRing_t* ring, size_t capacity);
+
+/**
+ * @brief De-allocates the memory owned by an SLCAN reception ring. The producer must be stopped before calling this.
+ * @param ring The ring to de-allocate.
+ */
+void slcanRingDealloc (slcanRing_t* ring);
+
+/**
+ * @brief Receiver function (producer side) of the ring. Decodes a message line and appends it to the ring. Matches the
+ * signature of SerialCAN's @c can_sio_receiver_t , so it may be installed directly.
+ * @param ring The ring to append to (@c slcanRing_t* ).
+ * @param line The message line to decode.
+ * @param length The length of the line, in bytes.
+ */
+void slcanRingReceive (void* ring, const uint8_t* line, size_t length);
+
+/**
+ * @brief Removes the oldest frame from the ring (consumer side), waiting for one to arrive if the ring is empty.
+ * @param ring The ring to read from.
+ * @param frame Buffer to write the frame into.
+ * @param timeoutMs The maximum amount of time to wait, in milliseconds. 0 indicates to wait indefinitely.
+ * @return 0 if successful, the error code otherwise. @c ERRNO_CAN_DEVICE_TIMEOUT indicates the timeout expired.
+ */
+int slcanRingPop (slcanRing_t* ring, canFrame_t* frame, unsigned long timeoutMs);
+
+/**
+ * @brief Discards all frames in the ring (consumer side).
+ * @param ring The ring to flush.
+ */
+void slcanRingFlush (slcanRing_t* ring);
+
+/// @return The number of frames dropped due to the ring being full.
+static inline size_t slcanRingGetOverflowCount (slcanRing_t* ring)
+{
+	return atomic_load_explicit (&ring->overflowCount, memory_order_relaxed);
+}
+
+#endif // ZRE_CANTOOLS_OS_linux
+
+#endif // SLCAN_RING_H
@@ -1,3 +1,7 @@
+// For sendmmsg. Note this must be the first include in this file.
+#define _GNU_SOURCE
+#include <stdio.h>
+
 // Header
 #include "socket_can.h"
 
@@ -27,6 +31,11 @@
 #include <string.h>
 #include <stdlib.h>
 
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The maximum number of frames sent with a single system call by @c socketCanTransmitBatch .
+#define SOCKET_CAN_BATCH_SIZE 64
+
 // Datatypes ------------------------------------------------------------------------------------------------------------------
 
 typedef struct
@@ -144,6 +153,7 @@ canDevice_t* socketCanInit (const char* name, canBaudrate_t baudrate)
 
 	// Setup the device's VMT
 	device->vmt.transmit		= socketCanTransmit;
+	device->vmt.transmitBatch	= socketCanTransmitBatch;
 	device->vmt.receive 		= socketCanReceive;
 	device->vmt.flushRx 		= socketCanFlushRx;
 	device->vmt.setTimeout		= socketCanSetTimeout;
@@ -223,6 +233,68 @@ int socketCanTransmit (void* device, canFrame_t* frame)
 	#endif // ZRE_CANTOOLS_OS_linux
 }
 
+int socketCanTransmitBatch (void* device, canFrame_t* frames, size_t frameCount, size_t* transmitCount)
+{
+	#ifdef ZRE_CANTOOLS_OS_linux
+
+	socketCan_t* sock = device;
+
+	// Frames are converted and sent in chunks, each with a single system call.
+	struct can_frame socketFrames [SOCKET_CAN_BATCH_SIZE];
+	struct mmsghdr messages [SOCKET_CAN_BATCH_SIZE];
+	struct iovec vectors [SOCKET_CAN_BATCH_SIZE];
+
+	size_t transmitted = 0;
+	while (transmitted < frameCount)
+	{
+		size_t count = frameCount - transmitted;
+		if (count > SOCKET_CAN_BATCH_SIZE)
+			count = SOCKET_CAN_BATCH_SIZE;
+
+		for (size_t index = 0; index < count; ++index)
+		{
+			canFrame_t* frame = &frames [transmitted + index];
+			socketFrames [index] = (struct can_frame)
+			{
+				.can_dlc = frame->dlc,
+				.can_id = frame->id | (frame->ide ? CAN_EFF_FLAG : 0) | (frame->rtr ? CAN_RTR_FLAG : 0),
+			};
+			memcpy (socketFrames [index].data, frame->data, frame->dlc);
+
+			vectors [index] = (struct iovec) { .iov_base = &socketFrames [index], .iov_len = sizeof (struct can_frame) };
+			messages [index] = (struct mmsghdr) { .msg_hdr = { .msg_iov = &vectors [index], .msg_iovlen = 1 } };
+		}
+
+		// Note the socket's queue may accept only part of the chunk.
+		int code = sendmmsg (sock->descriptor, messages, count, 0);
+		if (code <= 0)
+		{
+			if (transmitCount != NULL)
+				*transmitCount = transmitted;
+			return code == 0 ? (errno = EAGAIN) : errno;
+		}
+
+		transmitted += code;
+	}
+
+	if (transmitCount != NULL)
+		*transmitCount = transmitted;
+	return 0;
+
+	#else // ZRE_CANTOOLS_OS_linux
+
+	(void) device;
+	(void) frames;
+	(void) frameCount;
+
+	if (transmitCount != NULL)
+		*transmitCount = 0;
+	errno = ERRNO_OS_NOT_SUPPORTED;
+	return errno;
+
+	#endif // ZRE_CANTOOLS_OS_linux
+}
+
 int socketCanReceive (void* device, canFrame_t* frame)
 {
 	#ifdef ZRE_CANTOOLS_OS_linux
@@ -51,6 +51,9 @@ void socketCanDealloc (void* device);
 /// @brief SocketCAN implementation of the @c canTransmit function.
 int socketCanTransmit (void* device, canFrame_t* frame);
 
+/// @brief SocketCAN implementation of the @c canTransmitBatch function.
+int socketCanTransmitBatch (void* device, canFrame_t* frames, size_t frameCount, size_t* transmitCount);
+
 /// @brief SocketCAN implementation of the @c canReceive function.
 int socketCanReceive (void* device, canFrame_t* frame);
 
@@ -108,6 +108,24 @@
 #define ERRMSG_CAN_EEPROM_READ_ONLY				"Attempting to write to a read-only variable"
 #define ERRMSG_CAN_EEPROM_WRITE_ONLY			"Attempting to read from a write-only variable"
 
+// mdf Module ----------------------------------------------------------------------------------------------------------------
+
+#define ERRNO_MDF_LOG_OVERFLOW					1792
+#define ERRNO_MDF_LOG_UNRECOGNIZED				1793
+#define ERRNO_MDF_DEFLATE_FAILURE				1794
+#define ERRNO_MDF_UNSUPPORTED_DATA_BLOCK		1795
+#define ERRNO_MDF_MALFORMED_BLOCK				1796
+#define ERRNO_MDF_CATALOG_MALFORMED				1797
+#define ERRNO_MDF_ARCHIVE_MALFORMED				1798
+
+#define ERRMSG_MDF_LOG_OVERFLOW					"The MDF log's write buffer is full, the record was dropped"
+#define ERRMSG_MDF_LOG_UNRECOGNIZED				"The MDF file is not a recognized CAN bus log"
+#define ERRMSG_MDF_DEFLATE_FAILURE				"Failed to compress or decompress an MDF data block"
+#define ERRMSG_MDF_UNSUPPORTED_DATA_BLOCK		"Unsupported type of MDF data block"
+#define ERRMSG_MDF_MALFORMED_BLOCK				"Malformed MDF block"
+#define ERRMSG_MDF_CATALOG_MALFORMED			"Malformed or unrecognized MDF session catalog"
+#define ERRMSG_MDF_ARCHIVE_MALFORMED			"Malformed or unrecognized CAN bus archive"
+
 // serial_can Module ----------------------------------------------------------------------------------------------------------
 // - These error codes are all defined by the SerialCAN library, their values cannot be changed. Note that SerialCAN defines
 //   these as negative, however the can_device wrapper offsets these by 10000 to make the errors line up with standard errno
@@ -219,6 +237,15 @@ static inline const char* errorCodeToMessage (int code)
 	ERROR_CODE_TO_MESSAGE_CASE (CAN_EEPROM_READ_ONLY);
 	ERROR_CODE_TO_MESSAGE_CASE (CAN_EEPROM_WRITE_ONLY);
 
+	// mdf module
+	ERROR_CODE_TO_MESSAGE_CASE (MDF_LOG_OVERFLOW);
+	ERROR_CODE_TO_MESSAGE_CASE (MDF_LOG_UNRECOGNIZED);
+	ERROR_CODE_TO_MESSAGE_CASE (MDF_DEFLATE_FAILURE);
+	ERROR_CODE_TO_MESSAGE_CASE (MDF_UNSUPPORTED_DATA_BLOCK);
+	ERROR_CODE_TO_MESSAGE_CASE (MDF_MALFORMED_BLOCK);
+	ERROR_CODE_TO_MESSAGE_CASE (MDF_CATALOG_MALFORMED);
+	ERROR_CODE_TO_MESSAGE_CASE (MDF_ARCHIVE_MALFORMED);
+
 	// serial_can module
 	ERROR_CODE_TO_MESSAGE_CASE (SLCAN_EWRN);
 	ERROR_CODE_TO_MESSAGE_CASE (SLCAN_OFFLINE);
@@ -0,0 +1,118 @@
+// Header
+#include "histogram.h"
+
+// C Standard Library
+#include <string.h>
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+static inline size_t getBucketIndex (uint64_t value)
+{
+	// Values below the sub-bucket count are stored exactly.
+	if (value < HISTOGRAM_SUB_BUCKET_COUNT)
+		return value;
+
+	// Otherwise, index by the position of the most significant bit, then by the following sub-bucket bits.
+	unsigned shift = 63 - __builtin_clzll (value) - HISTOGRAM_SUB_BUCKET_BITS;
+	uint64_t mantissa = value >> shift;
+	return (shift + 1) * HISTOGRAM_SUB_BUCKET_COUNT + (mantissa - HISTOGRAM_SUB_BUCKET_COUNT);
+}
+
+static inline uint64_t getBucketMax (size_t index)
+{
+	if (index < HISTOGRAM_SUB_BUCKET_COUNT)
+		return index;
+
+	unsigned shift = index / HISTOGRAM_SUB_BUCKET_COUNT - 1;
+	uint64_t mantissa = HISTOGRAM_SUB_BUCKET_COUNT + index % HISTOGRAM_SUB_BUCKET_COUNT;
+	return ((mantissa + 1) << shift) - 1;
+}
+
+void histogramInit (histogram_t* hist)
+{
+	memset (hist, 0, sizeof (histogram_t));
+	hist->min = UINT64_MAX;
+}
+
+void histogramRecord (histogram_t* hist, uint64_t value)
+{
+	++hist->buckets [getBucketIndex (value)];
+	++hist->count;
+	hist->sum += value;
+
+	if (value < hist->min)
+		hist->min = value;
+	if (value > hist->max)
+		hist->max = value;
+}
+
+void histogramMerge (histogram_t* dest, const histogram_t* src)
+{
+	for (size_t index = 0; index < HISTOGRAM_BUCKET_COUNT; ++index)
+		dest->buckets [index] += src->buckets [index];
+
+	dest->count += src->count;
+	dest->sum += src->sum;
+
+	if (src->min < dest->min)
+		dest->min = src->min;
+	if (src->max > dest->max)
+		dest->max = src->max;
+}
+
+uint64_t histogramPercentile (const histogram_t* hist, double percentile)
+{
+	if (hist->count == 0)
+		return 0;
+
+	if (percentile < 0)
+		percentile = 0;
+	if (percentile > 100)
+		percentile = 100;
+
+	// Find the rank of the percentile (1-indexed), then the bucket containing said rank.
+	uint64_t rank = (uint64_t) (percentile / 100.0 * hist->count + 0.5);
+	if (rank == 0)
+		rank = 1;
+
+	uint64_t cumulative = 0;
+	for (size_t index = 0; index < HISTOGRAM_BUCKET_COUNT; ++index)
+	{
+		cumulative += hist->buckets [index];
+		if (cumulative < rank)
+			continue;
+
+		uint64_t value = getBucketMax (index);
+		if (value < hist->min)
+			return hist->min;
+		if (value > hist->max)
+			return hist->max;
+		return value;
+	}
+
+	return hist->max;
+}
+
+double histogramMean (const histogram_t* hist)
+{
+	if (hist->count == 0)
+		return 0;
+
+	return (double) (hist->sum / hist->count);
+}
+
+int fprintHistogramSummary (FILE* stream, const histogram_t* hist, double divisor, const char* unit)
+{
+	if (hist->count == 0)
+		return fprintf (stream, "n=0");
+
+	return fprintf (stream, "n=%llu min=%.3f%s mean=%.3f%s p50=%.3f%s p90=%.3f%s p99=%.3f%s p99.9=%.3f%s max=%.3f%s",
+		(unsigned long long) hist->count,
+		hist->min / divisor, unit,
+		histogramMean (hist) / divisor, unit,
+		histogramPercentile (hist, 50) / divisor, unit,
+		histogramPercentile (hist, 90) / divisor, unit,
+		histogramPercentile (hist, 99) / divisor, unit,
+		histogramPercentile (hist, 99.9) / divisor, unit,
+		hist->max / divisor, unit);
+}
@@ -0,0 +1,101 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+// Log-Linear Histogram -------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: Fixed-size histogram for recording latency-like measurements (ex. nanoseconds of timing error). Values are
+//   binned log-linearly, that is each power-of-two range is divided into a fixed number of linear sub-buckets. This bounds
+//   the relative error of any reported value (~3% with the default sub-bucket count) while covering the entire 64-bit range
+//   with a small, fixed amount of memory. Recording a value is constant time and never allocates, making it suitable for use
+//   inside of timing-critical loops.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// C Standard Library
+#include <stdint.h>
+#include <stdio.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of bits of precision each power-of-two range is divided into.
+#define HISTOGRAM_SUB_BUCKET_BITS 5
+
+/// @brief The number of linear sub-buckets each power-of-two range is divided into.
+#define HISTOGRAM_SUB_BUCKET_COUNT (1 << HISTOGRAM_SUB_BUCKET_BITS)
+
+/// @brief The total number of buckets in a histogram.
+#define HISTOGRAM_BUCKET_COUNT ((64 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKET_COUNT)
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The number of values recorded into each bucket.
+	uint64_t buckets [HISTOGRAM_BUCKET_COUNT];
+
+	/// @brief The total number of values recorded.
+	uint64_t count;
+
+	/// @brief The sum of all values recorded. Used for calculating the mean.
+	long double sum;
+
+	/// @brief The smallest value recorded.
+	uint64_t min;
+
+	/// @brief The largest value recorded.
+	uint64_t max;
+} histogram_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes (or resets) a histogram.
+ * @param hist The histogram to initialize.
+ */
+void histogramInit (histogram_t* hist);
+
+/**
+ * @brief Records a value into a histogram.
+ * @param hist The histogram to record into.
+ * @param value The value to record.
+ */
+void histogramRecord (histogram_t* hist, uint64_t value);
+
+/**
+ * @brief Adds all the values recorded in one histogram into another.
+ * @param dest The histogram to add into.
+ * @param src The histogram to add from. Not modified.
+ */
+void histogramMerge (histogram_t* dest, const histogram_t* src);
+
+/**
+ * @brief Gets the value at a percentile of a histogram. The returned value is the highest value equivalent to the bucket the
+ * percentile falls into, clamped to the range of recorded values.
+ * @param hist The histogram to get from.
+ * @param percentile The percentile to get, in the range [0, 100].
+ * @return The value at the percentile, 0 if the histogram is empty.
+ */
+uint64_t histogramPercentile (const histogram_t* hist, double percentile);
+
+/**
+ * @brief Gets the mean of all values recorded in a histogram.
+ * @param hist The histogram to get from.
+ * @return The mean value, 0 if the histogram is empty.
+ */
+double histogramMean (const histogram_t* hist);
+
+/**
+ * @brief Prints a one-line summary of a histogram's distribution. Values are scaled by a divisor before printing, allowing
+ * values recorded in nanoseconds to be displayed in micro- or milliseconds.
+ * @param stream The stream to print to.
+ * @param hist The histogram to print.
+ * @param divisor The value to divide each statistic by before printing.
+ * @param unit The unit to postfix each statistic with (ex. "us").
+ * @return The number of characters printed if successful, a negative value otherwise.
+ */
+int fprintHistogramSummary (FILE* stream, const histogram_t* hist, double divisor, const char* unit);
+
+#endif // HISTOGRAM_H
@@ -22,8 +22,8 @@
 /// @brief Converts a channel ID string into a channel ID value.
 #define MDF_BLOCK_ID_STR_TO_VALUE(c0, c1, c2, c3) ((c0) | (c1) << 8 | (c2) << 16 | (c3) << 24)
 
-/// @brief The file identification string of a finalized MDF file. Note MDF files generated with this interface are likely not
-/// finalized, I just added it here for completeness.
+/// @brief The file identification string of a finalized MDF file. Files are written unfinalized, then finalized once complete
+/// (see @c mdfFinalizeFileIdBlock ).
 #define MDF_FILE_IDENTIFICATION_FINALIZED {'M', 'D', 'F', ' ', ' ', ' ', ' ', ' '}
 
 /// @brief The file identification string of an unfinalized MDF file.
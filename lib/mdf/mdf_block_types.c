@@ -1,9 +1,17 @@
 // Header
 #include "mdf_block_types.h"
 
+// Includes
+#include "error_codes.h"
+
+// zlib
+#include <zlib.h>
+
 // C Standard Library
 #include <errno.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 int mdfHdBlockInit (mdfBlock_t* block, mdfHdDataSection_t* dataSection, mdfHdLinkList_t* linkList)
@@ -77,6 +85,147 @@ int mdfDtBlockInit (mdfBlock_t* block)
 	return mdfBlockInit (block, MDF_BLOCK_ID_DT, 0, 0);
 }
 
+/**
+ * @brief Transposes (or un-transposes) data, as done by @c MDF_DZ_ZIP_TYPE_TRANSPOSE_DEFLATE . The data is treated as a matrix
+ * with @c columns columns, and as many complete rows as fit. Any remaining bytes are copied as-is.
+ * @param destination The buffer to write the result into. Must be at least @c size bytes.
+ * @param source The data to transpose.
+ * @param size The size of the data, in bytes.
+ * @param columns The number of columns of the matrix.
+ * @param inverse False to transpose, true to reverse a previous transposition.
+ */
+static void transpose (uint8_t* destination, const uint8_t* source, size_t size, size_t columns, bool inverse)
+{
+	size_t rows = size / columns;
+	for (size_t row = 0; row < rows; ++row)
+	{
+		for (size_t column = 0; column < columns; ++column)
+		{
+			if (inverse)
+				destination [row * columns + column] = source [column * rows + row];
+			else
+				destination [column * rows + row] = source [row * columns + column];
+		}
+	}
+
+	memcpy (destination + rows * columns, source + rows * columns, size - rows * columns);
+}
+
+int mdfDzBlockInit (mdfBlock_t* block, const uint8_t* data, size_t size, uint32_t columns)
+{
+	// Transposition only applies if there is more than one column and at least one complete row.
+	bool transposed = columns > 1 && size >= columns;
+
+	// Initialize the block with enough space for the worst-case compressed size. The block length is shrunk to the actual
+	// size once known.
+	uLong bound = compressBound (size);
+	if (mdfBlockInit (block, MDF_BLOCK_ID_DZ, 0, sizeof (mdfDzDataSection_t) + bound) != 0)
+		return errno;
+
+	uint8_t* transposedData = NULL;
+	if (transposed)
+	{
+		transposedData = malloc (size);
+		if (transposedData == NULL)
+		{
+			mdfBlockDealloc (block);
+			return errno;
+		}
+
+		transpose (transposedData, data, size, columns, false);
+		data = transposedData;
+	}
+
+	// Use the fastest compression level, the data is produced in real-time.
+	uLongf dataLength = bound;
+	int code = compress2 ((uint8_t*) block->dataSection + sizeof (mdfDzDataSection_t), &dataLength, data, size, Z_BEST_SPEED);
+	free (transposedData);
+	if (code != Z_OK)
+	{
+		mdfBlockDealloc (block);
+		errno = ERRNO_MDF_DEFLATE_FAILURE;
+		return errno;
+	}
+
+	*mdfDzBlockDataSection (block) = (mdfDzDataSection_t)
+	{
+		.originalBlockType	= {'D', 'T'},
+		.zipType			= transposed ? MDF_DZ_ZIP_TYPE_TRANSPOSE_DEFLATE : MDF_DZ_ZIP_TYPE_DEFLATE,
+		.zipParameter		= transposed ? columns : 0,
+		.originalDataLength	= size,
+		.dataLength			= dataLength
+	};
+
+	block->header.blockLength = sizeof (block->header) + sizeof (mdfDzDataSection_t) + dataLength;
+	return 0;
+}
+
+int mdfDzBlockInflate (mdfBlock_t* block, uint8_t** data, size_t* size)
+{
+	mdfDzDataSection_t* dataSection = mdfDzBlockDataSection (block);
+
+	// Validate the data section against the block's length, the block may be corrupted.
+	if (mdfBlockDataSectionSize (block) < sizeof (mdfDzDataSection_t) ||
+		dataSection->dataLength > mdfBlockDataSectionSize (block) - sizeof (mdfDzDataSection_t) ||
+		(dataSection->zipType != MDF_DZ_ZIP_TYPE_DEFLATE && dataSection->zipType != MDF_DZ_ZIP_TYPE_TRANSPOSE_DEFLATE))
+	{
+		errno = ERRNO_MDF_DEFLATE_FAILURE;
+		return errno;
+	}
+
+	uLongf originalLength = dataSection->originalDataLength;
+	*data = malloc (originalLength);
+	if (*data == NULL)
+		return errno;
+
+	int code = uncompress (*data, &originalLength, (uint8_t*) block->dataSection + sizeof (mdfDzDataSection_t),
+		dataSection->dataLength);
+	if (code != Z_OK || originalLength != dataSection->originalDataLength)
+	{
+		free (*data);
+		errno = ERRNO_MDF_DEFLATE_FAILURE;
+		return errno;
+	}
+
+	*size = originalLength;
+
+	// Reverse the transposition, if used.
+	if (dataSection->zipType == MDF_DZ_ZIP_TYPE_TRANSPOSE_DEFLATE && dataSection->zipParameter > 1)
+	{
+		uint8_t* transposedData = *data;
+		*data = malloc (*size);
+		if (*data == NULL)
+		{
+			free (transposedData);
+			return errno;
+		}
+
+		transpose (*data, transposedData, *size, dataSection->zipParameter, true);
+		free (transposedData);
+	}
+
+	return 0;
+}
+
+int mdfDlBlockInit (mdfBlock_t* block, const uint64_t* dataAddrs, const uint64_t* offsets, uint32_t count)
+{
+	// Initialize the block
+	if (mdfBlockInit (block, MDF_BLOCK_ID_DL, count + 1, sizeof (mdfDlDataSection_t) + sizeof (uint64_t) * count) != 0)
+		return errno;
+
+	// Populate the link list (the next list's address is left as 0) and data section.
+	memcpy (block->linkList + 1, dataAddrs, sizeof (uint64_t) * count);
+
+	*mdfDlBlockDataSection (block) = (mdfDlDataSection_t)
+	{
+		.flags	= 0x00,
+		.count	= count
+	};
+	memcpy ((uint8_t*) block->dataSection + sizeof (mdfDlDataSection_t), offsets, sizeof (uint64_t) * count);
+
+	return 0;
+}
+
 int mdfSiBlockInit (mdfBlock_t* block, mdfSiDataSection_t* dataSection, mdfSiLinkList_t* linkList)
 {
 	// Initialize the block
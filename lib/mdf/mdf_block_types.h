@@ -19,6 +19,7 @@
 
 // C Standard Library
 #include <stdarg.h>
+#include <stddef.h>
 
 // ##HD - Header Block --------------------------------------------------------------------------------------------------------
 
@@ -91,6 +92,12 @@ static inline mdfHdLinkList_t* mdfHdBlockLinkList (mdfBlock_t* block) { return (
 /// @brief Channel data type indicating an unsigned integer encoded in the intel (little endian) format.
 #define MDF_DATA_TYPE_UNSIGNED_INTEL 0x00
 
+/// @brief Channel data type indicating a two's complement signed integer encoded in the intel (little endian) format.
+#define MDF_DATA_TYPE_SIGNED_INTEL 0x02
+
+/// @brief Channel data type indicating an IEEE 754 floating-point number encoded in the intel (little endian) format.
+#define MDF_DATA_TYPE_FLOAT_INTEL 0x04
+
 /// @brief Channel data type indicating an array of bytes.
 #define MDF_DATA_TYPE_BYTE_ARRAY 0x0A
 
@@ -374,6 +381,101 @@ static inline mdfDgLinkList_t* mdfDgBlockLinkList (mdfBlock_t* block) { return (
  */
 int mdfDtBlockInit (mdfBlock_t* block);
 
+// ##DZ - Compressed Data Block -----------------------------------------------------------------------------------------------
+
+/// @brief The block ID of a compressed data block.
+#define MDF_BLOCK_ID_DZ MDF_BLOCK_ID_STR_TO_VALUE ('#', '#', 'D', 'Z')
+
+/// @brief Zip type indicating the data is deflate-compressed.
+#define MDF_DZ_ZIP_TYPE_DEFLATE				0x00
+
+/// @brief Zip type indicating the data is transposed, then deflate-compressed.
+#define MDF_DZ_ZIP_TYPE_TRANSPOSE_DEFLATE	0x01
+
+/// @brief The data section of a compressed data block. Note the compressed data immediately follows this.
+typedef struct
+{
+	/// @brief The block type of the data before compression, ex. "DT". Note this string is not null-terminated.
+	char originalBlockType [2];
+
+	/// @brief The compression algorithm of the data.
+	uint8_t zipType;
+
+	/// @brief Reserved, must be all 0s.
+	uint8_t reserved0 [1];
+
+	/// @brief For transposed data, the number of columns of the transposition, that is the length of each record. Unused
+	/// otherwise.
+	uint32_t zipParameter;
+
+	/// @brief The length of the data before compression, in bytes.
+	uint64_t originalDataLength;
+
+	/// @brief The length of the compressed data, in bytes.
+	uint64_t dataLength;
+} mdfDzDataSection_t;
+
+/**
+ * @brief Initializes a compressed data block, compressing data that would otherwise be placed in a data block.
+ * @param block The block to initialize. Must be deallocated using @c mdfBlockDealloc .
+ * @param data The data to compress.
+ * @param size The size of @c data , in bytes.
+ * @param columns If greater than 1, the data is transposed before compression, using this as the record length. This greatly
+ * improves the compression of fixed-length records. Use 0 to not transpose the data.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfDzBlockInit (mdfBlock_t* block, const uint8_t* data, size_t size, uint32_t columns);
+
+/// @return The data section of the block.
+static inline mdfDzDataSection_t* mdfDzBlockDataSection (mdfBlock_t* block) { return (mdfDzDataSection_t*) block->dataSection; }
+
+/**
+ * @brief Decompresses the data of a compressed data block.
+ * @param block The block to decompress. The data section must be read.
+ * @param data Written to the decompressed data. Must be freed by the caller.
+ * @param size Written to the size of the decompressed data, in bytes.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfDzBlockInflate (mdfBlock_t* block, uint8_t** data, size_t* size);
+
+// ##DL - Data List Block -----------------------------------------------------------------------------------------------------
+
+/// @brief The block ID of a data list block.
+#define MDF_BLOCK_ID_DL MDF_BLOCK_ID_STR_TO_VALUE ('#', '#', 'D', 'L')
+
+/// @brief The data section of a data list block, excluding the offset of each data block, which immediately follow this.
+typedef struct
+{
+	/// @brief The list's flags. If bit 0 is set, all data blocks are of equal length.
+	uint8_t flags;
+
+	/// @brief Reserved, must be all 0s.
+	uint8_t reserved0 [3];
+
+	/// @brief The number of data blocks in the list.
+	uint32_t count;
+} mdfDlDataSection_t;
+
+/**
+ * @brief Initializes a data list block. The link list consists of the next data list's address, followed by the address of
+ * each data block.
+ * @param block The block to initialize. Must be deallocated using @c mdfBlockDealloc .
+ * @param dataAddrs The address of each data block.
+ * @param offsets The offset of each data block's (uncompressed) data within the concatenation of all the data.
+ * @param count The number of data blocks in the list.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfDlBlockInit (mdfBlock_t* block, const uint64_t* dataAddrs, const uint64_t* offsets, uint32_t count);
+
+/// @return The data section of the block.
+static inline mdfDlDataSection_t* mdfDlBlockDataSection (mdfBlock_t* block) { return (mdfDlDataSection_t*) block->dataSection; }
+
+/// @return The address of the next data list block, 0 if this is the last.
+static inline uint64_t mdfDlBlockNextAddr (mdfBlock_t* block) { return block->linkList [0]; }
+
+/// @return The address of the data block at the specified index.
+static inline uint64_t mdfDlBlockDataAddr (mdfBlock_t* block, size_t index) { return block->linkList [index + 1]; }
+
 // ##SI - Source Information Block --------------------------------------------------------------------------------------------
 
 /// @brief The block ID of a source information block.
@@ -0,0 +1,649 @@
+// Header
+#include "mdf_can_bus_archive.h"
+
+// Includes
+#include "error_codes.h"
+
+// zlib
+#include <zlib.h>
+
+// C Standard Library
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+#define ARCHIVE_MAGIC				"ZRECANAR"
+#define ARCHIVE_VERSION				1
+
+/// @brief The size of the archive's header, in bytes.
+#define ARCHIVE_HEADER_SIZE			24
+
+/// @brief The size of a block's header, in bytes.
+#define BLOCK_HEADER_SIZE			32
+
+/// @brief The maximum size of a varint, in bytes.
+#define VARINT_SIZE_MAX				10
+
+/// @brief The maximum size of a record's entry in the time stream, in bytes.
+#define TIME_SIZE_MAX				VARINT_SIZE_MAX
+
+/// @brief The maximum size of a record's entry in the tag stream, in bytes. That is, the tag, a CAN ID, and the remaining
+/// fields of a new dictionary entry.
+#define TAG_SIZE_MAX				(VARINT_SIZE_MAX + VARINT_SIZE_MAX + 4)
+
+/// @brief The size of the dictionary's hash table. Must be a power of 2, at least twice the block size, so it is never more
+/// than half full.
+#define TABLE_SIZE					(MDF_CAN_BUS_ARCHIVE_BLOCK_SIZE * 2)
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+static uint8_t* encodeField (uint8_t* data, const void* value, size_t size)
+{
+	memcpy (data, value, size);
+	return data + size;
+}
+
+static const uint8_t* decodeField (const uint8_t* data, void* value, size_t size)
+{
+	memcpy (value, data, size);
+	return data + size;
+}
+
+static inline size_t encodeVarint (uint8_t* data, uint64_t value)
+{
+	size_t size = 0;
+	while (value >= 0x80)
+	{
+		data [size++] = (uint8_t) value | 0x80;
+		value >>= 7;
+	}
+	data [size++] = (uint8_t) value;
+	return size;
+}
+
+/**
+ * @brief Decodes a varint from a stream.
+ * @param data The stream to decode from.
+ * @param size The size of the stream, in bytes.
+ * @param offset The offset of the varint within the stream. Advanced past it if successful.
+ * @param value Written to the decoded value.
+ * @return True if successful, false if the varint is truncated or too long.
+ */
+static inline bool decodeVarint (const uint8_t* data, size_t size, size_t* offset, uint64_t* value)
+{
+	uint64_t result = 0;
+	for (unsigned shift = 0; shift < 64 && *offset < size; shift += 7)
+	{
+		uint8_t byte = data [(*offset)++];
+		result |= (uint64_t) (byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			*value = result;
+			return true;
+		}
+	}
+	return false;
+}
+
+static inline uint64_t zigzagEncode (int64_t value)
+{
+	return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+}
+
+static inline int64_t zigzagDecode (uint64_t value)
+{
+	return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+static inline size_t getPayloadSize (const mdfCanBusArchiveEntry_t* entry)
+{
+	if (entry->type == MDF_CAN_BUS_RECORD_REMOTE_FRAME)
+		return 0;
+	return entry->dlc < MDF_CAN_BUS_ARCHIVE_PAYLOAD_SIZE ? entry->dlc : MDF_CAN_BUS_ARCHIVE_PAYLOAD_SIZE;
+}
+
+static inline bool entryMatches (const mdfCanBusArchiveEntry_t* entry, const mdfCanBusRecord_t* record)
+{
+	return entry->id == record->id && entry->ide == record->ide && entry->busChannel == record->busChannel &&
+		entry->direction == record->direction && entry->type == record->type && entry->errorType == record->errorType;
+}
+
+static inline size_t hashRecord (const mdfCanBusRecord_t* record)
+{
+	// Multiplicative hash, IDs are often consecutive.
+	uint64_t key = ((uint64_t) record->busChannel << 40) | ((uint64_t) record->errorType << 48) |
+		((uint64_t) record->type << 36) | ((uint64_t) record->direction << 34) | ((uint64_t) record->ide << 32) | record->id;
+	return (size_t) ((key * 0x9E3779B97F4A7C15ull) >> 32) & (TABLE_SIZE - 1);
+}
+
+/**
+ * @brief Writes the current block of a writer, then starts a new one.
+ * @param writer The writer to use.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int writeBlock (mdfCanBusArchiveWriter_t* writer)
+{
+	if (writer->recordCount == 0)
+		return 0;
+
+	// Deflate the streams together, so the compressor's window spans all three.
+	z_stream stream = { 0 };
+	if (deflateInit (&stream, writer->level) != Z_OK)
+	{
+		errno = ERRNO_MDF_DEFLATE_FAILURE;
+		return errno;
+	}
+
+	stream.next_out = writer->deflated;
+	stream.avail_out = writer->deflatedCapacity;
+
+	const uint8_t* streams [] = { writer->time, writer->tag, writer->payload };
+	size_t sizes [] = { writer->timeSize, writer->tagSize, writer->payloadSize };
+	int code = Z_OK;
+	for (size_t index = 0; index < 3 && code == Z_OK; ++index)
+	{
+		stream.next_in = (uint8_t*) streams [index];
+		stream.avail_in = sizes [index];
+		code = deflate (&stream, index == 2 ? Z_FINISH : Z_NO_FLUSH);
+	}
+
+	uint32_t compressedSize = stream.total_out;
+	deflateEnd (&stream);
+	if (code != Z_STREAM_END)
+	{
+		errno = ERRNO_MDF_DEFLATE_FAILURE;
+		return errno;
+	}
+
+	uint8_t header [BLOCK_HEADER_SIZE];
+	uint32_t recordCount = writer->recordCount;
+	uint32_t timeSize = writer->timeSize;
+	uint32_t tagSize = writer->tagSize;
+	uint32_t payloadSize = writer->payloadSize;
+
+	uint8_t* head = header;
+	head = encodeField (head, &compressedSize, sizeof (compressedSize));
+	head = encodeField (head, &recordCount, sizeof (recordCount));
+	head = encodeField (head, &timeSize, sizeof (timeSize));
+	head = encodeField (head, &tagSize, sizeof (tagSize));
+	head = encodeField (head, &payloadSize, sizeof (payloadSize));
+	head = encodeField (head, &writer->splitNumber, sizeof (writer->splitNumber));
+	head = encodeField (head, &writer->firstTimestampNs, sizeof (writer->firstTimestampNs));
+
+	if (fwrite (header, 1, sizeof (header), writer->file) != sizeof (header) ||
+		fwrite (writer->deflated, 1, compressedSize, writer->file) != compressedSize)
+		return errno;
+
+	writer->size += sizeof (header) + compressedSize;
+	++writer->blockCount;
+
+	// Reset the block's state.
+	writer->recordCount = 0;
+	writer->timeSize = 0;
+	writer->tagSize = 0;
+	writer->payloadSize = 0;
+	writer->entryCount = 0;
+	memset (writer->table, 0, sizeof (uint32_t) * TABLE_SIZE);
+	return 0;
+}
+
+int mdfCanBusArchiveWriterInit (mdfCanBusArchiveWriter_t* writer, const char* path, const mdfCanBusArchiveConfig_t* config)
+{
+	*writer = (mdfCanBusArchiveWriter_t)
+	{
+		.level				= config->level != 0 ? config->level : MDF_CAN_BUS_ARCHIVE_LEVEL_DEFAULT,
+		.deflatedCapacity	= compressBound (MDF_CAN_BUS_ARCHIVE_BLOCK_SIZE *
+			(TIME_SIZE_MAX + TAG_SIZE_MAX + MDF_CAN_BUS_ARCHIVE_PAYLOAD_SIZE))
+	};
+
+	writer->time = malloc (MDF_CAN_BUS_ARCHIVE_BLOCK_SIZE * TIME_SIZE_MAX);
+	writer->tag = malloc (MDF_CAN_BUS_ARCHIVE_BLOCK_SIZE * TAG_SIZE_MAX);
+	writer->payload = malloc (MDF_CAN_BUS_ARCHIVE_BLOCK_SIZE * MDF_CAN_BUS_ARCHIVE_PAYLOAD_SIZE);
+	writer->deflated = malloc (writer->deflatedCapacity);
+	writer->entries = malloc (sizeof (mdfCanBusArchiveEntry_t) * MDF_CAN_BUS_ARCHIVE_BLOCK_SIZE);
+	writer->table = calloc (TABLE_SIZE, sizeof (uint32_t));
+	if (writer->time == NULL || writer->tag == NULL || writer->payload == NULL || writer->deflated == NULL ||
+		writer->entries == NULL || writer->table == NULL)
+	{
+		int code = errno;
+		mdfCanBusArchiveWriterClose (writer);
+		errno = code;
+		return code;
+	}
+
+	writer->file = fopen (path, "wb");
+	if (writer->file == NULL)
+	{
+		int code = errno;
+		mdfCanBusArchiveWriterClose (writer);
+		errno = code;
+		return code;
+	}
+
+	uint8_t header [ARCHIVE_HEADER_SIZE];
+	uint32_t version = ARCHIVE_VERSION;
+
+	uint8_t* head = header;
+	head = encodeField (head, ARCHIVE_MAGIC, 8);
+	head = encodeField (head, &version, sizeof (version));
+	head = encodeField (head, &config->sessionNumber, sizeof (config->sessionNumber));
+	head = encodeField (head, &config->startTimeNs, sizeof (config->startTimeNs));
+
+	if (fwrite (header, 1, sizeof (header), writer->file) != sizeof (header))
+	{
+		int code = errno;
+		mdfCanBusArchiveWriterClose (writer);
+		errno = code;
+		return code;
+	}
+
+	writer->size = sizeof (header);
+	return 0;
+}
+
+int mdfCanBusArchiveWriterSplit (mdfCanBusArchiveWriter_t* writer, uint32_t splitNumber)
+{
+	if (writeBlock (writer) != 0)
+		return errno;
+
+	writer->splitNumber = splitNumber;
+	return 0;
+}
+
+int mdfCanBusArchiveWriterWrite (mdfCanBusArchiveWriter_t* writer, const mdfCanBusRecord_t* record)
+{
+	if (writer->recordCount == MDF_CAN_BUS_ARCHIVE_BLOCK_SIZE && writeBlock (writer) != 0)
+		return errno;
+
+	if (writer->recordCount == 0)
+	{
+		writer->firstTimestampNs = record->timestampNs;
+		writer->lastTimestampNs = record->timestampNs;
+	}
+
+	// Timestamp delta, signed as records need not be in timestamp order (ex. frames of multiple buses).
+	writer->timeSize += encodeVarint (writer->time + writer->timeSize,
+		zigzagEncode ((int64_t) (record->timestampNs - writer->lastTimestampNs)));
+	writer->lastTimestampNs = record->timestampNs;
+
+	// Find the record's dictionary entry.
+	size_t slot = hashRecord (record);
+	while (writer->table [slot] != 0 && !entryMatches (&writer->entries [writer->table [slot] - 1], record))
+		slot = (slot + 1) & (TABLE_SIZE - 1);
+
+	mdfCanBusArchiveEntry_t* entry;
+	if (writer->table [slot] == 0)
+	{
+		// New entry, always includes the DLC.
+		entry = &writer->entries [writer->entryCount];
+		*entry = (mdfCanBusArchiveEntry_t)
+		{
+			.id			= record->id,
+			.ide		= record->ide,
+			.direction	= record->direction,
+			.type		= record->type,
+			.busChannel	= record->busChannel,
+			.errorType	= record->errorType,
+			.dlc		= record->dlc
+		};
+
+		uint8_t* tag = writer->tag + writer->tagSize;
+		tag += encodeVarint (tag, (uint64_t) writer->entryCount << 1);
+		tag += encodeVarint (tag, record->id);
+		*(tag++) = record->ide | record->direction << 1 | record->type << 2;
+		*(tag++) = record->busChannel;
+		*(tag++) = record->errorType;
+		*(tag++) = record->dlc;
+		writer->tagSize = tag - writer->tag;
+
+		++writer->entryCount;
+		writer->table [slot] = writer->entryCount;
+	}
+	else
+	{
+		size_t index = writer->table [slot] - 1;
+		entry = &writer->entries [index];
+
+		bool dlcChanged = entry->dlc != record->dlc;
+		writer->tagSize += encodeVarint (writer->tag + writer->tagSize, (uint64_t) index << 1 | dlcChanged);
+		if (dlcChanged)
+		{
+			writer->tag [writer->tagSize++] = record->dlc;
+			entry->dlc = record->dlc;
+		}
+	}
+
+	// Payload, XOR-ed with the entry's previous payload.
+	size_t payloadSize = getPayloadSize (entry);
+	for (size_t index = 0; index < payloadSize; ++index)
+	{
+		writer->payload [writer->payloadSize++] = record->data [index] ^ entry->payload [index];
+		entry->payload [index] = record->data [index];
+	}
+
+	++writer->recordCount;
+	return 0;
+}
+
+int mdfCanBusArchiveWriterClose (mdfCanBusArchiveWriter_t* writer)
+{
+	int code = 0;
+	if (writer->file != NULL)
+	{
+		if (writeBlock (writer) != 0)
+			code = errno;
+		if (fclose (writer->file) != 0 && code == 0)
+			code = errno;
+	}
+
+	free (writer->time);
+	free (writer->tag);
+	free (writer->payload);
+	free (writer->deflated);
+	free (writer->entries);
+	free (writer->table);
+	writer->file = NULL;
+
+	errno = code;
+	return code;
+}
+
+/**
+ * @brief Decodes the inflated streams of a block into the reader's records.
+ * @param reader The reader to decode into.
+ * @param timeSize The size of the time stream, in bytes.
+ * @param tagSize The size of the tag stream, in bytes.
+ * @param payloadSize The size of the payload stream, in bytes.
+ * @param firstTimestampNs The timestamp preceding the block.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int decodeBlock (mdfCanBusArchiveReader_t* reader, size_t timeSize, size_t tagSize, size_t payloadSize,
+	uint64_t firstTimestampNs)
+{
+	const uint8_t* time = reader->inflated;
+	const uint8_t* tag = time + timeSize;
+	const uint8_t* payload = tag + tagSize;
+	size_t timeOffset = 0;
+	size_t tagOffset = 0;
+	size_t payloadOffset = 0;
+	size_t entryCount = 0;
+	uint64_t timestampNs = firstTimestampNs;
+
+	for (size_t recordIndex = 0; recordIndex < reader->recordCount; ++recordIndex)
+	{
+		uint64_t delta;
+		uint64_t tagValue;
+		if (!decodeVarint (time, timeSize, &timeOffset, &delta) || !decodeVarint (tag, tagSize, &tagOffset, &tagValue))
+		{
+			errno = ERRNO_MDF_ARCHIVE_MALFORMED;
+			return errno;
+		}
+
+		timestampNs += zigzagDecode (delta);
+
+		size_t index = tagValue >> 1;
+		mdfCanBusArchiveEntry_t* entry;
+		if (index == entryCount)
+		{
+			// New entry.
+			uint64_t id;
+			if (!decodeVarint (tag, tagSize, &tagOffset, &id) || tagSize - tagOffset < 4)
+			{
+				errno = ERRNO_MDF_ARCHIVE_MALFORMED;
+				return errno;
+			}
+
+			uint8_t flags = tag [tagOffset++];
+			if ((flags >> 2) > MDF_CAN_BUS_RECORD_ERROR_FRAME)
+			{
+				errno = ERRNO_MDF_ARCHIVE_MALFORMED;
+				return errno;
+			}
+
+			entry = &reader->entries [entryCount++];
+			*entry = (mdfCanBusArchiveEntry_t)
+			{
+				.id			= id,
+				.ide		= flags & 0x01,
+				.direction	= (flags >> 1) & 0x01,
+				.type		= flags >> 2,
+				.busChannel	= tag [tagOffset],
+				.errorType	= tag [tagOffset + 1],
+				.dlc		= tag [tagOffset + 2]
+			};
+			tagOffset += 3;
+		}
+		else if (index < entryCount)
+		{
+			entry = &reader->entries [index];
+			if (tagValue & 1)
+			{
+				if (tagOffset == tagSize)
+				{
+					errno = ERRNO_MDF_ARCHIVE_MALFORMED;
+					return errno;
+				}
+				entry->dlc = tag [tagOffset++];
+			}
+		}
+		else
+		{
+			errno = ERRNO_MDF_ARCHIVE_MALFORMED;
+			return errno;
+		}
+
+		size_t size = getPayloadSize (entry);
+		if (payloadSize - payloadOffset < size)
+		{
+			errno = ERRNO_MDF_ARCHIVE_MALFORMED;
+			return errno;
+		}
+
+		uint8_t* data = reader->payloads [recordIndex];
+		for (size_t byteIndex = 0; byteIndex < size; ++byteIndex)
+		{
+			entry->payload [byteIndex] ^= payload [payloadOffset++];
+			data [byteIndex] = entry->payload [byteIndex];
+		}
+		memset (data + size, 0, MDF_CAN_BUS_ARCHIVE_PAYLOAD_SIZE - size);
+
+		reader->records [recordIndex] = (mdfCanBusRecord_t)
+		{
+			.type			= entry->type,
+			.timestampNs	= timestampNs,
+			.id				= entry->id,
+			.ide			= entry->ide,
+			.dlc			= entry->dlc,
+			.busChannel		= entry->busChannel,
+			.direction		= entry->direction,
+			.errorType		= entry->errorType,
+			.data			= data
+		};
+	}
+
+	// Every byte of the streams should be consumed.
+	if (timeOffset != timeSize || tagOffset != tagSize || payloadOffset != payloadSize)
+	{
+		errno = ERRNO_MDF_ARCHIVE_MALFORMED;
+		return errno;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Reads and decodes the next block of an archive.
+ * @param reader The reader to use.
+ * @return 0 if successful, the error code otherwise. If there are no more blocks, @c reader->end is set.
+ */
+static int readBlock (mdfCanBusArchiveReader_t* reader)
+{
+	reader->recordCount = 0;
+	reader->recordIndex = 0;
+
+	uint8_t header [BLOCK_HEADER_SIZE];
+	size_t headerSize = fread (header, 1, sizeof (header), reader->file);
+	if (headerSize == 0 && feof (reader->file))
+	{
+		reader->end = true;
+		return 0;
+	}
+
+	if (headerSize != sizeof (header))
+	{
+		errno = ferror (reader->file) ? EIO : ERRNO_MDF_ARCHIVE_MALFORMED;
+		return errno;
+	}
+
+	uint32_t compressedSize;
+	uint32_t recordCount;
+	uint32_t timeSize;
+	uint32_t tagSize;
+	uint32_t payloadSize;
+	uint64_t firstTimestampNs;
+
+	const uint8_t* head = header;
+	head = decodeField (head, &compressedSize, sizeof (compressedSize));
+	head = decodeField (head, &recordCount, sizeof (recordCount));
+	head = decodeField (head, &timeSize, sizeof (timeSize));
+	head = decodeField (head, &tagSize, sizeof (tagSize));
+	head = decodeField (head, &payloadSize, sizeof (payloadSize));
+	head = decodeField (head, &reader->splitNumber, sizeof (reader->splitNumber));
+	head = decodeField (head, &firstTimestampNs, sizeof (firstTimestampNs));
+
+	// Validate the sizes before allocating anything, the header may be corrupted.
+	if (recordCount == 0 || recordCount > MDF_CAN_BUS_ARCHIVE_BLOCK_SIZE || timeSize > recordCount * TIME_SIZE_MAX ||
+		tagSize > recordCount * TAG_SIZE_MAX || payloadSize > recordCount * MDF_CAN_BUS_ARCHIVE_PAYLOAD_SIZE ||
+		compressedSize > compressBound (timeSize + tagSize + payloadSize))
+	{
+		errno = ERRNO_MDF_ARCHIVE_MALFORMED;
+		return errno;
+	}
+
+	if (compressedSize > reader->deflatedCapacity)
+	{
+		uint8_t* deflated = realloc (reader->deflated, compressedSize);
+		if (deflated == NULL)
+			return errno;
+		reader->deflated = deflated;
+		reader->deflatedCapacity = compressedSize;
+	}
+
+	size_t inflatedSize = (size_t) timeSize + tagSize + payloadSize;
+	if (inflatedSize > reader->inflatedCapacity)
+	{
+		uint8_t* inflated = realloc (reader->inflated, inflatedSize);
+		if (inflated == NULL)
+			return errno;
+		reader->inflated = inflated;
+		reader->inflatedCapacity = inflatedSize;
+	}
+
+	if (fread (reader->deflated, 1, compressedSize, reader->file) != compressedSize)
+	{
+		errno = ferror (reader->file) ? EIO : ERRNO_MDF_ARCHIVE_MALFORMED;
+		return errno;
+	}
+
+	uLongf size = inflatedSize;
+	if (uncompress (reader->inflated, &size, reader->deflated, compressedSize) != Z_OK || size != inflatedSize)
+	{
+		errno = ERRNO_MDF_DEFLATE_FAILURE;
+		return errno;
+	}
+
+	reader->recordCount = recordCount;
+	if (decodeBlock (reader, timeSize, tagSize, payloadSize, firstTimestampNs) != 0)
+	{
+		reader->recordCount = 0;
+		return errno;
+	}
+
+	++reader->blockCount;
+	return 0;
+}
+
+int mdfCanBusArchiveReaderInit (mdfCanBusArchiveReader_t* reader, const char* path)
+{
+	*reader = (mdfCanBusArchiveReader_t) { 0 };
+
+	reader->records = malloc (sizeof (mdfCanBusRecord_t) * MDF_CAN_BUS_ARCHIVE_BLOCK_SIZE);
+	reader->payloads = malloc (MDF_CAN_BUS_ARCHIVE_PAYLOAD_SIZE * MDF_CAN_BUS_ARCHIVE_BLOCK_SIZE);
+	reader->entries = malloc (sizeof (mdfCanBusArchiveEntry_t) * MDF_CAN_BUS_ARCHIVE_BLOCK_SIZE);
+	if (reader->records == NULL || reader->payloads == NULL || reader->entries == NULL)
+	{
+		int code = errno;
+		mdfCanBusArchiveReaderClose (reader);
+		errno = code;
+		return code;
+	}
+
+	reader->file = fopen (path, "rb");
+	if (reader->file == NULL)
+	{
+		int code = errno;
+		mdfCanBusArchiveReaderClose (reader);
+		errno = code;
+		return code;
+	}
+
+	uint8_t header [ARCHIVE_HEADER_SIZE];
+	char magic [8];
+	uint32_t version;
+	if (fread (header, 1, sizeof (header), reader->file) == sizeof (header))
+	{
+		const uint8_t* head = header;
+		head = decodeField (head, magic, sizeof (magic));
+		head = decodeField (head, &version, sizeof (version));
+		head = decodeField (head, &reader->sessionNumber, sizeof (reader->sessionNumber));
+		head = decodeField (head, &reader->startTimeNs, sizeof (reader->startTimeNs));
+	}
+
+	if (ferror (reader->file) || feof (reader->file) || memcmp (magic, ARCHIVE_MAGIC, sizeof (magic)) != 0 ||
+		version != ARCHIVE_VERSION)
+	{
+		int code = ferror (reader->file) ? EIO : ERRNO_MDF_ARCHIVE_MALFORMED;
+		mdfCanBusArchiveReaderClose (reader);
+		errno = code;
+		return code;
+	}
+
+	return 0;
+}
+
+int mdfCanBusArchiveReaderRead (mdfCanBusArchiveReader_t* reader, mdfCanBusRecord_t* records, size_t capacity,
+	size_t* count)
+{
+	*count = 0;
+
+	if (reader->recordIndex == reader->recordCount)
+	{
+		if (reader->end)
+			return 0;
+		if (readBlock (reader) != 0)
+			return errno;
+		if (reader->end)
+			return 0;
+	}
+
+	size_t remaining = reader->recordCount - reader->recordIndex;
+	*count = remaining < capacity ? remaining : capacity;
+	memcpy (records, reader->records + reader->recordIndex, sizeof (mdfCanBusRecord_t) * *count);
+	reader->recordIndex += *count;
+	return 0;
+}
+
+void mdfCanBusArchiveReaderClose (mdfCanBusArchiveReader_t* reader)
+{
+	if (reader->file != NULL)
+		fclose (reader->file);
+
+	free (reader->records);
+	free (reader->payloads);
+	free (reader->entries);
+	free (reader->deflated);
+	free (reader->inflated);
+	reader->file = NULL;
+}
@@ -0,0 +1,247 @@
+#ifndef MDF_CAN_BUS_ARCHIVE_H
+#define MDF_CAN_BUS_ARCHIVE_H
+
+// MDF CAN Bus Archive --------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: Compact archival format for CAN bus logging sessions. Where an MDF CAN bus log stores every frame as a fixed
+//   size record, an archive exploits the structure of CAN traffic: timestamps are stored as variable-length deltas, the
+//   distinct frame headers (CAN ID, IDE, bus channel, direction, frame type) of a block are stored once in a dictionary and
+//   referenced by index, and each payload is XOR-ed with the previous payload of its header, so unchanged bytes become
+//   zeros. The three resulting streams are then deflate-compressed as a block.
+//
+//   Each block is self-contained (its dictionary and previous payloads start empty), so blocks can be decoded independently.
+//   Blocks never span splits, so the split structure of a session is preserved when converting back to MDF.
+//
+// File Format:
+//   char magic [8]                                   - "ZRECANAR"
+//   uint32_t version
+//   uint32_t sessionNumber
+//   uint64_t startTimeNs                             - The start of the session, in nanoseconds since the Unix epoch.
+//   Blocks, each:
+//     uint32_t compressedSize                        - The size of the deflated streams following the header, in bytes.
+//     uint32_t recordCount
+//     uint32_t timeSize, tagSize, payloadSize        - The inflated size of each stream, in bytes.
+//     uint32_t splitNumber                           - The split of the session the records belong to.
+//     uint64_t firstTimestampNs                      - The timestamp preceding the block's first timestamp delta.
+//     uint8_t data [compressedSize]                  - The time, tag, then payload streams, zlib-deflated together.
+//
+//   Per record, in the streams:
+//     time:    varint zigzag (timestampNs - previous timestampNs)
+//     tag:     varint (dictionaryIndex << 1 | dlcChanged)
+//              If dictionaryIndex is the dictionary's size, a new entry follows: varint id,
+//                uint8_t (ide | direction << 1 | type << 2), uint8_t busChannel, uint8_t errorType, uint8_t dlc
+//              Else if dlcChanged, uint8_t dlc
+//     payload: min (dlc, 8) bytes XOR-ed with the previous payload of the entry (zeros initially). None for remote frames.
+//
+//   All fixed-size values are little-endian. Varints use 7 bits per byte, least significant first, the MSB indicating
+//   another byte follows.
+//
+// Usage:
+//   mdfCanBusArchiveReader_t reader;
+//   mdfCanBusArchiveReaderInit (&reader, "session_3.zca");
+//   mdfCanBusRecord_t records [256];
+//   size_t count;
+//   while (mdfCanBusArchiveReaderRead (&reader, records, 256, &count) == 0 && count != 0)
+//     ... records [0 to count - 1], of split reader.splitNumber ...
+//   mdfCanBusArchiveReaderClose (&reader);
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "mdf_can_bus_reader.h"
+
+// C Standard Library
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The maximum number of records in a block.
+#define MDF_CAN_BUS_ARCHIVE_BLOCK_SIZE		65536
+
+/// @brief The maximum number of payload bytes stored per record. Matches the data bytes of an MDF CAN bus log's records.
+#define MDF_CAN_BUS_ARCHIVE_PAYLOAD_SIZE	8
+
+/// @brief The default deflate compression level of an archive. Higher levels gain little on CAN traffic, at several times
+/// the cost.
+#define MDF_CAN_BUS_ARCHIVE_LEVEL_DEFAULT	6
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief An entry of a block's frame header dictionary.
+typedef struct
+{
+	uint32_t id;
+	bool ide;
+	bool direction;
+	mdfCanBusRecordType_t type;
+	uint8_t busChannel;
+	uint8_t errorType;
+
+	/// @brief The DLC of the entry's last record.
+	uint8_t dlc;
+
+	/// @brief The payload of the entry's last record.
+	uint8_t payload [MDF_CAN_BUS_ARCHIVE_PAYLOAD_SIZE];
+} mdfCanBusArchiveEntry_t;
+
+typedef struct
+{
+	/// @brief The number of the session being archived.
+	uint32_t sessionNumber;
+
+	/// @brief The start of the session, in nanoseconds since the Unix epoch.
+	uint64_t startTimeNs;
+
+	/// @brief The deflate compression level, from 1 (fastest) to 9 (smallest). Use 0 for the default
+	/// (@c MDF_CAN_BUS_ARCHIVE_LEVEL_DEFAULT ).
+	int level;
+} mdfCanBusArchiveConfig_t;
+
+/// @brief Writer of a CAN bus archive. See @c mdfCanBusArchiveWriterInit .
+typedef struct
+{
+	FILE* file;
+	int level;
+
+	/// @brief The split the records of the current block belong to.
+	uint32_t splitNumber;
+
+	/// @brief The number of records in the current block.
+	size_t recordCount;
+
+	/// @brief The timestamp preceding the current block, along with that of the last record, in nanoseconds.
+	uint64_t firstTimestampNs;
+	uint64_t lastTimestampNs;
+
+	/// @brief The streams of the current block.
+	uint8_t* time;
+	size_t timeSize;
+	uint8_t* tag;
+	size_t tagSize;
+	uint8_t* payload;
+	size_t payloadSize;
+
+	/// @brief Buffer for the deflated streams.
+	uint8_t* deflated;
+	size_t deflatedCapacity;
+
+	/// @brief The current block's dictionary.
+	mdfCanBusArchiveEntry_t* entries;
+	size_t entryCount;
+
+	/// @brief Open-addressing hash table of the dictionary's indices, plus one (0 indicates an empty slot).
+	uint32_t* table;
+
+	/// @brief The number of blocks written.
+	size_t blockCount;
+
+	/// @brief The number of bytes written to the file.
+	uint64_t size;
+} mdfCanBusArchiveWriter_t;
+
+/// @brief Reader of a CAN bus archive. See @c mdfCanBusArchiveReaderInit .
+typedef struct
+{
+	FILE* file;
+
+	/// @brief The number of the archived session.
+	uint32_t sessionNumber;
+
+	/// @brief The start of the archived session, in nanoseconds since the Unix epoch.
+	uint64_t startTimeNs;
+
+	/// @brief The split the records of the current block belong to.
+	uint32_t splitNumber;
+
+	/// @brief The decoded records of the current block, along with their payloads.
+	mdfCanBusRecord_t* records;
+	uint8_t (*payloads) [MDF_CAN_BUS_ARCHIVE_PAYLOAD_SIZE];
+	size_t recordCount;
+
+	/// @brief The index of the next record of the current block to read.
+	size_t recordIndex;
+
+	/// @brief Buffers for the deflated and inflated streams of the current block.
+	uint8_t* deflated;
+	size_t deflatedCapacity;
+	uint8_t* inflated;
+	size_t inflatedCapacity;
+
+	/// @brief The current block's dictionary.
+	mdfCanBusArchiveEntry_t* entries;
+
+	/// @brief The number of blocks read.
+	size_t blockCount;
+
+	/// @brief Indicates all blocks have been read.
+	bool end;
+} mdfCanBusArchiveReader_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates a CAN bus archive, overwriting any existing file.
+ * @param writer The writer to initialize. Must be closed using @c mdfCanBusArchiveWriterClose if successful.
+ * @param path The path of the archive to create.
+ * @param config The configuration to use.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusArchiveWriterInit (mdfCanBusArchiveWriter_t* writer, const char* path, const mdfCanBusArchiveConfig_t* config);
+
+/**
+ * @brief Starts the records of a new split. Any records of the previous split are written as a block.
+ * @param writer The writer to use.
+ * @param splitNumber The number of the split.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusArchiveWriterSplit (mdfCanBusArchiveWriter_t* writer, uint32_t splitNumber);
+
+/**
+ * @brief Writes a record to an archive. Records are stored in the order they are written, which need not be timestamp order.
+ * @param writer The writer to write to.
+ * @param record The record to write.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusArchiveWriterWrite (mdfCanBusArchiveWriter_t* writer, const mdfCanBusRecord_t* record);
+
+/**
+ * @brief Writes any remaining records, then closes an archive.
+ * @param writer The writer to close.
+ * @return 0 if successful, the error code otherwise. Note the writer is closed regardless.
+ */
+int mdfCanBusArchiveWriterClose (mdfCanBusArchiveWriter_t* writer);
+
+/**
+ * @brief Opens a CAN bus archive for reading.
+ * @param reader The reader to initialize. Must be closed using @c mdfCanBusArchiveReaderClose if successful.
+ * @param path The path of the archive to read.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusArchiveReaderInit (mdfCanBusArchiveReader_t* reader, const char* path);
+
+/**
+ * @brief Reads the next batch of records from an archive, in the order they were written. A batch never spans blocks, so
+ * all of its records belong to the split @c reader->splitNumber .
+ * @param reader The reader to read from.
+ * @param records Buffer to write the records into. Note their payloads reference the reader's memory, so are only valid
+ * until the next call to this function.
+ * @param capacity The number of elements in @c records .
+ * @param count Written to the number of records read. 0 indicates the end of the archive.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusArchiveReaderRead (mdfCanBusArchiveReader_t* reader, mdfCanBusRecord_t* records, size_t capacity,
+	size_t* count);
+
+/**
+ * @brief Closes an archive reader.
+ * @param reader The reader to close.
+ */
+void mdfCanBusArchiveReaderClose (mdfCanBusArchiveReader_t* reader);
+
+#endif // MDF_CAN_BUS_ARCHIVE_H
@@ -0,0 +1,398 @@
+// For asprintf. Note this must be the first include in this file.
+#define _GNU_SOURCE
+#include <stdio.h>
+
+// Header
+#include "mdf_can_bus_index.h"
+
+// POSIX
+#include <sys/stat.h>
+
+// C Standard Library
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The identification string of an index file. Note this string is not null-terminated.
+#define INDEX_FILE_MAGIC {'Z', 'R', 'E', 'M', 'D', 'F', 'I', 'X'}
+
+/// @brief The version of the index file format. Incremented whenever the format changes, invalidating older files.
+#define INDEX_FILE_VERSION 1
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The header of an index file. The entries of the index immediately follow this.
+typedef struct
+{
+	char magic [8];
+	uint32_t version;
+	uint32_t reserved;
+	uint64_t fileSize;
+	uint64_t recordCount;
+	uint64_t firstTimestampNs;
+	uint64_t lastTimestampNs;
+	uint64_t entryCount;
+} indexFileHeader_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+int mdfCanBusIndexBuild (mdfCanBusIndex_t* index, mdfCanBusReader_t* reader)
+{
+	*index = (mdfCanBusIndex_t)
+	{
+		.fileSize = reader->mapSize
+	};
+
+	size_t entryCapacity = 0;
+	mdfCanBusRecord_t* records = malloc (sizeof (mdfCanBusRecord_t) * MDF_CAN_BUS_INDEX_STRIDE);
+	if (records == NULL)
+		return errno;
+
+	// Each batch starts a new entry. Note batches may end early at the end of a data block.
+	while (true)
+	{
+		mdfCanBusReaderPosition_t position;
+		mdfCanBusReaderTell (reader, &position);
+
+		size_t count;
+		if (mdfCanBusReaderRead (reader, records, MDF_CAN_BUS_INDEX_STRIDE, &count) != 0)
+		{
+			int code = errno;
+			free (records);
+			mdfCanBusIndexDealloc (index);
+			errno = code;
+			return errno;
+		}
+
+		if (count == 0)
+			break;
+
+		if (index->entryCount == entryCapacity)
+		{
+			entryCapacity = entryCapacity != 0 ? entryCapacity * 2 : 64;
+			mdfCanBusIndexEntry_t* entries = realloc (index->entries, sizeof (mdfCanBusIndexEntry_t) * entryCapacity);
+			if (entries == NULL)
+			{
+				int code = errno;
+				free (records);
+				mdfCanBusIndexDealloc (index);
+				errno = code;
+				return errno;
+			}
+			index->entries = entries;
+		}
+
+		index->entries [index->entryCount] = (mdfCanBusIndexEntry_t)
+		{
+			.timestampNs	= records [0].timestampNs,
+			.position		= position
+		};
+		++index->entryCount;
+
+		if (index->recordCount == 0)
+			index->firstTimestampNs = records [0].timestampNs;
+		index->lastTimestampNs = records [count - 1].timestampNs;
+		index->recordCount += count;
+	}
+
+	free (records);
+	return 0;
+}
+
+/**
+ * @brief Reads the cached index of a split.
+ * @param index The index to read into.
+ * @param path The path of the split.
+ * @param fileSize The current size of the split, in bytes.
+ * @return 0 if successful, the error code otherwise. Fails if the cached index does not exist or is not valid.
+ */
+static int readIndex (mdfCanBusIndex_t* index, const char* path, uint64_t fileSize)
+{
+	char* indexPath;
+	if (asprintf (&indexPath, "%s.idx", path) < 0)
+		return errno;
+
+	FILE* file = fopen (indexPath, "rb");
+	free (indexPath);
+	if (file == NULL)
+		return errno;
+
+	indexFileHeader_t header;
+	char magic [] = INDEX_FILE_MAGIC;
+	if (fread (&header, sizeof (header), 1, file) != 1 || memcmp (header.magic, magic, sizeof (magic)) != 0 ||
+		header.version != INDEX_FILE_VERSION || header.fileSize != fileSize)
+	{
+		fclose (file);
+		errno = EINVAL;
+		return errno;
+	}
+
+	*index = (mdfCanBusIndex_t)
+	{
+		.fileSize			= header.fileSize,
+		.recordCount		= header.recordCount,
+		.firstTimestampNs	= header.firstTimestampNs,
+		.lastTimestampNs	= header.lastTimestampNs,
+		.entries			= malloc (sizeof (mdfCanBusIndexEntry_t) * header.entryCount),
+		.entryCount			= header.entryCount
+	};
+
+	if (header.entryCount != 0 && (index->entries == NULL ||
+		fread (index->entries, sizeof (mdfCanBusIndexEntry_t), header.entryCount, file) != header.entryCount))
+	{
+		free (index->entries);
+		fclose (file);
+		errno = EINVAL;
+		return errno;
+	}
+
+	fclose (file);
+	return 0;
+}
+
+int mdfCanBusIndexLoad (mdfCanBusIndex_t* index, const char* path)
+{
+	struct stat splitStat;
+	if (stat (path, &splitStat) != 0)
+		return errno;
+
+	if (readIndex (index, path, splitStat.st_size) == 0)
+		return 0;
+
+	// No valid cached index, build it from scratch.
+	mdfCanBusReader_t reader;
+	if (mdfCanBusReaderInit (&reader, path) != 0)
+		return errno;
+
+	int code = mdfCanBusIndexBuild (index, &reader);
+	bool finalized = reader.finalized;
+	mdfCanBusReaderClose (&reader);
+	if (code != 0)
+	{
+		errno = code;
+		return errno;
+	}
+
+	// Unfinalized splits may still be growing, so their index is not worth caching. Failing to cache the index is not an
+	// error, the split may be on read-only storage.
+	if (finalized)
+		mdfCanBusIndexWrite (index, path);
+
+	return 0;
+}
+
+int mdfCanBusIndexWrite (const mdfCanBusIndex_t* index, const char* path)
+{
+	char* indexPath;
+	if (asprintf (&indexPath, "%s.idx", path) < 0)
+		return errno;
+
+	FILE* file = fopen (indexPath, "wb");
+	if (file == NULL)
+	{
+		int code = errno;
+		free (indexPath);
+		errno = code;
+		return errno;
+	}
+
+	indexFileHeader_t header =
+	{
+		.magic				= INDEX_FILE_MAGIC,
+		.version			= INDEX_FILE_VERSION,
+		.fileSize			= index->fileSize,
+		.recordCount		= index->recordCount,
+		.firstTimestampNs	= index->firstTimestampNs,
+		.lastTimestampNs	= index->lastTimestampNs,
+		.entryCount			= index->entryCount
+	};
+
+	if (fwrite (&header, sizeof (header), 1, file) != 1 ||
+		fwrite (index->entries, sizeof (mdfCanBusIndexEntry_t), index->entryCount, file) != index->entryCount)
+	{
+		int code = errno;
+		fclose (file);
+		remove (indexPath);
+		free (indexPath);
+		errno = code;
+		return errno;
+	}
+
+	// Don't leave a partially-written index behind.
+	if (fclose (file) != 0)
+	{
+		int code = errno;
+		remove (indexPath);
+		free (indexPath);
+		errno = code;
+		return errno;
+	}
+
+	free (indexPath);
+	return 0;
+}
+
+void mdfCanBusIndexDealloc (mdfCanBusIndex_t* index)
+{
+	free (index->entries);
+	index->entries = NULL;
+	index->entryCount = 0;
+}
+
+int mdfCanBusIndexSeek (const mdfCanBusIndex_t* index, mdfCanBusReader_t* reader, uint64_t timeNs)
+{
+	// Find the last entry strictly before the time. Records equal to the time may precede an entry of the same timestamp.
+	size_t low = 0;
+	size_t high = index->entryCount;
+	while (low < high)
+	{
+		size_t middle = low + (high - low) / 2;
+		if (index->entries [middle].timestampNs < timeNs)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	// If no entry precedes the time, start from the beginning of the split.
+	mdfCanBusReaderPosition_t position = { 0 };
+	if (low != 0)
+		position = index->entries [low - 1].position;
+
+	return mdfCanBusReaderSeek (reader, &position, timeNs);
+}
+
+void mdfCanBusRangeReaderInit (mdfCanBusRangeReader_t* reader, const char* directory, uint64_t startNs, uint64_t endNs)
+{
+	*reader = (mdfCanBusRangeReader_t)
+	{
+		.directory		= directory,
+		.startNs		= startNs,
+		.endNs			= endNs,
+		.splitNumber	= 0,
+		.open			= false,
+		.done			= startNs > endNs
+	};
+}
+
+/**
+ * @brief Opens the next split of a range reader overlapping the range.
+ * @param reader The range reader to open for.
+ * @return 0 if successful, the error code otherwise. If no more splits overlap the range, @c reader->done is set.
+ */
+static int openSplit (mdfCanBusRangeReader_t* reader)
+{
+	while (true)
+	{
+		char* path;
+		if (asprintf (&path, "%s/split_%"PRIu32".mf4", reader->directory, reader->splitNumber) < 0)
+			return errno;
+
+		// The session ends at the first missing split.
+		struct stat splitStat;
+		if (stat (path, &splitStat) != 0)
+		{
+			free (path);
+			if (errno != ENOENT)
+				return errno;
+
+			reader->done = true;
+			return 0;
+		}
+
+		mdfCanBusIndex_t index;
+		if (mdfCanBusIndexLoad (&index, path) != 0)
+		{
+			int code = errno;
+			free (path);
+			errno = code;
+			return errno;
+		}
+		++reader->splitNumber;
+
+		// Skip splits ending before the range. As splits are in time order, stop at the first split starting after it.
+		if (index.recordCount == 0 || index.lastTimestampNs < reader->startNs)
+		{
+			mdfCanBusIndexDealloc (&index);
+			free (path);
+			continue;
+		}
+
+		if (index.firstTimestampNs > reader->endNs)
+		{
+			mdfCanBusIndexDealloc (&index);
+			free (path);
+			reader->done = true;
+			return 0;
+		}
+
+		int code = mdfCanBusReaderInit (&reader->reader, path);
+		free (path);
+		if (code == 0)
+		{
+			code = mdfCanBusIndexSeek (&index, &reader->reader, reader->startNs);
+			if (code != 0)
+				mdfCanBusReaderClose (&reader->reader);
+		}
+
+		mdfCanBusIndexDealloc (&index);
+		if (code != 0)
+		{
+			errno = code;
+			return errno;
+		}
+
+		reader->open = true;
+		return 0;
+	}
+}
+
+int mdfCanBusRangeReaderRead (mdfCanBusRangeReader_t* reader, mdfCanBusRecord_t* records, size_t capacity, size_t* count)
+{
+	*count = 0;
+
+	while (!reader->done)
+	{
+		if (!reader->open && openSplit (reader) != 0)
+			return errno;
+
+		if (reader->done)
+			return 0;
+
+		if (mdfCanBusReaderRead (&reader->reader, records, capacity, count) != 0)
+			return errno;
+
+		// Move onto the next split once this one is exhausted.
+		if (*count == 0)
+		{
+			mdfCanBusReaderClose (&reader->reader);
+			reader->open = false;
+			continue;
+		}
+
+		// Stop at the first record after the range. Note the split is left open, as the records reference its memory.
+		for (size_t index = 0; index < *count; ++index)
+		{
+			if (records [index].timestampNs > reader->endNs)
+			{
+				*count = index;
+				reader->done = true;
+				break;
+			}
+		}
+
+		return 0;
+	}
+
+	return 0;
+}
+
+void mdfCanBusRangeReaderClose (mdfCanBusRangeReader_t* reader)
+{
+	if (reader->open)
+		mdfCanBusReaderClose (&reader->reader);
+
+	reader->open = false;
+}
@@ -0,0 +1,159 @@
+#ifndef MDF_CAN_BUS_INDEX_H
+#define MDF_CAN_BUS_INDEX_H
+
+// MDF CAN Bus Index ----------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: Sparse time index of MDF CAN bus log splits, used to seek to a point in time without reading everything
+//   before it. An index maps the timestamp of every few thousand records to their position in the split. Indices are built
+//   lazily, the first time a split is indexed, and cached beside the split ('split_0.mf4.idx'). A cached index is rebuilt if
+//   the size of its split changes (ex. a split that was still being written, or has since been recovered).
+//
+//   On top of this, a range reader extracts the records of a time range from all splits of a session. Splits outside of the
+//   range are skipped entirely, and only the data blocks containing the range are read from the rest.
+//
+//   Note records are assumed to be stored in timestamp order, as written by the MDF CAN bus logging module. Timestamps are
+//   relative to the start of the session, which is shared by all of its splits.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "mdf_can_bus_reader.h"
+
+// C Standard Library
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The (maximum) number of records between consecutive index entries.
+#define MDF_CAN_BUS_INDEX_STRIDE 4096
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief An entry of a time index.
+typedef struct
+{
+	/// @brief The timestamp of the record at this entry's position, in nanoseconds.
+	uint64_t timestampNs;
+
+	/// @brief The position of the record in the split.
+	mdfCanBusReaderPosition_t position;
+} mdfCanBusIndexEntry_t;
+
+/// @brief The time index of a log split.
+typedef struct
+{
+	/// @brief The size of the split when it was indexed, in bytes.
+	uint64_t fileSize;
+
+	/// @brief The number of records in the split.
+	uint64_t recordCount;
+
+	/// @brief The timestamp of the first record of the split, in nanoseconds. Only valid if @c recordCount is not 0.
+	uint64_t firstTimestampNs;
+
+	/// @brief The timestamp of the last record of the split, in nanoseconds. Only valid if @c recordCount is not 0.
+	uint64_t lastTimestampNs;
+
+	/// @brief The entries of the index, in timestamp order.
+	mdfCanBusIndexEntry_t* entries;
+	size_t entryCount;
+} mdfCanBusIndex_t;
+
+/// @brief Reader extracting the records of a time range from a log session. See @c mdfCanBusRangeReaderInit .
+typedef struct
+{
+	/// @brief The directory of the session.
+	const char* directory;
+
+	/// @brief The start of the range, inclusive, in nanoseconds.
+	uint64_t startNs;
+
+	/// @brief The end of the range, inclusive, in nanoseconds.
+	uint64_t endNs;
+
+	/// @brief The number of the split currently being read, or to be read next.
+	uint32_t splitNumber;
+
+	/// @brief Indicates @c reader is open.
+	bool open;
+
+	/// @brief Indicates the end of the range has been reached.
+	bool done;
+
+	/// @brief The reader of the current split.
+	mdfCanBusReader_t reader;
+} mdfCanBusRangeReader_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds the time index of a split by reading all of its records.
+ * @param index The index to build. Must be deallocated using @c mdfCanBusIndexDealloc .
+ * @param reader The reader of the split. Read from the start to the end of the split.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusIndexBuild (mdfCanBusIndex_t* index, mdfCanBusReader_t* reader);
+
+/**
+ * @brief Loads the time index of a split. If the split has a valid cached index, it is read, otherwise the index is built,
+ * then cached (so long as the split is finalized).
+ * @param index The index to load. Must be deallocated using @c mdfCanBusIndexDealloc .
+ * @param path The path of the split.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusIndexLoad (mdfCanBusIndex_t* index, const char* path);
+
+/**
+ * @brief Writes the time index of a split to its cache file.
+ * @param index The index to write.
+ * @param path The path of the split (not the cache file).
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusIndexWrite (const mdfCanBusIndex_t* index, const char* path);
+
+/**
+ * @brief Deallocates the memory owned by an index.
+ * @param index The index to deallocate.
+ */
+void mdfCanBusIndexDealloc (mdfCanBusIndex_t* index);
+
+/**
+ * @brief Moves a reader to the first record at or after a point in time.
+ * @param index The index of the reader's split.
+ * @param reader The reader to move.
+ * @param timeNs The point in time to move to, in nanoseconds.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusIndexSeek (const mdfCanBusIndex_t* index, mdfCanBusReader_t* reader, uint64_t timeNs);
+
+/**
+ * @brief Initializes a reader extracting the records of a time range from a log session.
+ * @param reader The reader to initialize. Must be closed using @c mdfCanBusRangeReaderClose .
+ * @param directory The directory of the session (ex. 'logs/session_3'). Note this is referenced, not copied.
+ * @param startNs The start of the range, inclusive, in nanoseconds.
+ * @param endNs The end of the range, inclusive, in nanoseconds.
+ */
+void mdfCanBusRangeReaderInit (mdfCanBusRangeReader_t* reader, const char* directory, uint64_t startNs, uint64_t endNs);
+
+/**
+ * @brief Reads the next batch of records of the range. See @c mdfCanBusReaderRead for details.
+ * @param reader The reader to read from.
+ * @param records Buffer to write the records into.
+ * @param capacity The number of elements in @c records .
+ * @param count Written to the number of records read. 0 indicates the end of the range.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusRangeReaderRead (mdfCanBusRangeReader_t* reader, mdfCanBusRecord_t* records, size_t capacity, size_t* count);
+
+/**
+ * @brief Closes a range reader.
+ * @param reader The reader to close.
+ */
+void mdfCanBusRangeReaderClose (mdfCanBusRangeReader_t* reader);
+
+#endif // MDF_CAN_BUS_INDEX_H
@@ -7,8 +7,11 @@
 
 // Includes
 #include "debug.h"
+#include "error_codes.h"
+#include "mdf_reader.h"
 #include "mdf_writer.h"
 #include "misc_port.h"
+#include "time_port.h"
 
 // POSIX
 #include <dirent.h>
@@ -38,6 +41,11 @@ long long int diff_timespec (const struct timespec* a, const struct timespec* b)
 /// just that none of the CSS devices exceed 52428814 bytes. Chose 800 bytes less here just to be safe.
 #define SPLIT_SIZE_MAX							52428000
 
+/// @brief The size of the records (including record ID) of each channel group, in bytes.
+#define DATA_FRAME_RECORD_SIZE					(BIT_LENGTH_TO_BYTE_LENGTH (DATA_FRAME_BIT_LENGTH + DATA_FRAME_TIMESTAMP_BIT_LENGTH) + 1)
+#define REMOTE_FRAME_RECORD_SIZE				(BIT_LENGTH_TO_BYTE_LENGTH (REMOTE_FRAME_BIT_LENGTH + REMOTE_FRAME_TIMESTAMP_BIT_LENGTH) + 1)
+#define ERROR_FRAME_RECORD_SIZE					(BIT_LENGTH_TO_BYTE_LENGTH (ERROR_FRAME_BIT_LENGTH + ERROR_FRAME_TIMESTAMP_BIT_LENGTH) + 1)
+
 // Conversions from can_device error code to MDF bus logging error type
 #define ERROR_TYPE_BIT_ERROR					1
 #define ERROR_TYPE_BIT_STUFF_ERROR				3
@@ -1093,80 +1101,190 @@ static FILE* createDestinationFile (const char* parentDirectory, uint32_t sessio
 	// Create the file path based on the parent directory, session number, and split number.
 	// - Note: The split name is deallocate when the file is closed.
 	if (asprintf (splitName, "%s/session_%"PRIu32"/split_%"PRIu32".mf4", parentDirectory, sessionNumber, splitNumber) < 0)
+	{
+		*splitName = NULL;
 		return NULL;
+	}
 
 	// Attempt to create the file
 	debugPrintf ("Creating destination file '%s'.\n", *splitName);
 	return fopen (*splitName, "w");
 }
 
+/**
+ * @brief Opens the decoded signal file of the current split, if signals are logged. The signals are derived from the bus log,
+ * so failure is not an error, the split is simply logged without them.
+ * @param log The log to open the signal file of.
+ */
+static void openSignalLog (mdfCanBusLog_t* log)
+{
+	if (log->signalLog == NULL)
+		return;
+
+	char* path;
+	if (asprintf (&path, "%s/session_%"PRIu32"/signals_%"PRIu32".mf4", log->config->directory, log->config->sessionNumber,
+		log->splitNumber) < 0)
+	{
+		debugPrintf ("Warning, failed to create MDF signal file: %s.\n", errorCodeToMessage (errno));
+		return;
+	}
+
+	debugPrintf ("Creating signal file '%s'.\n", path);
+	if (mdfSignalLogOpen (log->signalLog, path, (uint64_t) log->dateStart * TIMESTAMP_SCALE_FACTOR) != 0)
+		debugPrintf ("Warning, failed to create MDF signal file '%s': %s.\n", path, errorCodeToMessage (errno));
+
+	free (path);
+}
+
+/**
+ * @brief Closes the decoded signal file of the current split, if one is open.
+ * @param log The log to close the signal file of.
+ */
+static void closeSignalLog (mdfCanBusLog_t* log)
+{
+	if (log->signalLog == NULL || log->signalLog->mdf == NULL)
+		return;
+
+	if (mdfSignalLogClose (log->signalLog) != 0)
+		debugPrintf ("Warning, failed to close MDF signal file: %s.\n", errorCodeToMessage (errno));
+}
+
+/**
+ * @brief Aborts the creation of a split, removing the partially written file. The split number is restored, so the next
+ * attempt to create the split does not leave a gap in the session.
+ * @param log The log the split belongs to.
+ * @param splitNumber The number of the split being created.
+ * @param hd The split's header block, if allocated, @c NULL otherwise.
+ * @param dg The split's data group block, if allocated, @c NULL otherwise.
+ * @return The error code that caused the failure, as read from @c errno .
+ */
+static int abortSplit (mdfCanBusLog_t* log, uint32_t splitNumber, mdfBlock_t* hd, mdfBlock_t* dg)
+{
+	int code = errno;
+
+	if (dg != NULL)
+	{
+		mdfBlockDealloc (dg);
+		free (dg);
+	}
+
+	if (hd != NULL)
+	{
+		mdfBlockDealloc (hd);
+		free (hd);
+	}
+
+	if (log->mdf != NULL)
+	{
+		fclose (log->mdf);
+		log->mdf = NULL;
+		remove (log->splitName);
+	}
+
+	free (log->splitName);
+	log->splitName = NULL;
+	log->splitNumber = splitNumber - 1;
+
+	errno = code;
+	return code;
+}
+
 static int createSplit (mdfCanBusLog_t* log, uint32_t splitNumber)
 {
 	log->splitNumber = splitNumber;
 
+	if (log->catalog != NULL)
+		mdfCatalogBuilderReset (log->catalog, log->config->sessionNumber, splitNumber,
+			(uint64_t) log->dateStart * TIMESTAMP_SCALE_FACTOR);
+
 	// Create the destination file within said directory.
 	log->mdf = createDestinationFile (log->config->directory, log->config->sessionNumber, log->splitNumber, &log->splitName);
 	if (log->mdf == NULL)
-		return errno;
+		return abortSplit (log, splitNumber, NULL, NULL);
 
 	mdfBlock_t* hd = writeHeader (log->mdf, "ZREMDF", log->dateStart);
 	if (hd == NULL)
-		return errno;
+		return abortSplit (log, splitNumber, NULL, NULL);
 
 	uint64_t acquisitionSourceAddr = writeAcquisitionSource (log->mdf, log->config->softwareVersion,
 		log->config->hardwareVersion, log->config->serialNumber, log->config->channel1Baudrate,
 		log->config->channel2Baudrate);
 	if (acquisitionSourceAddr == 0)
-		return errno;
+		return abortSplit (log, splitNumber, hd, NULL);
 
 	uint64_t timestampCcAddr = writeTimestampCc (log->mdf);
 	if (timestampCcAddr == 0)
-		return errno;
+		return abortSplit (log, splitNumber, hd, NULL);
 
 	uint64_t errorFrameCg = writeErrorFrameCg (log->mdf, 0, acquisitionSourceAddr, timestampCcAddr);
 	if (errorFrameCg == 0)
-		return errno;
+		return abortSplit (log, splitNumber, hd, NULL);
 
 	uint64_t remoteFrameCgAddr = writeRemoteFrameCg (log->mdf, errorFrameCg, acquisitionSourceAddr, timestampCcAddr);
 	if (remoteFrameCgAddr == 0)
-		return errno;
+		return abortSplit (log, splitNumber, hd, NULL);
 
 	uint64_t dataFrameCgAddr = writeDataFrameCg (log->mdf, remoteFrameCgAddr, acquisitionSourceAddr, timestampCcAddr);
 	if (dataFrameCgAddr == 0)
-		return errno;
+		return abortSplit (log, splitNumber, hd, NULL);
+
+	// Store the channel group addresses, their cycle counts are written when the split is finalized.
+	log->cgAddrs [DATA_FRAME_RECORD_ID - 1] = dataFrameCgAddr;
+	log->cgAddrs [REMOTE_FRAME_RECORD_ID - 1] = remoteFrameCgAddr;
+	log->cgAddrs [ERROR_FRAME_RECORD_ID - 1] = errorFrameCg;
+	for (size_t index = 0; index < MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT; ++index)
+		log->cycleCounts [index] = 0;
 
 	uint64_t fileHistoryAddr = writeFileHistory (log->mdf, log->dateStart, log->config->softwareName,
 		log->config->softwareVersion, log->config->softwareVendor);
 	if (fileHistoryAddr == 0)
-		return errno;
+		return abortSplit (log, splitNumber, hd, NULL);
 
 	uint64_t commentAddr = writeComment (log->mdf, log->config->configurationName, log->config->softwareVersion,
 		log->config->hardwareVersion, log->config->serialNumber, log->config->hardwareName, log->config->storageSize,
 		log->config->storageRemaining, log->config->sessionNumber, log->splitNumber);
 	if (commentAddr == 0)
-		return errno;
+		return abortSplit (log, splitNumber, hd, NULL);
 
 	mdfBlock_t* dg = writeDg (log->mdf, dataFrameCgAddr);
 	if (dg == NULL)
-		return errno;
+		return abortSplit (log, splitNumber, hd, NULL);
 
 	// Rewrite Link Lists -----------------------------------------------------------------------------------------------------
 
-	uint64_t dtAddr = mdfDtBlockWrite (log->mdf);
-	if (dtAddr == 0)
-		return errno;
+	log->dgAddr = dg->addr;
+	if (log->compressed)
+	{
+		// Compressed data blocks are written as the records are, so link the data group to the first of them. Once the split is
+		// finalized, this is replaced by a data list block. Note blocks are aligned to 8 bytes.
+		long addr = ftell (log->mdf);
+		if (addr < 0)
+			return abortSplit (log, splitNumber, hd, dg);
+
+		log->dtAddr = 0;
+		log->dzCount = 0;
+		log->dataLength = 0;
+		mdfDgBlockLinkList (dg)->dataBlockAddr = (addr + 7) & ~7l;
+	}
+	else
+	{
+		uint64_t dtAddr = mdfDtBlockWrite (log->mdf);
+		if (dtAddr == 0)
+			return abortSplit (log, splitNumber, hd, dg);
 
-	mdfDgBlockLinkList (dg)->dataBlockAddr = dtAddr;
+		log->dtAddr = dtAddr;
+		mdfDgBlockLinkList (dg)->dataBlockAddr = dtAddr;
+	}
 
 	if (mdfRewriteBlockLinkList (log->mdf, dg) != 0)
-		return errno;
+		return abortSplit (log, splitNumber, hd, dg);
 
 	mdfHdBlockLinkList (hd)->firstFhAddr = fileHistoryAddr;
 	mdfHdBlockLinkList (hd)->commentAddr = commentAddr;
 	mdfHdBlockLinkList (hd)->firstDgAddr = dg->addr;
 
 	if (mdfRewriteBlockLinkList (log->mdf, hd) != 0)
-		return errno;
+		return abortSplit (log, splitNumber, hd, dg);
 
 	mdfBlockDealloc (dg);
 	mdfBlockDealloc (hd);
@@ -1177,42 +1295,553 @@ static int createSplit (mdfCanBusLog_t* log, uint32_t splitNumber)
 	// Get header size
 	long splitSize = ftell (log->mdf);
 	if (splitSize < 0)
-		return errno;
+		return abortSplit (log, splitNumber, NULL, NULL);
 
 	log->splitSize = (size_t) splitSize;
+	log->splitSizeSynced = log->splitSize;
+	clock_gettime (CLOCK_MONOTONIC, &log->timeLastSync);
+
+	// Only report the split once its header is written, so a split that failed to be created is never reported.
+	if (log->config->splitCallback != NULL)
+		log->config->splitCallback (log->config->sessionNumber, log->splitNumber, false, log->config->splitArg);
+
+	// Reserve the storage of the entire split up-front, so it is allocated contiguously rather than record by record. This is
+	// only an optimization, so failure (ex. unsupported filesystem) is not an error.
+	if (fallocatePort (log->mdf, SPLIT_SIZE_MAX) != 0)
+		debugPrintf ("Warning, failed to preallocate MDF split: %s.\n", errorCodeToMessage (errno));
+
+	openSignalLog (log);
+	return 0;
+}
+
+/**
+ * @brief Finalizes the current split, once all of its records have been written. Everything past the split's size is
+ * discarded.
+ * @param log The log to finalize the split of.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int finalizeSplit (mdfCanBusLog_t* log)
+{
+	if (log->compressed)
+	{
+		// Write the list of compressed data blocks to the end of the split, then link the data group to it.
+		uint64_t dataBlockAddr = 0;
+		if (log->dzCount != 0)
+		{
+			if (fseek (log->mdf, log->splitSize, SEEK_SET) != 0)
+				return errno;
+
+			dataBlockAddr = mdfDlBlockWrite (log->mdf, log->dzAddrs, log->dzOffsets, log->dzCount);
+			if (dataBlockAddr == 0)
+				return errno;
+
+			long splitSize = ftell (log->mdf);
+			if (splitSize < 0)
+				return errno;
+			log->splitSize = (size_t) splitSize;
+		}
+
+		if (mdfRewriteDgBlockDataAddr (log->mdf, log->dgAddr, dataBlockAddr) != 0)
+			return errno;
+	}
+	else
+	{
+		// Now that all the records are written, patch the length of the data block.
+		if (mdfRewriteDtBlockLength (log->mdf, log->dtAddr, log->splitSize - log->dtAddr) != 0)
+			return errno;
+	}
+
+	for (size_t index = 0; index < MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT; ++index)
+		if (mdfRewriteCgBlockCycleCount (log->mdf, log->cgAddrs [index], log->cycleCounts [index]) != 0)
+			return errno;
+
+	if (mdfFinalizeFileIdBlock (log->mdf) != 0)
+		return errno;
+
+	// Release the preallocated storage past the end of the records.
+	if (ftruncatePort (log->mdf, log->splitSize) != 0)
+		return errno;
 
 	return 0;
 }
 
-static void closeSplit (mdfCanBusLog_t* log)
+static int closeSplit (mdfCanBusLog_t* log)
 {
+	int code = finalizeSplit (log);
+	if (code != 0)
+		debugPrintf ("Warning, failed to finalize MDF split '%s': %s.\n", log->splitName, errorCodeToMessage (code));
+
+	// Summarize the split in the catalog. This is only an index, so failure is not an error, the split can be cataloged later.
+	const mdfCatalogEntry_t* entry;
+	if (code == 0 && log->catalog != NULL && (mdfCatalogBuilderComplete (log->catalog, log->splitSize, &entry) != 0 ||
+		mdfCatalogAppend (log->config->directory, entry) != 0))
+		debugPrintf ("Warning, failed to catalog MDF split '%s': %s.\n", log->splitName, errorCodeToMessage (errno));
+
+	closeSignalLog (log);
+
 	// Attempt to synchronize any pending I/O operations. This is to prevent data loss in the DART project.
 	fsyncPort (log->mdf);
 
 	free (log->splitName);
-	fclose (log->mdf);
+	log->splitName = NULL;
+	if (fclose (log->mdf) != 0 && code == 0)
+		code = errno;
+	log->mdf = NULL;
+
+	if (log->config->splitCallback != NULL)
+		log->config->splitCallback (log->config->sessionNumber, log->splitNumber, true, log->config->splitArg);
+
+	errno = code;
+	return code;
+}
+
+size_t mdfCanBusLogGetRecordSize (uint8_t recordId)
+{
+	switch (recordId)
+	{
+	case DATA_FRAME_RECORD_ID:
+		return DATA_FRAME_RECORD_SIZE;
+	case REMOTE_FRAME_RECORD_ID:
+		return REMOTE_FRAME_RECORD_SIZE;
+	case ERROR_FRAME_RECORD_ID:
+		return ERROR_FRAME_RECORD_SIZE;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Adds encoded records to the current split's catalog entry and signal file, if the log has either.
+ * @param log The log the records are written to.
+ * @param data The encoded records.
+ * @param size The size of @c data , in bytes.
+ */
+static void decodeRecords (mdfCanBusLog_t* log, const uint8_t* data, size_t size)
+{
+	bool signalLogOpen = log->signalLog != NULL && log->signalLog->mdf != NULL;
+	if (log->catalog == NULL && !signalLogOpen)
+		return;
+
+	// Note all record types share the same layout, up to the data bytes.
+	for (size_t offset = 0; offset < size; offset += mdfCanBusLogGetRecordSize (data [offset]))
+	{
+		const uint8_t* record = data + offset;
+
+		uint64_t timestampNs = 0;
+		for (size_t index = 0; index < BIT_LENGTH_TO_BYTE_LENGTH (DATA_FRAME_TIMESTAMP_BIT_LENGTH); ++index)
+			timestampNs |= (uint64_t) record [index + DATA_FRAME_TIMESTAMP_BYTE_OFFSET + 1] << (index * 8);
+
+		uint32_t id = 0;
+		for (size_t index = 0; index < BIT_LENGTH_TO_BYTE_LENGTH (DATA_FRAME_ID_BIT_LENGTH); ++index)
+			id |= (uint32_t) record [index + DATA_FRAME_ID_BYTE_OFFSET + 1] << (index * 8);
+
+		mdfCanBusRecord_t decoded =
+		{
+			.type			= record [0] == ERROR_FRAME_RECORD_ID ? MDF_CAN_BUS_RECORD_ERROR_FRAME :
+				record [0] == REMOTE_FRAME_RECORD_ID ? MDF_CAN_BUS_RECORD_REMOTE_FRAME : MDF_CAN_BUS_RECORD_DATA_FRAME,
+			.timestampNs	= timestampNs,
+			.id				= id & BIT_LENGTH_TO_BIT_MASK (DATA_FRAME_ID_BIT_LENGTH),
+			.ide			= (record [DATA_FRAME_IDE_BYTE_OFFSET + 1] >> DATA_FRAME_IDE_BIT_OFFSET) &
+				BIT_LENGTH_TO_BIT_MASK (DATA_FRAME_IDE_BIT_LENGTH),
+			.dlc			= (record [DATA_FRAME_DLC_BYTE_OFFSET + 1] >> DATA_FRAME_DLC_BIT_OFFSET) &
+				BIT_LENGTH_TO_BIT_MASK (DATA_FRAME_DLC_BIT_LENGTH),
+			.busChannel		= (record [DATA_FRAME_BUS_CHANNEL_BYTE_OFFSET + 1] >> DATA_FRAME_BUS_CHANNEL_BIT_OFFSET) &
+				BIT_LENGTH_TO_BIT_MASK (DATA_FRAME_BUS_CHANNEL_BIT_LENGTH),
+			.direction		= (record [DATA_FRAME_DIR_BYTE_OFFSET + 1] >> DATA_FRAME_DIR_BIT_OFFSET) &
+				BIT_LENGTH_TO_BIT_MASK (DATA_FRAME_DIR_BIT_LENGTH),
+			.errorType		= record [0] != ERROR_FRAME_RECORD_ID ? 0 :
+				(record [ERROR_FRAME_ERROR_TYPE_BYTE_OFFSET + 1] >> ERROR_FRAME_ERROR_TYPE_BIT_OFFSET) &
+				BIT_LENGTH_TO_BIT_MASK (ERROR_FRAME_ERROR_TYPE_BIT_LENGTH),
+			.data			= record + DATA_FRAME_DATA_BYTES_BYTE_OFFSET + 1
+		};
+
+		if (log->catalog != NULL && mdfCatalogBuilderAddRecord (log->catalog, &decoded) != 0)
+		{
+			debugPrintf ("Warning, failed to catalog MDF record: %s.\n", errorCodeToMessage (errno));
+			return;
+		}
+
+		// If the signal file cannot be written (ex. storage is full), stop writing it for the remainder of the split.
+		if (signalLogOpen && mdfSignalLogAddRecord (log->signalLog, &decoded) != 0)
+		{
+			debugPrintf ("Warning, failed to write MDF signal record: %s.\n", errorCodeToMessage (errno));
+			closeSignalLog (log);
+			signalLogOpen = false;
+		}
+	}
+}
+
+/**
+ * @brief Appends a compressed data block to the current split's list of them.
+ * @param log The log to append to.
+ * @param addr The address of the block.
+ * @param offset The offset of the block's data, within the split's uncompressed data.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int appendDataBlock (mdfCanBusLog_t* log, uint64_t addr, uint64_t offset)
+{
+	if (log->dzCount == log->dzCapacity)
+	{
+		size_t capacity = log->dzCapacity != 0 ? log->dzCapacity * 2 : 64;
+
+		uint64_t* dzAddrs = realloc (log->dzAddrs, sizeof (uint64_t) * capacity);
+		if (dzAddrs == NULL)
+			return errno;
+		log->dzAddrs = dzAddrs;
+
+		uint64_t* dzOffsets = realloc (log->dzOffsets, sizeof (uint64_t) * capacity);
+		if (dzOffsets == NULL)
+			return errno;
+		log->dzOffsets = dzOffsets;
+
+		log->dzCapacity = capacity;
+	}
+
+	log->dzAddrs [log->dzCount] = addr;
+	log->dzOffsets [log->dzCount] = offset;
+	++log->dzCount;
+	return 0;
+}
+
+/**
+ * @brief Gets the number of columns to transpose a buffer of records into before compressing it. If every record is of the
+ * same type, the records are transposed, placing each byte of the records next to the same byte of the neighbouring records,
+ * which compresses far better.
+ * @param buffer The buffer to check.
+ * @return The size of the records, if all are the same type, 0 otherwise.
+ */
+static uint32_t getBufferColumns (const mdfCanBusLogBuffer_t* buffer)
+{
+	uint32_t columns = 0;
+	for (size_t index = 0; index < MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT; ++index)
+		if (buffer->cycleCounts [index] == buffer->recordCount)
+			columns = mdfCanBusLogGetRecordSize (index + 1);
+	return columns;
 }
 
-static int writeRecord (mdfCanBusLog_t* log, uint8_t* record, size_t recordSize)
+/**
+ * @brief Writes a buffer of records as a single compressed data block.
+ * @param log The log to write to.
+ * @param buffer The buffer to write.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int writeCompressedBuffer (mdfCanBusLog_t* log, const mdfCanBusLogBuffer_t* buffer)
 {
-	if (log->splitSize + recordSize > SPLIT_SIZE_MAX)
+	mdfBlock_t block;
+	if (mdfDzBlockInit (&block, buffer->data, buffer->size, getBufferColumns (buffer)) != 0)
+		return errno;
+
+	// The maximum split size applies to the compressed size, including the block's alignment and its entry in the data list.
+	size_t blockSize = block.header.blockLength + 7 + 2 * sizeof (uint64_t);
+	size_t listSize = sizeof (block.header) + sizeof (uint64_t) + sizeof (mdfDlDataSection_t) +
+		2 * sizeof (uint64_t) * log->dzCount;
+	if (log->dzCount != 0 && log->splitSize + listSize + blockSize > SPLIT_SIZE_MAX)
 	{
 		debugPrintf ("MDF split size exceeds maximum. Splitting log... ");
-		closeSplit (log);
+		if (closeSplit (log) != 0)
+			debugPrintf ("Warning, failed to close MDF split: %s.\n", errorCodeToMessage (errno));
 		if (createSplit (log, log->splitNumber + 1) != 0)
+		{
+			mdfBlockDealloc (&block);
 			return errno;
+		}
 		debugPrintf ("Success.\n");
 	}
 
-	if (fwrite (record, 1, recordSize, log->mdf) != recordSize)
+	uint64_t addr = mdfBlockWrite (log->mdf, &block);
+	mdfBlockDealloc (&block);
+	if (addr == 0 || appendDataBlock (log, addr, log->dataLength) != 0)
+		return errno;
+	decodeRecords (log, buffer->data, buffer->size);
+
+	long splitSize = ftell (log->mdf);
+	if (splitSize < 0)
+		return errno;
+
+	log->splitSize = (size_t) splitSize;
+	log->dataLength += buffer->size;
+	for (size_t index = 0; index < MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT; ++index)
+		log->cycleCounts [index] += buffer->cycleCounts [index];
+
+	return fflush (log->mdf) == 0 ? 0 : errno;
+}
+
+static int writeBuffer (mdfCanBusLog_t* log, const mdfCanBusLogBuffer_t* buffer)
+{
+	// If the previous split was ended by mdfCanBusLogSplit, start the next one.
+	if (log->mdf == NULL && createSplit (log, log->splitNumber + 1) != 0)
+		return errno;
+
+	if (log->compressed)
+		return writeCompressedBuffer (log, buffer);
+
+	// Fast path, the entire buffer fits into the current split.
+	if (log->splitSize + buffer->size <= SPLIT_SIZE_MAX)
+	{
+		if (fwrite (buffer->data, 1, buffer->size, log->mdf) != buffer->size)
+			return errno;
+		decodeRecords (log, buffer->data, buffer->size);
+
+		log->splitSize += buffer->size;
+		for (size_t index = 0; index < MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT; ++index)
+			log->cycleCounts [index] += buffer->cycleCounts [index];
+
+		return fflush (log->mdf) == 0 ? 0 : errno;
+	}
+
+	// Otherwise, walk the records to find the split boundary, writing each contiguous run of records as a whole.
+	size_t runStart = 0;
+	size_t runSize = 0;
+	for (size_t offset = 0; offset < buffer->size;)
+	{
+		size_t recordSize = mdfCanBusLogGetRecordSize (buffer->data [offset]);
+		if (recordSize == 0)
+		{
+			errno = EINVAL;
+			return errno;
+		}
+
+		if (log->splitSize + runSize + recordSize > SPLIT_SIZE_MAX)
+		{
+			if (fwrite (buffer->data + runStart, 1, runSize, log->mdf) != runSize)
+				return errno;
+			decodeRecords (log, buffer->data + runStart, runSize);
+			log->splitSize += runSize;
+
+			debugPrintf ("MDF split size exceeds maximum. Splitting log... ");
+			if (closeSplit (log) != 0)
+				debugPrintf ("Warning, failed to close MDF split: %s.\n", errorCodeToMessage (errno));
+			if (createSplit (log, log->splitNumber + 1) != 0)
+				return errno;
+			debugPrintf ("Success.\n");
+
+			runStart = offset;
+			runSize = 0;
+		}
+
+		++log->cycleCounts [buffer->data [offset] - 1];
+		runSize += recordSize;
+		offset += recordSize;
+	}
+
+	if (fwrite (buffer->data + runStart, 1, runSize, log->mdf) != runSize)
+		return errno;
+	decodeRecords (log, buffer->data + runStart, runSize);
+
+	log->splitSize += runSize;
+	return fflush (log->mdf) == 0 ? 0 : errno;
+}
+
+/**
+ * @brief Synchronizes the current split to the storage device, if it is due.
+ * @param log The log to synchronize.
+ * @param syncInterval The maximum amount of time between synchronizations.
+ * @param syncSize The maximum number of bytes between synchronizations.
+ * @param syncTimeNs Written to the amount of time the synchronization took, in nanoseconds. Left unmodified if no
+ * synchronization was performed.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int syncSplit (mdfCanBusLog_t* log, const struct timespec* syncInterval, size_t syncSize, long long* syncTimeNs)
+{
+	// Note closing a split synchronizes it.
+	if (log->mdf == NULL || log->splitSize == log->splitSizeSynced)
+		return 0;
+
+	struct timespec timeCurrent;
+	clock_gettime (CLOCK_MONOTONIC, &timeCurrent);
+
+	struct timespec timeElapsed = timespecSub (&timeCurrent, &log->timeLastSync);
+	if (log->splitSize - log->splitSizeSynced < syncSize && timespecCompare (&timeElapsed, syncInterval, <))
+		return 0;
+
+	if (fsyncPort (log->mdf) != 0)
+		return errno;
+
+	struct timespec timeSynced;
+	clock_gettime (CLOCK_MONOTONIC, &timeSynced);
+	struct timespec syncTime = timespecSub (&timeSynced, &timeCurrent);
+	*syncTimeNs = timespecToNs (&syncTime);
+
+	log->splitSizeSynced = log->splitSize;
+	log->timeLastSync = timeSynced;
+	return 0;
+}
+
+static void* writerThread (void* arg)
+{
+	mdfCanBusLog_t* log = arg;
+
+	struct timespec flushInterval =
+	{
+		.tv_sec		= log->config->flushIntervalMs / 1000,
+		.tv_nsec	= (log->config->flushIntervalMs % 1000) * 1000000
+	};
+	if (log->config->flushIntervalMs == 0)
+		flushInterval = (struct timespec) { .tv_nsec = MDF_CAN_BUS_LOG_FLUSH_INTERVAL_DEFAULT * 1000000 };
+
+	unsigned long syncIntervalMs = log->config->syncIntervalMs != 0 ? log->config->syncIntervalMs :
+		MDF_CAN_BUS_LOG_SYNC_INTERVAL_DEFAULT;
+	struct timespec syncInterval =
+	{
+		.tv_sec		= syncIntervalMs / 1000,
+		.tv_nsec	= (syncIntervalMs % 1000) * 1000000
+	};
+	size_t syncSize = log->config->syncSize != 0 ? log->config->syncSize : MDF_CAN_BUS_LOG_SYNC_SIZE_DEFAULT;
+
+	pthread_mutex_lock (&log->mutex);
+	while (true)
+	{
+		// Wait for the fill buffer to reach half capacity, the flush interval to elapse, the split to end, or the log to close.
+		if (!log->closing && !log->fill->splitAfter && log->fill->size < log->bufferSize / 2)
+		{
+			struct timespec deadline;
+			clock_gettime (CLOCK_REALTIME, &deadline);
+			deadline = timespecAdd (&deadline, &flushInterval);
+			pthread_cond_timedwait (&log->condition, &log->mutex, &deadline);
+		}
+
+		if (log->fill->size == 0 && !log->fill->splitAfter && log->closing)
+			break;
+
+		// Swap the buffers, producers may continue appending while the full buffer is written. If there is nothing to write,
+		// the pass is still performed, as previously written records may be due for synchronization.
+		mdfCanBusLogBuffer_t* buffer = NULL;
+		if (log->fill->size != 0 || log->fill->splitAfter)
+		{
+			buffer = log->fill;
+			log->fill = (buffer == &log->buffers [0]) ? &log->buffers [1] : &log->buffers [0];
+		}
+		int writerError = log->writerError;
+		pthread_mutex_unlock (&log->mutex);
+
+		// Once the writer has failed, the log file is in an unknown state, so all further records are discarded.
+		int code = writerError;
+		if (code == 0 && buffer != NULL && buffer->size != 0)
+			code = writeBuffer (log, buffer);
+
+		// End the split if requested, unless it has no records. The next split is only created once there are records to
+		// write into it.
+		if (code == 0 && buffer != NULL && buffer->splitAfter && log->mdf != NULL)
+		{
+			size_t recordCount = 0;
+			for (size_t index = 0; index < MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT; ++index)
+				recordCount += log->cycleCounts [index];
+
+			if (recordCount != 0)
+			{
+				debugPrintf ("Ending MDF split '%s'.\n", log->splitName);
+				code = closeSplit (log);
+			}
+		}
+
+		// Group-commit the written records, if enough time has passed or enough data has accumulated since the last sync.
+		long long syncTimeNs = -1;
+		int syncCode = 0;
+		if (code == 0)
+			syncCode = syncSplit (log, &syncInterval, syncSize, &syncTimeNs);
+
+		pthread_mutex_lock (&log->mutex);
+		if (buffer != NULL)
+		{
+			log->stats.queueDepth -= buffer->recordCount;
+			if (code == 0)
+				log->stats.writtenCount += buffer->recordCount;
+			else
+				log->stats.droppedCount += buffer->recordCount;
+
+			buffer->size = 0;
+			buffer->recordCount = 0;
+			buffer->splitAfter = false;
+			for (size_t index = 0; index < MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT; ++index)
+				buffer->cycleCounts [index] = 0;
+		}
+
+		// If the records could not be synchronized, their durability is unknown, so this is treated as a write failure.
+		if (code == 0)
+			code = syncCode;
+		if (code != 0)
+			log->writerError = code;
+
+		if (syncTimeNs >= 0)
+		{
+			++log->stats.syncCount;
+			if (syncTimeNs > log->stats.syncTimeMaxNs)
+				log->stats.syncTimeMaxNs = syncTimeNs;
+		}
+	}
+	pthread_mutex_unlock (&log->mutex);
+
+	return NULL;
+}
+
+static int writeRecord (mdfCanBusLog_t* log, const uint8_t* record, size_t recordSize)
+{
+	pthread_mutex_lock (&log->mutex);
+
+	// Report a failure of the writer to the caller, the record cannot be written.
+	if (log->writerError != 0)
+	{
+		++log->stats.droppedCount;
+		errno = log->writerError;
+		pthread_mutex_unlock (&log->mutex);
+		return errno;
+	}
+
+	// If both buffers are full, the record must be dropped.
+	mdfCanBusLogBuffer_t* buffer = log->fill;
+	if (buffer->size + recordSize > log->bufferSize)
+	{
+		++log->stats.droppedCount;
+		pthread_cond_signal (&log->condition);
+		pthread_mutex_unlock (&log->mutex);
+		errno = ERRNO_MDF_LOG_OVERFLOW;
 		return errno;
+	}
 
-	log->splitSize += recordSize;
-	debugPrintf ("Log size: %lu bytes.\n", (unsigned long) log->splitSize);
+	memcpy (buffer->data + buffer->size, record, recordSize);
+	buffer->size += recordSize;
+	++buffer->recordCount;
+	++buffer->cycleCounts [record [0] - 1];
 
+	++log->stats.queueDepth;
+	if (log->stats.queueDepth > log->stats.queueHighWaterMark)
+		log->stats.queueHighWaterMark = log->stats.queueDepth;
+
+	// Wake the writer once the buffer is half full, leaving the remaining half to absorb records while it wakes.
+	if (buffer->size >= log->bufferSize / 2)
+		pthread_cond_signal (&log->condition);
+
+	pthread_mutex_unlock (&log->mutex);
 	return 0;
 }
 
+static void deallocBuffers (mdfCanBusLog_t* log)
+{
+	free (log->buffers [0].data);
+	free (log->buffers [1].data);
+}
+
+static void deallocCatalog (mdfCanBusLog_t* log)
+{
+	if (log->catalog == NULL)
+		return;
+
+	mdfCatalogBuilderDealloc (log->catalog);
+	free (log->catalog);
+	log->catalog = NULL;
+}
+
+static void deallocSignalLog (mdfCanBusLog_t* log)
+{
+	if (log->signalLog == NULL)
+		return;
+
+	closeSignalLog (log);
+	mdfSignalLogDealloc (log->signalLog);
+	free (log->signalLog);
+	log->signalLog = NULL;
+}
+
 uint32_t mdfCanBusLogFindSessionNumber (const char* directory)
 {
 	debugPrintf ("Searching for MDF session number...\n");
@@ -1255,32 +1884,138 @@ uint32_t mdfCanBusLogFindSessionNumber (const char* directory)
 int mdfCanBusLogInit (mdfCanBusLog_t* log, const mdfCanBusLogConfig_t* config)
 {
 	log->config = config;
+	log->compressed = config->compress;
+	log->dzAddrs = NULL;
+	log->dzOffsets = NULL;
+	log->dzCapacity = 0;
+	log->catalog = NULL;
+	log->signalLog = NULL;
 
 	// Get the date and time of the log file.
-	log->dateStart = time (NULL);
+	log->dateStart = config->dateStart != 0 ? config->dateStart : time (NULL);
 	clock_gettime (CLOCK_MONOTONIC, &log->timeStart);
 
 	// Create the destination directory.
 	if (createDestinationDirectory (config->directory, config->sessionNumber) != 0)
 		return errno;
 
+	if (config->catalog)
+	{
+		log->catalog = malloc (sizeof (mdfCatalogBuilder_t));
+		if (log->catalog == NULL)
+			return errno;
+
+		if (mdfCatalogBuilderInit (log->catalog, config->catalogSignalNames, config->catalogSignalCount,
+			config->catalogCallback, config->catalogArg) != 0)
+		{
+			int code = errno;
+			free (log->catalog);
+			errno = code;
+			return errno;
+		}
+	}
+
+	if (config->signalLog)
+	{
+		log->signalLog = malloc (sizeof (mdfSignalLog_t));
+		if (log->signalLog == NULL)
+		{
+			int code = errno;
+			deallocCatalog (log);
+			errno = code;
+			return errno;
+		}
+
+		if (mdfSignalLogInit (log->signalLog, config->signalLogGroups, config->signalLogGroupCount,
+			config->signalLogCallback, config->signalLogArg) != 0)
+		{
+			int code = errno;
+			free (log->signalLog);
+			log->signalLog = NULL;
+			deallocCatalog (log);
+			errno = code;
+			return errno;
+		}
+	}
+
 	if (createSplit (log, 0) != 0)
+	{
+		int code = errno;
+		deallocSignalLog (log);
+		deallocCatalog (log);
+		errno = code;
 		return errno;
+	}
 
 	debugPrintf ("Initial MDF split size: %lu bytes.\n", (long unsigned) log->splitSize);
-	return 0;
-}
 
-const char* mdfCanBusLogGetName (mdfCanBusLog_t* log)
-{
-	return log->splitName;
-}
+	// Allocate the write buffers.
+	log->bufferSize = config->bufferSize != 0 ? config->bufferSize : MDF_CAN_BUS_LOG_BUFFER_SIZE_DEFAULT;
+	for (size_t index = 0; index < 2; ++index)
+	{
+		log->buffers [index] = (mdfCanBusLogBuffer_t)
+		{
+			.data			= malloc (log->bufferSize),
+			.size			= 0,
+			.recordCount	= 0,
+			.cycleCounts	= {0},
+			.splitAfter		= false
+		};
+	}
+	if (log->buffers [0].data == NULL || log->buffers [1].data == NULL)
+	{
+		int code = errno;
+		deallocBuffers (log);
+		deallocSignalLog (log);
+		deallocCatalog (log);
+		closeSplit (log);
+		errno = code;
+		return errno;
+	}
 
-int mdfCanBusLogWriteDataFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_t busChannel, bool direction, struct timespec* timestamp)
-{
-	uint8_t record [BIT_LENGTH_TO_BYTE_LENGTH (DATA_FRAME_BIT_LENGTH + DATA_FRAME_TIMESTAMP_BIT_LENGTH) + 1] = {0};
+	log->fill = &log->buffers [0];
+	log->closing = false;
+	log->writerError = 0;
+	log->stats = (mdfCanBusLogStats_t) {0};
 
-	// Record ID
+	pthread_mutex_init (&log->mutex, NULL);
+	pthread_cond_init (&log->condition, NULL);
+
+	// Start the writer thread.
+	int code = pthread_create (&log->writerThread, NULL, writerThread, log);
+	if (code != 0)
+	{
+		pthread_cond_destroy (&log->condition);
+		pthread_mutex_destroy (&log->mutex);
+		deallocBuffers (log);
+		deallocSignalLog (log);
+		deallocCatalog (log);
+		closeSplit (log);
+		errno = code;
+		return errno;
+	}
+
+	return 0;
+}
+
+void mdfCanBusLogGetStats (mdfCanBusLog_t* log, mdfCanBusLogStats_t* stats)
+{
+	pthread_mutex_lock (&log->mutex);
+	*stats = log->stats;
+	pthread_mutex_unlock (&log->mutex);
+}
+
+const char* mdfCanBusLogGetName (mdfCanBusLog_t* log)
+{
+	return log->splitName;
+}
+
+size_t mdfCanBusLogEncodeDataFrame (mdfCanBusLog_t* log, uint8_t* record, canFrame_t* frame, uint8_t busChannel, bool direction,
+	struct timespec* timestamp)
+{
+	memset (record, 0, DATA_FRAME_RECORD_SIZE);
+
+	// Record ID
 	record [0] = DATA_FRAME_RECORD_ID;
 
 	// Timestamp
@@ -1311,16 +2046,13 @@ int mdfCanBusLogWriteDataFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_t
 	for (size_t index = 0; index < frame->dlc; ++index)
 		record [DATA_FRAME_DATA_BYTES_BYTE_OFFSET + index + 1] |= frame->data [index];
 
-	// Write the record to the file.
-	if (writeRecord (log, record, sizeof (record)) != 0)
-		return errno;
-
-	return 0;
+	return DATA_FRAME_RECORD_SIZE;
 }
 
-int mdfCanBusLogWriteRemoteFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_t busChannel, bool direction, struct timespec* timestamp)
+size_t mdfCanBusLogEncodeRemoteFrame (mdfCanBusLog_t* log, uint8_t* record, canFrame_t* frame, uint8_t busChannel, bool direction,
+	struct timespec* timestamp)
 {
-	uint8_t record [BIT_LENGTH_TO_BYTE_LENGTH (REMOTE_FRAME_BIT_LENGTH + REMOTE_FRAME_TIMESTAMP_BIT_LENGTH) + 1] = {0};
+	memset (record, 0, REMOTE_FRAME_RECORD_SIZE);
 
 	// Record ID
 	record [0] = REMOTE_FRAME_RECORD_ID;
@@ -1353,16 +2085,13 @@ int mdfCanBusLogWriteRemoteFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_
 	for (size_t index = 0; index < frame->dlc; ++index)
 		record [REMOTE_FRAME_DATA_BYTES_BYTE_OFFSET + index + 1] |= frame->data [index];
 
-	// Write the record to the file.
-	if (writeRecord (log, record, sizeof (record)) != 0)
-		return errno;
-
-	return 0;
+	return REMOTE_FRAME_RECORD_SIZE;
 }
 
-int mdfCanBusLogWriteErrorFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_t busChannel, bool direction, int errorCode, struct timespec* timestamp)
+size_t mdfCanBusLogEncodeErrorFrame (mdfCanBusLog_t* log, uint8_t* record, canFrame_t* frame, uint8_t busChannel,
+	bool direction, int errorCode, struct timespec* timestamp)
 {
-	uint8_t record [BIT_LENGTH_TO_BYTE_LENGTH (ERROR_FRAME_BIT_LENGTH + ERROR_FRAME_TIMESTAMP_BIT_LENGTH) + 1] = {0};
+	memset (record, 0, ERROR_FRAME_RECORD_SIZE);
 
 	// Record ID
 	record [0] = ERROR_FRAME_RECORD_ID;
@@ -1430,20 +2159,838 @@ int mdfCanBusLogWriteErrorFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_t
 	record [ERROR_FRAME_ERROR_TYPE_BYTE_OFFSET + 1] |=
 		(errorType & BIT_LENGTH_TO_BIT_MASK (ERROR_FRAME_ERROR_TYPE_BIT_LENGTH)) << ERROR_FRAME_ERROR_TYPE_BIT_OFFSET;
 
-	// Write the record to the file.
-	if (writeRecord (log, record, sizeof (record)) != 0)
+	return ERROR_FRAME_RECORD_SIZE;
+}
+
+// Batch Encoding -------------------------------------------------------------------------------------------------------------
+
+// The batch encoder packs each data / RTR frame record into two 64-bit words and a 32-bit word, rather than assembling it byte
+// by byte:
+//   Word 0 (bytes 0 to 7):   Record ID, timestamp (48 bits), low byte of the ID field.
+//   Word 1 (bytes 8 to 15):  High 3 bytes of the ID field, DLC / DIR byte, data bytes 0 to 3.
+//   Word 2 (bytes 16 to 19): Data bytes 4 to 7.
+// Where the ID field is the 32-bit word holding the CAN ID, IDE bit and bus channel. This relies on the data and RTR frame
+// records sharing the layout below.
+
+_Static_assert (DATA_FRAME_RECORD_SIZE == MDF_CAN_BUS_LOG_FRAME_RECORD_SIZE &&
+	REMOTE_FRAME_RECORD_SIZE == MDF_CAN_BUS_LOG_FRAME_RECORD_SIZE, "Frame record size mismatch.");
+
+_Static_assert (DATA_FRAME_TIMESTAMP_BYTE_OFFSET == 0 && DATA_FRAME_TIMESTAMP_BIT_LENGTH == 48 &&
+	DATA_FRAME_ID_BYTE_OFFSET == 6 && DATA_FRAME_DLC_BYTE_OFFSET == 10 && DATA_FRAME_DIR_BYTE_OFFSET == 10 &&
+	DATA_FRAME_DATA_BYTES_BYTE_OFFSET == 11, "Batch encoder does not match the data frame record layout.");
+
+_Static_assert (REMOTE_FRAME_ID_BYTE_OFFSET == DATA_FRAME_ID_BYTE_OFFSET &&
+	REMOTE_FRAME_IDE_BIT_OFFSET == DATA_FRAME_IDE_BIT_OFFSET &&
+	REMOTE_FRAME_BUS_CHANNEL_BIT_OFFSET == DATA_FRAME_BUS_CHANNEL_BIT_OFFSET &&
+	REMOTE_FRAME_DLC_BIT_OFFSET == DATA_FRAME_DLC_BIT_OFFSET && REMOTE_FRAME_DIR_BIT_OFFSET == DATA_FRAME_DIR_BIT_OFFSET &&
+	REMOTE_FRAME_DATA_BYTES_BYTE_OFFSET == DATA_FRAME_DATA_BYTES_BYTE_OFFSET,
+	"Batch encoder requires the RTR frame record layout to match the data frame record layout.");
+
+/// @brief The positions of the IDE bit and bus channel within the ID field.
+#define ID_FIELD_IDE_SHIFT			((DATA_FRAME_IDE_BYTE_OFFSET - DATA_FRAME_ID_BYTE_OFFSET) * 8 + DATA_FRAME_IDE_BIT_OFFSET)
+#define ID_FIELD_BUS_CHANNEL_SHIFT	((DATA_FRAME_BUS_CHANNEL_BYTE_OFFSET - DATA_FRAME_ID_BYTE_OFFSET) * 8 +					\
+	DATA_FRAME_BUS_CHANNEL_BIT_OFFSET)
+
+/// @brief Mask of the timestamp's bits.
+#define TIMESTAMP_MASK				((UINT64_C (1) << DATA_FRAME_TIMESTAMP_BIT_LENGTH) - 1)
+
+static inline void storeLe64 (uint8_t* data, uint64_t value)
+{
+	#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	memcpy (data, &value, sizeof (value));
+	#else // __BYTE_ORDER__
+	for (size_t index = 0; index < sizeof (value); ++index)
+		data [index] = value >> (index * 8);
+	#endif // __BYTE_ORDER__
+}
+
+static inline void storeLe32 (uint8_t* data, uint32_t value)
+{
+	#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	memcpy (data, &value, sizeof (value));
+	#else // __BYTE_ORDER__
+	for (size_t index = 0; index < sizeof (value); ++index)
+		data [index] = value >> (index * 8);
+	#endif // __BYTE_ORDER__
+}
+
+static inline uint64_t loadLe64 (const uint8_t* data)
+{
+	uint64_t value = 0;
+	#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	memcpy (&value, data, sizeof (value));
+	#else // __BYTE_ORDER__
+	for (size_t index = 0; index < sizeof (value); ++index)
+		value |= (uint64_t) data [index] << (index * 8);
+	#endif // __BYTE_ORDER__
+	return value;
+}
+
+/**
+ * @brief Encodes a batch of data and RTR frames, see @c mdfCanBusLogEncodeFrames .
+ * @param remoteCount Written to the number of RTR frame records encoded.
+ * @return The total size of the records, in bytes.
+ */
+static size_t encodeFrames (mdfCanBusLog_t* log, uint8_t* records, const canFrame_t* frames, const struct timespec* timestamps,
+	size_t count, uint8_t busChannel, bool direction, size_t* remoteCount)
+{
+	// The bus channel and direction are common to the batch, so are only packed once.
+	uint32_t idFieldTemplate = (uint32_t) (busChannel & BIT_LENGTH_TO_BIT_MASK (DATA_FRAME_BUS_CHANNEL_BIT_LENGTH)) <<
+		ID_FIELD_BUS_CHANNEL_SHIFT;
+	uint64_t dlcTemplate = (uint64_t) direction << DATA_FRAME_DIR_BIT_OFFSET;
+
+	*remoteCount = 0;
+	for (size_t index = 0; index < count; ++index)
+	{
+		const canFrame_t* frame = &frames [index];
+		uint8_t* record = records + index * MDF_CAN_BUS_LOG_FRAME_RECORD_SIZE;
+
+		uint64_t recordId = DATA_FRAME_RECORD_ID;
+		if (frame->rtr)
+		{
+			recordId = REMOTE_FRAME_RECORD_ID;
+			++*remoteCount;
+		}
+
+		uint64_t timestamp = (uint64_t) ((timestamps [index].tv_sec - log->timeStart.tv_sec) * 1000000000LL +
+			timestamps [index].tv_nsec - log->timeStart.tv_nsec) & TIMESTAMP_MASK;
+
+		uint32_t idField = idFieldTemplate | (frame->id & BIT_LENGTH_TO_BIT_MASK (DATA_FRAME_ID_BIT_LENGTH)) |
+			(uint32_t) frame->ide << ID_FIELD_IDE_SHIFT;
+
+		uint64_t dlc = dlcTemplate | (frame->dlc & BIT_LENGTH_TO_BIT_MASK (DATA_FRAME_DLC_BIT_LENGTH)) <<
+			DATA_FRAME_DLC_BIT_OFFSET;
+
+		// Bytes past the DLC are zeroed, as the per-record encoders leave them.
+		uint64_t payload = loadLe64 (frame->data);
+		if (frame->dlc < sizeof (frame->data))
+			payload &= (UINT64_C (1) << (frame->dlc * 8)) - 1;
+
+		storeLe64 (record, recordId | timestamp << 8 | (uint64_t) idField << 56);
+		storeLe64 (record + 8, idField >> 8 | dlc << 24 | payload << 32);
+		storeLe32 (record + 16, payload >> 32);
+	}
+
+	return count * MDF_CAN_BUS_LOG_FRAME_RECORD_SIZE;
+}
+
+size_t mdfCanBusLogEncodeFrames (mdfCanBusLog_t* log, uint8_t* records, const canFrame_t* frames,
+	const struct timespec* timestamps, size_t count, uint8_t busChannel, bool direction)
+{
+	size_t remoteCount;
+	return encodeFrames (log, records, frames, timestamps, count, busChannel, direction, &remoteCount);
+}
+
+int mdfCanBusLogGetErrorCode (uint8_t errorType)
+{
+	switch (errorType)
+	{
+	case ERROR_TYPE_BIT_ERROR:
+		return ERRNO_CAN_DEVICE_BIT_ERROR;
+
+	case ERROR_TYPE_BIT_STUFF_ERROR:
+		return ERRNO_CAN_DEVICE_BIT_STUFF_ERROR;
+
+	case ERROR_TYPE_FORM_ERROR:
+		return ERRNO_CAN_DEVICE_FORM_ERROR;
+
+	case ERROR_TYPE_ACK_ERROR:
+		return ERRNO_CAN_DEVICE_ACK_ERROR;
+
+	case ERROR_TYPE_CRC_ERROR:
+		return ERRNO_CAN_DEVICE_CRC_ERROR;
+
+	case ERROR_TYPE_BUS_OFF:
+		return ERRNO_CAN_DEVICE_BUS_OFF;
+
+	case ERROR_TYPE_UNSPEC_ERROR:
+	default:
+		return ERRNO_CAN_DEVICE_UNSPEC_ERROR;
+	}
+}
+
+int mdfCanBusLogWriteRecord (mdfCanBusLog_t* log, const uint8_t* record, size_t recordSize)
+{
+	// The writer relies on the record ID to determine the record's size and channel group, so it must be valid.
+	if (recordSize == 0 || mdfCanBusLogGetRecordSize (record [0]) != recordSize)
+	{
+		errno = EINVAL;
 		return errno;
+	}
 
-	return 0;
+	return writeRecord (log, record, recordSize);
+}
+
+int mdfCanBusLogWriteDataFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_t busChannel, bool direction, struct timespec* timestamp)
+{
+	uint8_t record [DATA_FRAME_RECORD_SIZE];
+	size_t recordSize = mdfCanBusLogEncodeDataFrame (log, record, frame, busChannel, direction, timestamp);
+	return writeRecord (log, record, recordSize);
+}
+
+int mdfCanBusLogWriteRemoteFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_t busChannel, bool direction, struct timespec* timestamp)
+{
+	uint8_t record [REMOTE_FRAME_RECORD_SIZE];
+	size_t recordSize = mdfCanBusLogEncodeRemoteFrame (log, record, frame, busChannel, direction, timestamp);
+	return writeRecord (log, record, recordSize);
+}
+
+int mdfCanBusLogWriteErrorFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_t busChannel, bool direction, int errorCode, struct timespec* timestamp)
+{
+	uint8_t record [ERROR_FRAME_RECORD_SIZE];
+	size_t recordSize = mdfCanBusLogEncodeErrorFrame (log, record, frame, busChannel, direction, errorCode, timestamp);
+	return writeRecord (log, record, recordSize);
+}
+
+int mdfCanBusLogWriteFrames (mdfCanBusLog_t* log, const canFrame_t* frames, const struct timespec* timestamps, size_t count,
+	uint8_t busChannel, bool direction)
+{
+	pthread_mutex_lock (&log->mutex);
+
+	// Report a failure of the writer to the caller, the records cannot be written.
+	if (log->writerError != 0)
+	{
+		log->stats.droppedCount += count;
+		errno = log->writerError;
+		pthread_mutex_unlock (&log->mutex);
+		return errno;
+	}
+
+	// Encode the records directly into the fill buffer, rather than copying them in. Only as many records as fit are written,
+	// the remainder are dropped.
+	mdfCanBusLogBuffer_t* buffer = log->fill;
+	size_t writeCount = (log->bufferSize - buffer->size) / MDF_CAN_BUS_LOG_FRAME_RECORD_SIZE;
+	if (writeCount > count)
+		writeCount = count;
+
+	size_t remoteCount;
+	buffer->size += encodeFrames (log, buffer->data + buffer->size, frames, timestamps, writeCount, busChannel, direction,
+		&remoteCount);
+	buffer->recordCount += writeCount;
+	buffer->cycleCounts [DATA_FRAME_RECORD_ID - 1] += writeCount - remoteCount;
+	buffer->cycleCounts [REMOTE_FRAME_RECORD_ID - 1] += remoteCount;
+
+	log->stats.queueDepth += writeCount;
+	if (log->stats.queueDepth > log->stats.queueHighWaterMark)
+		log->stats.queueHighWaterMark = log->stats.queueDepth;
+
+	int code = 0;
+	if (writeCount != count)
+	{
+		log->stats.droppedCount += count - writeCount;
+		code = ERRNO_MDF_LOG_OVERFLOW;
+	}
+
+	// Wake the writer once the buffer is half full (or overflowing), same as for individual records.
+	if (code != 0 || buffer->size >= log->bufferSize / 2)
+		pthread_cond_signal (&log->condition);
+
+	pthread_mutex_unlock (&log->mutex);
+
+	errno = code;
+	return code;
+}
+
+int mdfCanBusLogSplit (mdfCanBusLog_t* log)
+{
+	pthread_mutex_lock (&log->mutex);
+
+	// The split ends after the last record of the fill buffer, so wake the writer to write it.
+	log->fill->splitAfter = true;
+	pthread_cond_signal (&log->condition);
+
+	int code = log->writerError;
+	pthread_mutex_unlock (&log->mutex);
+
+	errno = code;
+	return code;
 }
 
 int mdfCanBusLogClose (mdfCanBusLog_t* log)
 {
-	// Attempt to synchronize any pending I/O operations. This is to prevent data loss in the DART project.
-	fsyncPort (log->mdf);
+	// Stop the writer thread, this writes all remaining records.
+	pthread_mutex_lock (&log->mutex);
+	log->closing = true;
+	pthread_cond_signal (&log->condition);
+	pthread_mutex_unlock (&log->mutex);
+	pthread_join (log->writerThread, NULL);
+
+	pthread_cond_destroy (&log->condition);
+	pthread_mutex_destroy (&log->mutex);
+	deallocBuffers (log);
+
+	// If the writer failed to create a new split, there is no file to close.
+	int code = 0;
+	if (log->mdf != NULL)
+		code = closeSplit (log);
+
+	deallocSignalLog (log);
+	deallocCatalog (log);
+	free (log->dzAddrs);
+	free (log->dzOffsets);
+
+	if (code != 0)
+	{
+		errno = code;
+		return errno;
+	}
+
+	if (log->writerError != 0)
+	{
+		errno = log->writerError;
+		return errno;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Reads a block (header, link list, and data section) of a log being recovered.
+ * @param mdf The file to read from.
+ * @param addr The address of the block.
+ * @param blockId The expected ID of the block.
+ * @param block The block to read into. Must be deallocated using @c mdfBlockDealloc if successful.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int readRecoveryBlock (FILE* mdf, uint64_t addr, uint64_t blockId, mdfBlock_t* block)
+{
+	if (fseek (mdf, addr, SEEK_SET) != 0)
+		return errno;
+
+	if (mdfReadBlockHeader (mdf, block) != 0)
+		return errno;
+
+	if (block->header.blockId != blockId)
+	{
+		mdfBlockDealloc (block);
+		errno = ERRNO_MDF_LOG_UNRECOGNIZED;
+		return errno;
+	}
+
+	if (mdfReadBlockLinkList (mdf, block) != 0 || mdfReadBlockDataSection (mdf, block) != 0)
+	{
+		int code = errno;
+		mdfBlockDealloc (block);
+		errno = code;
+		return errno;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Recovers the records of an uncompressed log, that is, the records following its data block.
+ * @param log The state of the log to recover. Updated to reflect the recovered records.
+ * @param dtAddr The address of the data block.
+ * @param recovery The recovery result to update.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int recoverDataBlock (mdfCanBusLog_t* log, uint64_t dtAddr, mdfCanBusLogRecovery_t* recovery)
+{
+	log->compressed = false;
+	log->dtAddr = dtAddr;
+	log->splitSize = dtAddr + sizeof (((mdfBlock_t*) NULL)->header);
+	if (fseek (log->mdf, log->splitSize, SEEK_SET) != 0)
+		return errno;
+
+	// Walk the records until the end of the file, or until a record is incomplete or unrecognized (ex. a torn write),
+	// whichever comes first.
+	uint8_t record [MDF_CAN_BUS_LOG_RECORD_SIZE_MAX];
+	while (fread (record, 1, 1, log->mdf) == 1)
+	{
+		size_t recordSize = mdfCanBusLogGetRecordSize (record [0]);
+		if (recordSize == 0 || fread (record + 1, 1, recordSize - 1, log->mdf) != recordSize - 1)
+			break;
+
+		++log->cycleCounts [record [0] - 1];
+		++recovery->recordCount;
+		log->splitSize += recordSize;
+	}
+
+	if (ferror (log->mdf))
+		return errno;
+
+	return 0;
+}
+
+/**
+ * @brief Recovers the records of a compressed log, that is, its consecutive compressed data blocks.
+ * @param log The state of the log to recover. Updated to reflect the recovered records.
+ * @param dzAddr The address of the first compressed data block.
+ * @param fileSize The size of the file, in bytes.
+ * @param recovery The recovery result to update.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int recoverCompressedDataBlocks (mdfCanBusLog_t* log, uint64_t dzAddr, uint64_t fileSize,
+	mdfCanBusLogRecovery_t* recovery)
+{
+	log->compressed = true;
+	log->splitSize = dzAddr;
+
+	// Walk the blocks until the end of the file, or until a block is incomplete or cannot be decompressed (ex. a torn write),
+	// whichever comes first.
+	while (dzAddr + sizeof (((mdfBlock_t*) NULL)->header) <= fileSize)
+	{
+		// Check the block's header before reading the rest of it, as a torn block's length cannot be trusted.
+		mdfBlock_t block;
+		if (fseek (log->mdf, dzAddr, SEEK_SET) != 0 || fread (&block.header, sizeof (block.header), 1, log->mdf) != 1)
+			return errno;
+
+		if (block.header.blockId != MDF_BLOCK_ID_DZ || block.header.linkCount != 0 ||
+			block.header.blockLength > fileSize - dzAddr)
+			break;
+
+		if (readRecoveryBlock (log->mdf, dzAddr, MDF_BLOCK_ID_DZ, &block) != 0)
+			return errno;
+
+		uint8_t* data;
+		size_t size;
+		int code = mdfDzBlockInflate (&block, &data, &size);
+		uint64_t blockLength = block.header.blockLength;
+		mdfBlockDealloc (&block);
+		if (code != 0)
+			break;
 
-	if (fclose (log->mdf) != 0)
+		// Count the records of the block. Blocks are only written whole, so an incomplete record indicates corruption.
+		uint64_t cycleCounts [MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT] = {0};
+		size_t recordCount = 0;
+		size_t offset = 0;
+		while (offset < size)
+		{
+			size_t recordSize = mdfCanBusLogGetRecordSize (data [offset]);
+			if (recordSize == 0 || offset + recordSize > size)
+				break;
+
+			++cycleCounts [data [offset] - 1];
+			++recordCount;
+			offset += recordSize;
+		}
+		free (data);
+		if (offset != size)
+			break;
+
+		if (appendDataBlock (log, dzAddr, log->dataLength) != 0)
+			return errno;
+
+		for (size_t index = 0; index < MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT; ++index)
+			log->cycleCounts [index] += cycleCounts [index];
+		recovery->recordCount += recordCount;
+		log->dataLength += size;
+		log->splitSize = dzAddr + blockLength;
+
+		// The next block is aligned to 8 bytes.
+		dzAddr = (log->splitSize + 7) & ~(uint64_t) 7;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Reads the layout of a log file, as written by @c createSplit . Checks the file was written by this implementation.
+ * @param mdf The file to read from.
+ * @param dgAddr Written to the address of the data group block.
+ * @param cgAddrs Written to the address of each channel group block, indexed by record ID - 1.
+ * @param dataBlockAddr Written to the address the data group links its data to.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int readSplitLayout (FILE* mdf, uint64_t* dgAddr, uint64_t* cgAddrs, uint64_t* dataBlockAddr)
+{
+	// The header block immediately follows the file ID block. Follow it to the data group.
+	mdfBlock_t block;
+	if (readRecoveryBlock (mdf, sizeof (mdfFileIdBlock_t), MDF_BLOCK_ID_HD, &block) != 0)
+		return errno;
+	*dgAddr = mdfHdBlockLinkList (&block)->firstDgAddr;
+	mdfBlockDealloc (&block);
+
+	if (readRecoveryBlock (mdf, *dgAddr, MDF_BLOCK_ID_DG, &block) != 0)
+		return errno;
+	uint64_t cgAddr = mdfDgBlockLinkList (&block)->firstCgAddr;
+	*dataBlockAddr = mdfDgBlockLinkList (&block)->dataBlockAddr;
+	uint8_t recordIdLength = ((mdfDgDataSection_t*) block.dataSection)->recordIdLength;
+	mdfBlockDealloc (&block);
+
+	if (recordIdLength != 1)
+	{
+		errno = ERRNO_MDF_LOG_UNRECOGNIZED;
+		return errno;
+	}
+
+	// Walk the channel groups, each record type must be present exactly once, with the size this implementation writes.
+	for (size_t index = 0; index < MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT; ++index)
+		cgAddrs [index] = 0;
+	size_t cgCount = 0;
+	while (cgAddr != 0)
+	{
+		if (readRecoveryBlock (mdf, cgAddr, MDF_BLOCK_ID_CG, &block) != 0)
+			return errno;
+		mdfCgDataSection_t* dataSection = block.dataSection;
+		uint32_t recordId = dataSection->recordId;
+		size_t recordSize = dataSection->byteLength + recordIdLength;
+		uint64_t nextCgAddr = mdfCgBlockLinkList (&block)->nextCgAddr;
+		mdfBlockDealloc (&block);
+
+		if (recordId == 0 || recordId > MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT || cgAddrs [recordId - 1] != 0 ||
+			mdfCanBusLogGetRecordSize (recordId) != recordSize)
+		{
+			errno = ERRNO_MDF_LOG_UNRECOGNIZED;
+			return errno;
+		}
+
+		cgAddrs [recordId - 1] = cgAddr;
+		cgAddr = nextCgAddr;
+		++cgCount;
+	}
+
+	if (cgCount != MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT)
+	{
+		errno = ERRNO_MDF_LOG_UNRECOGNIZED;
 		return errno;
+	}
 
 	return 0;
-}
\ No newline at end of file
+}
+
+static int recoverSplit (FILE* mdf, mdfCanBusLogRecovery_t* recovery)
+{
+	if (fseek (mdf, 0, SEEK_END) != 0)
+		return errno;
+
+	long fileSize = ftell (mdf);
+	if (fileSize < 0)
+		return errno;
+	recovery->fileSize = (size_t) fileSize;
+	recovery->recoveredSize = (size_t) fileSize;
+	rewind (mdf);
+
+	// Check the file ID block. Finalized files were closed properly, so there is nothing to recover.
+	mdfFileIdBlock_t fileIdBlock;
+	if (mdfReadFileIdBlock (mdf, &fileIdBlock) != 0)
+		return errno;
+
+	if (memcmp (fileIdBlock.fileIdentification, (char []) MDF_FILE_IDENTIFICATION_FINALIZED,
+		sizeof (fileIdBlock.fileIdentification)) == 0)
+	{
+		recovery->finalized = true;
+		return 0;
+	}
+
+	if (memcmp (fileIdBlock.fileIdentification, (char []) MDF_FILE_IDENTIFICATION_UNFINALIZED,
+		sizeof (fileIdBlock.fileIdentification)) != 0)
+	{
+		errno = ERRNO_MDF_LOG_UNRECOGNIZED;
+		return errno;
+	}
+
+	uint64_t dgAddr;
+	uint64_t cgAddrs [MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT];
+	uint64_t dataBlockAddr;
+	if (readSplitLayout (mdf, &dgAddr, cgAddrs, &dataBlockAddr) != 0)
+		return errno;
+
+	// Recreate the state of the log at the time it was interrupted.
+	mdfCanBusLog_t log =
+	{
+		.mdf	= mdf,
+		.dgAddr	= dgAddr
+	};
+	memcpy (log.cgAddrs, cgAddrs, sizeof (cgAddrs));
+
+	// Check the type of the data block, an uncompressed log has a data block, a compressed log has the first of its
+	// compressed data blocks (if any were written).
+	mdfBlock_t block;
+	uint64_t blockId = 0;
+	if (dataBlockAddr < (uint64_t) fileSize)
+	{
+		if (fseek (mdf, dataBlockAddr, SEEK_SET) != 0 || fread (&blockId, sizeof (blockId), 1, mdf) != 1)
+			return errno;
+	}
+
+	// If the log was interrupted while being finalized, the data group may already link to the data list, in which case the
+	// compressed data blocks start at the list's first.
+	if (blockId == MDF_BLOCK_ID_DL)
+	{
+		if (readRecoveryBlock (mdf, dataBlockAddr, MDF_BLOCK_ID_DL, &block) != 0)
+			return errno;
+		dataBlockAddr = block.header.linkCount > 1 ? mdfDlBlockDataAddr (&block, 0) : (uint64_t) fileSize;
+		mdfBlockDealloc (&block);
+	}
+
+	int code;
+	if (blockId == MDF_BLOCK_ID_DT)
+		code = recoverDataBlock (&log, dataBlockAddr, recovery);
+	else
+		code = recoverCompressedDataBlocks (&log, dataBlockAddr, (uint64_t) fileSize, recovery);
+
+	// Finalize the split up to the last complete record, exactly as if it had been closed.
+	if (code == 0)
+		code = finalizeSplit (&log);
+
+	if (code == 0 && fsyncPort (mdf) != 0)
+		code = errno;
+
+	free (log.dzAddrs);
+	free (log.dzOffsets);
+
+	if (code != 0)
+	{
+		errno = code;
+		return errno;
+	}
+
+	recovery->recoveredSize = log.splitSize;
+	return 0;
+}
+
+int mdfCanBusLogRecoverSplit (const char* path, mdfCanBusLogRecovery_t* recovery)
+{
+	*recovery = (mdfCanBusLogRecovery_t) {0};
+
+	FILE* mdf = fopen (path, "r+b");
+	if (mdf == NULL)
+		return errno;
+
+	int code = recoverSplit (mdf, recovery);
+	if (fclose (mdf) != 0 && code == 0)
+		code = errno;
+
+	errno = code;
+	return code;
+}
+
+/**
+ * @brief Writes the records of an uncompressed log's data block as compressed data blocks.
+ * @param source The file to read the records from.
+ * @param log The state of the log to write. Updated to reflect the written records.
+ * @param dataAddr The address of the records within @c source .
+ * @param dataLength The length of the records, in bytes.
+ * @param rateLimit The maximum number of bytes to read per second, 0 for no limit.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int compressDataBlock (FILE* source, mdfCanBusLog_t* log, uint64_t dataAddr, uint64_t dataLength, size_t rateLimit)
+{
+	if (fseek (source, dataAddr, SEEK_SET) != 0)
+		return errno;
+
+	// Note the buffer holds an incomplete record from the previous read in addition to a full read.
+	size_t readSize = MDF_CAN_BUS_LOG_BUFFER_SIZE_DEFAULT;
+	mdfCanBusLogBuffer_t buffer =
+	{
+		.data = malloc (readSize + MDF_CAN_BUS_LOG_RECORD_SIZE_MAX)
+	};
+	if (buffer.data == NULL)
+		return errno;
+
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+
+	int code = 0;
+	size_t carry = 0;
+	uint64_t readLength = 0;
+	while (readLength < dataLength)
+	{
+		size_t size = dataLength - readLength < readSize ? dataLength - readLength : readSize;
+		if (fread (buffer.data + carry, 1, size, source) != size)
+		{
+			code = ferror (source) ? errno : ERRNO_MDF_LOG_UNRECOGNIZED;
+			break;
+		}
+		readLength += size;
+		size += carry;
+
+		// Only compress whole records, carrying the incomplete one over to the next block.
+		buffer.size = 0;
+		buffer.recordCount = 0;
+		for (size_t index = 0; index < MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT; ++index)
+			buffer.cycleCounts [index] = 0;
+		while (buffer.size < size)
+		{
+			size_t recordSize = mdfCanBusLogGetRecordSize (buffer.data [buffer.size]);
+			if (recordSize == 0)
+			{
+				code = ERRNO_MDF_LOG_UNRECOGNIZED;
+				break;
+			}
+
+			if (buffer.size + recordSize > size)
+				break;
+
+			++buffer.cycleCounts [buffer.data [buffer.size] - 1];
+			++buffer.recordCount;
+			buffer.size += recordSize;
+		}
+		if (code != 0)
+			break;
+
+		mdfBlock_t block;
+		if (mdfDzBlockInit (&block, buffer.data, buffer.size, getBufferColumns (&buffer)) != 0)
+		{
+			code = errno;
+			break;
+		}
+
+		uint64_t addr = mdfBlockWrite (log->mdf, &block);
+		mdfBlockDealloc (&block);
+		if (addr == 0 || appendDataBlock (log, addr, log->dataLength) != 0)
+		{
+			code = errno;
+			break;
+		}
+
+		long splitSize = ftell (log->mdf);
+		if (splitSize < 0)
+		{
+			code = errno;
+			break;
+		}
+
+		log->splitSize = (size_t) splitSize;
+		log->dataLength += buffer.size;
+		for (size_t index = 0; index < MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT; ++index)
+			log->cycleCounts [index] += buffer.cycleCounts [index];
+
+		carry = size - buffer.size;
+		memmove (buffer.data, buffer.data + buffer.size, carry);
+
+		// Limit the rate of reading by sleeping until the time the bytes read so far are due at.
+		if (rateLimit != 0)
+		{
+			long long delayNs = (long long) ((double) readLength / rateLimit * 1e9);
+			struct timespec deadline = timespecAdd (&timeStart, &(struct timespec)
+			{
+				.tv_sec		= delayNs / 1000000000,
+				.tv_nsec	= delayNs % 1000000000
+			});
+			clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+		}
+	}
+
+	// The data block ending with an incomplete record indicates corruption.
+	if (code == 0 && carry != 0)
+		code = ERRNO_MDF_LOG_UNRECOGNIZED;
+
+	free (buffer.data);
+	return code;
+}
+
+static int compressSplit (FILE* source, const char* path, size_t rateLimit, mdfCanBusLogCompression_t* compression)
+{
+	if (fseek (source, 0, SEEK_END) != 0)
+		return errno;
+
+	long fileSize = ftell (source);
+	if (fileSize < 0)
+		return errno;
+	compression->fileSize = (size_t) fileSize;
+	compression->compressedSize = (size_t) fileSize;
+	rewind (source);
+
+	// Only finalized files are compressed. Files that are not are either being written, or need to be recovered.
+	mdfFileIdBlock_t fileIdBlock;
+	if (mdfReadFileIdBlock (source, &fileIdBlock) != 0)
+		return errno;
+
+	if (memcmp (fileIdBlock.fileIdentification, (char []) MDF_FILE_IDENTIFICATION_FINALIZED,
+		sizeof (fileIdBlock.fileIdentification)) != 0)
+	{
+		compression->skipped = true;
+		return 0;
+	}
+
+	uint64_t dgAddr;
+	uint64_t cgAddrs [MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT];
+	uint64_t dataBlockAddr;
+	if (readSplitLayout (source, &dgAddr, cgAddrs, &dataBlockAddr) != 0)
+		return errno;
+
+	// Only an uncompressed log has a data block. Note a compressed log with no records has no data block at all.
+	mdfBlock_t block;
+	if (dataBlockAddr == 0 || fseek (source, dataBlockAddr, SEEK_SET) != 0 ||
+		fread (&block.header, sizeof (block.header), 1, source) != 1 || block.header.blockId != MDF_BLOCK_ID_DT)
+	{
+		compression->skipped = true;
+		return 0;
+	}
+	uint64_t dataLength = block.header.blockLength - sizeof (block.header);
+
+	// Write the compressed split to a temporary file, replacing the original once complete. This way, the split is never
+	// left incomplete, regardless of when the process is interrupted.
+	char* tempPath;
+	if (asprintf (&tempPath, "%s.tmp", path) < 0)
+		return errno;
+
+	FILE* mdf = fopen (tempPath, "w+b");
+	if (mdf == NULL)
+	{
+		int code = errno;
+		free (tempPath);
+		return code;
+	}
+
+	mdfCanBusLog_t log =
+	{
+		.mdf		= mdf,
+		.dgAddr		= dgAddr,
+		.compressed	= true,
+		.splitSize	= dataBlockAddr
+	};
+	memcpy (log.cgAddrs, cgAddrs, sizeof (cgAddrs));
+
+	// Copy everything preceding the data block, that is, the metadata of the split.
+	int code = 0;
+	uint8_t copyBuffer [4096];
+	rewind (source);
+	for (uint64_t addr = 0; addr < dataBlockAddr && code == 0;)
+	{
+		size_t size = dataBlockAddr - addr < sizeof (copyBuffer) ? dataBlockAddr - addr : sizeof (copyBuffer);
+		if (fread (copyBuffer, 1, size, source) != size)
+			code = ferror (source) ? errno : ERRNO_MDF_LOG_UNRECOGNIZED;
+		else if (fwrite (copyBuffer, 1, size, mdf) != size)
+			code = errno;
+		addr += size;
+	}
+
+	if (code == 0)
+		code = compressDataBlock (source, &log, dataBlockAddr + sizeof (block.header), dataLength, rateLimit);
+
+	if (code == 0)
+		code = finalizeSplit (&log);
+
+	if (code == 0 && fsyncPort (mdf) != 0)
+		code = errno;
+
+	if (fclose (mdf) != 0 && code == 0)
+		code = errno;
+
+	if (code == 0 && renamePort (tempPath, path) != 0)
+		code = errno;
+
+	if (code != 0)
+		remove (tempPath);
+	else
+		compression->compressedSize = log.splitSize;
+
+	// The rename is only durable once the directory is synchronized. Note the temporary file is gone by this point, so a
+	// failure here leaves the compressed split in place.
+	if (code == 0 && fsyncDirectoryPort (path) != 0)
+		code = errno;
+
+	free (log.dzAddrs);
+	free (log.dzOffsets);
+	free (tempPath);
+	return code;
+}
+
+int mdfCanBusLogCompressSplit (const char* path, size_t rateLimit, mdfCanBusLogCompression_t* compression)
+{
+	*compression = (mdfCanBusLogCompression_t) {0};
+
+	FILE* source = fopen (path, "rb");
+	if (source == NULL)
+		return errno;
+
+	int code = compressSplit (source, path, rateLimit, compression);
+	fclose (source);
+
+	errno = code;
+	return code;
+}
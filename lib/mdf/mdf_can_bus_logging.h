@@ -12,17 +12,57 @@
 
 // Includes
 #include "can_device/can_device.h"
+#include "mdf_catalog.h"
+#include "mdf_signal_log.h"
 
 // POSIX
+#include <pthread.h>
 #include <sys/time.h>
 
 // C Standard Library
 #include <errno.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <time.h>
 
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The default size of each of a log's write buffers, in bytes.
+#define MDF_CAN_BUS_LOG_BUFFER_SIZE_DEFAULT			(1 << 20)
+
+/// @brief The default maximum amount of time a record is held in memory before being written, in milliseconds.
+#define MDF_CAN_BUS_LOG_FLUSH_INTERVAL_DEFAULT		500
+
+/// @brief The default maximum amount of time written records may go without being synchronized to the storage device, in
+/// milliseconds.
+#define MDF_CAN_BUS_LOG_SYNC_INTERVAL_DEFAULT		1000
+
+/// @brief The default maximum number of bytes that may be written without being synchronized to the storage device.
+#define MDF_CAN_BUS_LOG_SYNC_SIZE_DEFAULT			(4 << 20)
+
+/// @brief The number of channel groups (record types) in a log. Record IDs range from 1 to this, inclusive.
+#define MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT			3
+
+/// @brief The maximum size of an encoded record (including the record ID), in bytes.
+#define MDF_CAN_BUS_LOG_RECORD_SIZE_MAX				21
+
+/// @brief The size of an encoded data or RTR frame record (including the record ID), in bytes.
+#define MDF_CAN_BUS_LOG_FRAME_RECORD_SIZE			20
+
+/// @brief The record ID (first byte) of an encoded error frame.
+#define MDF_CAN_BUS_LOG_ERROR_FRAME_RECORD_ID		0x03
+
 // Datatypes ------------------------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Function called when a split of a log is created, and again once it is closed.
+ * @param sessionNumber The session number of the log.
+ * @param splitNumber The number of the split.
+ * @param closed False if the split was just created, true if it was just closed (meaning it is no longer written).
+ * @param arg The user argument given by the log's configuration.
+ */
+typedef void mdfCanBusLogSplitCallback_t (uint32_t sessionNumber, uint32_t splitNumber, bool closed, void* arg);
+
 typedef struct
 {
 	// TODO(Barach):
@@ -60,8 +100,148 @@ typedef struct
 
 	/// @brief The index of this data log, starting from 0 and incrementing monotonically.
 	uint32_t sessionNumber;
+
+	/// @brief The date and time the log started at, in seconds since the Unix epoch. Use 0 for the current time. Only needed
+	/// when re-creating a previously recorded log (ex. from an archive, see mdf_can_bus_archive.h).
+	time_t dateStart;
+
+	/// @brief The size of each of the log's two write buffers, in bytes. Use 0 for the default
+	/// (@c MDF_CAN_BUS_LOG_BUFFER_SIZE_DEFAULT ).
+	size_t bufferSize;
+
+	/// @brief The maximum amount of time a record is held in memory before being written, in milliseconds. Use 0 for the
+	/// default (@c MDF_CAN_BUS_LOG_FLUSH_INTERVAL_DEFAULT ).
+	unsigned long flushIntervalMs;
+
+	/// @brief The maximum amount of time written records may go without being synchronized to the storage device, in
+	/// milliseconds. Use 0 for the default (@c MDF_CAN_BUS_LOG_SYNC_INTERVAL_DEFAULT ).
+	unsigned long syncIntervalMs;
+
+	/// @brief The maximum number of bytes that may be written without being synchronized to the storage device. Use 0 for the
+	/// default (@c MDF_CAN_BUS_LOG_SYNC_SIZE_DEFAULT ).
+	size_t syncSize;
+
+	/// @brief Indicates the records should be deflate-compressed. Each write buffer is written as a compressed data block,
+	/// listed by a data list block once the split is finalized. Note the maximum split size then applies to the compressed
+	/// data.
+	bool compress;
+
+	/// @brief Indicates each split should be summarized in the log directory's catalog once closed (see mdf_catalog.h).
+	bool catalog;
+
+	/// @brief The names of the signals whose ranges are summarized in the catalog. @c NULL if no signals are summarized.
+	const char* const* catalogSignalNames;
+
+	/// @brief The number of elements in @c catalogSignalNames .
+	size_t catalogSignalCount;
+
+	/// @brief Function decoding the summarized signals of each record, see @c mdfCatalogSignalCallback_t . Note this is
+	/// called by the log's writer thread.
+	mdfCatalogSignalCallback_t* catalogCallback;
+
+	/// @brief User argument to pass to @c catalogCallback .
+	void* catalogArg;
+
+	/// @brief Indicates the decoded signals of each split should be written alongside it, as 'signals_<N>.mf4' (see
+	/// mdf_signal_log.h). Records are decoded by the log's writer thread, so this adds no work to the producers of records.
+	bool signalLog;
+
+	/// @brief The groups (messages) of the signal log. Must remain valid for the lifetime of the log.
+	const mdfSignalLogGroup_t* signalLogGroups;
+
+	/// @brief The number of elements in @c signalLogGroups .
+	size_t signalLogGroupCount;
+
+	/// @brief Function decoding the signals of each record, see @c mdfSignalLogCallback_t . Note this is called by the log's
+	/// writer thread.
+	mdfSignalLogCallback_t* signalLogCallback;
+
+	/// @brief User argument to pass to @c signalLogCallback .
+	void* signalLogArg;
+
+	/// @brief Function notified of each split being created and closed (ex. to post-process closed splits, see
+	/// mdf_pipeline.h). @c NULL if not used. Note this is called by the log's writer thread, so should not block for long.
+	mdfCanBusLogSplitCallback_t* splitCallback;
+
+	/// @brief User argument to pass to @c splitCallback .
+	void* splitArg;
 } mdfCanBusLogConfig_t;
 
+/// @brief Buffer of encoded records waiting to be written to a log file.
+typedef struct
+{
+	uint8_t* data;
+	size_t size;
+	size_t recordCount;
+
+	/// @brief The number of records of each channel group, indexed by record ID - 1.
+	size_t cycleCounts [MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT];
+
+	/// @brief Indicates the current split should end after the records of this buffer, see @c mdfCanBusLogSplit .
+	bool splitAfter;
+} mdfCanBusLogBuffer_t;
+
+/// @brief Statistics of a log's write buffers.
+typedef struct
+{
+	/// @brief The number of records currently held in memory, that is, not yet written to the log file.
+	size_t queueDepth;
+
+	/// @brief The maximum value @c queueDepth has reached.
+	size_t queueHighWaterMark;
+
+	/// @brief The number of records dropped due to both buffers being full.
+	size_t droppedCount;
+
+	/// @brief The number of records written to the log file.
+	size_t writtenCount;
+
+	/// @brief The number of times the log file has been synchronized to the storage device.
+	size_t syncCount;
+
+	/// @brief The longest a single synchronization has taken, in nanoseconds.
+	long long syncTimeMaxNs;
+} mdfCanBusLogStats_t;
+
+/// @brief The result of recovering a log file, see @c mdfCanBusLogRecoverSplit .
+typedef struct
+{
+	/// @brief Indicates the file was already finalized, so nothing was changed.
+	bool finalized;
+
+	/// @brief The number of complete records recovered.
+	size_t recordCount;
+
+	/// @brief The size of the file before recovery, in bytes.
+	size_t fileSize;
+
+	/// @brief The size of the file after recovery, in bytes.
+	size_t recoveredSize;
+} mdfCanBusLogRecovery_t;
+
+/// @brief The result of compressing a log file, see @c mdfCanBusLogCompressSplit .
+typedef struct
+{
+	/// @brief Indicates the file was already compressed, or was not finalized, so nothing was changed.
+	bool skipped;
+
+	/// @brief The size of the file before compression, in bytes.
+	size_t fileSize;
+
+	/// @brief The size of the file after compression, in bytes.
+	size_t compressedSize;
+} mdfCanBusLogCompression_t;
+
+/**
+ * @brief An MDF CAN bus log. Records are appended into one of two preallocated buffers, while a dedicated writer thread writes
+ * the other to the log file. The buffers are swapped when the one being appended into fills, or after the flush interval
+ * elapses, meaning a slow storage device only stalls the writer thread, not the threads producing records.
+ *
+ * Written records are synchronized to the storage device in groups, once either the sync interval elapses or the sync size is
+ * reached. Should power be lost, the records at risk are limited to those held in memory (at most the flush interval) plus
+ * those not yet synchronized (at most the sync interval or sync size). The interrupted split can be repaired using
+ * @c mdfCanBusLogRecoverSplit .
+ */
 typedef struct
 {
 	// TODO(Barach)
@@ -72,6 +252,73 @@ typedef struct
 	char* splitName;
 	time_t dateStart;
 	struct timespec timeStart;
+
+	/// @brief Indicates the records are compressed, see @c mdfCanBusLogConfig_t.compress .
+	bool compressed;
+
+	/// @brief The address of the current split's data group block.
+	uint64_t dgAddr;
+
+	/// @brief The address of the current split's data block. Only used if the records are not compressed.
+	uint64_t dtAddr;
+
+	/// @brief The address of each of the current split's compressed data blocks. Only used if the records are compressed.
+	uint64_t* dzAddrs;
+
+	/// @brief The offset of each compressed data block's data, within the split's uncompressed data.
+	uint64_t* dzOffsets;
+
+	/// @brief The number of compressed data blocks in the current split.
+	size_t dzCount;
+
+	/// @brief The capacity of the @c dzAddrs and @c dzOffsets arrays.
+	size_t dzCapacity;
+
+	/// @brief The uncompressed size of the current split's data, in bytes. Only used if the records are compressed.
+	uint64_t dataLength;
+
+	/// @brief The address of each of the current split's channel group blocks, indexed by record ID - 1.
+	uint64_t cgAddrs [MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT];
+
+	/// @brief The number of records of each channel group written to the current split, indexed by record ID - 1.
+	uint64_t cycleCounts [MDF_CAN_BUS_LOG_CHANNEL_GROUP_COUNT];
+
+	/// @brief The size of the current split as of its last synchronization, in bytes. Only accessed by the writer thread.
+	size_t splitSizeSynced;
+
+	/// @brief The time at which the log file was last synchronized. Only accessed by the writer thread.
+	struct timespec timeLastSync;
+
+	/// @brief Builder of the current split's catalog entry, @c NULL if the log is not cataloged. Only accessed by the writer
+	/// thread.
+	mdfCatalogBuilder_t* catalog;
+
+	/// @brief Writer of the current split's decoded signals, @c NULL if signals are not logged. Only accessed by the writer
+	/// thread.
+	mdfSignalLog_t* signalLog;
+
+	/// @brief The write buffers. At any given moment, one is being appended to, while the other is written by the writer.
+	mdfCanBusLogBuffer_t buffers [2];
+
+	/// @brief The buffer records are currently being appended to.
+	mdfCanBusLogBuffer_t* fill;
+
+	/// @brief The capacity of each write buffer, in bytes.
+	size_t bufferSize;
+
+	/// @brief Mutex guarding the buffers and statistics.
+	pthread_mutex_t mutex;
+
+	/// @brief Condition signalled when the fill buffer needs to be written, or the log is closing.
+	pthread_cond_t condition;
+
+	pthread_t writerThread;
+	bool closing;
+
+	/// @brief The error that stopped the writer, 0 if none.
+	int writerError;
+
+	mdfCanBusLogStats_t stats;
 } mdfCanBusLog_t;
 
 // Functions ------------------------------------------------------------------------------------------------------------------
@@ -96,7 +343,8 @@ int mdfCanBusLogInit (mdfCanBusLog_t* log, const mdfCanBusLogConfig_t* config);
 /**
  * @brief Gets the name of the current logging file.
  * @param log The log file to get from.
- * @return The name of the current split file.
+ * @return The name of the current split file. @c NULL if the current split has been ended (see @c mdfCanBusLogSplit ) and
+ * the next is yet to be created.
  */
 const char* mdfCanBusLogGetName (mdfCanBusLog_t* log);
 
@@ -112,6 +360,13 @@ static inline uint32_t mdfCanBusLogGetSplitNumber (mdfCanBusLog_t* log)
 	return log->splitNumber;
 }
 
+/**
+ * @brief Gets the statistics of an MDF log's write buffers. This function is thread-safe.
+ * @param log The log to get from.
+ * @param stats Buffer to write the statistics into.
+ */
+void mdfCanBusLogGetStats (mdfCanBusLog_t* log, mdfCanBusLogStats_t* stats);
+
 /**
  * @brief Gets a timestamp used by an MDF log.
  * @param timestamp Buffer to write the timestamp into.
@@ -137,34 +392,117 @@ static inline int mdfCanBusLogGetTimeResolution (struct timespec* resolution)
 }
 
 /**
- * @brief Writes a CAN data frame to an MDF log. Note this function is not thread-safe, in order to use it a multithreaded
- * context, a mutex must be employed.
+ * @brief Gets the size of a record, based on its record ID (the first byte of the record).
+ * @param recordId The ID of the record.
+ * @return The size of the record (including the record ID), in bytes. 0 if the ID is not recognized.
+ */
+size_t mdfCanBusLogGetRecordSize (uint8_t recordId);
+
+/**
+ * @brief Gets the error code of an error frame record's error type, that is, the inverse of the conversion performed by
+ * @c mdfCanBusLogEncodeErrorFrame .
+ * @param errorType The error type of the record, as defined by the ASAM MDF Bus Logging Standard.
+ * @return The error code, as checked by @c canCheckBusError .
+ */
+int mdfCanBusLogGetErrorCode (uint8_t errorType);
+
+/**
+ * @brief Encodes a CAN data frame into a record, without writing it. This function is thread-safe.
+ * @param log The log the record is destined for.
+ * @param record Buffer to write the record into. Must be at least @c MDF_CAN_BUS_LOG_RECORD_SIZE_MAX bytes.
+ * @param frame The data frame to encode.
+ * @param busChannel The CAN bus channel the frame originated from. Either 1 or 2.
+ * @param direction The direction of the frame. False => received, true => transmitted.
+ * @param timestamp The time at which the frame arrived, as acquired by @c mdfCanBusLogGetTimestamp .
+ * @return The size of the record, in bytes.
+ */
+size_t mdfCanBusLogEncodeDataFrame (mdfCanBusLog_t* log, uint8_t* record, canFrame_t* frame, uint8_t busChannel, bool direction,
+	struct timespec* timestamp);
+
+/**
+ * @brief Encodes a CAN RTR frame into a record, without writing it. This function is thread-safe.
+ * @param log The log the record is destined for.
+ * @param record Buffer to write the record into. Must be at least @c MDF_CAN_BUS_LOG_RECORD_SIZE_MAX bytes.
+ * @param frame The RTR frame to encode.
+ * @param busChannel The CAN bus channel the frame originated from. Either 1 or 2.
+ * @param direction The direction of the frame. False => received, true => transmitted.
+ * @param timestamp The time at which the frame arrived, as acquired by @c mdfCanBusLogGetTimestamp .
+ * @return The size of the record, in bytes.
+ */
+size_t mdfCanBusLogEncodeRemoteFrame (mdfCanBusLog_t* log, uint8_t* record, canFrame_t* frame, uint8_t busChannel,
+	bool direction, struct timespec* timestamp);
+
+/**
+ * @brief Encodes a CAN error frame into a record, without writing it. This function is thread-safe.
+ * @param log The log the record is destined for.
+ * @param record Buffer to write the record into. Must be at least @c MDF_CAN_BUS_LOG_RECORD_SIZE_MAX bytes.
+ * @param frame The error frame to encode.
+ * @param busChannel The CAN bus channel the frame originated from. Either 1 or 2.
+ * @param direction The direction of the frame. False => received, true => transmitted.
+ * @param errorCode The error code that is associated with the frame.
+ * @param timestamp The time at which the frame was generated, as acquired by @c mdfCanBusLogGetTimestamp .
+ * @return The size of the record, in bytes.
+ */
+size_t mdfCanBusLogEncodeErrorFrame (mdfCanBusLog_t* log, uint8_t* record, canFrame_t* frame, uint8_t busChannel,
+	bool direction, int errorCode, struct timespec* timestamp);
+
+/**
+ * @brief Encodes a batch of CAN data and RTR frames into contiguous records, without writing them. Produces the same records
+ * as @c mdfCanBusLogEncodeDataFrame and @c mdfCanBusLogEncodeRemoteFrame (selected by each frame's @c rtr bit), but packs
+ * each record with a few word-sized stores rather than per-byte loops. This function is thread-safe.
+ * @param log The log the records are destined for.
+ * @param records Buffer to write the records into. Must be at least @c count * @c MDF_CAN_BUS_LOG_FRAME_RECORD_SIZE bytes.
+ * @param frames The frames to encode.
+ * @param timestamps The time at which each frame arrived, as acquired by @c mdfCanBusLogGetTimestamp .
+ * @param count The number of elements in @c frames and @c timestamps .
+ * @param busChannel The CAN bus channel the frames originated from. Either 1 or 2.
+ * @param direction The direction of the frames. False => received, true => transmitted.
+ * @return The total size of the records, in bytes.
+ */
+size_t mdfCanBusLogEncodeFrames (mdfCanBusLog_t* log, uint8_t* records, const canFrame_t* frames,
+	const struct timespec* timestamps, size_t count, uint8_t busChannel, bool direction);
+
+/**
+ * @brief Writes a record, as encoded by one of the @c mdfCanBusLogEncode functions, to an MDF log. This function is
+ * thread-safe, it may be called concurrently with the other write functions, @c mdfCanBusLogSplit and the log's writer thread.
+ * Note concurrent writes are appended in the order they acquire the log's mutex, so if the timestamps of the log must be
+ * monotonic, the records should be written by a single thread (see mdf_record_queue.h).
+ * @param log The log to write to.
+ * @param record The record to write.
+ * @param recordSize The size of the record, in bytes.
+ * @return 0 if successful, the error code otherwise. If the log's write buffers are full, the record is dropped and
+ * @c ERRNO_MDF_LOG_OVERFLOW is returned.
+ */
+int mdfCanBusLogWriteRecord (mdfCanBusLog_t* log, const uint8_t* record, size_t recordSize);
+
+/**
+ * @brief Writes a CAN data frame to an MDF log. This function is thread-safe, see @c mdfCanBusLogWriteRecord .
  * @param log The log to write to.
  * @param frame The data frame to write.
  * @param busChannel The CAN bus channel the frame originated from. Either 1 or 2.
  * @param direction The direction of the frame. False => received, true => transmitted.
  * @param timestamp The time at which the frame arrived, as acquired by @c mdfCanBusLogGetTimestamp .
- * @return 0 if successful, the error code otherwise.
+ * @return 0 if successful, the error code otherwise. If the log's write buffers are full, the record is dropped and
+ * @c ERRNO_MDF_LOG_OVERFLOW is returned.
  */
 int mdfCanBusLogWriteDataFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_t busChannel, bool direction,
 	struct timespec* timestamp);
 
 /**
- * @brief Writes an CAN RTR frame to an MDF log. Note this function is not thread-safe, in order to use it a multithreaded
- * context, a mutex must be employed.
+ * @brief Writes an CAN RTR frame to an MDF log. This function is thread-safe, see @c mdfCanBusLogWriteRecord .
  * @param log The log to write to.
  * @param frame The RTR frame to write.
  * @param busChannel The CAN bus channel the frame originated from. Either 1 or 2.
  * @param direction The direction of the frame. False => received, true => transmitted.
  * @param timestamp The time at which the frame arrived, as acquired by @c mdfCanBusLogGetTimestamp .
- * @return 0 if successful, the error code otherwise.
+ * @return 0 if successful, the error code otherwise. If the log's write buffers are full, the record is dropped and
+ * @c ERRNO_MDF_LOG_OVERFLOW is returned.
  */
 int mdfCanBusLogWriteRemoteFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_t busChannel, bool direction,
 	struct timespec* timestamp);
 
 /**
- * @brief Writes a CAN error frame to an MDF log. Note this function is not thread-safe, in order to use it a multithreaded
- * context, a mutex must be employed.
+ * @brief Writes a CAN error frame to an MDF log. This function is thread-safe, see @c mdfCanBusLogWriteRecord .
  * @param log The log to write to.
  * @param frame The error frame to write.
  * @param busChannel The CAN bus channel the frame originated from. Either 1 or 2.
@@ -172,17 +510,66 @@ int mdfCanBusLogWriteRemoteFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_
  * @param errorCode The error code that is associated with the frame (as returned by @c canReceive and checked by
  * @c canCheckBusError ).
  * @param timestamp The time at which the frame was generated, as acquired by @c mdfCanBusLogGetTimestamp .
- * @return 0 if successful, the error code otherwise.
+ * @return 0 if successful, the error code otherwise. If the log's write buffers are full, the record is dropped and
+ * @c ERRNO_MDF_LOG_OVERFLOW is returned.
  */
 int mdfCanBusLogWriteErrorFrame (mdfCanBusLog_t* log, canFrame_t* frame, uint8_t busChannel, bool direction, int errorCode,
 	struct timespec* timestamp);
 
 /**
- * @brief Closes a an MDF log. Note this function is not thread-safe, in order to use it a multithreaded context, a mutex must
- * be employed.
+ * @brief Writes a batch of CAN data and RTR frames to an MDF log. The frames are encoded (see @c mdfCanBusLogEncodeFrames )
+ * directly into the log's write buffer, which is locked once for the whole batch. This function is thread-safe, see
+ * @c mdfCanBusLogWriteRecord . Note the batch is appended contiguously, records written concurrently precede or follow it.
+ * @param log The log to write to.
+ * @param frames The frames to write.
+ * @param timestamps The time at which each frame arrived, as acquired by @c mdfCanBusLogGetTimestamp .
+ * @param count The number of elements in @c frames and @c timestamps .
+ * @param busChannel The CAN bus channel the frames originated from. Either 1 or 2.
+ * @param direction The direction of the frames. False => received, true => transmitted.
+ * @return 0 if successful, the error code otherwise. If the log's write buffers cannot hold the whole batch, the frames that
+ * fit are written, the remainder are dropped, and @c ERRNO_MDF_LOG_OVERFLOW is returned.
+ */
+int mdfCanBusLogWriteFrames (mdfCanBusLog_t* log, const canFrame_t* frames, const struct timespec* timestamps, size_t count,
+	uint8_t busChannel, bool direction);
+
+/**
+ * @brief Ends the current split of an MDF log, once all previously written records have been written to it. The next split is
+ * created once there are records to write into it, meaning splits are never left empty. If the current split has no records,
+ * this does nothing. This function is thread-safe, it may be called concurrently with the write functions and the log's
+ * writer thread. Records written concurrently with the call may fall on either side of the split.
+ * @param log The log to split.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusLogSplit (mdfCanBusLog_t* log);
+
+/**
+ * @brief Closes a an MDF log. All buffered records are written before the file is closed. Note this function is not
+ * thread-safe, in order to use it a multithreaded context, a mutex must be employed.
  * @param log The log to close.
  * @return 0 if successful, the error code otherwise.
  */
 int mdfCanBusLogClose (mdfCanBusLog_t* log);
 
+/**
+ * @brief Repairs a log file that was not closed properly, for instance due to power loss. The file is truncated to its last
+ * complete record, then finalized, as would have been done by @c mdfCanBusLogClose . Files that are already finalized are
+ * left untouched.
+ * @param path The path of the file to repair.
+ * @param recovery Buffer to write the result into.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusLogRecoverSplit (const char* path, mdfCanBusLogRecovery_t* recovery);
+
+/**
+ * @brief Compresses a log file that was written uncompressed, as if it had been written with compression enabled (see
+ * @c mdfCanBusLogConfig_t ). The compressed file is written alongside the original, replacing it once complete, so the
+ * original is never left incomplete. Files that are already compressed, or were not finalized, are left untouched.
+ * @param path The path of the file to compress.
+ * @param rateLimit The maximum number of bytes to read per second, 0 for no limit. Used to limit the I/O load placed on the
+ * storage device.
+ * @param compression Buffer to write the result into.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusLogCompressSplit (const char* path, size_t rateLimit, mdfCanBusLogCompression_t* compression);
+
 #endif // MDF_CAN_BUS_LOGGING
\ No newline at end of file
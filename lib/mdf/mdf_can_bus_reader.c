@@ -0,0 +1,784 @@
+// Header
+#include "mdf_can_bus_reader.h"
+
+// Includes
+#include "error_codes.h"
+#include "mdf_block_types.h"
+#include "misc_port.h"
+
+// C Standard Library
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Gets a view of a block within the mapped file. The block's link list and data section reference the mapping, so the
+ * block must not be deallocated.
+ * @param reader The reader to get from.
+ * @param addr The address of the block.
+ * @param blockId The expected ID of the block, 0 to accept any block.
+ * @param linkCount The minimum number of links the block must have.
+ * @param dataSectionSize The minimum size of the block's data section, in bytes.
+ * @param block Buffer to write the block into.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int getBlock (mdfCanBusReader_t* reader, uint64_t addr, uint64_t blockId, uint64_t linkCount, size_t dataSectionSize,
+	mdfBlock_t* block)
+{
+	// Blocks are 8-byte aligned, so links can be accessed in-place.
+	if (addr % sizeof (uint64_t) != 0 || addr > reader->mapSize || reader->mapSize - addr < sizeof (block->header))
+	{
+		errno = ERRNO_MDF_MALFORMED_BLOCK;
+		return errno;
+	}
+
+	block->addr = addr;
+	memcpy (&block->header, reader->map + addr, sizeof (block->header));
+
+	uint64_t length = block->header.blockLength;
+	if ((blockId != 0 && block->header.blockId != blockId) || length < sizeof (block->header) ||
+		length > reader->mapSize - addr || block->header.linkCount < linkCount ||
+		block->header.linkCount > (length - sizeof (block->header)) / sizeof (uint64_t) ||
+		mdfBlockDataSectionSize (block) < dataSectionSize)
+	{
+		errno = ERRNO_MDF_MALFORMED_BLOCK;
+		return errno;
+	}
+
+	block->linkList = (uint64_t*) (reader->map + addr + sizeof (block->header));
+	block->dataSection = block->linkList + block->header.linkCount;
+	return 0;
+}
+
+/**
+ * @brief Gets the string of a text block.
+ * @param reader The reader to get from.
+ * @param addr The address of the text block.
+ * @return The string, if valid, @c NULL otherwise.
+ */
+static const char* getText (mdfCanBusReader_t* reader, uint64_t addr)
+{
+	mdfBlock_t block;
+	if (addr == 0 || getBlock (reader, addr, MDF_BLOCK_ID_TX, 0, 0, &block) != 0)
+		return NULL;
+
+	// The string must be terminated within the block.
+	if (memchr (block.dataSection, '\0', mdfBlockDataSectionSize (&block)) == NULL)
+		return NULL;
+
+	return block.dataSection;
+}
+
+/**
+ * @brief Populates the location of a field from its channel block. The field is left absent if it does not fit in the record.
+ * @param layout The layout the field belongs to.
+ * @param field The field to populate.
+ * @param dataSection The channel's data section.
+ * @param recordIdLength The length of the record ID preceding the channel's byte offset, in bytes.
+ */
+static void setField (mdfCanBusReaderLayout_t* layout, mdfCanBusReaderField_t* field, mdfCnDataSection_t* dataSection,
+	uint8_t recordIdLength)
+{
+	size_t byteOffset = recordIdLength + dataSection->byteOffset;
+	size_t byteLength;
+
+	if (dataSection->dataType == MDF_DATA_TYPE_BYTE_ARRAY)
+		byteLength = dataSection->bitLength / 8;
+	else
+	{
+		// Values are read as a single 64-bit word.
+		if (dataSection->bitLength == 0 || dataSection->bitOffset + dataSection->bitLength > 64)
+			return;
+
+		byteLength = (dataSection->bitOffset + dataSection->bitLength + 7) / 8;
+	}
+
+	if (byteOffset + byteLength > layout->size)
+		return;
+
+	*field = (mdfCanBusReaderField_t)
+	{
+		.byteOffset	= byteOffset,
+		.bitOffset	= dataSection->bitOffset,
+		.bitLength	= dataSection->bitLength
+	};
+}
+
+/**
+ * @brief Populates the timestamp conversion of a layout from the timestamp channel's conversion block.
+ * @param reader The reader to read from.
+ * @param layout The layout to populate.
+ * @param conversionAddr The address of the channel's conversion block, 0 if there is none.
+ */
+static void setTimestampConversion (mdfCanBusReader_t* reader, mdfCanBusReaderLayout_t* layout, uint64_t conversionAddr)
+{
+	// Without a conversion, the raw value is in seconds.
+	layout->timestampFactorNs = 1e9;
+	layout->timestampOffsetNs = 0;
+
+	mdfBlock_t block;
+	if (conversionAddr != 0 && getBlock (reader, conversionAddr, MDF_BLOCK_ID_CC, 0, sizeof (mdfCcDataSection_t), &block) == 0)
+	{
+		mdfCcDataSection_t* dataSection = block.dataSection;
+		if (dataSection->conversionType == MDF_CC_CONVERSION_TYPE_LINEAR)
+		{
+			layout->timestampFactorNs = dataSection->a * 1e9;
+			layout->timestampOffsetNs = dataSection->b * 1e9;
+		}
+	}
+
+	layout->timestampNative = fabs (layout->timestampFactorNs - 1.0) < 1e-9 && layout->timestampOffsetNs == 0;
+}
+
+/**
+ * @brief Learns the layout of a channel group's records.
+ * @param reader The reader to read from.
+ * @param cg The channel group block.
+ * @param layout Buffer to write the layout into.
+ * @return 0 if successful, the error code otherwise. Note unsupported groups are not an error.
+ */
+static int readLayout (mdfCanBusReader_t* reader, mdfBlock_t* cg, mdfCanBusReaderLayout_t* layout)
+{
+	mdfCgDataSection_t* cgDataSection = cg->dataSection;
+
+	*layout = (mdfCanBusReaderLayout_t)
+	{
+		.recordId	= cgDataSection->recordId,
+		.size		= reader->recordIdLength + cgDataSection->byteLength,
+		.supported	= false
+	};
+
+	bool typeKnown = false;
+	uint64_t cnAddr = mdfCgBlockLinkList (cg)->firstCnAddr;
+	while (cnAddr != 0)
+	{
+		mdfBlock_t cn;
+		if (getBlock (reader, cnAddr, MDF_BLOCK_ID_CN, sizeof (mdfCnLinkList_t) / sizeof (uint64_t),
+			sizeof (mdfCnDataSection_t), &cn) != 0)
+			return errno;
+
+		mdfCnDataSection_t* cnDataSection = cn.dataSection;
+		mdfCnLinkList_t* cnLinkList = mdfCnBlockLinkList (&cn);
+		const char* name = getText (reader, cnLinkList->nameAddr);
+
+		if (cnDataSection->channelType == MDF_CHANNEL_TYPE_MASTER && cnDataSection->syncType == MDF_SYNC_TYPE_TIME)
+		{
+			setField (layout, &layout->timestamp, cnDataSection, reader->recordIdLength);
+			setTimestampConversion (reader, layout, cnLinkList->conversionAddr);
+		}
+		else if (cnLinkList->componentAddr != 0 && name != NULL)
+		{
+			// The composed channel identifies the type of frame.
+			typeKnown = true;
+			if (strcmp (name, "CAN_DataFrame") == 0)
+				layout->type = MDF_CAN_BUS_RECORD_DATA_FRAME;
+			else if (strcmp (name, "CAN_RemoteFrame") == 0)
+				layout->type = MDF_CAN_BUS_RECORD_REMOTE_FRAME;
+			else if (strcmp (name, "CAN_ErrorFrame") == 0)
+				layout->type = MDF_CAN_BUS_RECORD_ERROR_FRAME;
+			else
+				typeKnown = false;
+
+			// Component channels are named '<Frame><Separator><Signal>', ex. 'CAN_DataFrame.ID'.
+			uint64_t componentAddr = cnLinkList->componentAddr;
+			while (typeKnown && componentAddr != 0)
+			{
+				mdfBlock_t component;
+				if (getBlock (reader, componentAddr, MDF_BLOCK_ID_CN, sizeof (mdfCnLinkList_t) / sizeof (uint64_t),
+					sizeof (mdfCnDataSection_t), &component) != 0)
+					return errno;
+
+				const char* componentName = getText (reader, mdfCnBlockLinkList (&component)->nameAddr);
+				const char* signal = componentName != NULL ? strrchr (componentName, cgDataSection->pathSeparator) : NULL;
+				if (signal != NULL)
+				{
+					++signal;
+
+					mdfCanBusReaderField_t* field = NULL;
+					if (strcmp (signal, "ID") == 0)
+						field = &layout->id;
+					else if (strcmp (signal, "IDE") == 0)
+						field = &layout->ide;
+					else if (strcmp (signal, "BusChannel") == 0)
+						field = &layout->busChannel;
+					else if (strcmp (signal, "DLC") == 0)
+						field = &layout->dlc;
+					else if (strcmp (signal, "Dir") == 0)
+						field = &layout->direction;
+					else if (strcmp (signal, "DataBytes") == 0)
+						field = &layout->dataBytes;
+					else if (strcmp (signal, "ErrorType") == 0)
+						field = &layout->errorType;
+
+					if (field != NULL)
+						setField (layout, field, component.dataSection, reader->recordIdLength);
+				}
+
+				componentAddr = mdfCnBlockLinkList (&component)->nextCnAddr;
+			}
+		}
+
+		cnAddr = cnLinkList->nextCnAddr;
+	}
+
+	// The payload must be able to hold the largest DLC.
+	layout->supported = typeKnown && layout->timestamp.bitLength != 0 && layout->id.bitLength != 0 &&
+		layout->dlc.bitLength != 0 && layout->dataBytes.bitLength >= 64;
+
+	return 0;
+}
+
+/**
+ * @brief Appends the address of a data block to the current data group's list.
+ * @param reader The reader to append to.
+ * @param addr The address to append.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int appendBlockAddr (mdfCanBusReader_t* reader, uint64_t addr)
+{
+	if (reader->blockCount == reader->blockCapacity)
+	{
+		size_t capacity = reader->blockCapacity != 0 ? reader->blockCapacity * 2 : 16;
+		uint64_t* blockAddrs = realloc (reader->blockAddrs, sizeof (uint64_t) * capacity);
+		if (blockAddrs == NULL)
+			return errno;
+
+		reader->blockAddrs = blockAddrs;
+		reader->blockCapacity = capacity;
+	}
+
+	reader->blockAddrs [reader->blockCount] = addr;
+	++reader->blockCount;
+	return 0;
+}
+
+/**
+ * @brief Lists the compressed data blocks of an unfinalized file. These are not listed by a data list yet, rather they are
+ * written consecutively (aligned to 8 bytes) from the data group's data block until the end of the file. The list ends at the
+ * first incomplete block, as it may still be being written (or its write may have been interrupted).
+ * @param reader The reader to list into.
+ * @param addr The address of the first block.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int appendUnfinalizedBlockAddrs (mdfCanBusReader_t* reader, uint64_t addr)
+{
+	mdfBlock_t block;
+	while (addr < reader->mapSize && getBlock (reader, addr, MDF_BLOCK_ID_DZ, 0, sizeof (mdfDzDataSection_t), &block) == 0)
+	{
+		if (appendBlockAddr (reader, addr) != 0)
+			return errno;
+
+		addr = (addr + block.header.blockLength + 7) & ~(uint64_t) 7;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Loads a data group, learning its record layouts and listing its data blocks.
+ * @param reader The reader to load into.
+ * @param dgAddr The address of the data group block.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int loadDataGroup (mdfCanBusReader_t* reader, uint64_t dgAddr)
+{
+	mdfBlock_t dg;
+	if (getBlock (reader, dgAddr, MDF_BLOCK_ID_DG, sizeof (mdfDgLinkList_t) / sizeof (uint64_t),
+		sizeof (mdfDgDataSection_t), &dg) != 0)
+		return errno;
+
+	mdfDgLinkList_t* dgLinkList = mdfDgBlockLinkList (&dg);
+	reader->dgAddr = dgAddr;
+	reader->nextDgAddr = dgLinkList->nextDgAddr;
+	reader->recordIdLength = ((mdfDgDataSection_t*) dg.dataSection)->recordIdLength;
+	reader->layoutCount = 0;
+	reader->blockCount = 0;
+	reader->blockIndex = 0;
+	reader->carrySize = 0;
+
+	if (reader->recordIdLength != 0 && reader->recordIdLength != 1 && reader->recordIdLength != 2 &&
+		reader->recordIdLength != 4)
+	{
+		errno = ERRNO_MDF_LOG_UNRECOGNIZED;
+		return errno;
+	}
+
+	// Learn the layout of each channel group.
+	uint64_t cgAddr = dgLinkList->firstCgAddr;
+	while (cgAddr != 0)
+	{
+		mdfBlock_t cg;
+		if (getBlock (reader, cgAddr, MDF_BLOCK_ID_CG, sizeof (mdfCgLinkList_t) / sizeof (uint64_t),
+			sizeof (mdfCgDataSection_t), &cg) != 0)
+			return errno;
+
+		mdfCanBusReaderLayout_t* layouts = realloc (reader->layouts, sizeof (mdfCanBusReaderLayout_t) *
+			(reader->layoutCount + 1));
+		if (layouts == NULL)
+			return errno;
+		reader->layouts = layouts;
+
+		if (readLayout (reader, &cg, &reader->layouts [reader->layoutCount]) != 0)
+			return errno;
+
+		// Empty records cannot be delimited.
+		if (reader->layouts [reader->layoutCount].size == 0)
+		{
+			errno = ERRNO_MDF_MALFORMED_BLOCK;
+			return errno;
+		}
+
+		++reader->layoutCount;
+
+		cgAddr = mdfCgBlockLinkList (&cg)->nextCgAddr;
+	}
+
+	// Without record IDs, a data group may only contain a single channel group.
+	if (reader->recordIdLength == 0 && reader->layoutCount > 1)
+	{
+		errno = ERRNO_MDF_LOG_UNRECOGNIZED;
+		return errno;
+	}
+
+	// List the data blocks, following the chain of data lists (if any).
+	uint64_t addr = dgLinkList->dataBlockAddr;
+	while (addr != 0)
+	{
+		mdfBlock_t block;
+		if (getBlock (reader, addr, 0, 0, 0, &block) != 0)
+			return errno;
+
+		// Compressed data blocks of unfinalized files are not listed yet, so are walked until the end of the file.
+		if (!reader->finalized && block.header.blockId == MDF_BLOCK_ID_DZ)
+			return appendUnfinalizedBlockAddrs (reader, addr);
+
+		if (block.header.blockId != MDF_BLOCK_ID_DL)
+			return appendBlockAddr (reader, addr);
+
+		if (getBlock (reader, addr, MDF_BLOCK_ID_DL, 1, sizeof (mdfDlDataSection_t), &block) != 0)
+			return errno;
+
+		for (uint64_t index = 0; index < block.header.linkCount - 1; ++index)
+			if (appendBlockAddr (reader, mdfDlBlockDataAddr (&block, index)) != 0)
+				return errno;
+
+		addr = mdfDlBlockNextAddr (&block);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Loads the next data block, moving onto the next data group once the current one is exhausted. Note this replaces the
+ * data of the current block.
+ * @param reader The reader to load into.
+ * @return 0 if successful, the error code otherwise. If there are no more blocks, @c reader->end is set.
+ */
+static int loadNextBlock (mdfCanBusReader_t* reader)
+{
+	free (reader->inflated);
+	reader->inflated = NULL;
+	reader->data = NULL;
+	reader->dataSize = 0;
+	reader->dataOffset = 0;
+
+	while (reader->blockIndex == reader->blockCount)
+	{
+		if (reader->nextDgAddr == 0)
+		{
+			reader->end = true;
+			return 0;
+		}
+
+		if (loadDataGroup (reader, reader->nextDgAddr) != 0)
+			return errno;
+	}
+
+	mdfBlock_t block;
+	if (getBlock (reader, reader->blockAddrs [reader->blockIndex], 0, 0, 0, &block) != 0)
+		return errno;
+	++reader->blockIndex;
+
+	switch (block.header.blockId)
+	{
+	case MDF_BLOCK_ID_DT:
+		reader->data = block.dataSection;
+
+		// Data blocks of unfinalized files do not have a length yet, their data extends to the end of the file.
+		if (block.header.blockLength == sizeof (block.header))
+			reader->dataSize = reader->mapSize - (block.addr + sizeof (block.header));
+		else
+			reader->dataSize = mdfBlockDataSectionSize (&block);
+		return 0;
+
+	case MDF_BLOCK_ID_DZ:
+		if (mdfBlockDataSectionSize (&block) < sizeof (mdfDzDataSection_t))
+		{
+			errno = ERRNO_MDF_MALFORMED_BLOCK;
+			return errno;
+		}
+
+		if (mdfDzBlockInflate (&block, &reader->inflated, &reader->dataSize) != 0)
+		{
+			reader->inflated = NULL;
+			reader->dataSize = 0;
+			return errno;
+		}
+
+		reader->data = reader->inflated;
+		return 0;
+
+	default:
+		errno = ERRNO_MDF_UNSUPPORTED_DATA_BLOCK;
+		return errno;
+	}
+}
+
+/**
+ * @brief Finds the layout of a record.
+ * @param reader The reader to search in.
+ * @param record The record, at least @c reader->recordIdLength bytes.
+ * @return The layout of the record, @c NULL if the record ID is not recognized.
+ */
+static inline mdfCanBusReaderLayout_t* findLayout (mdfCanBusReader_t* reader, const uint8_t* record)
+{
+	uint32_t recordId;
+	switch (reader->recordIdLength)
+	{
+	case 0:
+		return reader->layoutCount != 0 ? &reader->layouts [0] : NULL;
+	case 1:
+		recordId = record [0];
+		break;
+	case 2:
+		recordId = record [0] | record [1] << 8;
+		break;
+	default:
+		recordId = record [0] | record [1] << 8 | record [2] << 16 | (uint32_t) record [3] << 24;
+		break;
+	}
+
+	for (size_t index = 0; index < reader->layoutCount; ++index)
+		if (reader->layouts [index].recordId == recordId)
+			return &reader->layouts [index];
+
+	return NULL;
+}
+
+/**
+ * @brief Reads the value of an unsigned, little-endian field.
+ * @param record The record to read from.
+ * @param field The field to read.
+ * @return The value of the field, 0 if the record does not contain it.
+ */
+static inline uint64_t readField (const uint8_t* record, const mdfCanBusReaderField_t* field)
+{
+	if (field->bitLength == 0)
+		return 0;
+
+	uint64_t value = 0;
+	size_t byteLength = (field->bitOffset + field->bitLength + 7) / 8;
+	for (size_t index = 0; index < byteLength; ++index)
+		value |= (uint64_t) record [field->byteOffset + index] << (index * 8);
+
+	value >>= field->bitOffset;
+	if (field->bitLength < 64)
+		value &= ((uint64_t) 1 << field->bitLength) - 1;
+
+	return value;
+}
+
+/**
+ * @brief Decodes a record.
+ * @param record The record to decode.
+ * @param layout The layout of the record.
+ * @param decoded Buffer to write the decoded record into.
+ */
+static inline void decodeRecord (const uint8_t* record, const mdfCanBusReaderLayout_t* layout, mdfCanBusRecord_t* decoded)
+{
+	uint64_t timestamp = readField (record, &layout->timestamp);
+	if (!layout->timestampNative)
+		timestamp = timestamp * layout->timestampFactorNs + layout->timestampOffsetNs;
+
+	*decoded = (mdfCanBusRecord_t)
+	{
+		.type			= layout->type,
+		.timestampNs	= timestamp,
+		.id				= readField (record, &layout->id),
+		.ide			= readField (record, &layout->ide),
+		.dlc			= readField (record, &layout->dlc),
+		.busChannel		= readField (record, &layout->busChannel),
+		.direction		= readField (record, &layout->direction),
+		.errorType		= readField (record, &layout->errorType),
+		.data			= record + layout->dataBytes.byteOffset
+	};
+}
+
+/**
+ * @brief Completes a record spanning multiple data blocks, whose start is held in the carry buffer.
+ * @param reader The reader to read from.
+ * @param layout Written to the layout of the record, @c NULL if the data ended before the record was completed.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int completeCarry (mdfCanBusReader_t* reader, mdfCanBusReaderLayout_t** layout)
+{
+	while (true)
+	{
+		// Until the record ID is known, only it can be completed.
+		size_t size = reader->recordIdLength;
+		*layout = NULL;
+		if (reader->carrySize >= reader->recordIdLength)
+		{
+			*layout = findLayout (reader, reader->carry);
+			if (*layout == NULL)
+			{
+				errno = ERRNO_MDF_MALFORMED_BLOCK;
+				return errno;
+			}
+
+			size = (*layout)->size;
+			if (reader->carrySize == size)
+				return 0;
+		}
+
+		size_t remaining = reader->dataSize - reader->dataOffset;
+		size_t length = size - reader->carrySize < remaining ? size - reader->carrySize : remaining;
+		memcpy (reader->carry + reader->carrySize, reader->data + reader->dataOffset, length);
+		reader->carrySize += length;
+		reader->dataOffset += length;
+
+		if (reader->carrySize < size)
+		{
+			if (loadNextBlock (reader) != 0)
+				return errno;
+
+			if (reader->end)
+			{
+				*layout = NULL;
+				return 0;
+			}
+		}
+	}
+}
+
+int mdfCanBusReaderInit (mdfCanBusReader_t* reader, const char* path)
+{
+	*reader = (mdfCanBusReader_t) { 0 };
+
+	reader->map = mapFilePort (path, &reader->mapSize);
+	if (reader->map == NULL)
+		return errno;
+
+	// Validate the file ID block.
+	mdfFileIdBlock_t fileIdBlock;
+	if (reader->mapSize < sizeof (fileIdBlock))
+	{
+		mdfCanBusReaderClose (reader);
+		errno = ERRNO_MDF_LOG_UNRECOGNIZED;
+		return errno;
+	}
+	memcpy (&fileIdBlock, reader->map, sizeof (fileIdBlock));
+
+	char finalized [] = MDF_FILE_IDENTIFICATION_FINALIZED;
+	char unfinalized [] = MDF_FILE_IDENTIFICATION_UNFINALIZED;
+	reader->finalized = memcmp (fileIdBlock.fileIdentification, finalized, sizeof (finalized)) == 0;
+	if ((!reader->finalized && memcmp (fileIdBlock.fileIdentification, unfinalized, sizeof (unfinalized)) != 0) ||
+		fileIdBlock.versionString [0] != '4')
+	{
+		mdfCanBusReaderClose (reader);
+		errno = ERRNO_MDF_LOG_UNRECOGNIZED;
+		return errno;
+	}
+
+	// The header block immediately follows the file ID block.
+	mdfBlock_t hd;
+	if (getBlock (reader, sizeof (fileIdBlock), MDF_BLOCK_ID_HD, sizeof (mdfHdLinkList_t) / sizeof (uint64_t),
+		sizeof (mdfHdDataSection_t), &hd) != 0)
+	{
+		int code = errno;
+		mdfCanBusReaderClose (reader);
+		errno = code;
+		return errno;
+	}
+
+	reader->startTimeNs = ((mdfHdDataSection_t*) hd.dataSection)->unixTimeNs;
+	reader->firstDgAddr = mdfHdBlockLinkList (&hd)->firstDgAddr;
+	reader->nextDgAddr = reader->firstDgAddr;
+	return 0;
+}
+
+int mdfCanBusReaderRead (mdfCanBusReader_t* reader, mdfCanBusRecord_t* records, size_t capacity, size_t* count)
+{
+	*count = 0;
+
+	// Only a single record of each batch may reference the carry buffer.
+	bool carryUsed = false;
+
+	while (*count < capacity && !reader->end)
+	{
+		// Decode the complete records of the current block.
+		while (*count < capacity)
+		{
+			size_t remaining = reader->dataSize - reader->dataOffset;
+			if (remaining == 0 || remaining < reader->recordIdLength)
+				break;
+
+			const uint8_t* record = reader->data + reader->dataOffset;
+			mdfCanBusReaderLayout_t* layout = findLayout (reader, record);
+			if (layout == NULL)
+			{
+				// An unfinalized file may end in garbage, if it was interrupted mid-write.
+				if (!reader->finalized)
+				{
+					reader->dataSize = reader->dataOffset;
+					break;
+				}
+
+				errno = ERRNO_MDF_MALFORMED_BLOCK;
+				return errno;
+			}
+
+			if (remaining < layout->size)
+				break;
+
+			if (layout->supported)
+			{
+				decodeRecord (record, layout, &records [*count]);
+				if (records [*count].timestampNs >= reader->skipBeforeNs)
+				{
+					reader->skipBeforeNs = 0;
+					++*count;
+				}
+			}
+
+			reader->dataOffset += layout->size;
+		}
+
+		if (*count == capacity)
+			break;
+
+		// The current block is exhausted, aside from the start of a record continuing into the next block. The batch must end
+		// before replacing data referenced by its records.
+		if (*count != 0 && (reader->inflated != NULL || carryUsed))
+			break;
+
+		reader->carrySize = reader->dataSize - reader->dataOffset;
+		if (reader->carrySize != 0)
+			memcpy (reader->carry, reader->data + reader->dataOffset, reader->carrySize);
+		reader->dataOffset = reader->dataSize;
+
+		if (loadNextBlock (reader) != 0)
+			return errno;
+
+		if (reader->carrySize != 0 && !reader->end)
+		{
+			mdfCanBusReaderLayout_t* layout;
+			if (completeCarry (reader, &layout) != 0)
+				return errno;
+
+			if (layout != NULL && layout->supported)
+			{
+				decodeRecord (reader->carry, layout, &records [*count]);
+				if (records [*count].timestampNs >= reader->skipBeforeNs)
+				{
+					reader->skipBeforeNs = 0;
+					++*count;
+					carryUsed = true;
+				}
+			}
+
+			reader->carrySize = 0;
+		}
+	}
+
+	return 0;
+}
+
+void mdfCanBusReaderTell (mdfCanBusReader_t* reader, mdfCanBusReaderPosition_t* position)
+{
+	// If the current block is exhausted, the next record starts at the beginning of the next block. This avoids loading the
+	// current block when seeking.
+	if (reader->blockIndex == 0 || (reader->dataOffset == reader->dataSize && reader->blockIndex < reader->blockCount))
+	{
+		*position = (mdfCanBusReaderPosition_t)
+		{
+			.dgAddr		= reader->dgAddr,
+			.blockIndex	= reader->blockIndex,
+			.dataOffset	= 0
+		};
+		return;
+	}
+
+	*position = (mdfCanBusReaderPosition_t)
+	{
+		.dgAddr		= reader->dgAddr,
+		.blockIndex	= reader->blockIndex - 1,
+		.dataOffset	= reader->dataOffset
+	};
+}
+
+int mdfCanBusReaderSeek (mdfCanBusReader_t* reader, const mdfCanBusReaderPosition_t* position, uint64_t skipBeforeNs)
+{
+	free (reader->inflated);
+	reader->inflated = NULL;
+	reader->data = NULL;
+	reader->dataSize = 0;
+	reader->dataOffset = 0;
+	reader->carrySize = 0;
+	reader->skipBeforeNs = skipBeforeNs;
+	reader->end = false;
+
+	// Seeking to the start of the file, nothing is loaded until the first read.
+	if (position->dgAddr == 0)
+	{
+		reader->dgAddr = 0;
+		reader->nextDgAddr = reader->firstDgAddr;
+		reader->blockCount = 0;
+		reader->blockIndex = 0;
+		return 0;
+	}
+
+	if (position->dgAddr != reader->dgAddr && loadDataGroup (reader, position->dgAddr) != 0)
+		return errno;
+
+	if (position->blockIndex > reader->blockCount)
+	{
+		errno = EINVAL;
+		return errno;
+	}
+
+	// Load the block containing the position, then move to the record within it.
+	reader->blockIndex = position->blockIndex;
+	if (reader->blockIndex == reader->blockCount)
+		return 0;
+
+	if (loadNextBlock (reader) != 0)
+		return errno;
+
+	if (position->dataOffset > reader->dataSize)
+	{
+		errno = EINVAL;
+		return errno;
+	}
+
+	reader->dataOffset = position->dataOffset;
+	return 0;
+}
+
+void mdfCanBusReaderClose (mdfCanBusReader_t* reader)
+{
+	if (reader->map != NULL)
+		unmapFilePort (reader->map, reader->mapSize);
+
+	free (reader->layouts);
+	free (reader->blockAddrs);
+	free (reader->inflated);
+
+	reader->map = NULL;
+	reader->layouts = NULL;
+	reader->blockAddrs = NULL;
+	reader->inflated = NULL;
+}
@@ -0,0 +1,245 @@
+#ifndef MDF_CAN_BUS_READER_H
+#define MDF_CAN_BUS_READER_H
+
+// MDF CAN Bus Reader ---------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: Streaming reader for MDF CAN bus logs, as written by the MDF CAN bus logging module (or any other logger
+//   implementing the ASAM MDF Bus Logging Standard). The file is memory-mapped, then the HD -> DG -> CG -> CN hierarchy is
+//   walked to learn the layout of each record type. Records are decoded in batches, directly from the mapping.
+//
+//   Records of uncompressed data blocks are never copied. Compressed data blocks are decompressed one at a time, so only a
+//   single block is ever held in memory, regardless of the size of the file.
+//
+// Usage:
+//   mdfCanBusReader_t reader;
+//   mdfCanBusReaderInit (&reader, "split_0.mf4");
+//   mdfCanBusRecord_t records [256];
+//   size_t count;
+//   while (mdfCanBusReaderRead (&reader, records, 256, &count) == 0 && count != 0)
+//     ... records [0 to count - 1] ...
+//   mdfCanBusReaderClose (&reader);
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// C Standard Library
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The maximum size of a record (including its record ID) the reader supports, in bytes.
+#define MDF_CAN_BUS_READER_RECORD_SIZE_MAX (sizeof (uint32_t) + UINT8_MAX)
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The type of frame a record represents.
+typedef enum
+{
+	MDF_CAN_BUS_RECORD_DATA_FRAME	= 0,
+	MDF_CAN_BUS_RECORD_REMOTE_FRAME	= 1,
+	MDF_CAN_BUS_RECORD_ERROR_FRAME	= 2
+} mdfCanBusRecordType_t;
+
+/// @brief A decoded record of a CAN bus log.
+typedef struct
+{
+	/// @brief The type of frame the record represents.
+	mdfCanBusRecordType_t type;
+
+	/// @brief The timestamp of the record, relative to the start of the log, in nanoseconds.
+	uint64_t timestampNs;
+
+	/// @brief The CAN ID of the frame.
+	uint32_t id;
+
+	/// @brief Indicates the frame uses an extended CAN ID.
+	bool ide;
+
+	/// @brief The DLC of the frame.
+	uint8_t dlc;
+
+	/// @brief The CAN bus channel the frame originated from.
+	uint8_t busChannel;
+
+	/// @brief The direction of the frame. False => received, true => transmitted.
+	bool direction;
+
+	/// @brief For error frames, the type of the error, as defined by the ASAM MDF Bus Logging Standard. 0 otherwise.
+	uint8_t errorType;
+
+	/// @brief The payload of the frame, at least @c dlc bytes. Note this references the reader's memory, so it is only valid
+	/// until the next call to @c mdfCanBusReaderRead .
+	const uint8_t* data;
+} mdfCanBusRecord_t;
+
+/// @brief The position of a record within a log, see @c mdfCanBusReaderTell .
+typedef struct
+{
+	/// @brief The address of the record's data group block. 0 indicates the start of the file.
+	uint64_t dgAddr;
+
+	/// @brief The index of the record's data block, within the data group.
+	uint64_t blockIndex;
+
+	/// @brief The offset of the record, within the data block's (uncompressed) data.
+	uint64_t dataOffset;
+} mdfCanBusReaderPosition_t;
+
+/// @brief The location of a channel within a record.
+typedef struct
+{
+	/// @brief The byte offset of the channel, relative to the start of the record (including its record ID).
+	uint16_t byteOffset;
+
+	/// @brief The bit offset of the channel, relative to its byte offset.
+	uint8_t bitOffset;
+
+	/// @brief The length of the channel, in bits. 0 if the record does not contain the channel.
+	uint8_t bitLength;
+} mdfCanBusReaderField_t;
+
+/// @brief The layout of a channel group's records.
+typedef struct
+{
+	/// @brief The record ID of the group.
+	uint32_t recordId;
+
+	/// @brief The size of each record (including its record ID), in bytes.
+	size_t size;
+
+	/// @brief Indicates the group's records are CAN frames. Records of any other group are skipped.
+	bool supported;
+
+	/// @brief The type of frame the group's records represent.
+	mdfCanBusRecordType_t type;
+
+	mdfCanBusReaderField_t timestamp;
+	mdfCanBusReaderField_t id;
+	mdfCanBusReaderField_t ide;
+	mdfCanBusReaderField_t busChannel;
+	mdfCanBusReaderField_t dlc;
+	mdfCanBusReaderField_t direction;
+	mdfCanBusReaderField_t dataBytes;
+	mdfCanBusReaderField_t errorType;
+
+	/// @brief Indicates the raw timestamp is already in nanoseconds, so the below conversion can be skipped.
+	bool timestampNative;
+
+	/// @brief The factor converting a raw timestamp into nanoseconds.
+	double timestampFactorNs;
+
+	/// @brief The offset converting a raw timestamp into nanoseconds.
+	double timestampOffsetNs;
+} mdfCanBusReaderLayout_t;
+
+/// @brief A streaming reader for MDF CAN bus logs. See @c mdfCanBusReaderInit .
+typedef struct
+{
+	/// @brief The memory-mapped contents of the file.
+	const uint8_t* map;
+
+	/// @brief The size of the file, in bytes.
+	size_t mapSize;
+
+	/// @brief Indicates the file has been finalized. Unfinalized files may end in an incomplete record, which is ignored.
+	bool finalized;
+
+	/// @brief The time the log was started, in nanoseconds since the Unix epoch.
+	uint64_t startTimeNs;
+
+	/// @brief The address of the first data group of the file.
+	uint64_t firstDgAddr;
+
+	/// @brief The address of the current data group, 0 if none has been loaded.
+	uint64_t dgAddr;
+
+	/// @brief The address of the next data group to read, 0 if there are no more.
+	uint64_t nextDgAddr;
+
+	/// @brief The length of the current data group's record IDs, in bytes.
+	uint8_t recordIdLength;
+
+	/// @brief The layout of each of the current data group's channel groups.
+	mdfCanBusReaderLayout_t* layouts;
+	size_t layoutCount;
+
+	/// @brief The address of each of the current data group's data blocks, in order.
+	uint64_t* blockAddrs;
+	size_t blockCount;
+	size_t blockCapacity;
+
+	/// @brief The index of the next data block to load.
+	size_t blockIndex;
+
+	/// @brief The data of the current data block.
+	const uint8_t* data;
+	size_t dataSize;
+
+	/// @brief The offset of the next record within @c data .
+	size_t dataOffset;
+
+	/// @brief The decompressed data of the current data block, if it is compressed. @c NULL otherwise.
+	uint8_t* inflated;
+
+	/// @brief Buffer holding a record spanning two data blocks.
+	uint8_t carry [MDF_CAN_BUS_READER_RECORD_SIZE_MAX];
+	size_t carrySize;
+
+	/// @brief Records with timestamps before this are skipped, see @c mdfCanBusReaderSeek .
+	uint64_t skipBeforeNs;
+
+	/// @brief Indicates all data groups have been read.
+	bool end;
+} mdfCanBusReader_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Opens an MDF CAN bus log for reading. Both finalized and unfinalized files are supported.
+ * @param reader The reader to initialize. Must be closed using @c mdfCanBusReaderClose .
+ * @param path The path of the file to read.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusReaderInit (mdfCanBusReader_t* reader, const char* path);
+
+/**
+ * @brief Reads the next batch of records from a log. Records are yielded in the order they are stored in the file. Records
+ * of channel groups that are not CAN frames are skipped.
+ * @param reader The reader to read from.
+ * @param records Buffer to write the records into.
+ * @param capacity The number of elements in @c records .
+ * @param count Written to the number of records read. Note a batch may end before @c records is full, 0 indicates the end of
+ * the file.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusReaderRead (mdfCanBusReader_t* reader, mdfCanBusRecord_t* records, size_t capacity, size_t* count);
+
+/**
+ * @brief Gets the position of the next record to be read.
+ * @param reader The reader to get from.
+ * @param position Buffer to write the position into.
+ */
+void mdfCanBusReaderTell (mdfCanBusReader_t* reader, mdfCanBusReaderPosition_t* position);
+
+/**
+ * @brief Moves a reader to a position previously returned by @c mdfCanBusReaderTell . Only the data block containing the
+ * position is loaded.
+ * @param reader The reader to move.
+ * @param position The position to move to.
+ * @param skipBeforeNs Records are skipped until one with a timestamp at or after this is reached. Since records are stored in
+ * timestamp order, this can be used to refine a coarse position (see @c mdfCanBusIndexSeek ). Use 0 to not skip any records.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusReaderSeek (mdfCanBusReader_t* reader, const mdfCanBusReaderPosition_t* position, uint64_t skipBeforeNs);
+
+/**
+ * @brief Closes a reader, unmapping its file.
+ * @param reader The reader to close.
+ */
+void mdfCanBusReaderClose (mdfCanBusReader_t* reader);
+
+#endif // MDF_CAN_BUS_READER_H
@@ -0,0 +1,459 @@
+// For asprintf. Note this must be the first include in this file.
+#define _GNU_SOURCE
+#include <stdio.h>
+
+// Header
+#include "mdf_can_bus_session_reader.h"
+
+// POSIX
+#include <sys/stat.h>
+
+// C Standard Library
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Checks whether a record of one split precedes a record of another. Records of equal timestamps are ordered by their
+ * splits.
+ */
+static inline bool recordPrecedes (const mdfCanBusRecord_t* a, uint32_t splitA, const mdfCanBusRecord_t* b, uint32_t splitB)
+{
+	return a->timestampNs < b->timestampNs || (a->timestampNs == b->timestampNs && splitA < splitB);
+}
+
+/**
+ * @brief Publishes a batch of a split, making it available to the reader. If the split already has
+ * @c MDF_CAN_BUS_SESSION_READER_BATCH_LIMIT batches waiting to be read, this blocks until the reader retires one.
+ * @param reader The session reader.
+ * @param split The split the batch belongs to.
+ * @param batch The batch to publish. Owned by the reader after this call.
+ * @return True if the reader has been closed, meaning the worker should stop, false otherwise.
+ */
+static bool publishBatch (mdfCanBusSessionReader_t* reader, mdfCanBusSessionSplit_t* split, mdfCanBusSessionBatch_t* batch)
+{
+	pthread_mutex_lock (&reader->mutex);
+
+	while (split->batchCount >= MDF_CAN_BUS_SESSION_READER_BATCH_LIMIT && !reader->stopped)
+		pthread_cond_wait (&reader->batchConsumed, &reader->mutex);
+
+	if (split->tail != NULL)
+		split->tail->next = batch;
+	else
+		split->head = batch;
+	split->tail = batch;
+	++split->batchCount;
+
+	bool stopped = reader->stopped;
+	pthread_cond_signal (&reader->batchAvailable);
+	pthread_mutex_unlock (&reader->mutex);
+	return stopped;
+}
+
+/**
+ * @brief Decodes all records of a split, publishing them in batches.
+ * @param reader The session reader.
+ * @param split The split to decode. Note the split's number is the only member that may be accessed without locking the
+ * reader's mutex.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int decodeSplit (mdfCanBusSessionReader_t* reader, mdfCanBusSessionSplit_t* split)
+{
+	char* path;
+	if (asprintf (&path, "%s/split_%"PRIu32".mf4", reader->directory, split->splitNumber) < 0)
+		return errno;
+
+	mdfCanBusReader_t splitReader;
+	int code = mdfCanBusReaderInit (&splitReader, path);
+	free (path);
+	if (code != 0)
+		return code;
+
+	mdfCanBusSessionBatch_t* batch = NULL;
+	while (true)
+	{
+		if (batch == NULL)
+		{
+			batch = malloc (sizeof (mdfCanBusSessionBatch_t));
+			if (batch == NULL)
+			{
+				code = errno;
+				break;
+			}
+
+			batch->next = NULL;
+			batch->count = 0;
+		}
+
+		// Records are read directly into the batch, then their payloads are copied into it.
+		size_t count;
+		if (mdfCanBusReaderRead (&splitReader, batch->records + batch->count,
+			MDF_CAN_BUS_SESSION_READER_BATCH_SIZE - batch->count, &count) != 0)
+		{
+			code = errno;
+			break;
+		}
+
+		if (count == 0)
+			break;
+
+		for (size_t index = batch->count; index < batch->count + count; ++index)
+		{
+			mdfCanBusRecord_t* record = &batch->records [index];
+			uint8_t* payload = batch->payloads [index];
+
+			size_t size = record->dlc < MDF_CAN_BUS_SESSION_READER_PAYLOAD_SIZE ?
+				record->dlc : MDF_CAN_BUS_SESSION_READER_PAYLOAD_SIZE;
+			memset (payload, 0, MDF_CAN_BUS_SESSION_READER_PAYLOAD_SIZE);
+			if (record->data != NULL)
+				memcpy (payload, record->data, size);
+
+			record->data = payload;
+		}
+		batch->count += count;
+
+		if (batch->count == MDF_CAN_BUS_SESSION_READER_BATCH_SIZE)
+		{
+			bool stopped = publishBatch (reader, split, batch);
+			batch = NULL;
+			if (stopped)
+				break;
+		}
+	}
+
+	// Publish the last, partial batch.
+	if (batch != NULL && batch->count != 0)
+		publishBatch (reader, split, batch);
+	else
+		free (batch);
+
+	mdfCanBusReaderClose (&splitReader);
+	return code;
+}
+
+/// @brief Worker thread decoding the splits of the window, earliest first.
+static void* workerThread (void* arg)
+{
+	mdfCanBusSessionReader_t* reader = arg;
+
+	pthread_mutex_lock (&reader->mutex);
+	while (true)
+	{
+		// Wait for a split that has not been started. Once every split of the session has been started, the worker is done.
+		mdfCanBusSessionSplit_t* split = NULL;
+		while (!reader->stopped)
+		{
+			for (size_t index = 0; index < reader->threadCount; ++index)
+			{
+				mdfCanBusSessionSplit_t* candidate = &reader->splits [index];
+				if (candidate->used && !candidate->started &&
+					(split == NULL || candidate->splitNumber < split->splitNumber))
+					split = candidate;
+			}
+
+			if (split != NULL || reader->nextSplit >= reader->splitCount)
+				break;
+
+			pthread_cond_wait (&reader->splitAvailable, &reader->mutex);
+		}
+
+		if (split == NULL || reader->stopped)
+			break;
+
+		split->started = true;
+		pthread_mutex_unlock (&reader->mutex);
+
+		int code = decodeSplit (reader, split);
+
+		pthread_mutex_lock (&reader->mutex);
+		split->code = code;
+		split->done = true;
+		pthread_cond_signal (&reader->batchAvailable);
+	}
+
+	pthread_mutex_unlock (&reader->mutex);
+	return NULL;
+}
+
+/**
+ * @brief Frees a list of batches.
+ * @param batch The first batch of the list.
+ */
+static void freeBatches (mdfCanBusSessionBatch_t* batch)
+{
+	while (batch != NULL)
+	{
+		mdfCanBusSessionBatch_t* next = batch->next;
+		free (batch);
+		batch = next;
+	}
+}
+
+/**
+ * @brief Moves a split onto the next batch if its current one has been completely read. The read batch is retired.
+ * @param reader The session reader. Note the mutex must be locked.
+ * @param split The split to advance.
+ */
+static void advanceSplit (mdfCanBusSessionReader_t* reader, mdfCanBusSessionSplit_t* split)
+{
+	// Note the last batch is kept until the split is done, as the worker may still be linking onto it.
+	bool retired = false;
+	while (split->head != NULL && split->index == split->head->count && split->head->next != NULL)
+	{
+		mdfCanBusSessionBatch_t* batch = split->head;
+		split->head = batch->next;
+		split->index = 0;
+		--split->batchCount;
+
+		batch->next = reader->retired;
+		reader->retired = batch;
+		retired = true;
+	}
+
+	// Wake the split's worker, should it be waiting for space. Note the workers share the condition.
+	if (retired)
+		pthread_cond_broadcast (&reader->batchConsumed);
+}
+
+/**
+ * @brief Removes a completely read split from the window, putting the next split of the session in its place.
+ * @param reader The session reader. Note the mutex must be locked.
+ * @param split The split to remove.
+ */
+static void releaseSplit (mdfCanBusSessionReader_t* reader, mdfCanBusSessionSplit_t* split)
+{
+	if (split->head != NULL)
+	{
+		split->head->next = reader->retired;
+		reader->retired = split->head;
+	}
+
+	*split = (mdfCanBusSessionSplit_t) { 0 };
+	if (reader->nextSplit < reader->splitCount)
+	{
+		split->used = true;
+		split->splitNumber = reader->nextSplit;
+		++reader->nextSplit;
+	}
+
+	// Wake the workers either way, as they exit once every split has been started.
+	pthread_cond_broadcast (&reader->splitAvailable);
+}
+
+int mdfCanBusSessionReaderInit (mdfCanBusSessionReader_t* reader, const char* directory, size_t threadCount)
+{
+	if (threadCount == 0)
+	{
+		errno = EINVAL;
+		return errno;
+	}
+
+	*reader = (mdfCanBusSessionReader_t) { 0 };
+	if (asprintf (&reader->directory, "%s", directory) < 0)
+		return errno;
+
+	// Count the splits of the session, it ends at the first missing split.
+	while (true)
+	{
+		char* path;
+		if (asprintf (&path, "%s/split_%"PRIu32".mf4", directory, reader->splitCount) < 0)
+		{
+			int code = errno;
+			free (reader->directory);
+			errno = code;
+			return errno;
+		}
+
+		struct stat splitStat;
+		int code = stat (path, &splitStat) == 0 ? 0 : errno;
+		free (path);
+		if (code == ENOENT)
+			break;
+
+		if (code != 0)
+		{
+			free (reader->directory);
+			errno = code;
+			return errno;
+		}
+
+		++reader->splitCount;
+	}
+
+	// No more workers than splits are needed.
+	if (threadCount > reader->splitCount)
+		threadCount = reader->splitCount;
+	reader->threadCount = threadCount;
+
+	reader->splits = calloc (threadCount, sizeof (mdfCanBusSessionSplit_t));
+	reader->threads = malloc (sizeof (pthread_t) * threadCount);
+	if (threadCount != 0 && (reader->splits == NULL || reader->threads == NULL))
+	{
+		int code = errno;
+		free (reader->splits);
+		free (reader->threads);
+		free (reader->directory);
+		errno = code;
+		return errno;
+	}
+
+	// Fill the window with the first splits of the session.
+	for (size_t index = 0; index < threadCount; ++index)
+	{
+		reader->splits [index].used = true;
+		reader->splits [index].splitNumber = reader->nextSplit;
+		++reader->nextSplit;
+	}
+
+	pthread_mutex_init (&reader->mutex, NULL);
+	pthread_cond_init (&reader->splitAvailable, NULL);
+	pthread_cond_init (&reader->batchAvailable, NULL);
+	pthread_cond_init (&reader->batchConsumed, NULL);
+
+	for (size_t index = 0; index < threadCount; ++index)
+	{
+		int code = pthread_create (&reader->threads [index], NULL, workerThread, reader);
+		if (code != 0)
+		{
+			// Stop the workers that were started.
+			pthread_mutex_lock (&reader->mutex);
+			reader->threadCount = index;
+			pthread_mutex_unlock (&reader->mutex);
+			mdfCanBusSessionReaderClose (reader);
+			errno = code;
+			return errno;
+		}
+	}
+
+	return 0;
+}
+
+int mdfCanBusSessionReaderRead (mdfCanBusSessionReader_t* reader, mdfCanBusRecord_t* records, size_t capacity, size_t* count)
+{
+	*count = 0;
+
+	// The records of the previous call are no longer referenced.
+	freeBatches (reader->retired);
+	reader->retired = NULL;
+
+	pthread_mutex_lock (&reader->mutex);
+	while (*count < capacity)
+	{
+		// Find the split holding the earliest record, along with the earliest record of any other split. If a split has no
+		// records available yet, its next record is unknown, so nothing can be yielded until it does.
+		mdfCanBusSessionSplit_t* first = NULL;
+		mdfCanBusSessionSplit_t* second = NULL;
+		bool blocked = false;
+
+		for (size_t index = 0; index < reader->threadCount; ++index)
+		{
+			mdfCanBusSessionSplit_t* split = &reader->splits [index];
+			if (!split->used)
+				continue;
+
+			advanceSplit (reader, split);
+			if (split->head == NULL || split->index == split->head->count)
+			{
+				if (!split->done)
+				{
+					blocked = true;
+					break;
+				}
+
+				if (split->code != 0)
+				{
+					int code = split->code;
+					pthread_mutex_unlock (&reader->mutex);
+					errno = code;
+					return errno;
+				}
+
+				// The split has been completely read, replace it with the next split. Note the replacement has no records
+				// yet.
+				releaseSplit (reader, split);
+				if (split->used)
+				{
+					blocked = true;
+					break;
+				}
+
+				continue;
+			}
+
+			const mdfCanBusRecord_t* record = &split->head->records [split->index];
+			if (first == NULL || recordPrecedes (record, split->splitNumber, &first->head->records [first->index],
+				first->splitNumber))
+			{
+				second = first;
+				first = split;
+			}
+			else if (second == NULL || recordPrecedes (record, split->splitNumber, &second->head->records [second->index],
+				second->splitNumber))
+			{
+				second = split;
+			}
+		}
+
+		if (blocked)
+		{
+			// Don't hold onto records already read while waiting.
+			if (*count != 0)
+				break;
+
+			pthread_cond_wait (&reader->batchAvailable, &reader->mutex);
+			continue;
+		}
+
+		// End of the session.
+		if (first == NULL)
+			break;
+
+		// Yield records of the first split until reaching the earliest record of the others (or the end of the batch). As
+		// the splits are mostly disjoint in time, this is typically the entire batch. Note the batch cannot be modified by the
+		// worker, so the mutex need not be held.
+		pthread_mutex_unlock (&reader->mutex);
+
+		const mdfCanBusSessionBatch_t* batch = first->head;
+		const mdfCanBusRecord_t* bound = second != NULL ? &second->head->records [second->index] : NULL;
+		do
+		{
+			records [*count] = batch->records [first->index];
+			++*count;
+			++first->index;
+		} while (*count < capacity && first->index < batch->count && (bound == NULL ||
+			recordPrecedes (&batch->records [first->index], first->splitNumber, bound, second->splitNumber)));
+
+		pthread_mutex_lock (&reader->mutex);
+	}
+
+	pthread_mutex_unlock (&reader->mutex);
+	return 0;
+}
+
+void mdfCanBusSessionReaderClose (mdfCanBusSessionReader_t* reader)
+{
+	pthread_mutex_lock (&reader->mutex);
+	reader->stopped = true;
+	pthread_cond_broadcast (&reader->splitAvailable);
+	pthread_cond_broadcast (&reader->batchConsumed);
+	pthread_mutex_unlock (&reader->mutex);
+
+	for (size_t index = 0; index < reader->threadCount; ++index)
+		pthread_join (reader->threads [index], NULL);
+
+	for (size_t index = 0; index < reader->threadCount; ++index)
+		freeBatches (reader->splits [index].head);
+	freeBatches (reader->retired);
+
+	pthread_mutex_destroy (&reader->mutex);
+	pthread_cond_destroy (&reader->splitAvailable);
+	pthread_cond_destroy (&reader->batchAvailable);
+	pthread_cond_destroy (&reader->batchConsumed);
+
+	free (reader->splits);
+	free (reader->threads);
+	free (reader->directory);
+}
@@ -0,0 +1,168 @@
+#ifndef MDF_CAN_BUS_SESSION_READER_H
+#define MDF_CAN_BUS_SESSION_READER_H
+
+// MDF CAN Bus Session Reader -------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: Reader yielding the records of an entire MDF CAN bus log session (all of its splits) as a single, time-ordered
+//   stream. Splits are decoded in parallel by a pool of worker threads, each worker decoding a split into batches of records.
+//   The decoded batches are then merged (k-way) by timestamp as they are read.
+//
+//   Only a window of splits is decoded at once, one per worker thread. Once every record of a split has been read, the next
+//   split of the session takes its place. As the splits of a session are consecutive in time, only overlapping near their
+//   boundaries (ex. records of multiple channels being written slightly out of order), this is sufficient to order the entire
+//   session. A worker only decodes up to @c MDF_CAN_BUS_SESSION_READER_BATCH_LIMIT batches ahead of the reader, waiting for
+//   them to be read before continuing, so memory usage is bounded regardless of the size of the splits.
+//
+// Usage:
+//   mdfCanBusSessionReader_t reader;
+//   mdfCanBusSessionReaderInit (&reader, "logs/session_3", 4);
+//   mdfCanBusRecord_t records [256];
+//   size_t count;
+//   while (mdfCanBusSessionReaderRead (&reader, records, 256, &count) == 0 && count != 0)
+//     ... records [0 to count - 1] ...
+//   mdfCanBusSessionReaderClose (&reader);
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "mdf_can_bus_reader.h"
+
+// POSIX
+#include <pthread.h>
+
+// C Standard Library
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of records in each batch decoded by a worker.
+#define MDF_CAN_BUS_SESSION_READER_BATCH_SIZE 4096
+
+/// @brief The number of batches of a split that may be decoded but not yet read. Once reached, the split's worker waits for
+/// the reader. Must be at least 2, as the last batch of a split is kept until the split is done.
+#define MDF_CAN_BUS_SESSION_READER_BATCH_LIMIT 8
+
+/// @brief The maximum size of a record's payload, in bytes.
+#define MDF_CAN_BUS_SESSION_READER_PAYLOAD_SIZE 8
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief A batch of decoded records. The payload of each record is copied into the batch, as the memory of the split's
+/// reader does not outlive the worker.
+typedef struct mdfCanBusSessionBatch
+{
+	/// @brief The next batch of the split, @c NULL if this is the last one decoded so far.
+	struct mdfCanBusSessionBatch* next;
+
+	/// @brief The records of the batch. The data of each record references @c payloads .
+	mdfCanBusRecord_t records [MDF_CAN_BUS_SESSION_READER_BATCH_SIZE];
+	size_t count;
+
+	/// @brief The payload of each record.
+	uint8_t payloads [MDF_CAN_BUS_SESSION_READER_BATCH_SIZE][MDF_CAN_BUS_SESSION_READER_PAYLOAD_SIZE];
+} mdfCanBusSessionBatch_t;
+
+/// @brief A split of the window being decoded.
+typedef struct
+{
+	/// @brief Indicates the slot holds a split.
+	bool used;
+
+	/// @brief Indicates a worker has started decoding the split.
+	bool started;
+
+	/// @brief Indicates the worker has finished decoding the split, that is, all of its batches have been published.
+	bool done;
+
+	/// @brief If decoding the split failed, the error code, 0 otherwise.
+	int code;
+
+	/// @brief The number of the split.
+	uint32_t splitNumber;
+
+	/// @brief The first batch of the split that has not been completely read. @c NULL if no batch has been published.
+	mdfCanBusSessionBatch_t* head;
+
+	/// @brief The last batch published by the worker.
+	mdfCanBusSessionBatch_t* tail;
+
+	/// @brief The number of batches from @c head to @c tail , inclusive.
+	size_t batchCount;
+
+	/// @brief The index of the next record to read within @c head .
+	size_t index;
+} mdfCanBusSessionSplit_t;
+
+/// @brief A reader for an entire MDF CAN bus log session. See @c mdfCanBusSessionReaderInit .
+typedef struct
+{
+	/// @brief The directory of the session.
+	char* directory;
+
+	/// @brief The number of splits in the session.
+	uint32_t splitCount;
+
+	/// @brief The number of the next split to enter the window.
+	uint32_t nextSplit;
+
+	/// @brief The window of splits being decoded, one per worker.
+	mdfCanBusSessionSplit_t* splits;
+
+	/// @brief The worker threads.
+	pthread_t* threads;
+	size_t threadCount;
+
+	/// @brief Mutex protecting the state of the window, shared by the workers and the reader.
+	pthread_mutex_t mutex;
+
+	/// @brief Signalled when a split enters the window (or the reader is closed).
+	pthread_cond_t splitAvailable;
+
+	/// @brief Signalled when a worker publishes a batch or finishes a split.
+	pthread_cond_t batchAvailable;
+
+	/// @brief Signalled when the reader retires a batch (or the reader is closed).
+	pthread_cond_t batchConsumed;
+
+	/// @brief Set to stop the workers.
+	bool stopped;
+
+	/// @brief Batches that have been completely read. Freed on the next read, as the caller may still be using their records.
+	mdfCanBusSessionBatch_t* retired;
+} mdfCanBusSessionReader_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Opens an MDF CAN bus log session for reading, starting the worker threads decoding its splits.
+ * @param reader The reader to initialize. Must be closed using @c mdfCanBusSessionReaderClose .
+ * @param directory The directory of the session (ex. 'logs/session_3'). The session ends at the first missing split.
+ * @param threadCount The number of worker threads. Must be at least 1.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusSessionReaderInit (mdfCanBusSessionReader_t* reader, const char* directory, size_t threadCount);
+
+/**
+ * @brief Reads the next batch of records from a session, in timestamp order. Records of equal timestamps are yielded in the
+ * order of their splits. See @c mdfCanBusReaderRead for details.
+ * @param reader The reader to read from.
+ * @param records Buffer to write the records into. The data of each record is only valid until the next call.
+ * @param capacity The number of elements in @c records .
+ * @param count Written to the number of records read. Note a batch may end before @c records is full, 0 indicates the end of
+ * the session.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusSessionReaderRead (mdfCanBusSessionReader_t* reader, mdfCanBusRecord_t* records, size_t capacity, size_t* count);
+
+/**
+ * @brief Closes a session reader, stopping its worker threads.
+ * @param reader The reader to close.
+ */
+void mdfCanBusSessionReaderClose (mdfCanBusSessionReader_t* reader);
+
+#endif // MDF_CAN_BUS_SESSION_READER_H
@@ -0,0 +1,300 @@
+// Header
+#include "mdf_can_bus_stats.h"
+
+// C Standard Library
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The initial capacity of the ID table. Must be a power of 2.
+#define ID_TABLE_CAPACITY_INITIAL 256
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+static inline uint64_t idKey (uint32_t id, bool ide, uint8_t busChannel)
+{
+	return ((uint64_t) busChannel << 33) | ((uint64_t) ide << 32) | id;
+}
+
+static inline size_t hashKey (uint64_t key, size_t tableMask)
+{
+	// Multiplicative hash, IDs are often consecutive.
+	return (size_t) ((key * 0x9E3779B97F4A7C15ull) >> 32) & tableMask;
+}
+
+/**
+ * @brief Doubles the capacity of the ID table, re-inserting its entries.
+ * @param stats The statistics to grow the table of.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int growIdTable (mdfCanBusStats_t* stats)
+{
+	size_t capacity = (stats->tableMask + 1) * 2;
+	mdfCanBusIdStats_t* ids = calloc (capacity, sizeof (mdfCanBusIdStats_t));
+	if (ids == NULL)
+		return errno;
+
+	for (size_t index = 0; index <= stats->tableMask; ++index)
+	{
+		mdfCanBusIdStats_t* idStats = &stats->ids [index];
+		if (idStats->frameCount == 0)
+			continue;
+
+		size_t slot = hashKey (idKey (idStats->id, idStats->ide, idStats->busChannel), capacity - 1);
+		while (ids [slot].frameCount != 0)
+			slot = (slot + 1) & (capacity - 1);
+		ids [slot] = *idStats;
+	}
+
+	free (stats->ids);
+	stats->ids = ids;
+	stats->tableMask = capacity - 1;
+	return 0;
+}
+
+/**
+ * @brief Finds the statistics of an ID, inserting them if not present.
+ * @param stats The statistics to search.
+ * @param record The record of the ID.
+ * @return The statistics of the ID, @c NULL if they could not be inserted.
+ */
+static mdfCanBusIdStats_t* findIdStats (mdfCanBusStats_t* stats, const mdfCanBusRecord_t* record)
+{
+	// Keep the table at most half full.
+	if ((stats->idCount + 1) * 2 > stats->tableMask + 1 && growIdTable (stats) != 0)
+		return NULL;
+
+	uint64_t key = idKey (record->id, record->ide, record->busChannel);
+	size_t slot = hashKey (key, stats->tableMask);
+	while (true)
+	{
+		mdfCanBusIdStats_t* idStats = &stats->ids [slot];
+		if (idStats->frameCount == 0)
+		{
+			*idStats = (mdfCanBusIdStats_t)
+			{
+				.id				= record->id,
+				.ide			= record->ide,
+				.busChannel		= record->busChannel,
+				.intervalMinNs	= UINT64_MAX,
+				.dlc			= record->dlc,
+				.dlcMin			= record->dlc,
+				.dlcMax			= record->dlc
+			};
+			++stats->idCount;
+			return idStats;
+		}
+
+		if (idKey (idStats->id, idStats->ide, idStats->busChannel) == key)
+			return idStats;
+
+		slot = (slot + 1) & stats->tableMask;
+	}
+}
+
+/**
+ * @brief Gets the histogram bucket of an inter-arrival time.
+ * @param intervalNs The inter-arrival time, in nanoseconds.
+ * @return The index of the bucket.
+ */
+static inline size_t getHistogramBucket (uint64_t intervalNs)
+{
+	uint64_t intervalUs = intervalNs / 1000;
+	if (intervalUs < 2)
+		return 0;
+
+	// Floor of log2.
+	size_t bucket = 63 - __builtin_clzll (intervalUs);
+	return bucket < MDF_CAN_BUS_STATS_HISTOGRAM_SIZE ? bucket : MDF_CAN_BUS_STATS_HISTOGRAM_SIZE - 1;
+}
+
+/**
+ * @brief Adds an inter-arrival time to the statistics of an ID.
+ * @param stats The statistics the ID belongs to.
+ * @param idStats The statistics of the ID.
+ * @param intervalNs The inter-arrival time, in nanoseconds.
+ */
+static void addInterval (mdfCanBusStats_t* stats, mdfCanBusIdStats_t* idStats, uint64_t intervalNs)
+{
+	// Gaps are judged against the mean of the preceding intervals, once it has settled.
+	if (idStats->intervalCount >= stats->config.gapWarmup &&
+		intervalNs > stats->config.gapFactor * idStats->intervalMeanNs)
+	{
+		++idStats->gapCount;
+
+		// The frames missed are those that would have fit into the gap, at the mean rate.
+		uint64_t missedCount = (uint64_t) (intervalNs / idStats->intervalMeanNs + 0.5);
+		if (missedCount > 1)
+			idStats->missedCount += missedCount - 1;
+
+		if (stats->config.gapCallback != NULL)
+			stats->config.gapCallback (stats, idStats, idStats->lastTimestampNs, intervalNs, stats->config.arg);
+	}
+
+	// Welford's method.
+	++idStats->intervalCount;
+	double delta = intervalNs - idStats->intervalMeanNs;
+	idStats->intervalMeanNs += delta / idStats->intervalCount;
+	idStats->intervalM2 += delta * (intervalNs - idStats->intervalMeanNs);
+
+	if (intervalNs < idStats->intervalMinNs)
+		idStats->intervalMinNs = intervalNs;
+
+	if (intervalNs > idStats->intervalMaxNs)
+	{
+		idStats->intervalMaxNs = intervalNs;
+		idStats->intervalMaxStartNs = idStats->lastTimestampNs;
+	}
+
+	++idStats->histogram [getHistogramBucket (intervalNs)];
+}
+
+/**
+ * @brief Ends the current run of error frames of a bus, counting it if it forms a burst.
+ * @param stats The statistics the bus belongs to.
+ * @param errors The error frame statistics of the bus.
+ */
+static void endErrorRun (mdfCanBusStats_t* stats, mdfCanBusErrorStats_t* errors)
+{
+	if (errors->runCount >= stats->config.burstMin)
+	{
+		++errors->burstCount;
+		if (errors->runCount > errors->longestBurstCount)
+		{
+			errors->longestBurstCount = errors->runCount;
+			errors->longestBurstStartNs = errors->runStartNs;
+			errors->longestBurstDurationNs = errors->lastTimestampNs - errors->runStartNs;
+		}
+	}
+
+	errors->runCount = 0;
+}
+
+/**
+ * @brief Adds an error frame to the statistics of its bus.
+ * @param stats The statistics to add to.
+ * @param record The error frame.
+ */
+static void addErrorFrame (mdfCanBusStats_t* stats, const mdfCanBusRecord_t* record)
+{
+	size_t busIndex = record->busChannel < MDF_CAN_BUS_STATS_BUS_COUNT ? record->busChannel : MDF_CAN_BUS_STATS_BUS_COUNT - 1;
+	mdfCanBusErrorStats_t* errors = &stats->errors [busIndex];
+
+	++errors->errorFrameCount;
+
+	// Error frames closer together than the burst gap form a run.
+	if (errors->runCount != 0 && record->timestampNs > errors->lastTimestampNs + stats->config.burstGapNs)
+		endErrorRun (stats, errors);
+
+	if (errors->runCount == 0)
+		errors->runStartNs = record->timestampNs;
+	++errors->runCount;
+	errors->lastTimestampNs = record->timestampNs;
+}
+
+int mdfCanBusStatsInit (mdfCanBusStats_t* stats, const mdfCanBusStatsConfig_t* config)
+{
+	*stats = (mdfCanBusStats_t)
+	{
+		.config		= *config,
+		.idCount	= 0,
+		.tableMask	= ID_TABLE_CAPACITY_INITIAL - 1,
+		.errors		= {{0}},
+		.finished	= false
+	};
+
+	if (stats->config.gapFactor == 0)
+		stats->config.gapFactor = MDF_CAN_BUS_STATS_GAP_FACTOR_DEFAULT;
+	if (stats->config.gapWarmup == 0)
+		stats->config.gapWarmup = MDF_CAN_BUS_STATS_GAP_WARMUP_DEFAULT;
+	if (stats->config.burstGapNs == 0)
+		stats->config.burstGapNs = MDF_CAN_BUS_STATS_BURST_GAP_DEFAULT;
+	if (stats->config.burstMin == 0)
+		stats->config.burstMin = MDF_CAN_BUS_STATS_BURST_MIN_DEFAULT;
+
+	stats->ids = calloc (ID_TABLE_CAPACITY_INITIAL, sizeof (mdfCanBusIdStats_t));
+	if (stats->ids == NULL)
+		return errno;
+
+	return 0;
+}
+
+int mdfCanBusStatsAddRecord (mdfCanBusStats_t* stats, const mdfCanBusRecord_t* record)
+{
+	if (stats->recordCount == 0 || record->timestampNs < stats->firstTimestampNs)
+		stats->firstTimestampNs = record->timestampNs;
+	if (stats->recordCount == 0 || record->timestampNs > stats->lastTimestampNs)
+		stats->lastTimestampNs = record->timestampNs;
+	++stats->recordCount;
+
+	if (record->type == MDF_CAN_BUS_RECORD_ERROR_FRAME)
+	{
+		addErrorFrame (stats, record);
+		return 0;
+	}
+
+	mdfCanBusIdStats_t* idStats = findIdStats (stats, record);
+	if (idStats == NULL)
+		return errno;
+
+	if (idStats->frameCount == 0)
+		idStats->firstTimestampNs = record->timestampNs;
+	else if (record->timestampNs < idStats->lastTimestampNs)
+		++stats->reorderedCount;
+	else
+		addInterval (stats, idStats, record->timestampNs - idStats->lastTimestampNs);
+
+	++idStats->frameCount;
+	if (record->type == MDF_CAN_BUS_RECORD_REMOTE_FRAME)
+		++idStats->remoteCount;
+
+	if (record->timestampNs >= idStats->lastTimestampNs)
+		idStats->lastTimestampNs = record->timestampNs;
+
+	if (record->dlc != idStats->dlc)
+	{
+		++idStats->dlcChangeCount;
+		idStats->dlc = record->dlc;
+		if (record->dlc < idStats->dlcMin)
+			idStats->dlcMin = record->dlc;
+		if (record->dlc > idStats->dlcMax)
+			idStats->dlcMax = record->dlc;
+	}
+
+	return 0;
+}
+
+static int compareIdStats (const void* a, const void* b)
+{
+	const mdfCanBusIdStats_t* statsA = a;
+	const mdfCanBusIdStats_t* statsB = b;
+	uint64_t keyA = idKey (statsA->id, statsA->ide, statsA->busChannel);
+	uint64_t keyB = idKey (statsB->id, statsB->ide, statsB->busChannel);
+	return (keyA > keyB) - (keyA < keyB);
+}
+
+void mdfCanBusStatsFinish (mdfCanBusStats_t* stats)
+{
+	if (stats->finished)
+		return;
+	stats->finished = true;
+
+	for (size_t index = 0; index < MDF_CAN_BUS_STATS_BUS_COUNT; ++index)
+		if (stats->errors [index].runCount != 0)
+			endErrorRun (stats, &stats->errors [index]);
+
+	// Compact the used entries, then order them.
+	size_t count = 0;
+	for (size_t index = 0; index <= stats->tableMask; ++index)
+		if (stats->ids [index].frameCount != 0)
+			stats->ids [count++] = stats->ids [index];
+	qsort (stats->ids, count, sizeof (mdfCanBusIdStats_t), compareIdStats);
+}
+
+void mdfCanBusStatsDealloc (mdfCanBusStats_t* stats)
+{
+	free (stats->ids);
+	stats->ids = NULL;
+}
@@ -0,0 +1,236 @@
+#ifndef MDF_CAN_BUS_STATS_H
+#define MDF_CAN_BUS_STATS_H
+
+// MDF CAN Bus Statistics -----------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: Streaming statistics of CAN bus traffic, computed in a single pass over time-ordered records (ex. those of
+//   @c mdfCanBusSessionReaderRead , or frames received live). For each CAN ID (per bus channel), the frame count, the mean,
+//   jitter (standard deviation), minimum and maximum of the inter-arrival time, a histogram of the inter-arrival time, gaps
+//   (likely dropped frames), and DLC changes are tracked. For each bus channel, error frames are grouped into bursts.
+//
+//   Memory is constant per CAN ID: no record is retained. The inter-arrival mean and variance are accumulated using Welford's
+//   method, so they remain accurate over arbitrarily long logs.
+//
+//   A gap is an inter-arrival time exceeding a multiple (the gap factor) of the ID's mean inter-arrival time thus far. The
+//   number of frames missed during a gap is estimated from the mean.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "mdf_can_bus_reader.h"
+
+// C Standard Library
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of buckets of an inter-arrival time histogram. Bucket N counts the intervals in the range
+/// [2^N, 2^(N+1)) microseconds, except the first, which includes all intervals below 2 us, and the last, which includes all
+/// intervals of at least 2^(MDF_CAN_BUS_STATS_HISTOGRAM_SIZE - 1) us (about 8.4 s).
+#define MDF_CAN_BUS_STATS_HISTOGRAM_SIZE		24
+
+/// @brief The number of bus channels tracked. Records of greater bus channels are counted towards the last.
+#define MDF_CAN_BUS_STATS_BUS_COUNT				4
+
+/// @brief The default gap factor, see @c mdfCanBusStatsConfig_t.gapFactor .
+#define MDF_CAN_BUS_STATS_GAP_FACTOR_DEFAULT	2.5f
+
+/// @brief The default number of intervals before gaps are detected, see @c mdfCanBusStatsConfig_t.gapWarmup .
+#define MDF_CAN_BUS_STATS_GAP_WARMUP_DEFAULT	8
+
+/// @brief The default maximum time between the error frames of a burst, in nanoseconds.
+#define MDF_CAN_BUS_STATS_BURST_GAP_DEFAULT		10000000
+
+/// @brief The default minimum number of error frames forming a burst.
+#define MDF_CAN_BUS_STATS_BURST_MIN_DEFAULT		3
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The statistics of a CAN ID.
+typedef struct
+{
+	uint32_t id;
+	bool ide;
+	uint8_t busChannel;
+
+	/// @brief The number of data / remote frames of the ID. 0 indicates an unused slot of the statistics' table.
+	uint64_t frameCount;
+
+	/// @brief The number of remote frames of the ID.
+	uint64_t remoteCount;
+
+	/// @brief The timestamps of the first and last frames of the ID, in nanoseconds.
+	uint64_t firstTimestampNs;
+	uint64_t lastTimestampNs;
+
+	/// @brief The number of inter-arrival times measured.
+	uint64_t intervalCount;
+
+	/// @brief The mean inter-arrival time, in nanoseconds.
+	double intervalMeanNs;
+
+	/// @brief The sum of squared differences from the mean inter-arrival time (Welford's M2), see
+	/// @c mdfCanBusIdStatsGetJitterNs .
+	double intervalM2;
+
+	/// @brief The minimum and maximum inter-arrival times, in nanoseconds. Note the maximum is the longest gap.
+	uint64_t intervalMinNs;
+	uint64_t intervalMaxNs;
+
+	/// @brief The timestamp at which the longest gap started (that is, of the frame preceding it), in nanoseconds.
+	uint64_t intervalMaxStartNs;
+
+	/// @brief The number of gaps detected.
+	uint64_t gapCount;
+
+	/// @brief The estimated number of frames missed during gaps.
+	uint64_t missedCount;
+
+	/// @brief The DLC of the last frame, along with the minimum and maximum DLCs.
+	uint8_t dlc;
+	uint8_t dlcMin;
+	uint8_t dlcMax;
+
+	/// @brief The number of times the DLC differed from that of the previous frame.
+	uint64_t dlcChangeCount;
+
+	/// @brief Histogram of the inter-arrival times, see @c MDF_CAN_BUS_STATS_HISTOGRAM_SIZE .
+	uint32_t histogram [MDF_CAN_BUS_STATS_HISTOGRAM_SIZE];
+} mdfCanBusIdStats_t;
+
+/// @brief The error frame statistics of a bus channel.
+typedef struct
+{
+	uint64_t errorFrameCount;
+
+	/// @brief The number of bursts of error frames.
+	uint64_t burstCount;
+
+	/// @brief The number of error frames, start timestamp and duration of the longest burst, in nanoseconds.
+	uint64_t longestBurstCount;
+	uint64_t longestBurstStartNs;
+	uint64_t longestBurstDurationNs;
+
+	/// @brief The number of error frames and start timestamp of the current run of error frames.
+	uint64_t runCount;
+	uint64_t runStartNs;
+
+	/// @brief The timestamp of the last error frame, in nanoseconds.
+	uint64_t lastTimestampNs;
+} mdfCanBusErrorStats_t;
+
+struct mdfCanBusStats;
+
+/**
+ * @brief Function called when a gap is detected.
+ * @param stats The statistics the gap was detected by.
+ * @param idStats The statistics of the ID the gap was detected in.
+ * @param startNs The timestamp of the frame preceding the gap, in nanoseconds.
+ * @param durationNs The duration of the gap, in nanoseconds.
+ * @param arg The user argument of the statistics' configuration.
+ */
+typedef void mdfCanBusStatsGapCallback_t (struct mdfCanBusStats* stats, const mdfCanBusIdStats_t* idStats, uint64_t startNs,
+	uint64_t durationNs, void* arg);
+
+typedef struct
+{
+	/// @brief The multiple of an ID's mean inter-arrival time above which an interval is a gap. Use 0 for the default
+	/// (@c MDF_CAN_BUS_STATS_GAP_FACTOR_DEFAULT ).
+	float gapFactor;
+
+	/// @brief The number of intervals of an ID before gaps are detected in it, so the mean has settled. Use 0 for the
+	/// default (@c MDF_CAN_BUS_STATS_GAP_WARMUP_DEFAULT ).
+	size_t gapWarmup;
+
+	/// @brief The maximum time between the error frames of a burst, in nanoseconds. Use 0 for the default
+	/// (@c MDF_CAN_BUS_STATS_BURST_GAP_DEFAULT ).
+	uint64_t burstGapNs;
+
+	/// @brief The minimum number of error frames forming a burst. Use 0 for the default
+	/// (@c MDF_CAN_BUS_STATS_BURST_MIN_DEFAULT ).
+	size_t burstMin;
+
+	/// @brief Function called when a gap is detected, @c NULL if not used.
+	mdfCanBusStatsGapCallback_t* gapCallback;
+
+	/// @brief User argument to pass to @c gapCallback .
+	void* arg;
+} mdfCanBusStatsConfig_t;
+
+/// @brief Streaming statistics of CAN bus traffic, see @c mdfCanBusStatsInit .
+typedef struct mdfCanBusStats
+{
+	mdfCanBusStatsConfig_t config;
+
+	/// @brief Open-addressing hash table of the ID statistics. Once finished, the used entries are compacted to the start of
+	/// the table, in order of bus channel, IDE, then ID.
+	mdfCanBusIdStats_t* ids;
+	size_t idCount;
+	size_t tableMask;
+
+	/// @brief The error frame statistics of each bus channel.
+	mdfCanBusErrorStats_t errors [MDF_CAN_BUS_STATS_BUS_COUNT];
+
+	/// @brief The number of records, along with the timestamps of the first and last records, in nanoseconds.
+	uint64_t recordCount;
+	uint64_t firstTimestampNs;
+	uint64_t lastTimestampNs;
+
+	/// @brief The number of records whose timestamp preceded that of the previous record of their ID. These are counted, but
+	/// excluded from the inter-arrival statistics.
+	uint64_t reorderedCount;
+
+	/// @brief Indicates the statistics have been finished, see @c mdfCanBusStatsFinish .
+	bool finished;
+} mdfCanBusStats_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes streaming statistics.
+ * @param stats The statistics to initialize. Must be de-allocated using @c mdfCanBusStatsDealloc if successful.
+ * @param config The configuration to use. Copied, so need not remain valid.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusStatsInit (mdfCanBusStats_t* stats, const mdfCanBusStatsConfig_t* config);
+
+/**
+ * @brief Adds a record to the statistics. Records should be added in timestamp order.
+ * @param stats The statistics to add to.
+ * @param record The record to add.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanBusStatsAddRecord (mdfCanBusStats_t* stats, const mdfCanBusRecord_t* record);
+
+/**
+ * @brief Finishes the statistics once all records have been added, closing any open burst and ordering the ID statistics.
+ * No further records may be added.
+ * @param stats The statistics to finish.
+ */
+void mdfCanBusStatsFinish (mdfCanBusStats_t* stats);
+
+/**
+ * @brief Gets the jitter (standard deviation of the inter-arrival time) of an ID.
+ * @param idStats The statistics of the ID.
+ * @return The jitter, in nanoseconds.
+ */
+static inline double mdfCanBusIdStatsGetJitterNs (const mdfCanBusIdStats_t* idStats)
+{
+	if (idStats->intervalCount < 2)
+		return 0;
+	return sqrt (idStats->intervalM2 / (idStats->intervalCount - 1));
+}
+
+/**
+ * @brief De-allocates the memory owned by streaming statistics.
+ * @param stats The statistics to de-allocate.
+ */
+void mdfCanBusStatsDealloc (mdfCanBusStats_t* stats);
+
+#endif // MDF_CAN_BUS_STATS_H
@@ -0,0 +1,421 @@
+// For strdup. Note this must be the first include in this file.
+#define _GNU_SOURCE
+
+// Header
+#include "mdf_can_replay.h"
+
+// Includes
+#include "error_codes.h"
+#include "mdf_can_bus_logging.h"
+#include "mdf_can_bus_session_reader.h"
+
+// C Standard Library
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The prefix of an MDF replay device's name.
+#define NAME_PREFIX "mdf:"
+
+/// @brief The number of records read from the session at once.
+#define READ_SIZE 256
+
+/// @brief The number of threads decoding the session. Note 2 allows the next split to be decoded while the current is being
+/// replayed.
+#define THREAD_COUNT 2
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	canDeviceVmt_t vmt;
+	char* name;
+	canBaudrate_t baudrate;
+	unsigned long timeout;
+
+	/// @brief The directory of the session.
+	char* directory;
+
+	/// @brief The playback speed, relative to real-time. 0 to replay as fast as possible.
+	double speed;
+
+	/// @brief The bus channel to replay, -1 for every channel.
+	int busChannel;
+
+	/// @brief Indicates the session should be restarted once its end is reached.
+	bool loop;
+
+	/// @brief The reader of the session.
+	mdfCanBusSessionReader_t reader;
+
+	/// @brief The records read from the session, but not yet returned.
+	mdfCanBusRecord_t records [READ_SIZE];
+	size_t recordCount;
+	size_t recordIndex;
+
+	/// @brief Indicates the end of the session has been reached (and it is not looping).
+	bool ended;
+
+	/// @brief Indicates the first record has been returned, meaning the fields below are valid.
+	bool started;
+
+	/// @brief The time the first record was returned at, in nanoseconds (CLOCK_MONOTONIC).
+	uint64_t startNs;
+
+	/// @brief The timestamp of the first record of the session.
+	uint64_t firstTimestampNs;
+
+	/// @brief The timestamp of the last record read from the session.
+	uint64_t lastTimestampNs;
+
+	/// @brief The duration of each previous pass of the session, for looping.
+	uint64_t loopOffsetNs;
+} mdfCanReplay_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+static uint64_t monotonicNs (void)
+{
+	struct timespec time;
+	clock_gettime (CLOCK_MONOTONIC, &time);
+	return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+static void sleepUntilNs (uint64_t timeNs)
+{
+	struct timespec time =
+	{
+		.tv_sec		= timeNs / 1000000000,
+		.tv_nsec	= timeNs % 1000000000
+	};
+
+	// Sleep again if interrupted by a signal.
+	while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &time, NULL) == EINTR);
+}
+
+/**
+ * @brief Parses the options of a device name.
+ * @param can The device to configure.
+ * @param options The options, that is, the portion of the name after the session directory. Modified by this function.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int parseOptions (mdfCanReplay_t* can, char* options)
+{
+	char* savePtr;
+	for (char* option = strtok_r (options, ",", &savePtr); option != NULL; option = strtok_r (NULL, ",", &savePtr))
+	{
+		char* end;
+		if (strcmp (option, "max") == 0)
+		{
+			can->speed = 0;
+		}
+		else if (strcmp (option, "loop") == 0)
+		{
+			can->loop = true;
+		}
+		else if (strncmp (option, "bus=", strlen ("bus=")) == 0)
+		{
+			can->busChannel = strtol (option + strlen ("bus="), &end, 0);
+			if (end == option + strlen ("bus=") || *end != '\0' || can->busChannel < 0)
+			{
+				errno = EINVAL;
+				return errno;
+			}
+		}
+		else
+		{
+			can->speed = strtod (option, &end);
+			if (end == option || *end != '\0' || can->speed <= 0)
+			{
+				errno = EINVAL;
+				return errno;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Gets the next record of the session to replay, reading more from the session if needed.
+ * @param can The device to read from.
+ * @return The next record, @c NULL if the end of the session has been reached or reading failed. Note @c errno is set to 0 in
+ * the first case, the error code in the second.
+ */
+static mdfCanBusRecord_t* peekRecord (mdfCanReplay_t* can)
+{
+	while (!can->ended)
+	{
+		// Skip records of other bus channels.
+		for (; can->recordIndex < can->recordCount; ++can->recordIndex)
+			if (can->busChannel < 0 || can->records [can->recordIndex].busChannel == can->busChannel)
+				return &can->records [can->recordIndex];
+
+		can->recordIndex = 0;
+		if (mdfCanBusSessionReaderRead (&can->reader, can->records, READ_SIZE, &can->recordCount) != 0)
+			return NULL;
+
+		if (can->recordCount != 0)
+		{
+			can->lastTimestampNs = can->records [can->recordCount - 1].timestampNs;
+			continue;
+		}
+
+		if (!can->loop || !can->started)
+		{
+			can->ended = true;
+			break;
+		}
+
+		// Restart the session, continuing from the end of the previous pass.
+		mdfCanBusSessionReaderClose (&can->reader);
+		if (mdfCanBusSessionReaderInit (&can->reader, can->directory, THREAD_COUNT) != 0)
+			return NULL;
+
+		can->loopOffsetNs += can->lastTimestampNs - can->firstTimestampNs;
+	}
+
+	errno = 0;
+	return NULL;
+}
+
+/**
+ * @brief Gets the time a record should be returned at.
+ * @param can The device the record belongs to. Must have been started.
+ * @param record The record to get the time of.
+ * @return The time, in nanoseconds (CLOCK_MONOTONIC).
+ */
+static uint64_t recordTimeNs (mdfCanReplay_t* can, const mdfCanBusRecord_t* record)
+{
+	// Note records may be slightly out of order (ex. from multiple splits), so clamp the first ones.
+	uint64_t offsetNs = can->loopOffsetNs;
+	if (record->timestampNs > can->firstTimestampNs)
+		offsetNs += record->timestampNs - can->firstTimestampNs;
+
+	return can->startNs + (uint64_t) (offsetNs / can->speed);
+}
+
+int mdfCanReplayRegister (void)
+{
+	return canRegisterDevice (mdfCanReplayNameDomain, mdfCanReplayInit);
+}
+
+bool mdfCanReplayNameDomain (const char* name)
+{
+	return strncmp (name, NAME_PREFIX, strlen (NAME_PREFIX)) == 0;
+}
+
+canDevice_t* mdfCanReplayInit (char* name, canBaudrate_t baudrate)
+{
+	// Device must be dynamically allocated
+	mdfCanReplay_t* device = malloc (sizeof (mdfCanReplay_t));
+	if (device == NULL)
+		return NULL;
+
+	// Setup the device's VMT
+	device->vmt.transmit		= mdfCanReplayTransmit;
+	device->vmt.transmitBatch	= mdfCanReplayTransmitBatch;
+	device->vmt.receive			= mdfCanReplayReceive;
+	device->vmt.flushRx			= mdfCanReplayFlushRx;
+	device->vmt.setTimeout		= mdfCanReplaySetTimeout;
+	device->vmt.getBaudrate		= mdfCanReplayGetBaudrate;
+	device->vmt.getDeviceName	= mdfCanReplayGetDeviceName;
+	device->vmt.getDeviceType	= mdfCanReplayGetDeviceType;
+	device->vmt.dealloc			= mdfCanReplayDealloc;
+
+	// Internal housekeeping
+	device->baudrate		= baudrate;
+	device->timeout			= 0;
+	device->speed			= 1;
+	device->busChannel		= -1;
+	device->loop			= false;
+	device->recordCount		= 0;
+	device->recordIndex		= 0;
+	device->ended			= false;
+	device->started			= false;
+	device->loopOffsetNs	= 0;
+
+	device->name = strdup (name);
+	if (device->name == NULL)
+	{
+		free (device);
+		return NULL;
+	}
+
+	// Split the session directory from the options.
+	device->directory = strdup (name + strlen (NAME_PREFIX));
+	if (device->directory == NULL)
+	{
+		free (device->name);
+		free (device);
+		return NULL;
+	}
+
+	char* options = strchr (device->directory, ',');
+	if (options != NULL)
+	{
+		*options = '\0';
+		++options;
+	}
+
+	if ((options != NULL && parseOptions (device, options) != 0) ||
+		mdfCanBusSessionReaderInit (&device->reader, device->directory, THREAD_COUNT) != 0)
+	{
+		int code = errno;
+		free (device->directory);
+		free (device->name);
+		free (device);
+		errno = code;
+		return NULL;
+	}
+
+	// A session without any splits is most likely a mistyped directory.
+	if (device->reader.splitCount == 0)
+	{
+		mdfCanReplayDealloc (device);
+		errno = ENOENT;
+		return NULL;
+	}
+
+	return (canDevice_t*) device;
+}
+
+void mdfCanReplayDealloc (void* device)
+{
+	mdfCanReplay_t* can = device;
+
+	mdfCanBusSessionReaderClose (&can->reader);
+
+	// Free the device's memory
+	free (can->directory);
+	free (can->name);
+	free (device);
+}
+
+int mdfCanReplayTransmit (void* device, canFrame_t* frame)
+{
+	(void) device;
+	(void) frame;
+
+	// Nothing to transmit to, always succeeds
+	return 0;
+}
+
+int mdfCanReplayTransmitBatch (void* device, canFrame_t* frames, size_t frameCount, size_t* transmitCount)
+{
+	(void) device;
+	(void) frames;
+
+	// Nothing to transmit to, always succeeds
+	if (transmitCount != NULL)
+		*transmitCount = frameCount;
+	return 0;
+}
+
+int mdfCanReplayReceive (void* device, canFrame_t* frame)
+{
+	mdfCanReplay_t* can = device;
+
+	mdfCanBusRecord_t* record = peekRecord (can);
+	if (record == NULL)
+	{
+		if (errno != 0)
+			return errno;
+
+		// End of the session, block for the timeout interval
+		if (can->timeout == 0)
+		{
+			while (true)
+				usleep (1000000);
+		}
+
+		usleep (can->timeout * 1000);
+		errno = ERRNO_CAN_DEVICE_TIMEOUT;
+		return errno;
+	}
+
+	if (!can->started)
+	{
+		can->started			= true;
+		can->startNs			= monotonicNs ();
+		can->firstTimestampNs	= record->timestampNs;
+	}
+
+	// Wait until the record's time, or the timeout interval, whichever is first. Note records are often closer together than
+	// the resolution of a sleep, so only sleep if the record's time has not already passed.
+	uint64_t timeNs = can->speed != 0 ? recordTimeNs (can, record) : 0;
+	uint64_t currentNs = can->speed != 0 ? monotonicNs () : 0;
+	if (timeNs > currentNs)
+	{
+		uint64_t timeoutNs = currentNs + (uint64_t) can->timeout * 1000000;
+		if (can->timeout != 0 && timeNs > timeoutNs)
+		{
+			sleepUntilNs (timeoutNs);
+			errno = ERRNO_CAN_DEVICE_TIMEOUT;
+			return errno;
+		}
+
+		sleepUntilNs (timeNs);
+	}
+
+	++can->recordIndex;
+
+	frame->id	= record->id;
+	frame->ide	= record->ide;
+	frame->dlc	= record->dlc < sizeof (frame->data) ? record->dlc : sizeof (frame->data);
+	frame->rtr	= record->type == MDF_CAN_BUS_RECORD_REMOTE_FRAME;
+	memset (frame->data, 0, sizeof (frame->data));
+	if (record->type == MDF_CAN_BUS_RECORD_DATA_FRAME)
+		memcpy (frame->data, record->data, frame->dlc);
+
+	if (record->type != MDF_CAN_BUS_RECORD_ERROR_FRAME)
+		return 0;
+
+	errno = mdfCanBusLogGetErrorCode (record->errorType);
+	return errno;
+}
+
+int mdfCanReplayFlushRx (void* device)
+{
+	mdfCanReplay_t* can = device;
+
+	// When replaying as fast as possible (or before replaying), no frames have been missed.
+	if (can->speed == 0 || !can->started)
+		return 0;
+
+	// Skip every record whose time has passed.
+	uint64_t timeNs = monotonicNs ();
+	mdfCanBusRecord_t* record;
+	while ((record = peekRecord (can)) != NULL && recordTimeNs (can, record) <= timeNs)
+		++can->recordIndex;
+
+	return record == NULL ? errno : 0;
+}
+
+int mdfCanReplaySetTimeout (void* device, unsigned long timeoutMs)
+{
+	mdfCanReplay_t* can = device;
+
+	// Save the timeout
+	can->timeout = timeoutMs;
+	return 0;
+}
+
+canBaudrate_t mdfCanReplayGetBaudrate (void* device)
+{
+	return ((mdfCanReplay_t*) device)->baudrate;
+}
+
+const char* mdfCanReplayGetDeviceName (void* device)
+{
+	return ((mdfCanReplay_t*) device)->name;
+}
+
+const char* mdfCanReplayGetDeviceType (void)
+{
+	return "mdf";
+}
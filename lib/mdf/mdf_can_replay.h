@@ -0,0 +1,90 @@
+#ifndef MDF_CAN_REPLAY_H
+#define MDF_CAN_REPLAY_H
+
+// MDF Replay CAN Device ------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: CAN device replaying a session of MDF CAN bus logs (see mdf_can_bus_logging.h). Rather than reading from
+//   hardware, received frames are read from the splits of the session, in timestamp order. Frames can be paced to the timing
+//   of the original recording (optionally scaled), or returned as fast as possible. Transmitted frames are discarded.
+//
+//   As this library depends on the CAN device library (not the other way around), @c canInit only recognizes the device once
+//   an application registers it, see @c mdfCanReplayRegister .
+//
+// Device Name:
+//   mdf:<Session Directory>[,<Option>]...
+//
+//   Options:
+//     <Speed>    - The playback speed, relative to real-time (ex. '2' for 2x speed, '0.5' for half speed). Defaults to 1.
+//     max        - Returns frames as fast as possible, rather than pacing them.
+//     bus=<N>    - Only replays the frames of a single bus channel. By default, the frames of every channel are replayed.
+//     loop       - Restarts the session once its end is reached. By default, the device times out once the end is reached.
+//
+//   Ex. 'mdf:logs/session_12', 'mdf:logs/session_12,4,bus=1', 'mdf:logs/session_12,max,loop'.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "can_device/can_device.h"
+
+// C Standard Library
+#include <stdbool.h>
+#include <stddef.h>
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Registers the MDF replay CAN device with @c canInit , allowing 'mdf:' device names to be used. Should be called once,
+ * before the first call to @c canInit .
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCanReplayRegister (void);
+
+/**
+ * @brief Checks if a device name belongs to an MDF replay CAN device.
+ * @param name The name to check.
+ * @return True if the name begins with 'mdf:', false otherwise.
+ */
+bool mdfCanReplayNameDomain (const char* name);
+
+/**
+ * @brief Initializes an MDF replay CAN device.
+ * @param name The name of the device, see the description of this file for the format.
+ * @param baudrate The baudrate of the device. Only used by @c canGetBaudrate .
+ * @return The initialized MDF replay CAN device if successful, @c NULL otherwise. Note @c errno is set on failure.
+ */
+canDevice_t* mdfCanReplayInit (char* name, canBaudrate_t baudrate);
+
+/**
+ * @brief De-allocates the memory owned by an MDF replay CAN device.
+ * @param device The device to de-allocate.
+ */
+void mdfCanReplayDealloc (void* device);
+
+/// @brief MDF replay implementation of the @c canTransmit function. Note the frame is discarded.
+int mdfCanReplayTransmit (void* device, canFrame_t* frame);
+
+/// @brief MDF replay implementation of the @c canTransmitBatch function. Note the frames are discarded.
+int mdfCanReplayTransmitBatch (void* device, canFrame_t* frames, size_t frameCount, size_t* transmitCount);
+
+/// @brief MDF replay implementation of the @c canReceive function.
+int mdfCanReplayReceive (void* device, canFrame_t* frame);
+
+/// @brief MDF replay implementation of the @c canFlushRx function. Skips every frame whose time has already passed.
+int mdfCanReplayFlushRx (void* device);
+
+/// @brief MDF replay implementation of the @c canSetTimeout function.
+int mdfCanReplaySetTimeout (void* device, unsigned long timeoutMs);
+
+/// @brief MDF replay implementation of the @c canGetBaudrate function.
+canBaudrate_t mdfCanReplayGetBaudrate (void* device);
+
+/// @brief MDF replay implementation of the @c canGetDeviceName function.
+const char* mdfCanReplayGetDeviceName (void* device);
+
+/// @brief MDF replay implementation of the @c canGetDeviceType function.
+const char* mdfCanReplayGetDeviceType (void);
+
+#endif // MDF_CAN_REPLAY_H
@@ -0,0 +1,257 @@
+// Header
+#include "mdf_capture.h"
+
+// Includes
+#include "debug.h"
+#include "time_port.h"
+
+// C Standard Library
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Writes the records of the ring falling within a window to the log, discarding the rest. Empties the ring. Note a
+ * record the log fails to write does not stop the flush, as the writer may free space in the log's buffers part-way.
+ * @param capture The capture to flush.
+ * @param startNs The start of the window, in nanoseconds. Records older than this are discarded.
+ * @return 0 if successful, the first error code otherwise.
+ */
+static int flushRing (mdfCapture_t* capture, long long startNs)
+{
+	int code = 0;
+	for (; capture->count != 0; --capture->count)
+	{
+		mdfRecord_t* record = &capture->records [capture->head];
+		capture->head = (capture->head + 1) % capture->capacity;
+
+		if (record->timestampNs < startNs)
+		{
+			++capture->discardedCount;
+			continue;
+		}
+
+		if (mdfCanBusLogWriteRecord (capture->log, record->data, record->size) == 0)
+		{
+			++capture->writtenCount;
+			continue;
+		}
+
+		++capture->droppedCount;
+		if (code == 0)
+			code = errno;
+	}
+
+	capture->head = 0;
+
+	errno = code;
+	return code;
+}
+
+/**
+ * @brief Applies the pending triggers, if any occurred at or before a point in time.
+ * @param capture The capture to apply to.
+ * @param timeNs The current time, in nanoseconds.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int applyTriggers (mdfCapture_t* capture, long long timeNs)
+{
+	long long firstNs = atomic_load (&capture->triggerFirstNs);
+	if (firstNs == LLONG_MAX || firstNs > timeNs)
+		return 0;
+
+	// Take the pending triggers. Note a trigger fired between these two exchanges is also left pending, in which case it
+	// is simply applied again.
+	firstNs = atomic_exchange (&capture->triggerFirstNs, LLONG_MAX);
+	long long lastNs = atomic_exchange (&capture->triggerLastNs, LLONG_MIN);
+	if (lastNs < firstNs)
+		lastNs = firstNs;
+
+	// Retriggering during an event extends its window.
+	if (capture->capturing)
+	{
+		if (lastNs + capture->postTriggerNs > capture->deadlineNs)
+			capture->deadlineNs = lastNs + capture->postTriggerNs;
+		return 0;
+	}
+
+	debugPrintf ("Capturing MDF event, triggered at %lli ns.\n", firstNs);
+
+	capture->capturing = true;
+	capture->deadlineNs = lastNs + capture->postTriggerNs;
+	++capture->eventCount;
+
+	// Write the pre-trigger window.
+	return flushRing (capture, firstNs - capture->preTriggerNs);
+}
+
+/**
+ * @brief Records an error frame, firing a trigger if it completes a burst.
+ * @param capture The capture to record to.
+ * @param timestampNs The timestamp of the error frame, in nanoseconds.
+ */
+static void recordErrorFrame (mdfCapture_t* capture, long long timestampNs)
+{
+	capture->errorTimestamps [capture->errorIndex] = timestampNs;
+	capture->errorIndex = (capture->errorIndex + 1) % capture->errorBurstCount;
+	if (capture->errorCount < capture->errorBurstCount)
+		++capture->errorCount;
+
+	// The next index is now the oldest of the last errors.
+	if (capture->errorCount == capture->errorBurstCount &&
+		timestampNs - capture->errorTimestamps [capture->errorIndex] <= capture->errorBurstWindowNs)
+	{
+		struct timespec timestamp =
+		{
+			.tv_sec		= timestampNs / 1000000000,
+			.tv_nsec	= timestampNs % 1000000000
+		};
+		mdfCaptureTrigger (capture, &timestamp);
+	}
+}
+
+int mdfCaptureInit (mdfCapture_t* capture, mdfCanBusLog_t* log, const mdfCaptureConfig_t* config)
+{
+	if (config->capacity == 0 || config->preTriggerNs < 0 || config->postTriggerNs < 0)
+	{
+		errno = EINVAL;
+		return errno;
+	}
+
+	*capture = (mdfCapture_t)
+	{
+		.log				= log,
+		.preTriggerNs		= config->preTriggerNs,
+		.postTriggerNs		= config->postTriggerNs,
+		.capacity			= config->capacity,
+		.head				= 0,
+		.count				= 0,
+		.capturing			= false,
+		.deadlineNs			= 0,
+		.errorTimestamps	= NULL,
+		.errorBurstCount	= config->errorBurstCount,
+		.errorBurstWindowNs	= config->errorBurstWindowNs,
+		.errorIndex			= 0,
+		.errorCount			= 0,
+		.eventCount			= 0,
+		.writtenCount		= 0,
+		.discardedCount		= 0,
+		.droppedCount		= 0
+	};
+	atomic_init (&capture->triggerFirstNs, LLONG_MAX);
+	atomic_init (&capture->triggerLastNs, LLONG_MIN);
+	atomic_init (&capture->triggerCount, 0);
+
+	capture->records = malloc (sizeof (mdfRecord_t) * capture->capacity);
+	if (capture->records == NULL)
+		return errno;
+
+	if (capture->errorBurstCount != 0)
+	{
+		capture->errorTimestamps = malloc (sizeof (long long) * capture->errorBurstCount);
+		if (capture->errorTimestamps == NULL)
+		{
+			free (capture->records);
+			return errno;
+		}
+	}
+
+	return 0;
+}
+
+void mdfCaptureTrigger (mdfCapture_t* capture, const struct timespec* timestamp)
+{
+	long long timestampNs = timespecToNs (timestamp);
+
+	// Atomic minimum of the first trigger.
+	long long firstNs = atomic_load (&capture->triggerFirstNs);
+	while (timestampNs < firstNs && !atomic_compare_exchange_weak (&capture->triggerFirstNs, &firstNs, timestampNs));
+
+	// Atomic maximum of the last trigger.
+	long long lastNs = atomic_load (&capture->triggerLastNs);
+	while (timestampNs > lastNs && !atomic_compare_exchange_weak (&capture->triggerLastNs, &lastNs, timestampNs));
+
+	atomic_fetch_add_explicit (&capture->triggerCount, 1, memory_order_relaxed);
+}
+
+int mdfCaptureWriteRecord (mdfCapture_t* capture, const mdfRecord_t* record)
+{
+	long long timestampNs = record->timestampNs;
+
+	if (capture->errorBurstCount != 0 && record->data [0] == MDF_CAN_BUS_LOG_ERROR_FRAME_RECORD_ID)
+		recordErrorFrame (capture, timestampNs);
+
+	int code = mdfCaptureAdvance (capture, timestampNs);
+	if (code != 0)
+		return code;
+
+	if (capture->capturing)
+	{
+		code = mdfCanBusLogWriteRecord (capture->log, record->data, record->size);
+		if (code == 0)
+			++capture->writtenCount;
+		else
+			++capture->droppedCount;
+		return code;
+	}
+
+	// Discard the records that have fallen out of the pre-trigger window, or the oldest record if the ring is full.
+	while (capture->count != 0 && (capture->count == capture->capacity ||
+		capture->records [capture->head].timestampNs < timestampNs - capture->preTriggerNs))
+	{
+		capture->head = (capture->head + 1) % capture->capacity;
+		--capture->count;
+		++capture->discardedCount;
+	}
+
+	capture->records [(capture->head + capture->count) % capture->capacity] = *record;
+	++capture->count;
+	return 0;
+}
+
+int mdfCaptureAdvance (mdfCapture_t* capture, long long timeNs)
+{
+	int code = applyTriggers (capture, timeNs);
+	if (code != 0)
+		return code;
+
+	// End the event once its post-trigger window has passed, placing the next event in a new split.
+	if (capture->capturing && timeNs > capture->deadlineNs)
+	{
+		debugPrintf ("Ending MDF event, window ended at %lli ns.\n", capture->deadlineNs);
+
+		capture->capturing = false;
+		return mdfCanBusLogSplit (capture->log);
+	}
+
+	return 0;
+}
+
+void mdfCaptureGetStats (mdfCapture_t* capture, mdfCaptureStats_t* stats)
+{
+	*stats = (mdfCaptureStats_t)
+	{
+		.triggerCount	= atomic_load_explicit (&capture->triggerCount, memory_order_relaxed),
+		.eventCount		= capture->eventCount,
+		.writtenCount	= capture->writtenCount,
+		.discardedCount	= capture->discardedCount + capture->count,
+		.droppedCount	= capture->droppedCount
+	};
+}
+
+int mdfCaptureClose (mdfCapture_t* capture)
+{
+	// Apply any trigger fired after the last record, so its pre-trigger window is not lost.
+	int code = applyTriggers (capture, LLONG_MAX);
+
+	capture->discardedCount += capture->count;
+	capture->count = 0;
+
+	free (capture->records);
+	free (capture->errorTimestamps);
+
+	errno = code;
+	return code;
+}
@@ -0,0 +1,171 @@
+#ifndef MDF_CAPTURE_H
+#define MDF_CAPTURE_H
+
+// MDF Event-Triggered Capture ------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: Event-triggered capture of MDF CAN bus logs. Rather than writing every record to the log, the last N seconds
+//   of encoded records are held in a fixed-size ring in memory. When a trigger fires, the records of the pre-trigger window
+//   are flushed from the ring into the log, followed by every record up to the end of the post-trigger window. Each event
+//   is written into its own split of the log. Triggering again during an event extends its post-trigger window.
+//
+//   Triggers may be fired by any thread (or signal handler) via @c mdfCaptureTrigger . Additionally, the capture can fire a
+//   trigger by itself upon a burst of error frames.
+//
+//   Records are fed to the capture in timestamp order by a single thread, see @c mdfRecordMergerStart . A trigger is applied
+//   once the capture has been fed a record (or advanced to a time) at or after the trigger's timestamp, meaning the
+//   trigger's position in the log is always accurate, regardless of which thread fired it.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "mdf_can_bus_logging.h"
+#include "mdf_record_queue.h"
+
+// C Standard Library
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The number of records the ring can hold. This should be large enough to hold the pre-trigger window at the
+	/// maximum frame rate of the bus(es), otherwise the window is shortened to the records that fit. Note the ring is flushed
+	/// into the log all at once, so the log's @c bufferSize should also be able to hold this many records (of
+	/// @c MDF_CAN_BUS_LOG_RECORD_SIZE_MAX bytes), otherwise the records that do not fit are dropped.
+	size_t capacity;
+
+	/// @brief The amount of time to capture before a trigger, in nanoseconds.
+	long long preTriggerNs;
+
+	/// @brief The amount of time to capture after a trigger, in nanoseconds.
+	long long postTriggerNs;
+
+	/// @brief The number of error frames that fire a trigger, if received within @c errorBurstWindowNs . 0 to disable.
+	size_t errorBurstCount;
+
+	/// @brief The window of time in which @c errorBurstCount error frames fire a trigger, in nanoseconds.
+	long long errorBurstWindowNs;
+} mdfCaptureConfig_t;
+
+typedef struct
+{
+	/// @brief The number of triggers fired, including those that extended an event.
+	size_t triggerCount;
+
+	/// @brief The number of events captured (that is, splits written).
+	size_t eventCount;
+
+	/// @brief The number of records written to the log.
+	size_t writtenCount;
+
+	/// @brief The number of records discarded from the ring without being written, as they were not within the pre-trigger
+	/// window of an event.
+	size_t discardedCount;
+
+	/// @brief The number of records of an event that could not be written, as the log failed or its buffers were full.
+	size_t droppedCount;
+} mdfCaptureStats_t;
+
+typedef struct mdfCapture
+{
+	mdfCanBusLog_t* log;
+	long long preTriggerNs;
+	long long postTriggerNs;
+
+	/// @brief The ring of records preceding the current time.
+	mdfRecord_t* records;
+	size_t capacity;
+
+	/// @brief The index of the oldest record of the ring.
+	size_t head;
+
+	/// @brief The number of records in the ring.
+	size_t count;
+
+	/// @brief Indicates an event is being captured, records are written straight to the log.
+	bool capturing;
+
+	/// @brief The end of the current event's post-trigger window, in nanoseconds.
+	long long deadlineNs;
+
+	/// @brief The timestamps of the last @c errorBurstCount error frames, in nanoseconds.
+	long long* errorTimestamps;
+	size_t errorBurstCount;
+	long long errorBurstWindowNs;
+	size_t errorIndex;
+	size_t errorCount;
+
+	/// @brief The timestamps of the first and last triggers yet to be applied, in nanoseconds. @c LLONG_MAX and @c LLONG_MIN
+	/// respectively if there are none.
+	atomic_llong triggerFirstNs;
+	atomic_llong triggerLastNs;
+
+	/// @brief The number of triggers fired.
+	atomic_size_t triggerCount;
+
+	size_t eventCount;
+	size_t writtenCount;
+	size_t discardedCount;
+	size_t droppedCount;
+} mdfCapture_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes an event-triggered capture.
+ * @param capture The capture to initialize.
+ * @param log The log to write captured events into. Note the log's current split is used for the first event.
+ * @param config The configuration to use.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCaptureInit (mdfCapture_t* capture, mdfCanBusLog_t* log, const mdfCaptureConfig_t* config);
+
+/**
+ * @brief Fires a trigger. This function is thread-safe and async-signal-safe.
+ * @param capture The capture to trigger.
+ * @param timestamp The time of the trigger, as acquired by @c mdfCanBusLogGetTimestamp .
+ */
+void mdfCaptureTrigger (mdfCapture_t* capture, const struct timespec* timestamp);
+
+/**
+ * @brief Feeds a record to the capture, either writing it to the log or holding it in the ring. Records must be fed in
+ * timestamp order. Note this function is not thread-safe, only one thread may feed the capture.
+ * @param capture The capture to feed.
+ * @param record The record to feed.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCaptureWriteRecord (mdfCapture_t* capture, const mdfRecord_t* record);
+
+/**
+ * @brief Advances the capture to a point in time, applying pending triggers and ending the current event if its window has
+ * passed. Used to end events when no records are being fed. Note this function is not thread-safe, it must only be called by
+ * the thread feeding the capture.
+ * @param capture The capture to advance.
+ * @param timeNs The time to advance to, in nanoseconds. No record older than this may be fed afterwards.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCaptureAdvance (mdfCapture_t* capture, long long timeNs);
+
+/**
+ * @brief Gets the statistics of a capture. Note this function is not thread-safe, it must only be called once the thread
+ * feeding the capture has stopped.
+ * @param capture The capture to get from.
+ * @param stats Buffer to write the statistics into.
+ */
+void mdfCaptureGetStats (mdfCapture_t* capture, mdfCaptureStats_t* stats);
+
+/**
+ * @brief Closes a capture, applying any pending triggers and de-allocating its memory. Records remaining in the ring are
+ * discarded, unless they fall within a pending trigger's window. The log must be closed separately, after this call.
+ * @param capture The capture to close.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCaptureClose (mdfCapture_t* capture);
+
+#endif // MDF_CAPTURE_H
@@ -0,0 +1,712 @@
+// For asprintf. Note this must be the first include in this file.
+#define _GNU_SOURCE
+#include <stdio.h>
+
+// Header
+#include "mdf_catalog.h"
+
+// Includes
+#include "debug.h"
+#include "error_codes.h"
+#include "misc_port.h"
+
+// C Standard Library
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+#define CATALOG_MAGIC					"ZREMDFCT"
+#define CATALOG_VERSION					1
+
+/// @brief The size of the catalog's header, in bytes.
+#define CATALOG_HEADER_SIZE				16
+
+/// @brief The size of an entry's fixed fields, in bytes.
+#define ENTRY_HEADER_SIZE				72
+
+/// @brief The size of an entry's ID count, in bytes.
+#define ENTRY_ID_SIZE					8
+
+/// @brief The size of an entry's signal range, excluding its name, in bytes.
+#define ENTRY_SIGNAL_SIZE				10
+
+/// @brief The initial capacity of a builder's ID table. Must be a power of 2.
+#define ID_TABLE_CAPACITY_INITIAL		256
+
+/// @brief The number of records read from a split at a time.
+#define READ_BATCH_SIZE					256
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+static uint32_t hashId (uint32_t id)
+{
+	// Multiplicative hash, IDs are often consecutive.
+	return id * 2654435761u;
+}
+
+/**
+ * @brief Doubles the capacity of a builder's ID table, re-inserting its entries.
+ * @param builder The builder to grow.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int growIdTable (mdfCatalogBuilder_t* builder)
+{
+	size_t capacity = (builder->tableMask + 1) * 2;
+	mdfCatalogIdCount_t* table = calloc (capacity, sizeof (mdfCatalogIdCount_t));
+	if (table == NULL)
+		return errno;
+
+	for (size_t index = 0; index <= builder->tableMask; ++index)
+	{
+		if (builder->table [index].count == 0)
+			continue;
+
+		size_t slot = hashId (builder->table [index].id) & (capacity - 1);
+		while (table [slot].count != 0)
+			slot = (slot + 1) & (capacity - 1);
+		table [slot] = builder->table [index];
+	}
+
+	free (builder->table);
+	builder->table = table;
+	builder->tableMask = capacity - 1;
+	return 0;
+}
+
+static int compareIdCounts (const void* a, const void* b)
+{
+	uint32_t idA = ((const mdfCatalogIdCount_t*) a)->id;
+	uint32_t idB = ((const mdfCatalogIdCount_t*) b)->id;
+	return (idA > idB) - (idA < idB);
+}
+
+int mdfCatalogBuilderInit (mdfCatalogBuilder_t* builder, const char* const* signalNames, size_t signalCount,
+	mdfCatalogSignalCallback_t* callback, void* arg)
+{
+	*builder = (mdfCatalogBuilder_t)
+	{
+		.entry			= {0},
+		.tableMask		= ID_TABLE_CAPACITY_INITIAL - 1,
+		.signalNames	= signalNames,
+		.signalCount	= signalCount,
+		.callback		= callback,
+		.arg			= arg
+	};
+
+	builder->table = calloc (ID_TABLE_CAPACITY_INITIAL, sizeof (mdfCatalogIdCount_t));
+	if (builder->table == NULL)
+		return errno;
+
+	if (signalCount != 0)
+	{
+		builder->signalMins = malloc (sizeof (float) * signalCount);
+		builder->signalMaxs = malloc (sizeof (float) * signalCount);
+		builder->entry.signals = malloc (sizeof (mdfCatalogSignal_t) * signalCount);
+		if (builder->signalMins == NULL || builder->signalMaxs == NULL || builder->entry.signals == NULL)
+		{
+			int code = errno;
+			mdfCatalogBuilderDealloc (builder);
+			errno = code;
+			return code;
+		}
+	}
+
+	mdfCatalogBuilderReset (builder, 0, 0, 0);
+	return 0;
+}
+
+void mdfCatalogBuilderReset (mdfCatalogBuilder_t* builder, uint32_t sessionNumber, uint32_t splitNumber, uint64_t startTimeNs)
+{
+	builder->entry.sessionNumber	= sessionNumber;
+	builder->entry.splitNumber		= splitNumber;
+	builder->entry.startTimeNs		= startTimeNs;
+	builder->entry.fileSize			= 0;
+	builder->entry.recordCount		= 0;
+	builder->entry.errorFrameCount	= 0;
+	builder->entry.firstTimestampNs	= 0;
+	builder->entry.lastTimestampNs	= 0;
+	builder->entry.idCount			= 0;
+	builder->entry.signalCount		= 0;
+
+	memset (builder->table, 0, sizeof (mdfCatalogIdCount_t) * (builder->tableMask + 1));
+
+	for (size_t index = 0; index < builder->signalCount; ++index)
+	{
+		builder->signalMins [index] = INFINITY;
+		builder->signalMaxs [index] = -INFINITY;
+	}
+}
+
+int mdfCatalogBuilderAddRecord (mdfCatalogBuilder_t* builder, const mdfCanBusRecord_t* record)
+{
+	mdfCatalogEntry_t* entry = &builder->entry;
+
+	if (entry->recordCount == 0 || record->timestampNs < entry->firstTimestampNs)
+		entry->firstTimestampNs = record->timestampNs;
+	if (entry->recordCount == 0 || record->timestampNs > entry->lastTimestampNs)
+		entry->lastTimestampNs = record->timestampNs;
+	++entry->recordCount;
+
+	if (record->type == MDF_CAN_BUS_RECORD_ERROR_FRAME)
+	{
+		++entry->errorFrameCount;
+		return 0;
+	}
+
+	// Keep the table at most 3/4 full.
+	if ((entry->idCount + 1) * 4 > (builder->tableMask + 1) * 3 && growIdTable (builder) != 0)
+		return errno;
+
+	uint32_t id = record->id | (record->ide ? MDF_CATALOG_ID_IDE : 0);
+	size_t slot = hashId (id) & builder->tableMask;
+	while (builder->table [slot].count != 0 && builder->table [slot].id != id)
+		slot = (slot + 1) & builder->tableMask;
+
+	if (builder->table [slot].count == 0)
+	{
+		builder->table [slot].id = id;
+		++entry->idCount;
+	}
+	++builder->table [slot].count;
+
+	if (builder->callback != NULL)
+		builder->callback (builder, record, builder->arg);
+
+	return 0;
+}
+
+int mdfCatalogBuilderComplete (mdfCatalogBuilder_t* builder, uint64_t fileSize, const mdfCatalogEntry_t** entry)
+{
+	builder->entry.fileSize = fileSize;
+
+	// Note the table's capacity always exceeds its count, so this also bounds the ID array.
+	mdfCatalogIdCount_t* ids = realloc (builder->entry.ids, sizeof (mdfCatalogIdCount_t) * (builder->tableMask + 1));
+	if (ids == NULL)
+		return errno;
+	builder->entry.ids = ids;
+
+	size_t idCount = 0;
+	for (size_t index = 0; index <= builder->tableMask; ++index)
+		if (builder->table [index].count != 0)
+			ids [idCount++] = builder->table [index];
+	qsort (ids, idCount, sizeof (mdfCatalogIdCount_t), compareIdCounts);
+
+	size_t signalCount = 0;
+	for (size_t index = 0; index < builder->signalCount; ++index)
+	{
+		if (builder->signalMins [index] > builder->signalMaxs [index])
+			continue;
+
+		builder->entry.signals [signalCount++] = (mdfCatalogSignal_t)
+		{
+			.name	= (char*) builder->signalNames [index],
+			.min	= builder->signalMins [index],
+			.max	= builder->signalMaxs [index]
+		};
+	}
+	builder->entry.signalCount = signalCount;
+
+	*entry = &builder->entry;
+	return 0;
+}
+
+int mdfCatalogBuilderReadSplit (mdfCatalogBuilder_t* builder, const char* path, uint32_t sessionNumber, uint32_t splitNumber,
+	const mdfCatalogEntry_t** entry)
+{
+	mdfCanBusReader_t reader;
+	if (mdfCanBusReaderInit (&reader, path) != 0)
+		return errno;
+
+	mdfCatalogBuilderReset (builder, sessionNumber, splitNumber, reader.startTimeNs);
+
+	mdfCanBusRecord_t records [READ_BATCH_SIZE];
+	size_t count;
+	int code = 0;
+	while (code == 0)
+	{
+		code = mdfCanBusReaderRead (&reader, records, READ_BATCH_SIZE, &count);
+		if (code != 0 || count == 0)
+			break;
+
+		for (size_t index = 0; index < count && code == 0; ++index)
+			code = mdfCatalogBuilderAddRecord (builder, &records [index]);
+	}
+
+	uint64_t fileSize = reader.mapSize;
+	mdfCanBusReaderClose (&reader);
+
+	if (code != 0)
+	{
+		errno = code;
+		return code;
+	}
+
+	return mdfCatalogBuilderComplete (builder, fileSize, entry);
+}
+
+void mdfCatalogBuilderDealloc (mdfCatalogBuilder_t* builder)
+{
+	free (builder->table);
+	free (builder->signalMins);
+	free (builder->signalMaxs);
+	free (builder->entry.ids);
+	free (builder->entry.signals);
+}
+
+/**
+ * @brief Gets the encoded size of an entry.
+ * @param entry The entry to get the size of.
+ * @return The size of the entry, in bytes.
+ */
+static size_t getEntrySize (const mdfCatalogEntry_t* entry)
+{
+	size_t size = ENTRY_HEADER_SIZE + ENTRY_ID_SIZE * entry->idCount;
+	for (size_t index = 0; index < entry->signalCount; ++index)
+		size += ENTRY_SIGNAL_SIZE + strlen (entry->signals [index].name);
+	return size;
+}
+
+static uint8_t* encodeField (uint8_t* data, const void* value, size_t size)
+{
+	memcpy (data, value, size);
+	return data + size;
+}
+
+/**
+ * @brief Writes an entry to a catalog file.
+ * @param catalog The catalog file to write to.
+ * @param entry The entry to write.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int writeEntry (FILE* catalog, const mdfCatalogEntry_t* entry)
+{
+	// Encode the entire entry up-front, so it is written by a single call.
+	size_t size = getEntrySize (entry);
+	uint8_t* data = malloc (size);
+	if (data == NULL)
+		return errno;
+
+	uint32_t entrySize = size;
+	uint32_t idCount = entry->idCount;
+	uint32_t signalCount = entry->signalCount;
+	uint32_t reserved = 0;
+
+	uint8_t* head = data;
+	head = encodeField (head, &entrySize, sizeof (entrySize));
+	head = encodeField (head, &entry->sessionNumber, sizeof (entry->sessionNumber));
+	head = encodeField (head, &entry->splitNumber, sizeof (entry->splitNumber));
+	head = encodeField (head, &idCount, sizeof (idCount));
+	head = encodeField (head, &signalCount, sizeof (signalCount));
+	head = encodeField (head, &reserved, sizeof (reserved));
+	head = encodeField (head, &entry->startTimeNs, sizeof (entry->startTimeNs));
+	head = encodeField (head, &entry->fileSize, sizeof (entry->fileSize));
+	head = encodeField (head, &entry->recordCount, sizeof (entry->recordCount));
+	head = encodeField (head, &entry->errorFrameCount, sizeof (entry->errorFrameCount));
+	head = encodeField (head, &entry->firstTimestampNs, sizeof (entry->firstTimestampNs));
+	head = encodeField (head, &entry->lastTimestampNs, sizeof (entry->lastTimestampNs));
+
+	for (size_t index = 0; index < entry->idCount; ++index)
+	{
+		head = encodeField (head, &entry->ids [index].id, sizeof (uint32_t));
+		head = encodeField (head, &entry->ids [index].count, sizeof (uint32_t));
+	}
+
+	for (size_t index = 0; index < entry->signalCount; ++index)
+	{
+		uint16_t nameLength = strlen (entry->signals [index].name);
+		head = encodeField (head, &entry->signals [index].min, sizeof (float));
+		head = encodeField (head, &entry->signals [index].max, sizeof (float));
+		head = encodeField (head, &nameLength, sizeof (nameLength));
+		head = encodeField (head, entry->signals [index].name, nameLength);
+	}
+
+	int code = 0;
+	if (fwrite (data, 1, size, catalog) != size)
+		code = errno;
+	free (data);
+
+	errno = code;
+	return code;
+}
+
+static const uint8_t* decodeField (const uint8_t* data, void* value, size_t size)
+{
+	memcpy (value, data, size);
+	return data + size;
+}
+
+/**
+ * @brief Decodes an entry of a catalog file.
+ * @param data The data of the entry.
+ * @param size The number of bytes remaining in the file, starting from @c data .
+ * @param entry Written to the decoded entry. Note its arrays reference temporary memory, see @c mdfCatalogInsert .
+ * @param ids Buffer to decode the entry's ID counts into. Must be de-allocated by the caller, regardless of the result.
+ * @param signals Buffer to decode the entry's signal ranges into. Must be de-allocated by the caller, regardless of the
+ * result. Note the names are allocated, so must be freed by the caller if successful.
+ * @return The size of the entry if successful, 0 otherwise.
+ */
+static size_t decodeEntry (const uint8_t* data, size_t size, mdfCatalogEntry_t* entry, mdfCatalogIdCount_t** ids,
+	mdfCatalogSignal_t** signals)
+{
+	if (size < ENTRY_HEADER_SIZE)
+		return 0;
+
+	uint32_t entrySize;
+	uint32_t idCount;
+	uint32_t signalCount;
+	uint32_t reserved;
+
+	const uint8_t* head = data;
+	head = decodeField (head, &entrySize, sizeof (entrySize));
+	head = decodeField (head, &entry->sessionNumber, sizeof (entry->sessionNumber));
+	head = decodeField (head, &entry->splitNumber, sizeof (entry->splitNumber));
+	head = decodeField (head, &idCount, sizeof (idCount));
+	head = decodeField (head, &signalCount, sizeof (signalCount));
+	head = decodeField (head, &reserved, sizeof (reserved));
+	head = decodeField (head, &entry->startTimeNs, sizeof (entry->startTimeNs));
+	head = decodeField (head, &entry->fileSize, sizeof (entry->fileSize));
+	head = decodeField (head, &entry->recordCount, sizeof (entry->recordCount));
+	head = decodeField (head, &entry->errorFrameCount, sizeof (entry->errorFrameCount));
+	head = decodeField (head, &entry->firstTimestampNs, sizeof (entry->firstTimestampNs));
+	head = decodeField (head, &entry->lastTimestampNs, sizeof (entry->lastTimestampNs));
+
+	if (entrySize > size || entrySize < ENTRY_HEADER_SIZE + (uint64_t) ENTRY_ID_SIZE * idCount +
+		(uint64_t) ENTRY_SIGNAL_SIZE * signalCount)
+		return 0;
+	const uint8_t* end = data + entrySize;
+
+	mdfCatalogIdCount_t* idBuffer = realloc (*ids, sizeof (mdfCatalogIdCount_t) * (idCount + 1));
+	if (idBuffer == NULL)
+		return 0;
+	*ids = idBuffer;
+
+	mdfCatalogSignal_t* signalBuffer = realloc (*signals, sizeof (mdfCatalogSignal_t) * (signalCount + 1));
+	if (signalBuffer == NULL)
+		return 0;
+	*signals = signalBuffer;
+
+	for (uint32_t index = 0; index < idCount; ++index)
+	{
+		head = decodeField (head, &idBuffer [index].id, sizeof (uint32_t));
+		head = decodeField (head, &idBuffer [index].count, sizeof (uint32_t));
+	}
+
+	uint32_t nameCount = 0;
+	for (; nameCount < signalCount; ++nameCount)
+	{
+		uint16_t nameLength;
+		if (end - head < ENTRY_SIGNAL_SIZE)
+			break;
+		head = decodeField (head, &signalBuffer [nameCount].min, sizeof (float));
+		head = decodeField (head, &signalBuffer [nameCount].max, sizeof (float));
+		head = decodeField (head, &nameLength, sizeof (nameLength));
+
+		if (end - head < nameLength)
+			break;
+		signalBuffer [nameCount].name = strndup ((const char*) head, nameLength);
+		if (signalBuffer [nameCount].name == NULL)
+			break;
+		head += nameLength;
+	}
+
+	if (nameCount != signalCount)
+	{
+		for (uint32_t index = 0; index < nameCount; ++index)
+			free (signalBuffer [index].name);
+		return 0;
+	}
+
+	entry->ids = *ids;
+	entry->idCount = idCount;
+	entry->signals = *signals;
+	entry->signalCount = signalCount;
+	return entrySize;
+}
+
+int mdfCatalogAppend (const char* directory, const mdfCatalogEntry_t* entry)
+{
+	char* path;
+	if (asprintf (&path, "%s/%s", directory, MDF_CATALOG_FILE_NAME) < 0)
+		return errno;
+
+	FILE* catalog = fopen (path, "ab");
+	free (path);
+	if (catalog == NULL)
+		return errno;
+
+	int code = 0;
+	if (fseek (catalog, 0, SEEK_END) != 0)
+		code = errno;
+
+	// A new catalog starts with its header.
+	if (code == 0 && ftell (catalog) == 0)
+	{
+		uint32_t version = CATALOG_VERSION;
+		uint32_t reserved = 0;
+		if (fwrite (CATALOG_MAGIC, 1, 8, catalog) != 8 || fwrite (&version, sizeof (version), 1, catalog) != 1 ||
+			fwrite (&reserved, sizeof (reserved), 1, catalog) != 1)
+			code = errno;
+	}
+
+	if (code == 0)
+		code = writeEntry (catalog, entry);
+
+	if (fclose (catalog) != 0 && code == 0)
+		code = errno;
+
+	errno = code;
+	return code;
+}
+
+int mdfCatalogLoad (mdfCatalog_t* catalog, const char* directory)
+{
+	*catalog = (mdfCatalog_t) {0};
+
+	char* path;
+	if (asprintf (&path, "%s/%s", directory, MDF_CATALOG_FILE_NAME) < 0)
+		return errno;
+
+	FILE* file = fopen (path, "rb");
+	free (path);
+	if (file == NULL)
+		return errno == ENOENT ? 0 : errno;
+
+	// The catalog is compact, so it is read in its entirety.
+	uint8_t* data = NULL;
+	long size = -1;
+	if (fseek (file, 0, SEEK_END) == 0)
+		size = ftell (file);
+	if (size >= 0 && fseek (file, 0, SEEK_SET) == 0)
+	{
+		data = malloc (size + 1);
+		if (data != NULL && fread (data, 1, size, file) != (size_t) size)
+		{
+			free (data);
+			data = NULL;
+		}
+	}
+	int code = (data == NULL) ? errno : 0;
+	fclose (file);
+	if (code != 0)
+		return code;
+
+	if (size < CATALOG_HEADER_SIZE || memcmp (data, CATALOG_MAGIC, 8) != 0 || *(uint32_t*) (data + 8) != CATALOG_VERSION)
+	{
+		free (data);
+		errno = ERRNO_MDF_CATALOG_MALFORMED;
+		return errno;
+	}
+
+	mdfCatalogIdCount_t* ids = NULL;
+	mdfCatalogSignal_t* signals = NULL;
+	for (size_t offset = CATALOG_HEADER_SIZE; offset < (size_t) size;)
+	{
+		mdfCatalogEntry_t entry;
+		size_t entrySize = decodeEntry (data + offset, size - offset, &entry, &ids, &signals);
+		if (entrySize == 0)
+		{
+			// An entry interrupted by a power loss is incomplete, in which case the rest of the catalog is ignored. Rebuilding
+			// the catalog repairs it.
+			debugPrintf ("Warning, MDF catalog '%s' is truncated at %lu bytes.\n", directory, (long unsigned) offset);
+			break;
+		}
+
+		code = mdfCatalogInsert (catalog, &entry);
+		for (size_t index = 0; index < entry.signalCount; ++index)
+			free (entry.signals [index].name);
+		if (code != 0)
+			break;
+
+		offset += entrySize;
+	}
+
+	free (ids);
+	free (signals);
+	free (data);
+
+	if (code != 0)
+	{
+		mdfCatalogDealloc (catalog);
+		errno = code;
+		return code;
+	}
+
+	return 0;
+}
+
+int mdfCatalogWrite (const mdfCatalog_t* catalog, const char* directory)
+{
+	char* path;
+	if (asprintf (&path, "%s/%s", directory, MDF_CATALOG_FILE_NAME) < 0)
+		return errno;
+
+	char* tempPath;
+	if (asprintf (&tempPath, "%s.tmp", path) < 0)
+	{
+		free (path);
+		return errno;
+	}
+
+	// Write to a temporary file, replacing the original once complete, so the catalog is never left incomplete.
+	int code = 0;
+	FILE* file = fopen (tempPath, "wb");
+	if (file == NULL)
+		code = errno;
+
+	uint32_t version = CATALOG_VERSION;
+	uint32_t reserved = 0;
+	if (code == 0 && (fwrite (CATALOG_MAGIC, 1, 8, file) != 8 || fwrite (&version, sizeof (version), 1, file) != 1 ||
+		fwrite (&reserved, sizeof (reserved), 1, file) != 1))
+		code = errno;
+
+	for (size_t index = 0; code == 0 && index < catalog->entryCount; ++index)
+		code = writeEntry (file, &catalog->entries [index]);
+
+	if (file != NULL && fclose (file) != 0 && code == 0)
+		code = errno;
+
+	if (code == 0 && renamePort (tempPath, path) != 0)
+		code = errno;
+
+	if (code != 0)
+		remove (tempPath);
+
+	free (tempPath);
+	free (path);
+
+	errno = code;
+	return code;
+}
+
+/**
+ * @brief Finds the index an entry of a catalog is, or would be, at.
+ * @param catalog The catalog to search.
+ * @param sessionNumber The session number of the entry.
+ * @param splitNumber The split number of the entry.
+ * @return The index of the first entry not preceding the given split.
+ */
+static size_t findEntryIndex (const mdfCatalog_t* catalog, uint32_t sessionNumber, uint32_t splitNumber)
+{
+	uint64_t key = ((uint64_t) sessionNumber << 32) | splitNumber;
+
+	size_t low = 0;
+	size_t high = catalog->entryCount;
+	while (low < high)
+	{
+		size_t middle = low + (high - low) / 2;
+		const mdfCatalogEntry_t* entry = &catalog->entries [middle];
+		if ((((uint64_t) entry->sessionNumber << 32) | entry->splitNumber) < key)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+static void deallocEntry (mdfCatalogEntry_t* entry)
+{
+	for (size_t index = 0; index < entry->signalCount; ++index)
+		free (entry->signals [index].name);
+	free (entry->signals);
+	free (entry->ids);
+}
+
+int mdfCatalogInsert (mdfCatalog_t* catalog, const mdfCatalogEntry_t* entry)
+{
+	// Deep-copy the entry.
+	mdfCatalogEntry_t copy = *entry;
+	copy.ids = malloc (sizeof (mdfCatalogIdCount_t) * (entry->idCount + 1));
+	copy.signals = calloc (entry->signalCount + 1, sizeof (mdfCatalogSignal_t));
+	if (copy.ids == NULL || copy.signals == NULL)
+	{
+		copy.signalCount = 0;
+		deallocEntry (&copy);
+		return errno;
+	}
+
+	memcpy (copy.ids, entry->ids, sizeof (mdfCatalogIdCount_t) * entry->idCount);
+	for (size_t index = 0; index < entry->signalCount; ++index)
+	{
+		copy.signals [index] = entry->signals [index];
+		copy.signals [index].name = strdup (entry->signals [index].name);
+		if (copy.signals [index].name == NULL)
+		{
+			int code = errno;
+			copy.signalCount = index;
+			deallocEntry (&copy);
+			errno = code;
+			return code;
+		}
+	}
+
+	// Replace the existing entry of the split, if any.
+	size_t index = findEntryIndex (catalog, entry->sessionNumber, entry->splitNumber);
+	if (index < catalog->entryCount && catalog->entries [index].sessionNumber == entry->sessionNumber &&
+		catalog->entries [index].splitNumber == entry->splitNumber)
+	{
+		deallocEntry (&catalog->entries [index]);
+		catalog->entries [index] = copy;
+		return 0;
+	}
+
+	mdfCatalogEntry_t* entries = realloc (catalog->entries, sizeof (mdfCatalogEntry_t) * (catalog->entryCount + 1));
+	if (entries == NULL)
+	{
+		int code = errno;
+		deallocEntry (&copy);
+		errno = code;
+		return code;
+	}
+	catalog->entries = entries;
+
+	memmove (&entries [index + 1], &entries [index], sizeof (mdfCatalogEntry_t) * (catalog->entryCount - index));
+	entries [index] = copy;
+	++catalog->entryCount;
+	return 0;
+}
+
+const mdfCatalogEntry_t* mdfCatalogFind (const mdfCatalog_t* catalog, uint32_t sessionNumber, uint32_t splitNumber)
+{
+	size_t index = findEntryIndex (catalog, sessionNumber, splitNumber);
+	if (index < catalog->entryCount && catalog->entries [index].sessionNumber == sessionNumber &&
+		catalog->entries [index].splitNumber == splitNumber)
+		return &catalog->entries [index];
+	return NULL;
+}
+
+uint32_t mdfCatalogEntryGetIdCount (const mdfCatalogEntry_t* entry, uint32_t id)
+{
+	mdfCatalogIdCount_t key = { .id = id };
+	const mdfCatalogIdCount_t* count = bsearch (&key, entry->ids, entry->idCount, sizeof (mdfCatalogIdCount_t),
+		compareIdCounts);
+	return count != NULL ? count->count : 0;
+}
+
+const mdfCatalogSignal_t* mdfCatalogEntryGetSignal (const mdfCatalogEntry_t* entry, const char* name)
+{
+	for (size_t index = 0; index < entry->signalCount; ++index)
+	{
+		const char* signalName = entry->signals [index].name;
+		if (strcmp (signalName, name) == 0)
+			return &entry->signals [index];
+
+		// Also match the signal name alone.
+		const char* separator = strchr (signalName, '.');
+		if (separator != NULL && strcmp (separator + 1, name) == 0)
+			return &entry->signals [index];
+	}
+
+	return NULL;
+}
+
+void mdfCatalogDealloc (mdfCatalog_t* catalog)
+{
+	for (size_t index = 0; index < catalog->entryCount; ++index)
+		deallocEntry (&catalog->entries [index]);
+	free (catalog->entries);
+	*catalog = (mdfCatalog_t) {0};
+}
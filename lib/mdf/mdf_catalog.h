@@ -0,0 +1,282 @@
+#ifndef MDF_CATALOG_H
+#define MDF_CATALOG_H
+
+// MDF Session Catalog --------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: Compact on-disk catalog of a directory of MDF CAN bus logging sessions, used to search the sessions without
+//   opening any of their splits. The catalog holds one entry per split, summarizing its time range, the number of frames of
+//   each CAN ID, the number of error frames, and optionally the range (minimum / maximum) of a set of signals.
+//
+//   The catalog is stored in the log directory ('catalog.bin'). Entries are appended as splits are closed, either by the
+//   logger itself or by a backfill tool. If a split is cataloged multiple times, the last entry takes precedence.
+//
+// File Format:
+//   char magic [8]                                   - "ZREMDFCT"
+//   uint32_t version, uint32_t reserved
+//   Entries, each:
+//     uint32_t entrySize                             - The size of the entry, including this field, in bytes.
+//     uint32_t sessionNumber, uint32_t splitNumber
+//     uint32_t idCount, uint32_t signalCount
+//     uint32_t reserved
+//     uint64_t startTimeNs                           - The start of the session, in nanoseconds since the Unix epoch.
+//     uint64_t fileSize, uint64_t recordCount, uint64_t errorFrameCount
+//     uint64_t firstTimestampNs, uint64_t lastTimestampNs
+//     idCount x { uint32_t id, uint32_t count }      - In ascending order of ID.
+//     signalCount x { float min, float max, uint16_t nameLength, char name [nameLength] }
+//
+//   All values are little-endian.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "mdf_can_bus_reader.h"
+
+// C Standard Library
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The name of the catalog file, within the log directory.
+#define MDF_CATALOG_FILE_NAME "catalog.bin"
+
+/// @brief Flag set in the ID of a catalog entry's ID count, if the ID is extended.
+#define MDF_CATALOG_ID_IDE 0x80000000
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of frames of a CAN ID.
+typedef struct
+{
+	/// @brief The CAN ID, with @c MDF_CATALOG_ID_IDE set if the ID is extended.
+	uint32_t id;
+
+	/// @brief The number of data / RTR frames of the ID.
+	uint32_t count;
+} mdfCatalogIdCount_t;
+
+/// @brief The range of a signal.
+typedef struct
+{
+	/// @brief The name of the signal ('Message.Signal').
+	char* name;
+
+	float min;
+	float max;
+} mdfCatalogSignal_t;
+
+/// @brief The catalog entry of a split.
+typedef struct
+{
+	uint32_t sessionNumber;
+	uint32_t splitNumber;
+
+	/// @brief The start of the session, in nanoseconds since the Unix epoch.
+	uint64_t startTimeNs;
+
+	/// @brief The size of the split when it was cataloged, in bytes.
+	uint64_t fileSize;
+
+	/// @brief The number of records of the split.
+	uint64_t recordCount;
+
+	/// @brief The number of error frames of the split.
+	uint64_t errorFrameCount;
+
+	/// @brief The timestamps of the earliest and latest records of the split, relative to the start of the session, in
+	/// nanoseconds. Only valid if @c recordCount is not 0.
+	uint64_t firstTimestampNs;
+	uint64_t lastTimestampNs;
+
+	/// @brief The number of frames of each CAN ID, in ascending order of ID.
+	mdfCatalogIdCount_t* ids;
+	size_t idCount;
+
+	/// @brief The range of each summarized signal. Only signals with at least one value are present.
+	mdfCatalogSignal_t* signals;
+	size_t signalCount;
+} mdfCatalogEntry_t;
+
+/// @brief The catalog of a log directory.
+typedef struct
+{
+	/// @brief The entries of the catalog, in order of session number, then split number.
+	mdfCatalogEntry_t* entries;
+	size_t entryCount;
+} mdfCatalog_t;
+
+struct mdfCatalogBuilder;
+
+/**
+ * @brief Function called for each record added to a catalog builder, used to summarize signals. Implementations should
+ * decode the record's signals, passing each to @c mdfCatalogBuilderUpdateSignal .
+ * @param builder The builder the record was added to.
+ * @param record The record.
+ * @param arg The user argument given to @c mdfCatalogBuilderInit .
+ */
+typedef void mdfCatalogSignalCallback_t (struct mdfCatalogBuilder* builder, const mdfCanBusRecord_t* record, void* arg);
+
+/// @brief Builder of catalog entries, see @c mdfCatalogBuilderInit .
+typedef struct mdfCatalogBuilder
+{
+	/// @brief The entry being built. Note the ID counts and signal ranges are only populated upon completion.
+	mdfCatalogEntry_t entry;
+
+	/// @brief Open-addressing hash table of the ID counts. Empty slots have a count of 0.
+	mdfCatalogIdCount_t* table;
+	size_t tableMask;
+
+	/// @brief The names of the signals to summarize.
+	const char* const* signalNames;
+	size_t signalCount;
+
+	/// @brief The range of each signal. A minimum greater than the maximum indicates no value has been observed.
+	float* signalMins;
+	float* signalMaxs;
+
+	mdfCatalogSignalCallback_t* callback;
+	void* arg;
+} mdfCatalogBuilder_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes a catalog entry builder.
+ * @param builder The builder to initialize.
+ * @param signalNames The names of the signals to summarize ('Message.Signal'). Must remain valid for the lifetime of the
+ * builder. @c NULL if no signals are summarized.
+ * @param signalCount The number of elements in @c signalNames .
+ * @param callback Function called for each record added, used to summarize the signals. @c NULL if no signals are summarized.
+ * @param arg User argument to pass to @c callback .
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCatalogBuilderInit (mdfCatalogBuilder_t* builder, const char* const* signalNames, size_t signalCount,
+	mdfCatalogSignalCallback_t* callback, void* arg);
+
+/**
+ * @brief Starts a new entry, discarding the current one.
+ * @param builder The builder to reset.
+ * @param sessionNumber The session number of the split.
+ * @param splitNumber The split number of the split.
+ * @param startTimeNs The start of the session, in nanoseconds since the Unix epoch.
+ */
+void mdfCatalogBuilderReset (mdfCatalogBuilder_t* builder, uint32_t sessionNumber, uint32_t splitNumber, uint64_t startTimeNs);
+
+/**
+ * @brief Adds a record of the split to the current entry.
+ * @param builder The builder to add to.
+ * @param record The record to add.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCatalogBuilderAddRecord (mdfCatalogBuilder_t* builder, const mdfCanBusRecord_t* record);
+
+/**
+ * @brief Updates the range of a signal with a value. Called by the builder's signal callback.
+ * @param builder The builder to update.
+ * @param signalIndex The index of the signal, within the builder's signal names.
+ * @param value The value of the signal.
+ */
+static inline void mdfCatalogBuilderUpdateSignal (mdfCatalogBuilder_t* builder, size_t signalIndex, float value)
+{
+	if (value < builder->signalMins [signalIndex])
+		builder->signalMins [signalIndex] = value;
+	if (value > builder->signalMaxs [signalIndex])
+		builder->signalMaxs [signalIndex] = value;
+}
+
+/**
+ * @brief Completes the current entry, populating its ID counts and signal ranges.
+ * @param builder The builder to complete.
+ * @param fileSize The size of the split, in bytes.
+ * @param entry Written to the completed entry. References the builder's memory, so it is only valid until the builder is
+ * next reset.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCatalogBuilderComplete (mdfCatalogBuilder_t* builder, uint64_t fileSize, const mdfCatalogEntry_t** entry);
+
+/**
+ * @brief Builds the entry of a split by reading all of its records.
+ * @param builder The builder to use. Reset before the split is read.
+ * @param path The path of the split.
+ * @param sessionNumber The session number of the split.
+ * @param splitNumber The split number of the split.
+ * @param entry Written to the completed entry, see @c mdfCatalogBuilderComplete .
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCatalogBuilderReadSplit (mdfCatalogBuilder_t* builder, const char* path, uint32_t sessionNumber, uint32_t splitNumber,
+	const mdfCatalogEntry_t** entry);
+
+/**
+ * @brief De-allocates the memory owned by a catalog entry builder.
+ * @param builder The builder to de-allocate.
+ */
+void mdfCatalogBuilderDealloc (mdfCatalogBuilder_t* builder);
+
+/**
+ * @brief Appends an entry to the catalog of a log directory, creating the catalog if it does not exist.
+ * @param directory The log directory.
+ * @param entry The entry to append.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCatalogAppend (const char* directory, const mdfCatalogEntry_t* entry);
+
+/**
+ * @brief Loads the catalog of a log directory. If a split has multiple entries, only the last is kept.
+ * @param catalog The catalog to load into. Must be de-allocated using @c mdfCatalogDealloc if successful.
+ * @param directory The log directory.
+ * @return 0 if successful, the error code otherwise. Note a directory without a catalog loads as an empty catalog.
+ */
+int mdfCatalogLoad (mdfCatalog_t* catalog, const char* directory);
+
+/**
+ * @brief Writes a catalog to a log directory, replacing the existing catalog.
+ * @param catalog The catalog to write.
+ * @param directory The log directory.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCatalogWrite (const mdfCatalog_t* catalog, const char* directory);
+
+/**
+ * @brief Inserts (or replaces) the entry of a split into a loaded catalog. The entry is deep-copied.
+ * @param catalog The catalog to insert into.
+ * @param entry The entry to insert.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfCatalogInsert (mdfCatalog_t* catalog, const mdfCatalogEntry_t* entry);
+
+/**
+ * @brief Finds the entry of a split in a loaded catalog.
+ * @param catalog The catalog to search.
+ * @param sessionNumber The session number of the split.
+ * @param splitNumber The split number of the split.
+ * @return The entry of the split, @c NULL if the split is not cataloged.
+ */
+const mdfCatalogEntry_t* mdfCatalogFind (const mdfCatalog_t* catalog, uint32_t sessionNumber, uint32_t splitNumber);
+
+/**
+ * @brief Gets the number of frames of a CAN ID in a split.
+ * @param entry The entry of the split.
+ * @param id The CAN ID, with @c MDF_CATALOG_ID_IDE set if the ID is extended.
+ * @return The number of frames of the ID.
+ */
+uint32_t mdfCatalogEntryGetIdCount (const mdfCatalogEntry_t* entry, uint32_t id);
+
+/**
+ * @brief Gets the range of a signal in a split.
+ * @param entry The entry of the split.
+ * @param name The name of the signal, either 'Message.Signal' or just 'Signal'.
+ * @return The range of the signal, @c NULL if the signal was not summarized or had no values.
+ */
+const mdfCatalogSignal_t* mdfCatalogEntryGetSignal (const mdfCatalogEntry_t* entry, const char* name);
+
+/**
+ * @brief De-allocates the memory owned by a catalog.
+ * @param catalog The catalog to de-allocate.
+ */
+void mdfCatalogDealloc (mdfCatalog_t* catalog);
+
+#endif // MDF_CATALOG_H
@@ -0,0 +1,641 @@
+// For asprintf. Note this must be the first include in this file.
+#define _GNU_SOURCE
+#include <stdio.h>
+
+// Header
+#include "mdf_pipeline.h"
+
+// Includes
+#include "debug.h"
+#include "error_codes.h"
+#include "mdf_can_bus_index.h"
+#include "mdf_can_bus_logging.h"
+#include "mdf_catalog.h"
+#include "misc_port.h"
+#include "time_port.h"
+
+// POSIX
+#include <unistd.h>
+
+// C Standard Library
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+// Journal events, other than stage names
+#define EVENT_OPEN		"open"
+#define EVENT_QUEUED	"queued"
+#define EVENT_DONE		"done"
+
+/// @brief The maximum length of a journal line, in characters.
+#define JOURNAL_LINE_MAX 128
+
+/// @brief The period at which the pipeline thread checks for split events, in milliseconds. The producer never signals the
+/// thread, as that would require locking the pipeline's mutex.
+#define EVENT_POLL_PERIOD_MS 100
+
+// Built-in Stages ------------------------------------------------------------------------------------------------------------
+
+static int recoverStage (const mdfPipelineSplit_t* split, void* arg)
+{
+	(void) arg;
+
+	mdfCanBusLogRecovery_t recovery;
+	if (mdfCanBusLogRecoverSplit (split->path, &recovery) != 0)
+		return errno;
+
+	if (!recovery.finalized)
+		debugPrintf ("Recovered MDF split '%s': %lu records, %lu bytes discarded.\n", split->path,
+			(unsigned long) recovery.recordCount, (unsigned long) (recovery.fileSize - recovery.recoveredSize));
+
+	return 0;
+}
+
+static int compressStage (const mdfPipelineSplit_t* split, void* arg)
+{
+	(void) arg;
+
+	mdfCanBusLogCompression_t compression;
+	if (mdfCanBusLogCompressSplit (split->path, split->rateLimit, &compression) != 0)
+		return errno;
+
+	if (!compression.skipped)
+		debugPrintf ("Compressed MDF split '%s': %lu bytes to %lu bytes.\n", split->path,
+			(unsigned long) compression.fileSize, (unsigned long) compression.compressedSize);
+
+	return 0;
+}
+
+static int indexStage (const mdfPipelineSplit_t* split, void* arg)
+{
+	(void) arg;
+
+	// Loading the index builds and caches it, if it is not already.
+	mdfCanBusIndex_t index;
+	if (mdfCanBusIndexLoad (&index, split->path) != 0)
+		return errno;
+
+	mdfCanBusIndexDealloc (&index);
+	return 0;
+}
+
+static int catalogStage (const mdfPipelineSplit_t* split, void* arg)
+{
+	mdfCatalogBuilder_t* builder = arg;
+	mdfCatalogBuilder_t defaultBuilder;
+	if (builder == NULL)
+	{
+		if (mdfCatalogBuilderInit (&defaultBuilder, NULL, 0, NULL, NULL) != 0)
+			return errno;
+		builder = &defaultBuilder;
+	}
+
+	int code = 0;
+	const mdfCatalogEntry_t* entry;
+	if (mdfCatalogBuilderReadSplit (builder, split->path, split->sessionNumber, split->splitNumber, &entry) != 0 ||
+		mdfCatalogAppend (split->directory, entry) != 0)
+		code = errno;
+
+	if (builder == &defaultBuilder)
+		mdfCatalogBuilderDealloc (&defaultBuilder);
+
+	errno = code;
+	return code;
+}
+
+/// @brief The built-in stages, see @c mdfPipelineGetStage .
+static const mdfPipelineStage_t BUILT_IN_STAGES [] =
+{
+	{ .name = "recover",	.function = recoverStage },
+	{ .name = "compress",	.function = compressStage },
+	{ .name = "index",		.function = indexStage },
+	{ .name = "catalog",	.function = catalogStage }
+};
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Finds the pending entry of a split.
+ * @return The index of the entry, @c pipeline->entryCount if the split has none.
+ */
+static size_t findEntry (mdfPipeline_t* pipeline, uint32_t sessionNumber, uint32_t splitNumber)
+{
+	for (size_t index = 0; index < pipeline->entryCount; ++index)
+		if (pipeline->entries [index].sessionNumber == sessionNumber && pipeline->entries [index].splitNumber == splitNumber)
+			return index;
+
+	return pipeline->entryCount;
+}
+
+/**
+ * @brief Appends a new entry to a pipeline's pending entries.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int appendEntry (mdfPipeline_t* pipeline, const mdfPipelineEntry_t* entry)
+{
+	if (pipeline->entryCount == pipeline->entryCapacity)
+	{
+		size_t capacity = pipeline->entryCapacity != 0 ? pipeline->entryCapacity * 2 : 16;
+		mdfPipelineEntry_t* entries = realloc (pipeline->entries, sizeof (mdfPipelineEntry_t) * capacity);
+		if (entries == NULL)
+			return errno;
+
+		pipeline->entries = entries;
+		pipeline->entryCapacity = capacity;
+	}
+
+	pipeline->entries [pipeline->entryCount] = *entry;
+	++pipeline->entryCount;
+	return 0;
+}
+
+static void removeEntry (mdfPipeline_t* pipeline, size_t index)
+{
+	memmove (&pipeline->entries [index], &pipeline->entries [index + 1],
+		sizeof (mdfPipelineEntry_t) * (pipeline->entryCount - index - 1));
+	--pipeline->entryCount;
+}
+
+/**
+ * @brief Finds the stage of a pipeline with a name.
+ * @return The index of the stage, @c pipeline->config.stageCount if no stage has the name.
+ */
+static size_t findStage (mdfPipeline_t* pipeline, const char* name)
+{
+	for (size_t index = 0; index < pipeline->config.stageCount; ++index)
+		if (strcmp (pipeline->config.stages [index].name, name) == 0)
+			return index;
+
+	return pipeline->config.stageCount;
+}
+
+/**
+ * @brief Appends an event to the journal. Must only be called by the pipeline thread (or before it is started).
+ * @param pipeline The pipeline to journal.
+ * @param sessionNumber The session number of the split.
+ * @param splitNumber The number of the split.
+ * @param event The event to journal.
+ * @param sync Indicates the journal should be synchronized to the storage device. Only needed for events that cannot be
+ * recreated, as stages are idempotent.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int writeEvent (mdfPipeline_t* pipeline, uint32_t sessionNumber, uint32_t splitNumber, const char* event, bool sync)
+{
+	if (fprintf (pipeline->journal, "%"PRIu32" %"PRIu32" %s\n", sessionNumber, splitNumber, event) < 0)
+		return errno;
+
+	if (fflush (pipeline->journal) != 0)
+		return errno;
+
+	if (sync && fsyncPort (pipeline->journal) != 0)
+		return errno;
+
+	return 0;
+}
+
+/**
+ * @brief Reads the journal of the log directory, populating the pending entries. Splits left open are assumed to have been
+ * interrupted, so are ready to be processed.
+ * @param pipeline The pipeline to populate.
+ * @param path The path of the journal.
+ * @return 0 if successful, the error code otherwise. Note a directory without a journal has no pending entries.
+ */
+static int readJournal (mdfPipeline_t* pipeline, const char* path)
+{
+	FILE* journal = fopen (path, "r");
+	if (journal == NULL)
+		return errno == ENOENT ? 0 : errno;
+
+	char line [JOURNAL_LINE_MAX];
+	while (fgets (line, sizeof (line), journal) != NULL)
+	{
+		// Note the last line may be incomplete, if power was lost while it was written.
+		uint32_t sessionNumber;
+		uint32_t splitNumber;
+		// Note the field width must match MDF_PIPELINE_STAGE_NAME_MAX.
+		char event [MDF_PIPELINE_STAGE_NAME_MAX + 1];
+		if (strchr (line, '\n') == NULL ||
+			sscanf (line, "%"SCNu32" %"SCNu32" %31s", &sessionNumber, &splitNumber, event) != 3)
+			continue;
+
+		size_t index = findEntry (pipeline, sessionNumber, splitNumber);
+		if (strcmp (event, EVENT_DONE) == 0)
+		{
+			if (index != pipeline->entryCount)
+				removeEntry (pipeline, index);
+			continue;
+		}
+
+		if (index == pipeline->entryCount)
+		{
+			mdfPipelineEntry_t entry =
+			{
+				.sessionNumber	= sessionNumber,
+				.splitNumber	= splitNumber,
+				.stageIndex		= 0,
+				.closed			= true
+			};
+
+			if (appendEntry (pipeline, &entry) != 0)
+			{
+				int code = errno;
+				fclose (journal);
+				errno = code;
+				return code;
+			}
+		}
+
+		// Stages no longer in the pipeline are ignored.
+		size_t stageIndex = findStage (pipeline, event);
+		if (stageIndex != pipeline->config.stageCount)
+			pipeline->entries [index].stageIndex = stageIndex + 1;
+	}
+
+	fclose (journal);
+	return 0;
+}
+
+/**
+ * @brief Rewrites the journal of the log directory, only retaining the pending entries, then opens it for appending.
+ * @param pipeline The pipeline to journal.
+ * @param path The path of the journal.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int compactJournal (mdfPipeline_t* pipeline, const char* path)
+{
+	// Write the compacted journal to a temporary file, replacing the original once complete. This way, the journal is never
+	// left incomplete.
+	char* tempPath;
+	if (asprintf (&tempPath, "%s.tmp", path) < 0)
+		return errno;
+
+	pipeline->journal = fopen (tempPath, "w");
+	if (pipeline->journal == NULL)
+	{
+		int code = errno;
+		free (tempPath);
+		errno = code;
+		return code;
+	}
+
+	int code = 0;
+	for (size_t index = 0; code == 0 && index < pipeline->entryCount; ++index)
+	{
+		mdfPipelineEntry_t* entry = &pipeline->entries [index];
+		code = writeEvent (pipeline, entry->sessionNumber, entry->splitNumber, EVENT_QUEUED, false);
+		if (code == 0 && entry->stageIndex != 0)
+			code = writeEvent (pipeline, entry->sessionNumber, entry->splitNumber,
+				pipeline->config.stages [entry->stageIndex - 1].name, false);
+	}
+
+	if (code == 0 && fsyncPort (pipeline->journal) != 0)
+		code = errno;
+
+	if (fclose (pipeline->journal) != 0 && code == 0)
+		code = errno;
+
+	if (code == 0 && renamePort (tempPath, path) != 0)
+		code = errno;
+
+	free (tempPath);
+	if (code != 0)
+	{
+		errno = code;
+		return code;
+	}
+
+	pipeline->journal = fopen (path, "a");
+	if (pipeline->journal == NULL)
+		return errno;
+
+	return 0;
+}
+
+/// @return True if the pipeline is still running, false if it is stopping.
+static bool isRunning (mdfPipeline_t* pipeline)
+{
+	pthread_mutex_lock (&pipeline->mutex);
+	bool running = !pipeline->closing;
+	pthread_mutex_unlock (&pipeline->mutex);
+	return running;
+}
+
+/**
+ * @brief Runs the remaining stages of a split.
+ * @param pipeline The pipeline to use.
+ * @param entry The entry of the split.
+ * @param stopped Written to true if the pipeline was stopped before every stage was run, false otherwise.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int processSplit (mdfPipeline_t* pipeline, const mdfPipelineEntry_t* entry, bool* stopped)
+{
+	*stopped = false;
+
+	char* path;
+	if (asprintf (&path, "%s/session_%"PRIu32"/split_%"PRIu32".mf4", pipeline->config.directory, entry->sessionNumber,
+		entry->splitNumber) < 0)
+		return errno;
+
+	mdfPipelineSplit_t split =
+	{
+		.path			= path,
+		.directory		= pipeline->config.directory,
+		.sessionNumber	= entry->sessionNumber,
+		.splitNumber	= entry->splitNumber,
+		.rateLimit		= pipeline->config.rateLimit
+	};
+
+	// Splits that no longer exist (ex. deleted by the retention policy) have nothing left to process.
+	int code = 0;
+	bool exists = access (path, F_OK) == 0;
+	for (size_t index = entry->stageIndex; exists && code == 0 && index < pipeline->config.stageCount; ++index)
+	{
+		if (!isRunning (pipeline))
+		{
+			*stopped = true;
+			break;
+		}
+
+		const mdfPipelineStage_t* stage = &pipeline->config.stages [index];
+		code = stage->function (&split, stage->arg);
+		if (code != 0)
+		{
+			debugPrintf ("Warning, pipeline stage '%s' failed on MDF split '%s': %s.\n", stage->name, path,
+				errorCodeToMessage (code));
+			break;
+		}
+
+		code = writeEvent (pipeline, entry->sessionNumber, entry->splitNumber, stage->name, false);
+	}
+
+	if (code == 0 && !*stopped)
+		code = writeEvent (pipeline, entry->sessionNumber, entry->splitNumber, EVENT_DONE, false);
+
+	free (path);
+	errno = code;
+	return code;
+}
+
+/**
+ * @brief Journals the split events queued by the producer, adding the splits to the pending entries. Must only be called by
+ * the pipeline thread, with the mutex unlocked.
+ * @param pipeline The pipeline to drain.
+ */
+static void drainEvents (mdfPipeline_t* pipeline)
+{
+	// Only this thread writes the tail, so it can be read relaxed.
+	size_t tail = atomic_load_explicit (&pipeline->eventTail, memory_order_relaxed);
+	size_t head = atomic_load_explicit (&pipeline->eventHead, memory_order_acquire);
+	if (tail == head)
+		return;
+
+	// Copy the events out, freeing their slots before the journal is written.
+	mdfPipelineEvent_t events [MDF_PIPELINE_EVENT_QUEUE_SIZE];
+	size_t count = head - tail;
+	for (size_t index = 0; index < count; ++index)
+		events [index] = pipeline->events [(tail + index) & (MDF_PIPELINE_EVENT_QUEUE_SIZE - 1)];
+	atomic_store_explicit (&pipeline->eventTail, head, memory_order_release);
+
+	// Unlike stage events, these cannot be recreated, so are synchronized immediately.
+	int code = 0;
+	for (size_t index = 0; code == 0 && index < count; ++index)
+		code = writeEvent (pipeline, events [index].sessionNumber, events [index].splitNumber,
+			events [index].closed ? EVENT_QUEUED : EVENT_OPEN, false);
+
+	if (code == 0 && fsyncPort (pipeline->journal) != 0)
+		code = errno;
+
+	if (code != 0)
+		debugPrintf ("Warning, failed to journal MDF split events: %s.\n", errorCodeToMessage (code));
+
+	pthread_mutex_lock (&pipeline->mutex);
+	for (size_t index = 0; index < count; ++index)
+	{
+		mdfPipelineEvent_t* event = &events [index];
+		size_t entryIndex = findEntry (pipeline, event->sessionNumber, event->splitNumber);
+		if (entryIndex != pipeline->entryCount)
+		{
+			if (event->closed)
+				pipeline->entries [entryIndex].closed = true;
+			continue;
+		}
+
+		mdfPipelineEntry_t entry =
+		{
+			.sessionNumber	= event->sessionNumber,
+			.splitNumber	= event->splitNumber,
+			.stageIndex		= 0,
+			.closed			= event->closed
+		};
+
+		if (appendEntry (pipeline, &entry) != 0)
+			debugPrintf ("Warning, failed to add MDF split %"PRIu32" to the pipeline: %s.\n", event->splitNumber,
+				errorCodeToMessage (errno));
+	}
+	pthread_mutex_unlock (&pipeline->mutex);
+}
+
+static void* pipelineThread (void* arg)
+{
+	mdfPipeline_t* pipeline = arg;
+
+	// Post-processing is never urgent, so only run when the system is otherwise idle.
+	if (idlePriorityPort () != 0)
+		debugPrintf ("Warning, failed to lower MDF pipeline priority: %s.\n", errorCodeToMessage (errno));
+
+	struct timespec pollPeriod =
+	{
+		.tv_sec		= EVENT_POLL_PERIOD_MS / 1000,
+		.tv_nsec	= (EVENT_POLL_PERIOD_MS % 1000) * 1000000
+	};
+
+	while (true)
+	{
+		drainEvents (pipeline);
+
+		// Find the oldest closed split, waiting for the next poll if there is none.
+		pthread_mutex_lock (&pipeline->mutex);
+		size_t index;
+		for (index = 0; index < pipeline->entryCount; ++index)
+			if (pipeline->entries [index].closed)
+				break;
+
+		if (!pipeline->closing && index == pipeline->entryCount)
+		{
+			struct timespec deadline;
+			clock_gettime (CLOCK_REALTIME, &deadline);
+			deadline = timespecAdd (&deadline, &pollPeriod);
+			pthread_cond_timedwait (&pipeline->condition, &pipeline->mutex, &deadline);
+			pthread_mutex_unlock (&pipeline->mutex);
+			continue;
+		}
+
+		if (pipeline->closing)
+		{
+			pthread_mutex_unlock (&pipeline->mutex);
+			break;
+		}
+
+		// Note entries are only ever removed by this thread, so the index remains valid while unlocked.
+		mdfPipelineEntry_t entry = pipeline->entries [index];
+		pthread_mutex_unlock (&pipeline->mutex);
+
+		bool stopped;
+		int code = processSplit (pipeline, &entry, &stopped);
+		if (stopped)
+			break;
+
+		// Failed splits are retried the next time the pipeline is started.
+		pthread_mutex_lock (&pipeline->mutex);
+		removeEntry (pipeline, index);
+		if (code == 0)
+			++pipeline->stats.processedCount;
+		else
+			++pipeline->stats.failedCount;
+		pthread_mutex_unlock (&pipeline->mutex);
+	}
+
+	// Journal any splits reported before the pipeline was stopped, so they are resumed on the next start.
+	drainEvents (pipeline);
+
+	return NULL;
+}
+
+int mdfPipelineStart (mdfPipeline_t* pipeline, const mdfPipelineConfig_t* config)
+{
+	pipeline->config = *config;
+	pipeline->journal = NULL;
+	pipeline->entries = NULL;
+	pipeline->entryCount = 0;
+	pipeline->entryCapacity = 0;
+	pipeline->closing = false;
+	pipeline->stats = (mdfPipelineStats_t) {0};
+	atomic_init (&pipeline->eventHead, 0);
+	atomic_init (&pipeline->eventTail, 0);
+	atomic_init (&pipeline->eventOverflowCount, 0);
+
+	for (size_t index = 0; index < config->stageCount; ++index)
+	{
+		const char* name = config->stages [index].name;
+		if (strlen (name) > MDF_PIPELINE_STAGE_NAME_MAX || strcspn (name, " \t\n") != strlen (name) ||
+			strcmp (name, EVENT_OPEN) == 0 || strcmp (name, EVENT_QUEUED) == 0 || strcmp (name, EVENT_DONE) == 0)
+		{
+			errno = EINVAL;
+			return errno;
+		}
+	}
+
+	char* path;
+	if (asprintf (&path, "%s/%s", config->directory, MDF_PIPELINE_JOURNAL_FILE_NAME) < 0)
+		return errno;
+
+	int code = readJournal (pipeline, path);
+	if (code == 0)
+		code = compactJournal (pipeline, path);
+	free (path);
+
+	if (code != 0)
+	{
+		free (pipeline->entries);
+		errno = code;
+		return code;
+	}
+
+	if (pipeline->entryCount != 0)
+		debugPrintf ("Resuming %lu MDF splits left in the pipeline.\n", (unsigned long) pipeline->entryCount);
+
+	pthread_mutex_init (&pipeline->mutex, NULL);
+	pthread_cond_init (&pipeline->condition, NULL);
+
+	code = pthread_create (&pipeline->thread, NULL, pipelineThread, pipeline);
+	if (code != 0)
+	{
+		pthread_cond_destroy (&pipeline->condition);
+		pthread_mutex_destroy (&pipeline->mutex);
+		fclose (pipeline->journal);
+		free (pipeline->entries);
+		errno = code;
+		return code;
+	}
+
+	return 0;
+}
+
+int mdfPipelineAddSplit (mdfPipeline_t* pipeline, uint32_t sessionNumber, uint32_t splitNumber, bool closed)
+{
+	// Only the producer writes the head, so it can be read relaxed.
+	size_t head = atomic_load_explicit (&pipeline->eventHead, memory_order_relaxed);
+	size_t tail = atomic_load_explicit (&pipeline->eventTail, memory_order_acquire);
+	if (head - tail == MDF_PIPELINE_EVENT_QUEUE_SIZE)
+	{
+		atomic_fetch_add_explicit (&pipeline->eventOverflowCount, 1, memory_order_relaxed);
+		errno = ENOBUFS;
+		return errno;
+	}
+
+	pipeline->events [head & (MDF_PIPELINE_EVENT_QUEUE_SIZE - 1)] = (mdfPipelineEvent_t)
+	{
+		.sessionNumber	= sessionNumber,
+		.splitNumber	= splitNumber,
+		.closed			= closed
+	};
+
+	// The pipeline thread picks the event up on its next poll.
+	atomic_store_explicit (&pipeline->eventHead, head + 1, memory_order_release);
+	return 0;
+}
+
+void mdfPipelineSplitCallback (uint32_t sessionNumber, uint32_t splitNumber, bool closed, void* arg)
+{
+	if (mdfPipelineAddSplit (arg, sessionNumber, splitNumber, closed) != 0)
+		debugPrintf ("Warning, failed to add MDF split %"PRIu32" to the pipeline: %s.\n", splitNumber,
+			errorCodeToMessage (errno));
+}
+
+void mdfPipelineGetStats (mdfPipeline_t* pipeline, mdfPipelineStats_t* stats)
+{
+	pthread_mutex_lock (&pipeline->mutex);
+	*stats = pipeline->stats;
+	stats->droppedCount = atomic_load_explicit (&pipeline->eventOverflowCount, memory_order_relaxed);
+
+	stats->pendingCount = 0;
+	for (size_t index = 0; index < pipeline->entryCount; ++index)
+		if (pipeline->entries [index].closed)
+			++stats->pendingCount;
+
+	pthread_mutex_unlock (&pipeline->mutex);
+}
+
+void mdfPipelineStop (mdfPipeline_t* pipeline)
+{
+	pthread_mutex_lock (&pipeline->mutex);
+	pipeline->closing = true;
+	pthread_cond_signal (&pipeline->condition);
+	pthread_mutex_unlock (&pipeline->mutex);
+	pthread_join (pipeline->thread, NULL);
+
+	// The thread has been joined, so the pending and dropped counts may be updated directly.
+	pipeline->stats.droppedCount = atomic_load_explicit (&pipeline->eventOverflowCount, memory_order_relaxed);
+	pipeline->stats.pendingCount = 0;
+	for (size_t index = 0; index < pipeline->entryCount; ++index)
+		if (pipeline->entries [index].closed)
+			++pipeline->stats.pendingCount;
+
+	pthread_cond_destroy (&pipeline->condition);
+	pthread_mutex_destroy (&pipeline->mutex);
+	fclose (pipeline->journal);
+	free (pipeline->entries);
+	pipeline->entries = NULL;
+}
+
+const mdfPipelineStage_t* mdfPipelineGetStage (const char* name)
+{
+	for (size_t index = 0; index < sizeof (BUILT_IN_STAGES) / sizeof (BUILT_IN_STAGES [0]); ++index)
+		if (strcmp (BUILT_IN_STAGES [index].name, name) == 0)
+			return &BUILT_IN_STAGES [index];
+
+	return NULL;
+}
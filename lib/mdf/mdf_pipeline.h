@@ -0,0 +1,244 @@
+#ifndef MDF_PIPELINE_H
+#define MDF_PIPELINE_H
+
+// MDF Split Post-Processing Pipeline -----------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.19
+//
+// Description: Background post-processing of the splits of an MDF CAN bus log (see mdf_can_bus_logging.h). Each closed split
+//   is passed through a sequence of stages, for instance recovering it, building its time index, cataloging it, then
+//   compressing it. The stages are run by a single thread at idle priority (see @c idlePriorityPort ), so the work only
+//   happens when the CPU and storage device are not needed by the logger.
+//
+//   Progress is recorded in a journal within the log directory ('pipeline.journal'). Should the pipeline be stopped (or power
+//   be lost) before a split has passed through every stage, its remaining stages are resumed the next time the pipeline is
+//   started. Splits that were still being written at the time (never closed) are resumed as well, which is why a recovery
+//   stage is useful. As a stage may be interrupted part-way, stages must be idempotent, that is, running a stage on a split
+//   it has already processed must be harmless.
+//
+//   Splits are reported by the log's writer thread, which must never wait on the pipeline thread (running at idle priority,
+//   it may be starved indefinitely). Instead, split events are handed to the pipeline thread through a lock-free queue, and
+//   only the pipeline thread writes (and synchronizes) the journal. Should the queue fill, further events are dropped and
+//   counted, their splits are left unprocessed.
+//
+// Journal Format:
+//   One line per event, '<Session Number> <Split Number> <Event>', where the event is one of:
+//     open                                           - The split was created, it is being written.
+//     queued                                         - The split was closed, it is ready to be processed.
+//     <Stage Name>                                   - The stage has completed.
+//     done                                           - Every stage has completed (or the split no longer exists).
+//   Later lines of a split supersede earlier ones. The journal is compacted each time the pipeline is started.
+//
+// Usage:
+//   mdfPipeline_t pipeline;
+//   mdfPipelineStart (&pipeline, &(mdfPipelineConfig_t) { .directory = "logs", .stages = stages, .stageCount = 2 });
+//   mdfCanBusLogConfig_t config = { ..., .splitCallback = mdfPipelineSplitCallback, .splitArg = &pipeline };
+//   ...
+//   mdfPipelineStop (&pipeline);
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// POSIX
+#include <pthread.h>
+
+// C Standard Library
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The name of the journal file, within the log directory.
+#define MDF_PIPELINE_JOURNAL_FILE_NAME "pipeline.journal"
+
+/// @brief The maximum length of a stage's name, in characters.
+#define MDF_PIPELINE_STAGE_NAME_MAX 31
+
+/// @brief The number of split events that may be waiting for the pipeline thread. Must be a power of 2.
+#define MDF_PIPELINE_EVENT_QUEUE_SIZE 64
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief A split being processed by a pipeline stage.
+typedef struct
+{
+	/// @brief The path of the split.
+	const char* path;
+
+	/// @brief The log directory containing the split's session.
+	const char* directory;
+
+	uint32_t sessionNumber;
+	uint32_t splitNumber;
+
+	/// @brief The maximum number of bytes a stage should read per second, 0 for no limit.
+	size_t rateLimit;
+} mdfPipelineSplit_t;
+
+/**
+ * @brief Function implementing a stage of a pipeline. Must be idempotent, see the module description.
+ * @param split The split to process.
+ * @param arg The stage's user argument.
+ * @return 0 if successful, the error code otherwise.
+ */
+typedef int mdfPipelineStageFunction_t (const mdfPipelineSplit_t* split, void* arg);
+
+/// @brief A stage of a pipeline.
+typedef struct
+{
+	/// @brief The name of the stage, identifying it in the journal. Must be unique and not contain whitespace.
+	const char* name;
+
+	/// @brief The function implementing the stage.
+	mdfPipelineStageFunction_t* function;
+
+	/// @brief User argument to pass to @c function .
+	void* arg;
+} mdfPipelineStage_t;
+
+typedef struct
+{
+	/// @brief The log directory containing the sessions. Must remain valid until the pipeline is stopped.
+	const char* directory;
+
+	/// @brief The stages to run, in order. Must remain valid until the pipeline is stopped.
+	const mdfPipelineStage_t* stages;
+
+	/// @brief The number of elements in @c stages .
+	size_t stageCount;
+
+	/// @brief The maximum number of bytes a stage should read per second, 0 for no limit.
+	size_t rateLimit;
+} mdfPipelineConfig_t;
+
+typedef struct
+{
+	/// @brief The number of splits that have passed through every stage.
+	size_t processedCount;
+
+	/// @brief The number of splits a stage failed on. These are retried the next time the pipeline is started.
+	size_t failedCount;
+
+	/// @brief The number of splits waiting to be processed (including the one being processed).
+	size_t pendingCount;
+
+	/// @brief The number of split events dropped due to the event queue being full. These splits are not processed.
+	size_t droppedCount;
+} mdfPipelineStats_t;
+
+/// @brief A split event, waiting to be journaled by the pipeline thread.
+typedef struct
+{
+	uint32_t sessionNumber;
+	uint32_t splitNumber;
+	bool closed;
+} mdfPipelineEvent_t;
+
+/// @brief A split pending in a pipeline.
+typedef struct
+{
+	uint32_t sessionNumber;
+	uint32_t splitNumber;
+
+	/// @brief The index of the next stage to run on the split.
+	size_t stageIndex;
+
+	/// @brief Indicates the split is closed, meaning it is ready to be processed.
+	bool closed;
+} mdfPipelineEntry_t;
+
+typedef struct
+{
+	mdfPipelineConfig_t config;
+
+	/// @brief The journal file, opened for appending.
+	FILE* journal;
+
+	/// @brief The splits pending in the pipeline, in the order they were added.
+	mdfPipelineEntry_t* entries;
+	size_t entryCount;
+	size_t entryCapacity;
+
+	pthread_mutex_t mutex;
+
+	/// @brief Condition signalled when the pipeline is stopping.
+	pthread_cond_t condition;
+
+	pthread_t thread;
+	bool closing;
+
+	mdfPipelineStats_t stats;
+
+	/// @brief Single-producer, single-consumer ring of split events. Written by @c mdfPipelineAddSplit , drained by the
+	/// pipeline thread.
+	mdfPipelineEvent_t events [MDF_PIPELINE_EVENT_QUEUE_SIZE];
+
+	/// @brief Index of the next event to be written by the producer.
+	atomic_size_t eventHead;
+
+	/// @brief Index of the next event to be read by the pipeline thread.
+	atomic_size_t eventTail;
+
+	/// @brief The number of events dropped due to the ring being full.
+	atomic_size_t eventOverflowCount;
+} mdfPipeline_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Starts the pipeline of a log directory. Any splits left pending in the directory's journal are resumed.
+ * @param pipeline The pipeline to start.
+ * @param config The configuration to use. Copied, so need not remain valid.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfPipelineStart (mdfPipeline_t* pipeline, const mdfPipelineConfig_t* config);
+
+/**
+ * @brief Adds a split to a pipeline. Note the split is only processed once it is closed. This function never blocks, the
+ * split is queued for the pipeline thread to journal. Must only be called by a single thread (ex. the log's writer thread).
+ * @param pipeline The pipeline to add to.
+ * @param sessionNumber The session number of the split.
+ * @param splitNumber The number of the split.
+ * @param closed False if the split is still being written, true if it is closed.
+ * @return 0 if successful, the error code otherwise. @c ENOBUFS if the event queue is full.
+ */
+int mdfPipelineAddSplit (mdfPipeline_t* pipeline, uint32_t sessionNumber, uint32_t splitNumber, bool closed);
+
+/**
+ * @brief Split callback of an MDF CAN bus log, adding each of its splits to a pipeline. See
+ * @c mdfCanBusLogSplitCallback_t .
+ * @param arg The pipeline to add to.
+ */
+void mdfPipelineSplitCallback (uint32_t sessionNumber, uint32_t splitNumber, bool closed, void* arg);
+
+/**
+ * @brief Gets the statistics of a pipeline. This function is thread-safe.
+ * @param pipeline The pipeline to get from.
+ * @param stats Buffer to write the statistics into.
+ */
+void mdfPipelineGetStats (mdfPipeline_t* pipeline, mdfPipelineStats_t* stats);
+
+/**
+ * @brief Stops a pipeline, waiting for its thread to exit. Note if a stage is running, it is completed first. Any pending
+ * splits are resumed the next time the pipeline is started.
+ * @param pipeline The pipeline to stop.
+ */
+void mdfPipelineStop (mdfPipeline_t* pipeline);
+
+/**
+ * @brief Gets one of the built-in stages, by name:
+ *   - 'recover':  Repairs the split if it was not closed properly (see @c mdfCanBusLogRecoverSplit ).
+ *   - 'compress': Compresses the split (see @c mdfCanBusLogCompressSplit ).
+ *   - 'index':    Builds and caches the time index of the split (see @c mdfCanBusIndexLoad ).
+ *   - 'catalog':  Summarizes the split in the log directory's catalog (see mdf_catalog.h). The stage's argument may be set
+ *                 to an @c mdfCatalogBuilder_t to summarize signals, otherwise only frames are summarized.
+ * Note the index and catalog both depend on the layout of the split, so should follow any stage changing it.
+ * @param name The name of the stage.
+ * @return The stage, @c NULL if no built-in stage has the name.
+ */
+const mdfPipelineStage_t* mdfPipelineGetStage (const char* name);
+
+#endif // MDF_PIPELINE_H
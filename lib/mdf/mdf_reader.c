@@ -1,10 +1,12 @@
 // Header
 #include "mdf_reader.h"
 #include "error_codes.h"
+#include "mdf_block_types.h"
 
 // C Standard Library
 #include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 
 /**
  * @brief Handles an unsuccessful call to @c fread .
@@ -81,6 +83,252 @@ int mdfReaderJumpToBlock (FILE* mdf)
 	return 0;
 }
 
+/**
+ * @brief Appends a block's data to the data read thus far. If no data has been read, ownership of the block's data is taken
+ * instead.
+ * @param data The data read thus far.
+ * @param size The size of the data read thus far, in bytes.
+ * @param blockData The data to append. Freed by this function.
+ * @param blockSize The size of @c blockData , in bytes.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int appendData (uint8_t** data, size_t* size, uint8_t* blockData, size_t blockSize)
+{
+	if (*data == NULL)
+	{
+		*data = blockData;
+		*size = blockSize;
+		return 0;
+	}
+
+	uint8_t* newData = realloc (*data, *size + blockSize);
+	if (newData == NULL)
+	{
+		free (blockData);
+		return errno;
+	}
+
+	memcpy (newData + *size, blockData, blockSize);
+	free (blockData);
+	*data = newData;
+	*size += blockSize;
+	return 0;
+}
+
+/**
+ * @brief Reads the data of a data block whose length was never written, that is all the data until the end of the file.
+ * @param mdf The file to read from, positioned at the start of the data.
+ * @param blockData Written to the data. Must be freed by the caller.
+ * @param blockSize Written to the size of the data, in bytes.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int readUnfinalizedData (FILE* mdf, uint8_t** blockData, size_t* blockSize)
+{
+	long start = ftell (mdf);
+	if (start < 0 || fseek (mdf, 0, SEEK_END) != 0)
+		return errno;
+
+	long end = ftell (mdf);
+	if (end < 0 || fseek (mdf, start, SEEK_SET) != 0)
+		return errno;
+
+	*blockSize = end - start;
+	*blockData = malloc (*blockSize);
+	if (*blockData == NULL)
+		return errno;
+
+	if (fread (*blockData, 1, *blockSize, mdf) != *blockSize)
+	{
+		free (*blockData);
+		return handleFreadError (mdf);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Reads the compressed data blocks of an unfinalized file, appending their data to the data read thus far. These are
+ * not listed by a data list yet, rather they are written consecutively (aligned to 8 bytes) from the data group's data block
+ * until the end of the file. Reading stops at the first incomplete block, as it may still be being written (or its write may
+ * have been interrupted).
+ * @param mdf The file to read from.
+ * @param addr The address of the first block.
+ * @param fileSize The size of the file, in bytes.
+ * @param data The data read thus far.
+ * @param size The size of the data read thus far, in bytes.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int readUnfinalizedDzBlocks (FILE* mdf, uint64_t addr, uint64_t fileSize, uint8_t** data, size_t* size)
+{
+	while (addr + sizeof (((mdfBlock_t*) NULL)->header) <= fileSize)
+	{
+		// Check the block's header before reading the rest of it, as an incomplete block's length cannot be trusted.
+		mdfBlock_t block;
+		if (fseek (mdf, addr, SEEK_SET) != 0)
+			return errno;
+		if (fread (&block.header, sizeof (block.header), 1, mdf) != 1)
+			return handleFreadError (mdf);
+
+		if (block.header.blockId != MDF_BLOCK_ID_DZ || block.header.linkCount != 0 ||
+			block.header.blockLength > fileSize - addr)
+			break;
+
+		if (fseek (mdf, addr, SEEK_SET) != 0 || mdfReadBlockHeader (mdf, &block) != 0)
+			return errno;
+
+		uint8_t* blockData = NULL;
+		size_t blockSize = 0;
+		int code = 0;
+		if (mdfReadBlockDataSection (mdf, &block) != 0 || mdfDzBlockInflate (&block, &blockData, &blockSize) != 0)
+			code = errno;
+
+		uint64_t blockLength = block.header.blockLength;
+		mdfBlockDealloc (&block);
+
+		// A block that cannot be decompressed was not completely written.
+		if (code == ERRNO_MDF_DEFLATE_FAILURE)
+			break;
+
+		if (code == 0)
+			code = appendData (data, size, blockData, blockSize);
+
+		if (code != 0)
+		{
+			errno = code;
+			return errno;
+		}
+
+		addr = (addr + blockLength + 7) & ~(uint64_t) 7;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Reads the data of a data block, compressed data block, or data list, appending it to the data read thus far.
+ * @param mdf The file to read from.
+ * @param addr The address of the block.
+ * @param fileSize For unfinalized files, the size of the file, in bytes. 0 for finalized files.
+ * @param data The data read thus far.
+ * @param size The size of the data read thus far, in bytes.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int readDataBlock (FILE* mdf, uint64_t addr, uint64_t fileSize, uint8_t** data, size_t* size)
+{
+	// Follow the chain of data lists (if any).
+	while (addr != 0)
+	{
+		mdfBlock_t block;
+		if (fseek (mdf, addr, SEEK_SET) != 0 || mdfReadBlockHeader (mdf, &block) != 0)
+			return errno;
+
+		if (mdfReadBlockLinkList (mdf, &block) != 0)
+		{
+			int code = errno;
+			mdfBlockDealloc (&block);
+			errno = code;
+			return errno;
+		}
+
+		uint8_t* blockData = NULL;
+		size_t blockSize = 0;
+		int code = 0;
+		uint64_t nextAddr = 0;
+
+		switch (block.header.blockId)
+		{
+		case MDF_BLOCK_ID_DT:
+			// Data blocks of unfinalized files do not have a length yet, their data extends to the end of the file.
+			if (block.header.blockLength == sizeof (block.header))
+				code = readUnfinalizedData (mdf, &blockData, &blockSize);
+			else if (mdfReadBlockDataSection (mdf, &block) == 0)
+			{
+				// Take ownership of the data section, rather than copying it.
+				blockData = block.dataSection;
+				blockSize = mdfBlockDataSectionSize (&block);
+				block.dataSection = NULL;
+			}
+			else
+				code = errno;
+			break;
+
+		case MDF_BLOCK_ID_DZ:
+			// Compressed data blocks of unfinalized files are not listed yet, so are read until the end of the file.
+			if (fileSize != 0)
+			{
+				mdfBlockDealloc (&block);
+				return readUnfinalizedDzBlocks (mdf, addr, fileSize, data, size);
+			}
+
+			if (mdfReadBlockDataSection (mdf, &block) != 0 || mdfDzBlockInflate (&block, &blockData, &blockSize) != 0)
+				code = errno;
+			break;
+
+		case MDF_BLOCK_ID_DL:
+			// Read each block of the list, then move onto the next list.
+			for (uint64_t index = 1; code == 0 && index < block.header.linkCount; ++index)
+				if (readDataBlock (mdf, block.linkList [index], 0, data, size) != 0)
+					code = errno;
+			nextAddr = mdfDlBlockNextAddr (&block);
+			break;
+
+		default:
+			code = ERRNO_MDF_UNSUPPORTED_DATA_BLOCK;
+			break;
+		}
+
+		mdfBlockDealloc (&block);
+
+		if (code == 0 && blockData != NULL)
+			code = appendData (data, size, blockData, blockSize);
+
+		if (code != 0)
+		{
+			errno = code;
+			return errno;
+		}
+
+		addr = nextAddr;
+	}
+
+	return 0;
+}
+
+int mdfReadDataGroupData (FILE* mdf, uint64_t dataBlockAddr, uint8_t** data, size_t* size)
+{
+	*data = NULL;
+	*size = 0;
+
+	// Unfinalized files may have compressed data blocks not yet listed, see readUnfinalizedDzBlocks.
+	mdfFileIdBlock_t fileIdBlock;
+	if (fseek (mdf, 0, SEEK_SET) != 0 || mdfReadFileIdBlock (mdf, &fileIdBlock) != 0)
+		return errno;
+
+	uint64_t fileSize = 0;
+	char unfinalized [] = MDF_FILE_IDENTIFICATION_UNFINALIZED;
+	if (memcmp (fileIdBlock.fileIdentification, unfinalized, sizeof (unfinalized)) == 0)
+	{
+		if (fseek (mdf, 0, SEEK_END) != 0)
+			return errno;
+
+		long end = ftell (mdf);
+		if (end < 0)
+			return errno;
+		fileSize = end;
+	}
+
+	if (readDataBlock (mdf, dataBlockAddr, fileSize, data, size) != 0)
+	{
+		int code = errno;
+		free (*data);
+		*data = NULL;
+		errno = code;
+		return errno;
+	}
+
+	return 0;
+}
+
 static int handleFreadError (FILE* stream)
 {
 	// If the file ended, return the code for that.
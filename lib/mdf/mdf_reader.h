@@ -20,6 +20,10 @@
 // Includes
 #include "mdf_block.h"
 
+// C Standard Library
+#include <stddef.h>
+#include <stdint.h>
+
 // C Standard Library
 #include <stdio.h>
 
@@ -35,4 +39,15 @@ int mdfReadBlockDataSection (FILE* mdf, mdfBlock_t* block);
 
 int mdfReaderJumpToBlock (FILE* mdf);
 
+/**
+ * @brief Reads the data of a data group, that is the concatenation of all of its records. The data may be stored in a data
+ * block (including that of an unfinalized file), a compressed data block, or a data list of either.
+ * @param mdf The file to read from.
+ * @param dataBlockAddr The address of the data group's data block, see @c mdfDgLinkList_t.dataBlockAddr .
+ * @param data Written to the data, @c NULL if there is none. Must be freed by the caller.
+ * @param size Written to the size of the data, in bytes.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfReadDataGroupData (FILE* mdf, uint64_t dataBlockAddr, uint8_t** data, size_t* size);
+
 #endif // MDF_READER_H
\ No newline at end of file
@@ -0,0 +1,234 @@
+// Header
+#include "mdf_record_queue.h"
+
+// Includes
+#include "debug.h"
+#include "error_codes.h"
+#include "mdf_capture.h"
+#include "time_port.h"
+
+// C Standard Library
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The amount of time the merger sleeps for when no records can be written, in nanoseconds.
+#define MERGER_IDLE_PERIOD_NS 200000
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+int mdfRecordQueueInit (mdfRecordQueue_t* queue, size_t capacity)
+{
+	// Round the capacity up to a power of 2, so indices can be masked rather than wrapped.
+	size_t powerCapacity = 1;
+	while (powerCapacity < capacity)
+		powerCapacity <<= 1;
+
+	queue->records = malloc (sizeof (mdfRecord_t) * powerCapacity);
+	if (queue->records == NULL)
+		return errno;
+
+	queue->mask = powerCapacity - 1;
+	queue->lastTimestampNs = LLONG_MIN;
+	atomic_init (&queue->head, 0);
+	atomic_init (&queue->tail, 0);
+	atomic_init (&queue->busy, false);
+	atomic_init (&queue->closed, false);
+	atomic_init (&queue->overflowCount, 0);
+	return 0;
+}
+
+void mdfRecordQueueDealloc (mdfRecordQueue_t* queue)
+{
+	free (queue->records);
+}
+
+mdfRecord_t* mdfRecordQueueReserve (mdfRecordQueue_t* queue)
+{
+	// Only the producer writes the head, so it can be read relaxed.
+	size_t head = atomic_load_explicit (&queue->head, memory_order_relaxed);
+	size_t tail = atomic_load_explicit (&queue->tail, memory_order_acquire);
+	if (head - tail > queue->mask)
+	{
+		atomic_fetch_add_explicit (&queue->overflowCount, 1, memory_order_relaxed);
+		return NULL;
+	}
+
+	return &queue->records [head & queue->mask];
+}
+
+void mdfRecordQueuePublish (mdfRecordQueue_t* queue, mdfRecord_t* record, struct timespec* timestamp)
+{
+	record->timestampNs = timespecToNs (timestamp);
+
+	size_t head = atomic_load_explicit (&queue->head, memory_order_relaxed);
+	atomic_store_explicit (&queue->head, head + 1, memory_order_release);
+}
+
+void mdfRecordQueueClose (mdfRecordQueue_t* queue)
+{
+	atomic_store (&queue->closed, true);
+}
+
+/**
+ * @brief Performs a single pass of the merge. A snapshot of each queue is taken, then as many records as can be proven to be
+ * in order are written.
+ * @param merger The merger to use.
+ * @param done Written to true if all queues are closed and empty, false otherwise.
+ * @param watermarkNs Written to the timestamp no record yet to be written can be older than, in nanoseconds.
+ * @return The number of records written.
+ */
+static size_t mergePass (mdfRecordMerger_t* merger, bool* done, long long* watermarkNs)
+{
+	size_t* heads = merger->heads;
+	long long* bounds = merger->bounds;
+
+	// Take the time before inspecting the queues. Any idle producer must acquire its next timestamp after this.
+	struct timespec timeCurrent;
+	clock_gettime (CLOCK_MONOTONIC, &timeCurrent);
+	long long timeCurrentNs = timespecToNs (&timeCurrent);
+
+	*done = true;
+	for (size_t index = 0; index < merger->queueCount; ++index)
+	{
+		mdfRecordQueue_t* queue = &merger->queues [index];
+
+		// Note the order of these loads matters: a queue observed to be closed (or idle) must have all of its records visible
+		// by the time its head is loaded.
+		bool closed = atomic_load (&queue->closed);
+		bool busy = atomic_load (&queue->busy);
+		heads [index] = atomic_load_explicit (&queue->head, memory_order_acquire);
+
+		// Any record the producer has yet to publish is at least as new as its last record. If the producer is idle, it is
+		// also at least as new as the current time. If it is closed, there are no more records.
+		if (closed)
+			bounds [index] = LLONG_MAX;
+		else if (!busy && timeCurrentNs > queue->lastTimestampNs)
+			bounds [index] = timeCurrentNs;
+		else
+			bounds [index] = queue->lastTimestampNs;
+
+		if (!closed || heads [index] != atomic_load_explicit (&queue->tail, memory_order_relaxed))
+			*done = false;
+	}
+
+	size_t count = 0;
+	while (true)
+	{
+		// Find the oldest record visible in the snapshot, along with the oldest record that could still be published.
+		size_t oldestIndex = 0;
+		mdfRecordQueue_t* oldestQueue = NULL;
+		long long oldestNs = LLONG_MAX;
+		long long boundNs = LLONG_MAX;
+		for (size_t index = 0; index < merger->queueCount; ++index)
+		{
+			mdfRecordQueue_t* queue = &merger->queues [index];
+			size_t tail = atomic_load_explicit (&queue->tail, memory_order_relaxed);
+			if (tail == heads [index])
+			{
+				if (bounds [index] < boundNs)
+					boundNs = bounds [index];
+				continue;
+			}
+
+			long long timestampNs = queue->records [tail & queue->mask].timestampNs;
+			if (oldestQueue == NULL || timestampNs < oldestNs)
+			{
+				oldestIndex = index;
+				oldestQueue = queue;
+				oldestNs = timestampNs;
+			}
+		}
+
+		// Stop if nothing is visible, or if another queue may still produce an older record.
+		if (oldestQueue == NULL || oldestNs > boundNs)
+		{
+			*watermarkNs = oldestNs < boundNs ? oldestNs : boundNs;
+			return count;
+		}
+
+		size_t tail = atomic_load_explicit (&oldestQueue->tail, memory_order_relaxed);
+		mdfRecord_t* record = &oldestQueue->records [tail & oldestQueue->mask];
+		int code = merger->capture != NULL ?
+			mdfCaptureWriteRecord (merger->capture, record) :
+			mdfCanBusLogWriteRecord (merger->log, record->data, record->size);
+		if (code == 0)
+			atomic_fetch_add_explicit (&merger->mergedCount, 1, memory_order_relaxed);
+		else
+			atomic_fetch_add_explicit (&merger->droppedCount, 1, memory_order_relaxed);
+
+		// Once a queue is emptied, its unseen records can be no older than the one just removed.
+		oldestQueue->lastTimestampNs = oldestNs;
+		if (bounds [oldestIndex] < oldestNs)
+			bounds [oldestIndex] = oldestNs;
+
+		atomic_store_explicit (&oldestQueue->tail, tail + 1, memory_order_release);
+		++count;
+	}
+}
+
+static void* mergerThread (void* arg)
+{
+	mdfRecordMerger_t* merger = arg;
+
+	while (true)
+	{
+		bool done;
+		long long watermarkNs;
+		size_t count = mergePass (merger, &done, &watermarkNs);
+
+		// Let the capture end its event even if no records arrive.
+		if (merger->capture != NULL && !done && mdfCaptureAdvance (merger->capture, watermarkNs) != 0)
+			debugPrintf ("Failed to advance MDF capture: %s.\n", errorCodeToMessage (errno));
+
+		if (count != 0)
+			continue;
+
+		if (done)
+			break;
+
+		nanosleep (&(struct timespec) { .tv_nsec = MERGER_IDLE_PERIOD_NS }, NULL);
+	}
+
+	return NULL;
+}
+
+int mdfRecordMergerStart (mdfRecordMerger_t* merger, mdfCanBusLog_t* log, struct mdfCapture* capture, mdfRecordQueue_t* queues,
+	size_t queueCount)
+{
+	merger->log = log;
+	merger->capture = capture;
+	merger->queues = queues;
+	merger->queueCount = queueCount;
+	atomic_init (&merger->mergedCount, 0);
+	atomic_init (&merger->droppedCount, 0);
+
+	merger->heads = malloc (sizeof (size_t) * queueCount);
+	merger->bounds = malloc (sizeof (long long) * queueCount);
+	if (merger->heads == NULL || merger->bounds == NULL)
+	{
+		free (merger->heads);
+		free (merger->bounds);
+		return errno;
+	}
+
+	int code = pthread_create (&merger->thread, NULL, mergerThread, merger);
+	if (code != 0)
+	{
+		free (merger->heads);
+		free (merger->bounds);
+		errno = code;
+		return errno;
+	}
+
+	return 0;
+}
+
+void mdfRecordMergerJoin (mdfRecordMerger_t* merger)
+{
+	pthread_join (merger->thread, NULL);
+	free (merger->heads);
+	free (merger->bounds);
+}
@@ -0,0 +1,198 @@
+#ifndef MDF_RECORD_QUEUE_H
+#define MDF_RECORD_QUEUE_H
+
+// MDF Record Queues ----------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: Per-channel queues of encoded MDF records, along with a merger writing them into a single log. Each channel's
+//   thread acts as the producer of its own single-producer, single-consumer ring, so channels never contend with one another.
+//   A single merger thread drains all the rings, writing records in timestamp order so the log stays time-ordered across
+//   channels.
+//
+//   Ordering works as follows. Each producer's records are in timestamp order, as it acquires its timestamps sequentially.
+//   The merger may only write a queue's oldest record once no other queue can still produce an older one. To know this, a
+//   producer marks itself busy before acquiring a timestamp, and clears the mark after publishing the record. If the merger
+//   observes a queue as idle and empty, any record it produces later must have a timestamp after the merger's observation.
+//
+// Usage:
+//   Producer:
+//     mdfRecordQueueBegin (queue);
+//     mdfCanBusLogGetTimestamp (&timestamp);
+//     mdfRecord_t* record = mdfRecordQueueReserve (queue);
+//     ... encode into record->data, set record->size ...
+//     mdfRecordQueuePublish (queue, record, &timestamp);
+//     mdfRecordQueueEnd (queue);
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "mdf_can_bus_logging.h"
+
+// POSIX
+#include <pthread.h>
+
+// C Standard Library
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+// Forward declaration, see mdf_capture.h.
+struct mdfCapture;
+
+typedef struct
+{
+	/// @brief The timestamp of the record, in nanoseconds. Used for ordering records across queues.
+	long long timestampNs;
+
+	/// @brief The size of the encoded record, in bytes.
+	uint8_t size;
+
+	/// @brief The encoded record.
+	uint8_t data [MDF_CAN_BUS_LOG_RECORD_SIZE_MAX];
+} mdfRecord_t;
+
+typedef struct
+{
+	/// @brief The records of the ring. The capacity is always a power of 2.
+	mdfRecord_t* records;
+
+	/// @brief Mask for converting a ring index into an array index, that is capacity - 1.
+	size_t mask;
+
+	/// @brief Index of the next record to be written by the producer. The producer and consumer indices are padded apart by
+	/// a cache line, so they do not falsely share one.
+	atomic_size_t head;
+	char headPadding [64];
+
+	/// @brief Index of the next record to be read by the consumer.
+	atomic_size_t tail;
+	char tailPadding [64];
+
+	/// @brief Indicates the producer has acquired (or is acquiring) a timestamp it has not yet published.
+	atomic_bool busy;
+
+	/// @brief Indicates the producer has stopped, no more records will be published.
+	atomic_bool closed;
+
+	/// @brief The number of records dropped due to the ring being full.
+	atomic_size_t overflowCount;
+
+	/// @brief The timestamp of the last record removed from the queue. Only accessed by the consumer.
+	long long lastTimestampNs;
+} mdfRecordQueue_t;
+
+typedef struct
+{
+	mdfCanBusLog_t* log;
+
+	/// @brief The event-triggered capture to feed records to, or @c NULL to write them straight to the log.
+	struct mdfCapture* capture;
+
+	mdfRecordQueue_t* queues;
+	size_t queueCount;
+	pthread_t thread;
+
+	/// @brief The snapshot of each queue's head, as taken by the last merge pass.
+	size_t* heads;
+
+	/// @brief The lower bound of the timestamp of each queue's unseen records, in nanoseconds.
+	long long* bounds;
+
+	/// @brief The number of records written to the log (or fed to the capture).
+	atomic_size_t mergedCount;
+
+	/// @brief The number of records the log failed to accept.
+	atomic_size_t droppedCount;
+} mdfRecordMerger_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes a record queue.
+ * @param queue The queue to initialize.
+ * @param capacity The minimum number of records the queue should hold. Rounded up to the next power of 2.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfRecordQueueInit (mdfRecordQueue_t* queue, size_t capacity);
+
+/**
+ * @brief De-allocates the memory owned by a record queue. The producer and merger must be stopped before calling this.
+ * @param queue The queue to de-allocate.
+ */
+void mdfRecordQueueDealloc (mdfRecordQueue_t* queue);
+
+/**
+ * @brief Marks the producer as busy (producer side). Must be called before acquiring the timestamp of a record.
+ * @param queue The queue to mark.
+ */
+static inline void mdfRecordQueueBegin (mdfRecordQueue_t* queue)
+{
+	// Sequentially consistent, as the merger must not observe the acquisition of the timestamp before this.
+	atomic_store (&queue->busy, true);
+}
+
+/**
+ * @brief Marks the producer as idle (producer side). Must be called after all records using the last acquired timestamp
+ * have been published (or abandoned).
+ * @param queue The queue to mark.
+ */
+static inline void mdfRecordQueueEnd (mdfRecordQueue_t* queue)
+{
+	atomic_store (&queue->busy, false);
+}
+
+/**
+ * @brief Gets the slot the next record should be encoded into (producer side). The record is not visible to the merger until
+ * @c mdfRecordQueuePublish is called.
+ * @param queue The queue to reserve from.
+ * @return The slot to encode into, or @c NULL if the queue is full (the record is counted as dropped).
+ */
+mdfRecord_t* mdfRecordQueueReserve (mdfRecordQueue_t* queue);
+
+/**
+ * @brief Publishes the record previously reserved via @c mdfRecordQueueReserve (producer side).
+ * @param queue The queue to publish to.
+ * @param record The reserved record.
+ * @param timestamp The timestamp the record was encoded with.
+ */
+void mdfRecordQueuePublish (mdfRecordQueue_t* queue, mdfRecord_t* record, struct timespec* timestamp);
+
+/**
+ * @brief Closes a record queue (producer side). Once the merger has emptied all closed queues, it stops.
+ * @param queue The queue to close.
+ */
+void mdfRecordQueueClose (mdfRecordQueue_t* queue);
+
+/// @return The number of records dropped due to the queue being full.
+static inline size_t mdfRecordQueueGetOverflowCount (mdfRecordQueue_t* queue)
+{
+	return atomic_load_explicit (&queue->overflowCount, memory_order_relaxed);
+}
+
+/**
+ * @brief Starts a merger, writing the records of a set of queues into a log in timestamp order. The merger stops once all
+ * queues are closed and empty.
+ * @param merger The merger to start.
+ * @param log The log to write to.
+ * @param capture The event-triggered capture to feed records to, rather than writing them straight to the log. @c NULL to
+ * write every record.
+ * @param queues The array of queues to merge.
+ * @param queueCount The number of elements in @c queues .
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfRecordMergerStart (mdfRecordMerger_t* merger, mdfCanBusLog_t* log, struct mdfCapture* capture, mdfRecordQueue_t* queues,
+	size_t queueCount);
+
+/**
+ * @brief Waits for a merger to stop. All queues should be closed before calling this.
+ * @param merger The merger to wait for.
+ */
+void mdfRecordMergerJoin (mdfRecordMerger_t* merger);
+
+#endif // MDF_RECORD_QUEUE_H
@@ -0,0 +1,471 @@
+// For asprintf. Note this must be the first include in this file.
+#define _GNU_SOURCE
+#include <stdio.h>
+
+// Header
+#include "mdf_retention.h"
+
+// Includes
+#include "debug.h"
+#include "error_codes.h"
+#include "mdf_can_bus_logging.h"
+#include "misc_port.h"
+#include "time_port.h"
+
+// POSIX
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// C Standard Library
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	uint32_t number;
+	char* path;
+} session_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Waits for a period of time, or until the retention is stopped.
+ * @param retention The retention to wait on.
+ * @param periodMs The amount of time to wait for, in milliseconds.
+ * @return True if the retention is still running, false if it is stopping.
+ */
+static bool waitFor (mdfRetention_t* retention, unsigned periodMs)
+{
+	struct timespec period =
+	{
+		.tv_sec		= periodMs / 1000,
+		.tv_nsec	= (periodMs % 1000) * 1000000
+	};
+
+	pthread_mutex_lock (&retention->mutex);
+	if (!retention->closing)
+	{
+		struct timespec deadline;
+		clock_gettime (CLOCK_REALTIME, &deadline);
+		deadline = timespecAdd (&deadline, &period);
+		pthread_cond_timedwait (&retention->condition, &retention->mutex, &deadline);
+	}
+	bool running = !retention->closing;
+	pthread_mutex_unlock (&retention->mutex);
+
+	return running;
+}
+
+/// @return True if the retention is still running, false if it is stopping.
+static bool isRunning (mdfRetention_t* retention)
+{
+	pthread_mutex_lock (&retention->mutex);
+	bool running = !retention->closing;
+	pthread_mutex_unlock (&retention->mutex);
+	return running;
+}
+
+/**
+ * @brief Accounts for bytes freed by compressing or deleting a file.
+ */
+static void recordFreed (mdfRetention_t* retention, size_t size, size_t* usedSize)
+{
+	*usedSize = *usedSize > size ? *usedSize - size : 0;
+
+	pthread_mutex_lock (&retention->mutex);
+	retention->stats.freedSize += size;
+	retention->stats.usedSize = *usedSize;
+	pthread_mutex_unlock (&retention->mutex);
+}
+
+/**
+ * @brief Gets the total size of the files in a session directory.
+ * @param path The path of the session.
+ * @return The size of the session, in bytes.
+ */
+static size_t getSessionSize (const char* path)
+{
+	DIR* dirp = opendir (path);
+	if (dirp == NULL)
+		return 0;
+
+	size_t size = 0;
+	struct dirent* ent;
+	while ((ent = readdir (dirp)) != NULL)
+	{
+		char* filePath;
+		if (asprintf (&filePath, "%s/%s", path, ent->d_name) < 0)
+			continue;
+
+		struct stat fileStat;
+		if (stat (filePath, &fileStat) == 0 && S_ISREG (fileStat.st_mode))
+			size += fileStat.st_size;
+		free (filePath);
+	}
+
+	closedir (dirp);
+	return size;
+}
+
+static int compareSessions (const void* a, const void* b)
+{
+	uint32_t numberA = ((const session_t*) a)->number;
+	uint32_t numberB = ((const session_t*) b)->number;
+	return (numberA > numberB) - (numberA < numberB);
+}
+
+static void deallocSessions (session_t* sessions, size_t sessionCount)
+{
+	for (size_t index = 0; index < sessionCount; ++index)
+		free (sessions [index].path);
+	free (sessions);
+}
+
+/**
+ * @brief Lists the completed sessions of the directory, oldest first, and measures the size of every session.
+ * @param retention The retention to list for.
+ * @param sessions Written to the array of completed sessions. Must be de-allocated using @c deallocSessions .
+ * @param sessionCount Written to the number of elements in @c sessions .
+ * @param usedSize Written to the size of every session, including those that are not completed, in bytes.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int listSessions (mdfRetention_t* retention, session_t** sessions, size_t* sessionCount, size_t* usedSize)
+{
+	*sessions = NULL;
+	*sessionCount = 0;
+	*usedSize = 0;
+
+	DIR* dirp = opendir (retention->config.directory);
+	if (dirp == NULL)
+		return errno;
+
+	struct dirent* ent;
+	while ((ent = readdir (dirp)) != NULL)
+	{
+		if (strncmp (ent->d_name, "session_", strlen ("session_")) != 0)
+			continue;
+
+		char* numberStr = ent->d_name + strlen ("session_");
+		char* end;
+		uint32_t number = strtoul (numberStr, &end, 0);
+		if (end == numberStr || *end != '\0')
+			continue;
+
+		char* path;
+		if (asprintf (&path, "%s/%s", retention->config.directory, ent->d_name) < 0)
+			continue;
+
+		*usedSize += getSessionSize (path);
+
+		// The active session, along with any newer, is never touched.
+		if (number >= retention->config.activeSessionNumber)
+		{
+			free (path);
+			continue;
+		}
+
+		session_t* reallocated = realloc (*sessions, sizeof (session_t) * (*sessionCount + 1));
+		if (reallocated == NULL)
+		{
+			int code = errno;
+			free (path);
+			closedir (dirp);
+			deallocSessions (*sessions, *sessionCount);
+			*sessions = NULL;
+			*sessionCount = 0;
+			return code;
+		}
+
+		*sessions = reallocated;
+		(*sessions) [*sessionCount] = (session_t)
+		{
+			.number	= number,
+			.path	= path
+		};
+		++*sessionCount;
+	}
+
+	closedir (dirp);
+
+	if (*sessions != NULL)
+		qsort (*sessions, *sessionCount, sizeof (session_t), compareSessions);
+	return 0;
+}
+
+/**
+ * @brief Gets the number of bytes that must be freed to satisfy the configured limits.
+ * @param retention The retention to check.
+ * @param usedSize The size of every session, in bytes.
+ * @return The number of bytes to free, 0 if the limits are satisfied.
+ */
+static size_t getExcessSize (mdfRetention_t* retention, size_t usedSize)
+{
+	size_t excess = 0;
+	if (retention->config.quota != 0 && usedSize > retention->config.quota)
+		excess = usedSize - retention->config.quota;
+
+	size_t total;
+	size_t available;
+	if (retention->config.freeMin != 0 && storageCapacityPort (retention->config.directory, &total, &available) == 0 &&
+		available < retention->config.freeMin && retention->config.freeMin - available > excess)
+		excess = retention->config.freeMin - available;
+
+	return excess;
+}
+
+/**
+ * @brief Compresses the splits of a session, until either the limits are satisfied or every split is compressed.
+ * @param retention The retention to use.
+ * @param session The session to compress.
+ * @param usedSize The size of every session, in bytes. Updated to reflect the compressed splits.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int compressSession (mdfRetention_t* retention, const session_t* session, size_t* usedSize)
+{
+	DIR* dirp = opendir (session->path);
+	if (dirp == NULL)
+		return errno;
+
+	int code = 0;
+	bool complete = true;
+	struct dirent* ent;
+	while ((ent = readdir (dirp)) != NULL)
+	{
+		// Only the splits of the bus log are compressed, other files (ex. decoded signals) are left as-is.
+		size_t nameLength = strlen (ent->d_name);
+		if (strncmp (ent->d_name, "split_", strlen ("split_")) != 0 || nameLength < strlen (".mf4") ||
+			strcmp (ent->d_name + nameLength - strlen (".mf4"), ".mf4") != 0)
+			continue;
+
+		// Stop once the limits are satisfied, or the retention is stopping.
+		if (!isRunning (retention) || getExcessSize (retention, *usedSize) == 0)
+		{
+			complete = false;
+			break;
+		}
+
+		char* path;
+		if (asprintf (&path, "%s/%s", session->path, ent->d_name) < 0)
+		{
+			code = errno;
+			break;
+		}
+
+		mdfCanBusLogCompression_t compression;
+		code = mdfCanBusLogCompressSplit (path, retention->config.rateLimit, &compression);
+		if (code != 0)
+			debugPrintf ("Warning, failed to compress MDF split '%s': %s.\n", path, errorCodeToMessage (code));
+		free (path);
+		if (code != 0)
+			break;
+
+		if (compression.skipped)
+			continue;
+
+		pthread_mutex_lock (&retention->mutex);
+		++retention->stats.compressedCount;
+		pthread_mutex_unlock (&retention->mutex);
+
+		if (compression.compressedSize < compression.fileSize)
+			recordFreed (retention, compression.fileSize - compression.compressedSize, usedSize);
+	}
+
+	closedir (dirp);
+
+	// Sessions are compressed oldest first, so everything before the next session is now compressed.
+	if (code == 0 && complete)
+		retention->compressedSessionNumber = session->number + 1;
+
+	errno = code;
+	return code;
+}
+
+/**
+ * @brief Deletes a session, one file at a time.
+ * @param retention The retention to use.
+ * @param session The session to delete.
+ * @param usedSize The size of every session, in bytes. Updated to reflect the deleted files.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int deleteSession (mdfRetention_t* retention, const session_t* session, size_t* usedSize)
+{
+	debugPrintf ("Deleting MDF session '%s'...\n", session->path);
+
+	DIR* dirp = opendir (session->path);
+	if (dirp == NULL)
+		return errno;
+
+	int code = 0;
+	bool stopped = false;
+	struct dirent* ent;
+	while ((ent = readdir (dirp)) != NULL)
+	{
+		if (strcmp (ent->d_name, ".") == 0 || strcmp (ent->d_name, "..") == 0)
+			continue;
+
+		char* path;
+		if (asprintf (&path, "%s/%s", session->path, ent->d_name) < 0)
+		{
+			code = errno;
+			break;
+		}
+
+		struct stat fileStat;
+		size_t size = stat (path, &fileStat) == 0 ? (size_t) fileStat.st_size : 0;
+		if (remove (path) != 0)
+			code = errno;
+		free (path);
+		if (code != 0)
+			break;
+
+		recordFreed (retention, size, usedSize);
+
+		// Space the deletions out, so as to not stall the storage device.
+		if (!waitFor (retention, MDF_RETENTION_DELETE_PERIOD))
+		{
+			stopped = true;
+			break;
+		}
+	}
+
+	closedir (dirp);
+
+	// If stopped part way through, the remainder of the session is deleted the next time the limits are enforced.
+	if (code == 0 && !stopped && rmdir (session->path) != 0)
+		code = errno;
+
+	if (code == 0 && !stopped)
+	{
+		pthread_mutex_lock (&retention->mutex);
+		++retention->stats.deletedCount;
+		pthread_mutex_unlock (&retention->mutex);
+	}
+
+	errno = code;
+	return code;
+}
+
+/**
+ * @brief Checks the storage usage, compressing and deleting the oldest completed sessions until the limits are satisfied.
+ * @param retention The retention to enforce.
+ */
+static void enforceLimits (mdfRetention_t* retention)
+{
+	session_t* sessions;
+	size_t sessionCount;
+	size_t usedSize;
+	if (listSessions (retention, &sessions, &sessionCount, &usedSize) != 0)
+	{
+		debugPrintf ("Warning, failed to list MDF sessions of '%s': %s.\n", retention->config.directory,
+			errorCodeToMessage (errno));
+		return;
+	}
+
+	pthread_mutex_lock (&retention->mutex);
+	retention->stats.usedSize = usedSize;
+	pthread_mutex_unlock (&retention->mutex);
+
+	// Compress the oldest sessions first, as this loses no data.
+	if (retention->config.compress)
+	{
+		for (size_t index = 0; index < sessionCount; ++index)
+		{
+			if (sessions [index].number < retention->compressedSessionNumber)
+				continue;
+
+			if (!isRunning (retention) || getExcessSize (retention, usedSize) == 0)
+			{
+				deallocSessions (sessions, sessionCount);
+				return;
+			}
+
+			// If compression fails (ex. no space for the compressed copy), fall back to deleting.
+			if (compressSession (retention, &sessions [index], &usedSize) != 0)
+				break;
+		}
+	}
+
+	for (size_t index = 0; index < sessionCount; ++index)
+	{
+		if (!isRunning (retention) || getExcessSize (retention, usedSize) == 0)
+		{
+			deallocSessions (sessions, sessionCount);
+			return;
+		}
+
+		if (deleteSession (retention, &sessions [index], &usedSize) != 0)
+			debugPrintf ("Warning, failed to delete MDF session '%s': %s.\n", sessions [index].path,
+				errorCodeToMessage (errno));
+	}
+
+	if (getExcessSize (retention, usedSize) != 0)
+		debugPrintf ("Warning, MDF storage limits exceeded with no completed sessions remaining.\n");
+
+	deallocSessions (sessions, sessionCount);
+}
+
+static void* retentionThread (void* arg)
+{
+	mdfRetention_t* retention = arg;
+
+	// Compressing and deleting sessions is never urgent, so only run when the system is otherwise idle.
+	if (idlePriorityPort () != 0)
+		debugPrintf ("Warning, failed to lower MDF retention priority: %s.\n", errorCodeToMessage (errno));
+
+	do
+		enforceLimits (retention);
+	while (waitFor (retention, retention->config.intervalMs));
+
+	return NULL;
+}
+
+int mdfRetentionStart (mdfRetention_t* retention, const mdfRetentionConfig_t* config)
+{
+	retention->config = *config;
+	if (retention->config.rateLimit == 0)
+		retention->config.rateLimit = MDF_RETENTION_RATE_LIMIT_DEFAULT;
+	if (retention->config.intervalMs == 0)
+		retention->config.intervalMs = MDF_RETENTION_INTERVAL_DEFAULT;
+
+	retention->compressedSessionNumber = 0;
+	retention->closing = false;
+	retention->stats = (mdfRetentionStats_t) {0};
+
+	pthread_mutex_init (&retention->mutex, NULL);
+	pthread_cond_init (&retention->condition, NULL);
+
+	int code = pthread_create (&retention->thread, NULL, retentionThread, retention);
+	if (code != 0)
+	{
+		pthread_cond_destroy (&retention->condition);
+		pthread_mutex_destroy (&retention->mutex);
+		errno = code;
+		return code;
+	}
+
+	return 0;
+}
+
+void mdfRetentionGetStats (mdfRetention_t* retention, mdfRetentionStats_t* stats)
+{
+	pthread_mutex_lock (&retention->mutex);
+	*stats = retention->stats;
+	pthread_mutex_unlock (&retention->mutex);
+}
+
+void mdfRetentionStop (mdfRetention_t* retention)
+{
+	pthread_mutex_lock (&retention->mutex);
+	retention->closing = true;
+	pthread_cond_signal (&retention->condition);
+	pthread_mutex_unlock (&retention->mutex);
+	pthread_join (retention->thread, NULL);
+
+	pthread_cond_destroy (&retention->condition);
+	pthread_mutex_destroy (&retention->mutex);
+}
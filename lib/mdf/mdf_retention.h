@@ -0,0 +1,123 @@
+#ifndef MDF_RETENTION_H
+#define MDF_RETENTION_H
+
+// MDF Session Retention ------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: Background storage quota manager for a directory of MDF CAN bus logging sessions (see
+//   mdf_can_bus_logging.h). A thread periodically checks the space used by the sessions, along with the space remaining on the
+//   storage device. If either limit is exceeded, the oldest completed sessions are first compressed (optionally), then
+//   deleted, until both limits are satisfied again. The active session, along with any newer, is never touched.
+//
+//   The thread is rate limited so it does not compete with the logger for the storage device: compression reads at a bounded
+//   rate, and files are deleted one at a time with a delay between each.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// POSIX
+#include <pthread.h>
+
+// C Standard Library
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The default interval at which the storage usage is checked, in milliseconds.
+#define MDF_RETENTION_INTERVAL_DEFAULT		10000
+
+/// @brief The default maximum number of bytes read per second when compressing sessions.
+#define MDF_RETENTION_RATE_LIMIT_DEFAULT	(4 << 20)
+
+/// @brief The delay between deleting consecutive files, in milliseconds.
+#define MDF_RETENTION_DELETE_PERIOD			100
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The directory containing the sessions. Must remain valid until the retention is stopped.
+	const char* directory;
+
+	/// @brief The number of the session being logged. This session, along with any newer, is never compressed nor deleted.
+	uint32_t activeSessionNumber;
+
+	/// @brief The maximum number of bytes the sessions may occupy. Use 0 for no limit.
+	size_t quota;
+
+	/// @brief The minimum number of bytes to keep available on the storage device. Use 0 for no limit. Note this is only
+	/// supported on Linux.
+	size_t freeMin;
+
+	/// @brief Indicates the oldest sessions should be compressed before any session is deleted.
+	bool compress;
+
+	/// @brief The maximum number of bytes read per second when compressing sessions. Use 0 for the default
+	/// (@c MDF_RETENTION_RATE_LIMIT_DEFAULT ).
+	size_t rateLimit;
+
+	/// @brief The interval at which the storage usage is checked, in milliseconds. Use 0 for the default
+	/// (@c MDF_RETENTION_INTERVAL_DEFAULT ).
+	unsigned intervalMs;
+} mdfRetentionConfig_t;
+
+typedef struct
+{
+	/// @brief The number of splits compressed.
+	size_t compressedCount;
+
+	/// @brief The number of sessions deleted.
+	size_t deletedCount;
+
+	/// @brief The number of bytes freed, by both compression and deletion.
+	size_t freedSize;
+
+	/// @brief The number of bytes the sessions occupied, as of the last check.
+	size_t usedSize;
+} mdfRetentionStats_t;
+
+typedef struct
+{
+	mdfRetentionConfig_t config;
+
+	/// @brief Sessions numbered below this are known to be compressed.
+	uint32_t compressedSessionNumber;
+
+	pthread_mutex_t mutex;
+
+	/// @brief Condition signalled when the retention is stopping.
+	pthread_cond_t condition;
+
+	pthread_t thread;
+	bool closing;
+
+	mdfRetentionStats_t stats;
+} mdfRetention_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Starts the retention thread of a directory of sessions.
+ * @param retention The retention to start.
+ * @param config The configuration to use. Copied, so need not remain valid.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfRetentionStart (mdfRetention_t* retention, const mdfRetentionConfig_t* config);
+
+/**
+ * @brief Gets the statistics of a retention. This function is thread-safe.
+ * @param retention The retention to get from.
+ * @param stats Buffer to write the statistics into.
+ */
+void mdfRetentionGetStats (mdfRetention_t* retention, mdfRetentionStats_t* stats);
+
+/**
+ * @brief Stops a retention thread, waiting for it to exit. Note if a split is being compressed, it is completed first.
+ * @param retention The retention to stop.
+ */
+void mdfRetentionStop (mdfRetention_t* retention);
+
+#endif // MDF_RETENTION_H
@@ -0,0 +1,434 @@
+// Header
+#include "mdf_signal_log.h"
+
+// Includes
+#include "mdf_block.h"
+#include "mdf_writer.h"
+
+// C Standard Library
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The size of each record's record ID, in bytes.
+#define RECORD_ID_SIZE sizeof (uint16_t)
+
+/// @brief The size of each record's timestamp, in bytes.
+#define TIMESTAMP_SIZE sizeof (uint64_t)
+
+/// @brief The factor converting a timestamp from nanoseconds into seconds.
+#define TIMESTAMP_SCALE_FACTOR 1e9
+
+/// @brief Gets the number of bytes a channel's raw value occupies within a record.
+#define CHANNEL_SIZE(channel) (((channel)->bitLength + 7) / 8)
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+static mdfBlock_t* writeHeader (FILE* mdf, uint64_t startTimeNs)
+{
+	mdfFileIdBlock_t fileIdBlock =
+	{
+		.fileIdentification		= MDF_FILE_IDENTIFICATION_UNFINALIZED,
+		.versionString			= MDF_VERSION_STRING_V4_11,
+		.programIdentification	= "ZREMDF",
+		.data					= MDF_FILE_ID_BLOCK_DATA
+	};
+
+	if (mdfWriteFileIdBlock (mdf, &fileIdBlock) != 0)
+		return NULL;
+
+	// The link list of the header is populated once the groups are written.
+	mdfBlock_t* block = malloc (sizeof (mdfBlock_t));
+	if (block == NULL)
+		return NULL;
+
+	if (mdfHdBlockInit (block,
+		&(mdfHdDataSection_t)
+		{
+			.unixTimeNs = startTimeNs
+		},
+		&(mdfHdLinkList_t)
+		{
+			0
+		}) != 0)
+	{
+		free (block);
+		return NULL;
+	}
+
+	if (mdfBlockWrite (mdf, block) == 0)
+	{
+		mdfBlockDealloc (block);
+		free (block);
+		return NULL;
+	}
+
+	return block;
+}
+
+static uint64_t writeFileHistory (FILE* mdf, uint64_t startTimeNs)
+{
+	uint64_t commentAddr = mdfMdBlockWrite (mdf,
+		"<FHcomment>\n"
+		"	<TX>\n"
+		"		Decoding of CAN signals.\n"
+		"	</TX>\n"
+		"	<tool_id>ZREMDF</tool_id>\n"
+		"	<tool_vendor>ZRE</tool_vendor>\n"
+		"</FHcomment>");
+	if (commentAddr == 0)
+		return 0;
+
+	return mdfFhBlockWrite (mdf,
+		&(mdfFhDataSection_t)
+		{
+			.unixTimeNs = startTimeNs
+		},
+		&(mdfFhLinkList_t)
+		{
+			.commentAddr = commentAddr
+		});
+}
+
+static uint64_t writeLinearCc (FILE* mdf, double a, double b, uint64_t unitAddr)
+{
+	return mdfCcBlockWrite (mdf,
+		&(mdfCcDataSection_t)
+		{
+			.conversionType				= MDF_CC_CONVERSION_TYPE_LINEAR,
+			.precision					= 0,
+			.flags						= MDF_CC_FLAGS_NONE,
+			.referenceParameterNumber	= 0,
+			.valueParameterNumber		= 2,
+			.minPhysicalValue			= 0.0,
+			.maxPhysicalValue			= 0.0,
+			.b							= b,
+			.a							= a,
+		},
+		&(mdfCcLinkList_t)
+		{
+			.unitAddr = unitAddr
+		});
+}
+
+/**
+ * @brief Writes the channel group of a group, along with its channels.
+ * @param log The log to write to.
+ * @param groupIndex The index of the group.
+ * @param nextCgAddr The address of the next channel group.
+ * @param timestampCcAddr The address of the conversion block of the timestamp channel.
+ * @return The address of the channel group block if successful, 0 otherwise.
+ */
+static uint64_t writeGroupCg (mdfSignalLog_t* log, size_t groupIndex, uint64_t nextCgAddr, uint64_t timestampCcAddr)
+{
+	const mdfSignalLogGroup_t* group = &log->groups [groupIndex];
+
+	// Channels are written in reverse, so the address of the next channel is always known.
+	uint64_t nextCnAddr = 0;
+	size_t byteOffset = log->recordSizes [groupIndex] - RECORD_ID_SIZE;
+	for (size_t index = group->channelCount; index > 0; --index)
+	{
+		const mdfSignalLogChannel_t* channel = &group->channels [index - 1];
+		byteOffset -= CHANNEL_SIZE (channel);
+
+		uint64_t nameAddr = mdfTxBlockWrite (log->mdf, "%s", channel->name);
+		if (nameAddr == 0)
+			return 0;
+
+		uint64_t unitAddr = 0;
+		if (channel->unit != NULL && channel->unit [0] != '\0')
+		{
+			unitAddr = mdfTxBlockWrite (log->mdf, "%s", channel->unit);
+			if (unitAddr == 0)
+				return 0;
+		}
+
+		uint64_t ccAddr = writeLinearCc (log->mdf, channel->factor, channel->offset, unitAddr);
+		if (ccAddr == 0)
+			return 0;
+
+		nextCnAddr = mdfCnBlockWrite (log->mdf,
+			&(mdfCnDataSection_t)
+			{
+				.channelType	= MDF_CHANNEL_TYPE_VALUE,
+				.syncType		= MDF_SYNC_TYPE_NONE,
+				.dataType		= channel->signedness ? MDF_DATA_TYPE_SIGNED_INTEL : MDF_DATA_TYPE_UNSIGNED_INTEL,
+				.bitOffset		= 0,
+				.byteOffset		= byteOffset,
+				.bitLength		= channel->bitLength,
+				.flags			= MDF_CN_FLAGS_NONE
+			},
+			&(mdfCnLinkList_t)
+			{
+				.nextCnAddr		= nextCnAddr,
+				.nameAddr		= nameAddr,
+				.conversionAddr	= ccAddr,
+				.unitAddr		= unitAddr
+			});
+		if (nextCnAddr == 0)
+			return 0;
+	}
+
+	uint64_t timestampNameAddr = mdfTxBlockWrite (log->mdf, "Timestamp");
+	if (timestampNameAddr == 0)
+		return 0;
+
+	uint64_t timestampCnAddr = mdfCnBlockWrite (log->mdf,
+		&(mdfCnDataSection_t)
+		{
+			.channelType	= MDF_CHANNEL_TYPE_MASTER,
+			.syncType		= MDF_SYNC_TYPE_TIME,
+			.dataType		= MDF_DATA_TYPE_UNSIGNED_INTEL,
+			.bitOffset		= 0,
+			.byteOffset		= 0,
+			.bitLength		= TIMESTAMP_SIZE * 8,
+			.flags			= MDF_CN_FLAGS_NONE
+		},
+		&(mdfCnLinkList_t)
+		{
+			.nextCnAddr		= nextCnAddr,
+			.nameAddr		= timestampNameAddr,
+			.conversionAddr	= timestampCcAddr
+		});
+	if (timestampCnAddr == 0)
+		return 0;
+
+	uint64_t groupNameAddr = mdfTxBlockWrite (log->mdf, "%s", group->name);
+	if (groupNameAddr == 0)
+		return 0;
+
+	return mdfCgBlockWrite (log->mdf,
+		&(mdfCgDataSection_t)
+		{
+			.recordId		= groupIndex + 1,
+			.flags			= MDF_CG_FLAGS_NONE,
+			.pathSeparator	= '.',
+			.byteLength		= log->recordSizes [groupIndex] - RECORD_ID_SIZE
+		},
+		&(mdfCgLinkList_t)
+		{
+			.nextCgAddr				= nextCgAddr,
+			.firstCnAddr			= timestampCnAddr,
+			.acquisitionNameAddr	= groupNameAddr
+		});
+}
+
+/**
+ * @brief Writes the blocks of a new file, up to and including the header of its data block.
+ * @param log The log to write to.
+ * @param hd The header block of the file. Its link list is rewritten.
+ * @param startTimeNs The start of the log, in nanoseconds since the Unix epoch.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int writeLayout (mdfSignalLog_t* log, mdfBlock_t* hd, uint64_t startTimeNs)
+{
+	uint64_t fileHistoryAddr = writeFileHistory (log->mdf, startTimeNs);
+	if (fileHistoryAddr == 0)
+		return errno;
+
+	uint64_t unitAddr = mdfTxBlockWrite (log->mdf, "s");
+	if (unitAddr == 0)
+		return errno;
+
+	uint64_t timestampCcAddr = writeLinearCc (log->mdf, 1.0 / TIMESTAMP_SCALE_FACTOR, 0.0, unitAddr);
+	if (timestampCcAddr == 0)
+		return errno;
+
+	// Groups are written in reverse, so the address of the next group is always known.
+	uint64_t nextCgAddr = 0;
+	for (size_t index = log->groupCount; index > 0; --index)
+	{
+		nextCgAddr = writeGroupCg (log, index - 1, nextCgAddr, timestampCcAddr);
+		if (nextCgAddr == 0)
+			return errno;
+
+		log->cgAddrs [index - 1] = nextCgAddr;
+		log->cycleCounts [index - 1] = 0;
+	}
+
+	uint64_t dgAddr = mdfDgBlockWrite (log->mdf,
+		&(mdfDgDataSection_t)
+		{
+			.recordIdLength = RECORD_ID_SIZE
+		},
+		&(mdfDgLinkList_t)
+		{
+			.firstCgAddr = nextCgAddr
+		});
+	if (dgAddr == 0)
+		return errno;
+
+	// The data block is written last, so records can be appended to it.
+	log->dtAddr = mdfDtBlockWrite (log->mdf);
+	if (log->dtAddr == 0)
+		return errno;
+
+	if (mdfRewriteDgBlockDataAddr (log->mdf, dgAddr, log->dtAddr) != 0)
+		return errno;
+
+	mdfHdBlockLinkList (hd)->firstDgAddr = dgAddr;
+	mdfHdBlockLinkList (hd)->firstFhAddr = fileHistoryAddr;
+	if (mdfRewriteBlockLinkList (log->mdf, hd) != 0)
+		return errno;
+
+	// Subsequent writes append to the data block.
+	if (fseek (log->mdf, 0, SEEK_END) != 0)
+		return errno;
+
+	long size = ftell (log->mdf);
+	if (size < 0)
+		return errno;
+
+	log->size = size;
+	return 0;
+}
+
+int mdfSignalLogInit (mdfSignalLog_t* log, const mdfSignalLogGroup_t* groups, size_t groupCount,
+	mdfSignalLogCallback_t* callback, void* arg)
+{
+	if (groupCount > MDF_SIGNAL_LOG_GROUP_COUNT_MAX)
+	{
+		errno = EINVAL;
+		return errno;
+	}
+
+	*log = (mdfSignalLog_t)
+	{
+		.groups		= groups,
+		.groupCount	= groupCount,
+		.callback	= callback,
+		.arg		= arg
+	};
+
+	size_t channelCountMax = 0;
+	size_t recordSizeMax = RECORD_ID_SIZE + TIMESTAMP_SIZE;
+
+	log->recordSizes = malloc (sizeof (size_t) * (groupCount != 0 ? groupCount : 1));
+	if (log->recordSizes == NULL)
+		return errno;
+
+	for (size_t index = 0; index < groupCount; ++index)
+	{
+		size_t recordSize = RECORD_ID_SIZE + TIMESTAMP_SIZE;
+		for (size_t channelIndex = 0; channelIndex < groups [index].channelCount; ++channelIndex)
+		{
+			const mdfSignalLogChannel_t* channel = &groups [index].channels [channelIndex];
+			if (channel->bitLength == 0 || channel->bitLength > 64)
+			{
+				free (log->recordSizes);
+				errno = EINVAL;
+				return errno;
+			}
+
+			recordSize += CHANNEL_SIZE (channel);
+		}
+
+		log->recordSizes [index] = recordSize;
+		if (recordSize > recordSizeMax)
+			recordSizeMax = recordSize;
+		if (groups [index].channelCount > channelCountMax)
+			channelCountMax = groups [index].channelCount;
+	}
+
+	log->values = malloc (sizeof (uint64_t) * (channelCountMax != 0 ? channelCountMax : 1));
+	log->record = malloc (recordSizeMax);
+	log->cgAddrs = malloc (sizeof (uint64_t) * (groupCount != 0 ? groupCount : 1));
+	log->cycleCounts = malloc (sizeof (uint64_t) * (groupCount != 0 ? groupCount : 1));
+	if (log->values == NULL || log->record == NULL || log->cgAddrs == NULL || log->cycleCounts == NULL)
+	{
+		int code = errno;
+		mdfSignalLogDealloc (log);
+		errno = code;
+		return errno;
+	}
+
+	return 0;
+}
+
+int mdfSignalLogOpen (mdfSignalLog_t* log, const char* path, uint64_t startTimeNs)
+{
+	log->mdf = fopen (path, "wb");
+	if (log->mdf == NULL)
+		return errno;
+
+	mdfBlock_t* hd = writeHeader (log->mdf, startTimeNs);
+	int code = hd != NULL ? writeLayout (log, hd, startTimeNs) : errno;
+
+	if (hd != NULL)
+	{
+		mdfBlockDealloc (hd);
+		free (hd);
+	}
+
+	if (code != 0)
+	{
+		fclose (log->mdf);
+		log->mdf = NULL;
+		errno = code;
+		return errno;
+	}
+
+	return 0;
+}
+
+int mdfSignalLogAddRecord (mdfSignalLog_t* log, const mdfCanBusRecord_t* record)
+{
+	size_t groupIndex;
+	if (!log->callback (record, &groupIndex, log->values, log->arg) || groupIndex >= log->groupCount)
+		return 0;
+
+	const mdfSignalLogGroup_t* group = &log->groups [groupIndex];
+	size_t recordSize = log->recordSizes [groupIndex];
+
+	uint16_t recordId = groupIndex + 1;
+	memcpy (log->record, &recordId, RECORD_ID_SIZE);
+	memcpy (log->record + RECORD_ID_SIZE, &record->timestampNs, TIMESTAMP_SIZE);
+
+	// Each value is truncated to its channel's size. Note the upper bits of the last byte are ignored by readers.
+	size_t offset = RECORD_ID_SIZE + TIMESTAMP_SIZE;
+	for (size_t index = 0; index < group->channelCount; ++index)
+	{
+		size_t size = CHANNEL_SIZE (&group->channels [index]);
+		memcpy (log->record + offset, &log->values [index], size);
+		offset += size;
+	}
+
+	if (fwrite (log->record, 1, recordSize, log->mdf) != recordSize)
+		return errno;
+
+	log->size += recordSize;
+	++log->cycleCounts [groupIndex];
+	return 0;
+}
+
+int mdfSignalLogClose (mdfSignalLog_t* log)
+{
+	int code = 0;
+	if (mdfRewriteDtBlockLength (log->mdf, log->dtAddr, log->size - log->dtAddr) != 0)
+		code = errno;
+
+	for (size_t index = 0; code == 0 && index < log->groupCount; ++index)
+		if (mdfRewriteCgBlockCycleCount (log->mdf, log->cgAddrs [index], log->cycleCounts [index]) != 0)
+			code = errno;
+
+	if (code == 0 && mdfFinalizeFileIdBlock (log->mdf) != 0)
+		code = errno;
+
+	if (fclose (log->mdf) != 0 && code == 0)
+		code = errno;
+	log->mdf = NULL;
+
+	errno = code;
+	return code;
+}
+
+void mdfSignalLogDealloc (mdfSignalLog_t* log)
+{
+	free (log->recordSizes);
+	free (log->values);
+	free (log->record);
+	free (log->cgAddrs);
+	free (log->cycleCounts);
+}
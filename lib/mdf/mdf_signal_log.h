@@ -0,0 +1,166 @@
+#ifndef MDF_SIGNAL_LOG_H
+#define MDF_SIGNAL_LOG_H
+
+// MDF Signal Log -------------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.19
+//
+// Description: Writer for MDF files of decoded CAN signals, written alongside the splits of an MDF CAN bus log (see
+//   mdf_can_bus_logging.h). Each message is written as a channel group, holding one channel per signal. Signals are stored as
+//   their raw integer values, each with a linear conversion block applying the signal's scale factor and offset, so MDF
+//   tools display the physical values while encoding a record requires no floating-point math.
+//
+//   Like the bus log, the files are unsorted: all groups share a single data group, each record being prefixed by a 2-byte
+//   record ID (the index of its group, plus one). Records are appended as they are added, the length of the data block and
+//   the cycle counts of the groups are written once the file is closed.
+//
+//   This module does not depend on the CAN database library. The caller describes the groups, and provides a function
+//   decoding the raw signal values of a record (ex. using @c signalDecodeRaw of can_signals.h).
+//
+// Usage:
+//   mdfSignalLog_t log;
+//   mdfSignalLogInit (&log, groups, groupCount, decodeSignals, NULL);
+//   mdfSignalLogOpen (&log, "signals_0.mf4", startTimeNs);
+//   mdfSignalLogAddRecord (&log, &record);
+//   ...
+//   mdfSignalLogClose (&log);
+//   mdfSignalLogDealloc (&log);
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "mdf_can_bus_reader.h"
+
+// C Standard Library
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The maximum number of groups of a signal log, limited by the size of the record IDs.
+#define MDF_SIGNAL_LOG_GROUP_COUNT_MAX UINT16_MAX
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief Description of a channel (signal) of a group.
+typedef struct
+{
+	/// @brief The name of the channel.
+	const char* name;
+
+	/// @brief The unit of the channel, @c NULL if it has none.
+	const char* unit;
+
+	/// @brief The signedness of the channel's raw value. True => signed (two's complement), false => unsigned.
+	bool signedness;
+
+	/// @brief The length of the channel's raw value, in bits. Must be from 1 to 64.
+	uint8_t bitLength;
+
+	/// @brief The scale factor and offset converting the raw value into the physical value (physical = raw * factor + offset).
+	double factor;
+	double offset;
+} mdfSignalLogChannel_t;
+
+/// @brief Description of a group (message).
+typedef struct
+{
+	/// @brief The name of the group.
+	const char* name;
+
+	/// @brief The channels of the group.
+	const mdfSignalLogChannel_t* channels;
+
+	/// @brief The number of elements in @c channels .
+	size_t channelCount;
+} mdfSignalLogGroup_t;
+
+/**
+ * @brief Function decoding the signals of a record.
+ * @param record The record to decode.
+ * @param groupIndex Written to the index of the record's group.
+ * @param values Buffer to write the raw value of each of the group's channels into. Signed values should be sign-extended.
+ * @param arg The user argument given to @c mdfSignalLogInit .
+ * @return True if the record belongs to a group, false if it should be skipped.
+ */
+typedef bool mdfSignalLogCallback_t (const mdfCanBusRecord_t* record, size_t* groupIndex, uint64_t* values, void* arg);
+
+/// @brief Writer of decoded signal files. See @c mdfSignalLogInit .
+typedef struct
+{
+	const mdfSignalLogGroup_t* groups;
+	size_t groupCount;
+	mdfSignalLogCallback_t* callback;
+	void* arg;
+
+	/// @brief The size of each group's records, in bytes, including the record ID.
+	size_t* recordSizes;
+
+	/// @brief Buffers for the decoded values and the encoded record, sized for the largest group.
+	uint64_t* values;
+	uint8_t* record;
+
+	/// @brief The file being written, @c NULL if no file is open.
+	FILE* mdf;
+
+	/// @brief The address of the file's data block.
+	uint64_t dtAddr;
+
+	/// @brief The address of each group's channel group block.
+	uint64_t* cgAddrs;
+
+	/// @brief The number of records written to each group of the file.
+	uint64_t* cycleCounts;
+
+	/// @brief The size of the file, in bytes.
+	uint64_t size;
+} mdfSignalLog_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes a signal log. No file is opened, see @c mdfSignalLogOpen .
+ * @param log The log to initialize. Must be de-allocated using @c mdfSignalLogDealloc if successful.
+ * @param groups The groups of the log. Must remain valid for the lifetime of the log.
+ * @param groupCount The number of elements in @c groups , at most @c MDF_SIGNAL_LOG_GROUP_COUNT_MAX .
+ * @param callback Function decoding the signals of each record added.
+ * @param arg User argument to pass to @c callback .
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfSignalLogInit (mdfSignalLog_t* log, const mdfSignalLogGroup_t* groups, size_t groupCount,
+	mdfSignalLogCallback_t* callback, void* arg);
+
+/**
+ * @brief Creates a file and writes the description of the log's groups into it, overwriting any existing file.
+ * @param log The log to use. Must not have a file open.
+ * @param path The path of the file to create.
+ * @param startTimeNs The start of the log, in nanoseconds since the Unix epoch. Record timestamps are relative to this.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfSignalLogOpen (mdfSignalLog_t* log, const char* path, uint64_t startTimeNs);
+
+/**
+ * @brief Decodes a record, writing its signals to the open file. Records not belonging to a group are skipped.
+ * @param log The log to write to.
+ * @param record The record to add.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfSignalLogAddRecord (mdfSignalLog_t* log, const mdfCanBusRecord_t* record);
+
+/**
+ * @brief Finalizes and closes the open file.
+ * @param log The log to close the file of.
+ * @return 0 if successful, the error code otherwise. Note the file is closed regardless.
+ */
+int mdfSignalLogClose (mdfSignalLog_t* log);
+
+/**
+ * @brief De-allocates the memory owned by a signal log. Any open file should be closed first.
+ * @param log The log to de-allocate.
+ */
+void mdfSignalLogDealloc (mdfSignalLog_t* log);
+
+#endif // MDF_SIGNAL_LOG_H
@@ -0,0 +1,400 @@
+// Header
+#include "mdf_sorted_writer.h"
+
+// Includes
+#include "mdf_writer.h"
+
+// C Standard Library
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The maximum size of the (uncompressed) data of each compressed data block, in bytes. Large groups are split across
+/// multiple blocks, so that readers only need to decompress a block at a time.
+#define COMPRESSED_BLOCK_SIZE_MAX (1 << 20)
+
+/// @brief The factor converting a timestamp from nanoseconds into seconds.
+#define TIMESTAMP_SCALE_FACTOR 1e9
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+static mdfBlock_t* writeHeader (FILE* mdf, const char* programId, uint64_t startTimeNs)
+{
+	mdfFileIdBlock_t fileIdBlock =
+	{
+		.fileIdentification		= MDF_FILE_IDENTIFICATION_UNFINALIZED,
+		.versionString			= MDF_VERSION_STRING_V4_11,
+		.data					= MDF_FILE_ID_BLOCK_DATA
+	};
+
+	strncpy (fileIdBlock.programIdentification, programId, sizeof (fileIdBlock.programIdentification));
+	fileIdBlock.programIdentification [sizeof (fileIdBlock.programIdentification) - 1] = '\0';
+
+	if (mdfWriteFileIdBlock (mdf, &fileIdBlock) != 0)
+		return NULL;
+
+	// The link list of the header is populated once the file is closed.
+	mdfBlock_t* block = malloc (sizeof (mdfBlock_t));
+	if (block == NULL)
+		return NULL;
+
+	if (mdfHdBlockInit (block,
+		&(mdfHdDataSection_t)
+		{
+			.unixTimeNs = startTimeNs
+		},
+		&(mdfHdLinkList_t)
+		{
+			0
+		}) != 0)
+	{
+		free (block);
+		return NULL;
+	}
+
+	if (mdfBlockWrite (mdf, block) == 0)
+	{
+		mdfBlockDealloc (block);
+		free (block);
+		return NULL;
+	}
+
+	return block;
+}
+
+static uint64_t writeFileHistory (FILE* mdf, const char* programId, uint64_t startTimeNs)
+{
+	uint64_t commentAddr = mdfMdBlockWrite (mdf,
+		"<FHcomment>\n"
+		"	<TX>\n"
+		"		Sorting of data into channel groups.\n"
+		"	</TX>\n"
+		"	<tool_id>%s</tool_id>\n"
+		"	<tool_vendor>ZRE</tool_vendor>\n"
+		"</FHcomment>", programId);
+	if (commentAddr == 0)
+		return 0;
+
+	return mdfFhBlockWrite (mdf,
+		&(mdfFhDataSection_t)
+		{
+			.unixTimeNs = startTimeNs
+		},
+		&(mdfFhLinkList_t)
+		{
+			.commentAddr = commentAddr
+		});
+}
+
+static uint64_t writeTimestampCc (FILE* mdf)
+{
+	uint64_t unitAddr = mdfTxBlockWrite (mdf, "s");
+	if (unitAddr == 0)
+		return 0;
+
+	return mdfCcBlockWrite (mdf,
+		&(mdfCcDataSection_t)
+		{
+			.conversionType				= MDF_CC_CONVERSION_TYPE_LINEAR,
+			.precision					= 0,
+			.flags						= MDF_CC_FLAGS_NONE,
+			.referenceParameterNumber	= 0,
+			.valueParameterNumber		= 2,
+			.minPhysicalValue			= 0.0,
+			.maxPhysicalValue			= 0.0,
+			.b							= 0.0,
+			.a							= 1.0 / TIMESTAMP_SCALE_FACTOR,
+		},
+		&(mdfCcLinkList_t)
+		{
+			.unitAddr = unitAddr
+		});
+}
+
+/**
+ * @brief Writes the data of a group, either as a single data block, or as a list of compressed data blocks.
+ * @param writer The writer to write to.
+ * @param recordSize The size of each record, in bytes.
+ * @param records The array of records.
+ * @param recordCount The number of elements in @c records .
+ * @return The address of the data block (or data list block) if successful, 0 otherwise.
+ */
+static uint64_t writeData (mdfSortedWriter_t* writer, uint8_t recordSize, const uint8_t* records, uint64_t recordCount)
+{
+	size_t size = recordSize * recordCount;
+
+	if (!writer->compressed)
+	{
+		uint64_t dtAddr = mdfDtBlockWrite (writer->mdf);
+		if (dtAddr == 0)
+			return 0;
+
+		if (fwrite (records, 1, size, writer->mdf) != size)
+			return 0;
+
+		long end = ftell (writer->mdf);
+		if (end < 0)
+			return 0;
+
+		if (mdfRewriteDtBlockLength (writer->mdf, dtAddr, end - dtAddr) != 0)
+			return 0;
+
+		return dtAddr;
+	}
+
+	// Each block holds a whole number of records, as the data is transposed by record.
+	size_t blockSize = (COMPRESSED_BLOCK_SIZE_MAX / recordSize) * recordSize;
+	size_t blockCount = (size + blockSize - 1) / blockSize;
+
+	uint64_t* addrs = malloc (sizeof (uint64_t) * blockCount);
+	uint64_t* offsets = malloc (sizeof (uint64_t) * blockCount);
+	if (addrs == NULL || offsets == NULL)
+	{
+		free (addrs);
+		free (offsets);
+		return 0;
+	}
+
+	for (size_t index = 0; index < blockCount; ++index)
+	{
+		size_t offset = index * blockSize;
+		size_t length = size - offset < blockSize ? size - offset : blockSize;
+
+		offsets [index] = offset;
+		addrs [index] = mdfDzBlockWrite (writer->mdf, records + offset, length, recordSize);
+		if (addrs [index] == 0)
+		{
+			int code = errno;
+			free (addrs);
+			free (offsets);
+			errno = code;
+			return 0;
+		}
+	}
+
+	// A single block can be linked directly, otherwise a list of them is needed.
+	uint64_t addr = addrs [0];
+	if (blockCount > 1)
+		addr = mdfDlBlockWrite (writer->mdf, addrs, offsets, blockCount);
+
+	int code = errno;
+	free (addrs);
+	free (offsets);
+	errno = code;
+	return addr;
+}
+
+int mdfSortedWriterInit (mdfSortedWriter_t* writer, const char* path, const char* programId, uint64_t startTimeNs,
+	bool compressed)
+{
+	*writer = (mdfSortedWriter_t)
+	{
+		.compressed = compressed
+	};
+
+	writer->mdf = fopen (path, "wb");
+	if (writer->mdf == NULL)
+		return errno;
+
+	writer->hd = writeHeader (writer->mdf, programId, startTimeNs);
+	if (writer->hd == NULL)
+	{
+		int code = errno;
+		fclose (writer->mdf);
+		errno = code;
+		return errno;
+	}
+
+	uint64_t fileHistoryAddr = writeFileHistory (writer->mdf, programId, startTimeNs);
+	writer->timestampCcAddr = writeTimestampCc (writer->mdf);
+	if (fileHistoryAddr == 0 || writer->timestampCcAddr == 0)
+	{
+		int code = errno;
+		mdfBlockDealloc (writer->hd);
+		free (writer->hd);
+		fclose (writer->mdf);
+		errno = code;
+		return errno;
+	}
+
+	mdfHdBlockLinkList (writer->hd)->firstFhAddr = fileHistoryAddr;
+	return 0;
+}
+
+int mdfSortedWriterAddGroup (mdfSortedWriter_t* writer, const char* name, const mdfSortedChannel_t* channels,
+	size_t channelCount, uint8_t recordSize, const uint8_t* records, uint64_t recordCount)
+{
+	if (recordSize < MDF_SORTED_WRITER_TIMESTAMP_SIZE)
+	{
+		errno = EINVAL;
+		return errno;
+	}
+
+	if (writer->groupCount == writer->groupCapacity)
+	{
+		size_t capacity = writer->groupCapacity != 0 ? writer->groupCapacity * 2 : 64;
+
+		uint64_t* cgAddrs = realloc (writer->cgAddrs, sizeof (uint64_t) * capacity);
+		if (cgAddrs == NULL)
+			return errno;
+		writer->cgAddrs = cgAddrs;
+
+		uint64_t* dataAddrs = realloc (writer->dataAddrs, sizeof (uint64_t) * capacity);
+		if (dataAddrs == NULL)
+			return errno;
+		writer->dataAddrs = dataAddrs;
+
+		writer->groupCapacity = capacity;
+	}
+
+	uint64_t dataAddr = 0;
+	if (recordCount != 0)
+	{
+		dataAddr = writeData (writer, recordSize, records, recordCount);
+		if (dataAddr == 0)
+			return errno;
+	}
+
+	// Channels are written in reverse, so the address of the next channel is always known.
+	uint64_t nextCnAddr = 0;
+	for (size_t index = channelCount; index > 0; --index)
+	{
+		const mdfSortedChannel_t* channel = &channels [index - 1];
+
+		uint64_t nameAddr = mdfTxBlockWrite (writer->mdf, "%s", channel->name);
+		if (nameAddr == 0)
+			return errno;
+
+		uint64_t unitAddr = 0;
+		if (channel->unit != NULL && channel->unit [0] != '\0')
+		{
+			unitAddr = mdfTxBlockWrite (writer->mdf, "%s", channel->unit);
+			if (unitAddr == 0)
+				return errno;
+		}
+
+		nextCnAddr = mdfCnBlockWrite (writer->mdf,
+			&(mdfCnDataSection_t)
+			{
+				.channelType	= MDF_CHANNEL_TYPE_VALUE,
+				.syncType		= MDF_SYNC_TYPE_NONE,
+				.dataType		= channel->dataType,
+				.bitOffset		= channel->bitOffset,
+				.byteOffset		= channel->byteOffset,
+				.bitLength		= channel->bitLength,
+				.flags			= MDF_CN_FLAGS_NONE
+			},
+			&(mdfCnLinkList_t)
+			{
+				.nextCnAddr	= nextCnAddr,
+				.nameAddr	= nameAddr,
+				.unitAddr	= unitAddr
+			});
+		if (nextCnAddr == 0)
+			return errno;
+	}
+
+	uint64_t timestampNameAddr = mdfTxBlockWrite (writer->mdf, "Timestamp");
+	if (timestampNameAddr == 0)
+		return errno;
+
+	uint64_t timestampCnAddr = mdfCnBlockWrite (writer->mdf,
+		&(mdfCnDataSection_t)
+		{
+			.channelType	= MDF_CHANNEL_TYPE_MASTER,
+			.syncType		= MDF_SYNC_TYPE_TIME,
+			.dataType		= MDF_DATA_TYPE_UNSIGNED_INTEL,
+			.bitOffset		= 0,
+			.byteOffset		= 0,
+			.bitLength		= MDF_SORTED_WRITER_TIMESTAMP_SIZE * 8,
+			.flags			= MDF_CN_FLAGS_NONE
+		},
+		&(mdfCnLinkList_t)
+		{
+			.nextCnAddr		= nextCnAddr,
+			.nameAddr		= timestampNameAddr,
+			.conversionAddr	= writer->timestampCcAddr
+		});
+	if (timestampCnAddr == 0)
+		return errno;
+
+	uint64_t groupNameAddr = mdfTxBlockWrite (writer->mdf, "%s", name);
+	if (groupNameAddr == 0)
+		return errno;
+
+	// Sorted groups have no record ID, as they are the only group of their data group.
+	uint64_t cgAddr = mdfCgBlockWrite (writer->mdf,
+		&(mdfCgDataSection_t)
+		{
+			.recordId		= 0,
+			.flags			= MDF_CG_FLAGS_NONE,
+			.pathSeparator	= '.',
+			.byteLength		= recordSize
+		},
+		&(mdfCgLinkList_t)
+		{
+			.firstCnAddr			= timestampCnAddr,
+			.acquisitionNameAddr	= groupNameAddr
+		});
+	if (cgAddr == 0)
+		return errno;
+
+	if (mdfRewriteCgBlockCycleCount (writer->mdf, cgAddr, recordCount) != 0)
+		return errno;
+
+	writer->cgAddrs [writer->groupCount] = cgAddr;
+	writer->dataAddrs [writer->groupCount] = dataAddr;
+	++writer->groupCount;
+	return 0;
+}
+
+/**
+ * @brief Writes the data group of each group, then links the header to the first of them.
+ * @param writer The writer to write to.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int writeDataGroups (mdfSortedWriter_t* writer)
+{
+	// Data groups are written in reverse, so the address of the next group is always known.
+	uint64_t nextDgAddr = 0;
+	for (size_t index = writer->groupCount; index > 0; --index)
+	{
+		nextDgAddr = mdfDgBlockWrite (writer->mdf,
+			&(mdfDgDataSection_t)
+			{
+				.recordIdLength = 0
+			},
+			&(mdfDgLinkList_t)
+			{
+				.nextDgAddr		= nextDgAddr,
+				.firstCgAddr	= writer->cgAddrs [index - 1],
+				.dataBlockAddr	= writer->dataAddrs [index - 1]
+			});
+		if (nextDgAddr == 0)
+			return errno;
+	}
+
+	mdfHdBlockLinkList (writer->hd)->firstDgAddr = nextDgAddr;
+	if (mdfRewriteBlockLinkList (writer->mdf, writer->hd) != 0)
+		return errno;
+
+	return mdfFinalizeFileIdBlock (writer->mdf);
+}
+
+int mdfSortedWriterClose (mdfSortedWriter_t* writer)
+{
+	int code = writeDataGroups (writer);
+
+	if (fclose (writer->mdf) != 0 && code == 0)
+		code = errno;
+
+	mdfBlockDealloc (writer->hd);
+	free (writer->hd);
+	free (writer->cgAddrs);
+	free (writer->dataAddrs);
+
+	errno = code;
+	return code;
+}
@@ -0,0 +1,124 @@
+#ifndef MDF_SORTED_WRITER_H
+#define MDF_SORTED_WRITER_H
+
+// MDF Sorted Writer ----------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: Writer for sorted MDF files, that is, files where each data group contains exactly one channel group. Unlike
+//   the unsorted files written by the MDF CAN bus logging module, reading a channel of a sorted file only requires reading
+//   the data of its group, rather than every record of the file.
+//
+//   Groups are written all at once, given the complete array of their records. Every record starts with a 64-bit timestamp,
+//   in nanoseconds, which is written as the master channel of the group. The remaining channels of the group are described
+//   by the caller.
+//
+// Usage:
+//   mdfSortedWriter_t writer;
+//   mdfSortedWriterInit (&writer, "sorted.mf4", "ZREMDF", startTimeNs, false);
+//   mdfSortedWriterAddGroup (&writer, "Group", channels, channelCount, recordSize, records, recordCount);
+//   ...
+//   mdfSortedWriterClose (&writer);
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "mdf_block.h"
+
+// C Standard Library
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The size of the timestamp at the start of each record, in bytes.
+#define MDF_SORTED_WRITER_TIMESTAMP_SIZE sizeof (uint64_t)
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief Description of a channel of a group.
+typedef struct
+{
+	/// @brief The name of the channel.
+	const char* name;
+
+	/// @brief The unit of the channel, @c NULL if it has none.
+	const char* unit;
+
+	/// @brief The data type of the channel, see @c MDF_DATA_TYPE_UNSIGNED_INTEL and related.
+	uint8_t dataType;
+
+	/// @brief The byte offset of the channel within each record. Note this includes the timestamp.
+	uint8_t byteOffset;
+
+	/// @brief The bit offset of the channel, relative to its byte offset. Must be less than 8.
+	uint8_t bitOffset;
+
+	/// @brief The length of the channel, in bits.
+	uint8_t bitLength;
+} mdfSortedChannel_t;
+
+/// @brief A writer for sorted MDF files. See @c mdfSortedWriterInit .
+typedef struct
+{
+	/// @brief The file being written.
+	FILE* mdf;
+
+	/// @brief The header block of the file. Its link list is rewritten once the file is closed.
+	mdfBlock_t* hd;
+
+	/// @brief Indicates the data of each group is compressed.
+	bool compressed;
+
+	/// @brief The address of the conversion block shared by the timestamp channel of every group.
+	uint64_t timestampCcAddr;
+
+	/// @brief The address of each group's channel group block, in the order they were added.
+	uint64_t* cgAddrs;
+
+	/// @brief The address of each group's data block (or data list block), 0 if the group has no records.
+	uint64_t* dataAddrs;
+
+	size_t groupCount;
+	size_t groupCapacity;
+} mdfSortedWriter_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Creates a sorted MDF file.
+ * @param writer The writer to initialize. Must be closed using @c mdfSortedWriterClose .
+ * @param path The path of the file to create. Existing files are overwritten.
+ * @param programId The identifier of the program writing the file, at most 7 characters.
+ * @param startTimeNs The start time of the file, in nanoseconds since the Unix epoch. Timestamps of records are relative to
+ * this.
+ * @param compressed True to compress the data of each group, false to store it as-is.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfSortedWriterInit (mdfSortedWriter_t* writer, const char* path, const char* programId, uint64_t startTimeNs,
+	bool compressed);
+
+/**
+ * @brief Writes a group (data group, channel group and its channels) to a sorted MDF file.
+ * @param writer The writer to write to.
+ * @param name The name of the group.
+ * @param channels The channels of each record, excluding the timestamp.
+ * @param channelCount The number of elements in @c channels .
+ * @param recordSize The size of each record, in bytes. Must be at least @c MDF_SORTED_WRITER_TIMESTAMP_SIZE .
+ * @param records The array of records, in timestamp order. Each record starts with its timestamp, in nanoseconds.
+ * @param recordCount The number of records in @c records .
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfSortedWriterAddGroup (mdfSortedWriter_t* writer, const char* name, const mdfSortedChannel_t* channels,
+	size_t channelCount, uint8_t recordSize, const uint8_t* records, uint64_t recordCount);
+
+/**
+ * @brief Finalizes and closes a sorted MDF file. Note the writer is closed even if this fails.
+ * @param writer The writer to close.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfSortedWriterClose (mdfSortedWriter_t* writer);
+
+#endif // MDF_SORTED_WRITER_H
@@ -3,6 +3,21 @@
 
 // C Standard Library
 #include <errno.h>
+#include <stddef.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The offset of the unfinalized flags (standard and custom, 2 bytes each) within the file ID block.
+#define FILE_ID_UNFINALIZED_FLAGS_OFFSET 60
+
+/// @brief The offset of the cycle count within a channel group block, that is after the header, link list and record ID.
+#define CG_CYCLE_COUNT_OFFSET (sizeof (((mdfBlock_t*) NULL)->header) + sizeof (mdfCgLinkList_t) + sizeof (uint64_t))
+
+/// @brief The offset of the data block address within a data group block, that is after the header and the first 2 links.
+#define DG_DATA_BLOCK_ADDR_OFFSET (sizeof (((mdfBlock_t*) NULL)->header) + offsetof (mdfDgLinkList_t, dataBlockAddr))
+
+/// @brief The offset of the block length within a block.
+#define BLOCK_LENGTH_OFFSET 8
 
 /**
  * @brief Aligns the I/O stream to an 8 byte address.
@@ -11,6 +26,16 @@
  */
 static int alignBlock (FILE* mdf);
 
+/**
+ * @brief Overwrites data at an address of a file, restoring the stream's position afterwards.
+ * @param mdf The file to write to.
+ * @param addr The address to write at.
+ * @param data The data to write.
+ * @param size The size of the data, in bytes.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int rewriteAt (FILE* mdf, uint64_t addr, const void* data, size_t size);
+
 int mdfWriteFileIdBlock (FILE* mdf, mdfFileIdBlock_t* fileIdBlock)
 {
 	if (fwrite (fileIdBlock, sizeof (*fileIdBlock), 1, mdf) != 1)
@@ -84,6 +109,31 @@ int mdfRewriteBlockDataSection (FILE* mdf, mdfBlock_t* block)
 	return 0;
 }
 
+int mdfFinalizeFileIdBlock (FILE* mdf)
+{
+	const char fileIdentification [8] = MDF_FILE_IDENTIFICATION_FINALIZED;
+	if (rewriteAt (mdf, 0, fileIdentification, sizeof (fileIdentification)) != 0)
+		return errno;
+
+	const uint16_t flags [2] = { 0, 0 };
+	return rewriteAt (mdf, FILE_ID_UNFINALIZED_FLAGS_OFFSET, flags, sizeof (flags));
+}
+
+int mdfRewriteDtBlockLength (FILE* mdf, uint64_t dtAddr, uint64_t blockLength)
+{
+	return rewriteAt (mdf, dtAddr + BLOCK_LENGTH_OFFSET, &blockLength, sizeof (blockLength));
+}
+
+int mdfRewriteCgBlockCycleCount (FILE* mdf, uint64_t cgAddr, uint64_t cycleCount)
+{
+	return rewriteAt (mdf, cgAddr + CG_CYCLE_COUNT_OFFSET, &cycleCount, sizeof (cycleCount));
+}
+
+int mdfRewriteDgBlockDataAddr (FILE* mdf, uint64_t dgAddr, uint64_t dataBlockAddr)
+{
+	return rewriteAt (mdf, dgAddr + DG_DATA_BLOCK_ADDR_OFFSET, &dataBlockAddr, sizeof (dataBlockAddr));
+}
+
 uint64_t mdfCnBlockWrite (FILE* mdf, mdfCnDataSection_t* dataSection, mdfCnLinkList_t* linkList)
 {
 	// Allocate the block
@@ -153,6 +203,34 @@ uint64_t mdfDtBlockWrite (FILE* mdf)
 	return addr;
 }
 
+uint64_t mdfDzBlockWrite (FILE* mdf, const uint8_t* data, size_t size, uint32_t columns)
+{
+	// Allocate the block
+	mdfBlock_t block;
+	if (mdfDzBlockInit (&block, data, size, columns) != 0)
+		return 0;
+
+	// Write the block then deallocate
+	uint64_t addr = mdfBlockWrite (mdf, &block);
+	mdfBlockDealloc (&block);
+
+	return addr;
+}
+
+uint64_t mdfDlBlockWrite (FILE* mdf, const uint64_t* dataAddrs, const uint64_t* offsets, uint32_t count)
+{
+	// Allocate the block
+	mdfBlock_t block;
+	if (mdfDlBlockInit (&block, dataAddrs, offsets, count) != 0)
+		return 0;
+
+	// Write the block then deallocate
+	uint64_t addr = mdfBlockWrite (mdf, &block);
+	mdfBlockDealloc (&block);
+
+	return addr;
+}
+
 uint64_t mdfSiBlockWrite (FILE* mdf, mdfSiDataSection_t* dataSection, mdfSiLinkList_t* linkList)
 {
 	// Allocate the block
@@ -236,4 +314,22 @@ static int alignBlock (FILE* mdf)
 			return errno;
 
 	return 0;
-}
\ No newline at end of file
+}
+
+static int rewriteAt (FILE* mdf, uint64_t addr, const void* data, size_t size)
+{
+	long position = ftell (mdf);
+	if (position < 0)
+		return errno;
+
+	if (fseek (mdf, addr, SEEK_SET) != 0)
+		return errno;
+
+	if (fwrite (data, 1, size, mdf) != size)
+		return errno;
+
+	if (fseek (mdf, position, SEEK_SET) != 0)
+		return errno;
+
+	return 0;
+}
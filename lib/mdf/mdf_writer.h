@@ -56,6 +56,44 @@ int mdfRewriteBlockLinkList (FILE* mdf, mdfBlock_t* block);
  */
 int mdfRewriteBlockDataSection (FILE* mdf, mdfBlock_t* block);
 
+/**
+ * @brief Finalizes an MDF file, that is, marks all of its blocks as complete. This changes the file identification string
+ * from @c MDF_FILE_IDENTIFICATION_UNFINALIZED to @c MDF_FILE_IDENTIFICATION_FINALIZED and clears the unfinalized flags. Note
+ * the length of the last data block and the cycle count of each channel group must be rewritten first.
+ * @param mdf The file to write to.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfFinalizeFileIdBlock (FILE* mdf);
+
+/**
+ * @brief Re-writes the length of a data block. Data blocks of unfinalized files are written before their records, so their
+ * length is not known until the file is finalized.
+ * @param mdf The file to write to.
+ * @param dtAddr The address of the data block.
+ * @param blockLength The length of the block, including its header, in bytes.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfRewriteDtBlockLength (FILE* mdf, uint64_t dtAddr, uint64_t blockLength);
+
+/**
+ * @brief Re-writes the cycle count (number of records) of a channel group block.
+ * @param mdf The file to write to.
+ * @param cgAddr The address of the channel group block.
+ * @param cycleCount The number of records belonging to the channel group.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfRewriteCgBlockCycleCount (FILE* mdf, uint64_t cgAddr, uint64_t cycleCount);
+
+/**
+ * @brief Re-writes the data block address of a data group block. Used when the data group's data is stored in a list of data
+ * blocks, which cannot be written until all of the data blocks are.
+ * @param mdf The file to write to.
+ * @param dgAddr The address of the data group block.
+ * @param dataBlockAddr The address of the data block (or data list block) to link to.
+ * @return 0 if successful, the error code otherwise.
+ */
+int mdfRewriteDgBlockDataAddr (FILE* mdf, uint64_t dgAddr, uint64_t dataBlockAddr);
+
 // Block Types ----------------------------------------------------------------------------------------------------------------
 
 /**
@@ -101,6 +139,26 @@ uint64_t mdfDgBlockWrite (FILE* mdf, mdfDgDataSection_t* dataSection, mdfDgLinkL
  */
 uint64_t mdfDtBlockWrite (FILE* mdf);
 
+/**
+ * @brief Creates and writes a compressed data block to an MDF file. See @c mdfDzBlockInit for details.
+ * @param mdf The file to write to.
+ * @param data The data to compress.
+ * @param size The size of @c data , in bytes.
+ * @param columns The number of columns to transpose the data with, 0 to not transpose the data.
+ * @return The address of the block if successful, 0 otherwise.
+ */
+uint64_t mdfDzBlockWrite (FILE* mdf, const uint8_t* data, size_t size, uint32_t columns);
+
+/**
+ * @brief Creates and writes a data list block to an MDF file. See @c mdfDlBlockInit for details.
+ * @param mdf The file to write to.
+ * @param dataAddrs The address of each data block.
+ * @param offsets The offset of each data block's (uncompressed) data within the concatenation of all the data.
+ * @param count The number of data blocks in the list.
+ * @return The address of the block if successful, 0 otherwise.
+ */
+uint64_t mdfDlBlockWrite (FILE* mdf, const uint64_t* dataAddrs, const uint64_t* offsets, uint32_t count);
+
 /**
  * @brief Creates and writes a source information block to an MDF file.
  * @param mdf The file to write to.
@@ -9,15 +9,25 @@
 #include "debug.h"
 
 // C Standard Library
+#include <errno.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 
 // POSIX
+#include <fcntl.h>
 #include <libgen.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#ifdef ZRE_CANTOOLS_OS_linux
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/statvfs.h>
+#include <sys/syscall.h>
+#endif // ZRE_CANTOOLS_OS_linux
+
 char* expandEnv (const char* str)
 {
 	size_t variablePosition = strcspn (str, "$");
@@ -100,6 +110,218 @@ int fsyncPort (FILE* file)
 	#endif // ZRE_CANTOOLS_OS_linux
 }
 
+int fsyncDirectoryPort (const char* path)
+{
+	#ifdef ZRE_CANTOOLS_OS_linux
+
+	// Note dirname may modify its argument, so a copy is given.
+	char* pathCopy = strdup (path);
+	if (pathCopy == NULL)
+		return -1;
+
+	int fd = open (dirname (pathCopy), O_RDONLY | O_DIRECTORY);
+	free (pathCopy);
+	if (fd < 0)
+		return -1;
+
+	int result = fsync (fd);
+	int code = errno;
+	close (fd);
+	errno = code;
+	return result;
+
+	#else // ZRE_CANTOOLS_OS_linux
+
+	(void) path;
+
+	// Not aware of, nor concerned with a Windows equivalent.
+	return 0;
+
+	#endif // ZRE_CANTOOLS_OS_linux
+}
+
+int fallocatePort (FILE* file, size_t size)
+{
+	#ifdef ZRE_CANTOOLS_OS_linux
+
+	int fd = fileno (file);
+	if (fd < 0)
+		return -1;
+
+	return fallocate (fd, FALLOC_FL_KEEP_SIZE, 0, size);
+
+	#else // ZRE_CANTOOLS_OS_linux
+
+	(void) file;
+	(void) size;
+
+	// Not aware of, nor concerned with a Windows equivalent.
+	return 0;
+
+	#endif // ZRE_CANTOOLS_OS_linux
+}
+
+int ftruncatePort (FILE* file, size_t size)
+{
+	if (fflush (file) != 0)
+		return -1;
+
+	int fd = fileno (file);
+	if (fd < 0)
+		return -1;
+
+	return ftruncate (fd, size);
+}
+
+int renamePort (const char* oldPath, const char* newPath)
+{
+	#ifdef ZRE_CANTOOLS_OS_windows
+	if (remove (newPath) != 0 && errno != ENOENT)
+		return -1;
+	#endif // ZRE_CANTOOLS_OS_windows
+
+	return rename (oldPath, newPath);
+}
+
+int storageCapacityPort (const char* path, size_t* total, size_t* available)
+{
+	#ifdef ZRE_CANTOOLS_OS_linux
+
+	struct statvfs statvfsBuffer;
+	if (statvfs (path, &statvfsBuffer) != 0)
+		return -1;
+
+	*total = (size_t) statvfsBuffer.f_blocks * statvfsBuffer.f_frsize;
+	*available = (size_t) statvfsBuffer.f_bavail * statvfsBuffer.f_frsize;
+	return 0;
+
+	#else // ZRE_CANTOOLS_OS_linux
+
+	(void) path;
+	(void) total;
+	(void) available;
+
+	// Not aware of, nor concerned with a Windows equivalent.
+	errno = ENOSYS;
+	return -1;
+
+	#endif // ZRE_CANTOOLS_OS_linux
+}
+
+const void* mapFilePort (const char* path, size_t* size)
+{
+	#ifdef ZRE_CANTOOLS_OS_linux
+
+	int fd = open (path, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	struct stat fileStat;
+	if (fstat (fd, &fileStat) != 0)
+	{
+		int code = errno;
+		close (fd);
+		errno = code;
+		return NULL;
+	}
+
+	*size = fileStat.st_size;
+	void* data = mmap (NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping remains valid after the descriptor is closed.
+	int code = errno;
+	close (fd);
+	if (data == MAP_FAILED)
+	{
+		errno = code;
+		return NULL;
+	}
+
+	// Files are typically read front-to-back, so have the kernel read ahead aggressively.
+	madvise (data, *size, MADV_SEQUENTIAL);
+	return data;
+
+	#else // ZRE_CANTOOLS_OS_linux
+
+	FILE* file = fopen (path, "rb");
+	if (file == NULL)
+		return NULL;
+
+	long end;
+	if (fseek (file, 0, SEEK_END) != 0 || (end = ftell (file)) < 0 || fseek (file, 0, SEEK_SET) != 0)
+	{
+		int code = errno;
+		fclose (file);
+		errno = code;
+		return NULL;
+	}
+
+	*size = end;
+	void* data = malloc (*size);
+	if (data == NULL)
+	{
+		int code = errno;
+		fclose (file);
+		errno = code;
+		return NULL;
+	}
+
+	if (fread (data, 1, *size, file) != *size)
+	{
+		free (data);
+		fclose (file);
+		errno = EIO;
+		return NULL;
+	}
+
+	fclose (file);
+	return data;
+
+	#endif // ZRE_CANTOOLS_OS_linux
+}
+
+void unmapFilePort (const void* data, size_t size)
+{
+	#ifdef ZRE_CANTOOLS_OS_linux
+	munmap ((void*) data, size);
+	#else // ZRE_CANTOOLS_OS_linux
+	(void) size;
+	free ((void*) data);
+	#endif // ZRE_CANTOOLS_OS_linux
+}
+
+int idlePriorityPort (void)
+{
+	#ifdef ZRE_CANTOOLS_OS_linux
+
+	// Note Linux applies each of these to the calling thread alone, given an ID of 0 (or the thread's own ID).
+	int code = 0;
+	if (setpriority (PRIO_PROCESS, syscall (SYS_gettid), 19) != 0)
+		code = errno;
+
+	struct sched_param param = { .sched_priority = 0 };
+	if (sched_setscheduler (0, SCHED_IDLE, &param) != 0 && code == 0)
+		code = errno;
+
+	// glibc provides no wrapper for ioprio_set. The value is the idle class (3), shifted into place (13 bits).
+	if (syscall (SYS_ioprio_set, 1, 0, 3 << 13) != 0 && code == 0)
+		code = errno;
+
+	if (code != 0)
+	{
+		errno = code;
+		return -1;
+	}
+	return 0;
+
+	#else // ZRE_CANTOOLS_OS_linux
+
+	// Not aware of, nor concerned with a Windows equivalent.
+	return 0;
+
+	#endif // ZRE_CANTOOLS_OS_linux
+}
+
 int systemf (char* format, ...)
 {
 	// Expand the format string into a dynamically-allocated buffer.
@@ -2,6 +2,7 @@
 #define MISC_PORT_H
 
 // C Standard Library
+#include <stddef.h>
 #include <stdio.h>
 
 /**
@@ -28,6 +29,78 @@ int mkdirPort (const char* path);
  */
 int fsyncPort (FILE* file);
 
+/**
+ * @brief Synchronizes the directory containing a file, so that changes to its entry (ex. a rename replacing it) survive power
+ * loss. On Linux, the directory is opened and passed to @c fsync . On Windows, this call is ignored.
+ * @param path The path of the file.
+ * @return 0 if successful, -1 otherwise and @c errno is set to indicate the error.
+ */
+int fsyncDirectoryPort (const char* path);
+
+/**
+ * @brief Reserves storage for a file without changing its size. On Linux, this is @c fallocate with @c FALLOC_FL_KEEP_SIZE ,
+ * meaning the file's blocks are allocated contiguously up-front, while the file itself still grows as data is written. On
+ * Windows, this call is ignored.
+ * @param file The file to reserve storage for.
+ * @param size The number of bytes to reserve, starting from the beginning of the file.
+ * @return 0 if successful, -1 otherwise and @c errno is set to indicate the error.
+ */
+int fallocatePort (FILE* file, size_t size);
+
+/**
+ * @brief Portability for the POSIX @c ftruncate function. Any buffered data is flushed before truncating. On Linux, this also
+ * releases any storage reserved past the end of the file (see @c fallocatePort ).
+ * @param file The file to truncate.
+ * @param size The size to truncate the file to, in bytes.
+ * @return 0 if successful, -1 otherwise and @c errno is set to indicate the error.
+ */
+int ftruncatePort (FILE* file, size_t size);
+
+/**
+ * @brief Portability for the POSIX @c rename function. On Windows, @c rename fails if the destination exists, so it is removed
+ * first (meaning the replacement is not atomic).
+ * @param oldPath The path of the file to rename.
+ * @param newPath The path to rename the file to. Replaced if it exists.
+ * @return 0 if successful, -1 otherwise and @c errno is set to indicate the error.
+ */
+int renamePort (const char* oldPath, const char* newPath);
+
+/**
+ * @brief Gets the capacity of the filesystem containing a path. On Linux, this is @c statvfs . On Windows, this call fails with
+ * @c ENOSYS .
+ * @param path A path within the filesystem.
+ * @param total Written to the total capacity of the filesystem, in bytes.
+ * @param available Written to the capacity available to unprivileged users, in bytes.
+ * @return 0 if successful, -1 otherwise and @c errno is set to indicate the error.
+ */
+int storageCapacityPort (const char* path, size_t* total, size_t* available);
+
+/**
+ * @brief Maps a file into memory for reading. On Linux, the file is memory-mapped (read-only), meaning its pages are only read
+ * from the storage device as they are accessed. On Windows, the file's contents are read into a dynamically allocated buffer.
+ * @param path The path of the file to map.
+ * @param size Written to the size of the file, in bytes.
+ * @return The contents of the file, if successful, @c NULL otherwise and @c errno is set to indicate the error. Must be
+ * unmapped using @c unmapFilePort . Note an empty file cannot be mapped.
+ */
+const void* mapFilePort (const char* path, size_t* size);
+
+/**
+ * @brief Unmaps a file mapped by @c mapFilePort .
+ * @param data The contents of the file.
+ * @param size The size of the file, in bytes.
+ */
+void unmapFilePort (const void* data, size_t size);
+
+/**
+ * @brief Lowers the scheduling priority of the calling thread as far as possible, so that it only runs when the system is
+ * otherwise idle. On Linux, the thread is moved to the @c SCHED_IDLE policy, given the lowest priority (the highest nice
+ * value, 19), and placed in the idle I/O scheduling class (as by @c ionice @c -c3 ). On Windows, this call is ignored.
+ * @return 0 if successful, -1 otherwise and @c errno is set to indicate the error. Note every adjustment is attempted, even if
+ * one fails.
+ */
+int idlePriorityPort (void);
+
 /**
  * @brief Executes a system command from a format string. Note due to using both dynamic memory allocation and the @c system
  * system call, performance of this function is rather poor. If performance is important, @c fork and @c exec should be
@@ -68,6 +68,7 @@ extern "C" {
 
 #include <stdint.h>                     /* C99 header for sized integer types */
 #include <stdbool.h>                    /* C99 header for boolean type */
+#include <stddef.h>                     /* C99 header for size_t */
 
 
 /*  -----------  options  ------------------------------------------------
@@ -198,6 +199,10 @@ typedef struct can_sio_attr_t_ {        /* serial port attributes: */
     uint8_t  parity;                    /**<  parity bit (None, Even, Odd) */
     uint8_t  stopbits;                  /**<  number of stop bits (1 or 2) */
     uint8_t  protocol;                  /**<  protocol (defaul: Lawicel) */
+    uint8_t  latency;                   /**<  low-latency mode (0 = off, 1 = on) */
+    uint8_t  vmin;                      /**<  low-latency mode: minimum bytes per read (0 = 1) */
+    uint8_t  vtime;                     /**<  low-latency mode: inter-byte timeout (in [1/10 s]) */
+    uint16_t readsize;                  /**<  maximum bytes per read (0 = default, POSIX only) */
 } can_sio_attr_t;
 
 /** @brief SerialCAN port parameters
@@ -207,6 +212,73 @@ typedef struct can_sio_param_t_ {       /* device parameters: */
     can_sio_attr_t attr;                /**< serial communication attributes*/
 } can_sio_param_t;
 
+/** @brief Number of messages converted at once by can_sio_write_batch
+ */
+#define CAN_SIO_BATCH_MAX  64U
+
+/** @brief CAN message (see can_message_t in CANAPI_Types.h)
+ */
+struct can_message_t_;
+
+/** @brief SerialCAN message receiver (see can_sio_receiver)
+ *
+ *  @param[in]   context - context pointer given to can_sio_receiver
+ *  @param[in]   line    - message line in ASCII (e.g. 't1232ABCD\r')
+ *  @param[in]   nbytes  - length of the line, including the terminator
+ */
+typedef void (*can_sio_receiver_t)(void *context, const uint8_t *line, size_t nbytes);
+
+/** @brief ASCII hex digit to value (0xFF = invalid), for decoding the message
+ *         lines handed to a receiver (see slcan_hex_values in slcan.h)
+ */
+extern const uint8_t slcan_hex_values[256];
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       installs a receiver for CAN messages of the CAN interface.
+ *               When installed, each received message line is handed to
+ *               the receiver (from the reception thread) instead of being
+ *               decoded into the message queue, so 'can_read' will not
+ *               return any messages. Should be installed before the CAN
+ *               controller is started.
+ *
+ *  @param[in]   handle   - handle of the CAN interface
+ *  @param[in]   receiver - receiver to install, or NULL to uninstall
+ *  @param[in]   context  - context pointer handed to the receiver
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ */
+int can_sio_receiver(int handle, can_sio_receiver_t receiver, void *context);
+
+
+/** @brief       transmits several CAN messages through the CAN interface.
+ *               With CANable devices the messages are packed into as few
+ *               serial writes as possible and the function does not wait
+ *               for each of them to be sent, see 'slcan_write_messages'.
+ *               Stops at the first message that cannot be sent.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   msgs    - pointer to the messages to send
+ *  @param[in]   count   - number of messages to send
+ *  @param[out]  written - number of messages sent (optional)
+ *  @param[in]   timeout - (not implemented yet)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - illegal data length code or identifier
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      others           - vendor-specific
+ */
+int can_sio_write_batch(int handle, const struct can_message_t_ *msgs, size_t count, size_t *written, uint16_t timeout);
+
 
 #ifdef __cplusplus
 }
@@ -107,6 +107,10 @@ typedef struct sio_attr_t_ {            /* serial port attributes: */
     sio_bytesize_t bytesize;            /**<  number of data bits (5, 6, 7, 8) */
     sio_parity_t parity;                /**<  parity bit (none, odd, even, mark, space) */
     sio_stopbits_t stopbits;            /**<  number of stop bits (1 or 1.5 or 2) */
+    uint8_t latency;                    /**<  low-latency mode (0 = off, 1 = on) */
+    uint8_t vmin;                       /**<  low-latency mode: minimum bytes per read (0 = 1) */
+    uint8_t vtime;                      /**<  low-latency mode: inter-byte timeout (in [1/10 s]) */
+    uint16_t readsize;                  /**<  maximum bytes per read (0 = default, POSIX only) */
 } sio_attr_t;
 
 
@@ -71,6 +71,10 @@
 #include <sys/select.h>
 #include <sys/time.h>
 #include <assert.h>
+#if defined(__linux__)
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+#endif
 
 
 /*  -----------  options  ------------------------------------------------
@@ -109,6 +113,7 @@
 #define BYTESIZE        CS8
 #define STOPBITS        CSTOPB
 #define BUFFER_SIZE     1024
+#define BUFFER_SIZE_MAX 4096
 
 
 /*  -----------  types  --------------------------------------------------
@@ -208,6 +213,10 @@ sio_port_t sio_create(sio_recv_t callback, void *receiver) {
         serial->attr.bytesize = BYTESIZE8;
         serial->attr.parity = PARITYNONE;
         serial->attr.stopbits = STOPBITS1;
+        serial->attr.latency = 0U;
+        serial->attr.vmin = 0U;
+        serial->attr.vtime = 0U;
+        serial->attr.readsize = 0U;
         serial->callback = callback;
         serial->receiver = receiver;
     }
@@ -249,6 +258,10 @@ int sio_get_attr(sio_port_t port, sio_attr_t* attr) {
     attr->bytesize = serial->attr.bytesize;
     attr->stopbits = serial->attr.stopbits;
     attr->parity = serial->attr.parity;
+    attr->latency = serial->attr.latency;
+    attr->vmin = serial->attr.vmin;
+    attr->vtime = serial->attr.vtime;
+    attr->readsize = serial->attr.readsize;
     return 0;
 }
 
@@ -289,6 +302,10 @@ int sio_connect(sio_port_t port, const char *device, const sio_attr_t *param) {
         serial->attr.bytesize = param->bytesize;
         serial->attr.stopbits = param->stopbits;
         serial->attr.parity = param->parity;
+        serial->attr.latency = param->latency;
+        serial->attr.vmin = param->vmin;
+        serial->attr.vtime = param->vtime;
+        serial->attr.readsize = param->readsize;
         // TODO: range check required?
     }
     /* connect to serial port */
@@ -311,6 +328,10 @@ int sio_connect(sio_port_t port, const char *device, const sio_attr_t *param) {
     attr.c_iflag = 0;
     attr.c_oflag = 0;
     attr.c_lflag = 0;
+    /* low-latency mode: a blocking read returns as soon as 'vmin' bytes
+     * have been received, or 'vtime' after the last byte received */
+    attr.c_cc[VMIN] = serial->attr.latency ? (serial->attr.vmin ? serial->attr.vmin : 1U) : 0U;
+    attr.c_cc[VTIME] = serial->attr.latency ? serial->attr.vtime : 0U;
     tcflush(serial->fildes, TCIOFLUSH);
     if (tcsetattr(serial->fildes, TCSANOW, &attr) < 0) {
         /* errno set */
@@ -318,6 +339,30 @@ int sio_connect(sio_port_t port, const char *device, const sio_attr_t *param) {
         serial->fildes = -1;
         return -1;
     }
+    if (serial->attr.latency) {
+        /* read blocking, so that 'VMIN' and 'VTIME' take effect */
+        int flags = fcntl(serial->fildes, F_GETFL);
+        if ((flags < 0) || (fcntl(serial->fildes, F_SETFL, flags & ~O_NONBLOCK) < 0)) {
+            /* errno set */
+            close(serial->fildes);
+            serial->fildes = -1;
+            return -1;
+        }
+#if defined(__linux__) && defined(ASYNC_LOW_LATENCY)
+        /* note: USB-serial drivers buffer received bytes for some
+         *       milliseconds before passing them on, unless the port
+         *       is flagged as low-latency. Not every driver supports
+         *       this (e.g. pseudo terminals don't), so it's optional.
+         */
+        struct serial_struct info;
+        if (ioctl(serial->fildes, TIOCGSERIAL, &info) == 0) {
+            info.flags |= ASYNC_LOW_LATENCY;
+            if (ioctl(serial->fildes, TIOCSSERIAL, &info) < 0)
+                SERIAL_DEBUG_INFO("serial: low-latency mode not supported\n");
+        }
+        errno = 0;
+#endif
+    }
     /* create the reception thread */
     if (pthread_create(&serial->pthread, NULL, reception_loop, (void*)serial) < 0) {
         /* errno set */
@@ -409,17 +454,36 @@ static void *reception_loop(void *arg) {
     FD_ZERO(&rdfs);
     FD_SET(serial->fildes, &rdfs);
 
+    /* number of bytes per read */
+    size_t size = serial->attr.readsize ? serial->attr.readsize : BUFFER_SIZE;
+    if (size > BUFFER_SIZE_MAX)
+        size = BUFFER_SIZE_MAX;
+
     /* thread cancellation */
     assert(pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL) == 0);
     assert(pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, NULL) == 0);
 
+    /* low-latency mode: one blocking read per wake-up */
+    while (serial->attr.latency) {
+        ssize_t nbytes;
+        uint8_t buffer[BUFFER_SIZE_MAX];
+
+        nbytes = read(serial->fildes, &buffer, size);
+        SERIAL_DEBUG_ASYNC(buffer, nbytes);
+        if ((nbytes > 0) && serial->callback)
+            serial->callback(serial->receiver, &buffer[0], (size_t)nbytes);
+        else if ((nbytes < 0) && (errno != EINTR) && (errno != EAGAIN)) {
+            perror("serial");
+            return NULL;
+        }
+    }
     /* the torture never stops */
     for (;;) {
         ssize_t nbytes;
-        uint8_t buffer[BUFFER_SIZE];
+        uint8_t buffer[BUFFER_SIZE_MAX];
 
         do {
-            nbytes = read(serial->fildes, &buffer, BUFFER_SIZE);
+            nbytes = read(serial->fildes, &buffer, size);
             SERIAL_DEBUG_ASYNC(buffer, nbytes);
             if ((nbytes > 0) && serial->callback)
                 serial->callback(serial->receiver, &buffer[0], (size_t)nbytes);
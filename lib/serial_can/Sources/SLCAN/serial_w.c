@@ -142,6 +142,10 @@ sio_port_t sio_create(sio_recv_t callback, void *receiver) {
         serial->attr.bytesize = BYTESIZE8;
         serial->attr.stopbits = STOPBITS1;
         serial->attr.parity = PARITYNONE;
+        serial->attr.latency = 0U;
+        serial->attr.vmin = 0U;
+        serial->attr.vtime = 0U;
+        serial->attr.readsize = 0U;
         serial->callback = callback;
         serial->receiver = receiver;
         serial->running = 0;
@@ -184,6 +188,10 @@ int sio_get_attr(sio_port_t port, sio_attr_t* attr) {
     attr->bytesize = serial->attr.bytesize;
     attr->stopbits = serial->attr.stopbits;
     attr->parity = serial->attr.parity;
+    attr->latency = serial->attr.latency;
+    attr->vmin = serial->attr.vmin;
+    attr->vtime = serial->attr.vtime;
+    attr->readsize = serial->attr.readsize;
     return 0;
 }
 
@@ -228,6 +236,12 @@ int sio_connect(sio_port_t port, const char *device, const sio_attr_t *attr) {
         serial->attr.bytesize = attr->bytesize;
         serial->attr.stopbits = attr->stopbits;
         serial->attr.parity = attr->parity;
+        /* note: low-latency mode is not supported (yet), and the read
+         *       size is ignored, as the port is read byte by byte */
+        serial->attr.latency = 0U;
+        serial->attr.vmin = attr->vmin;
+        serial->attr.vtime = attr->vtime;
+        serial->attr.readsize = attr->readsize;
     }
     /* get comm port number from device name */
     if (((n = sscanf_s(device, "COM%i", &comm)) < 1) &&
@@ -155,6 +155,8 @@ static void _finalizer() {
 #define MAX_DLC(l)  (((l) < CAN_LEN_MAX) ? (l) : (CAN_DLC_MAX))
 
 #define BUFFER_SIZE 128U
+#define TX_BUFFER_SIZE  4096U
+#define TX_BACKLOG_MAX  512U
 #define RESPONSE_TIMEOUT  100U
 #define TRANSMIT_TIMEOUT  1000U
 
@@ -172,6 +174,9 @@ typedef struct slcan_t_ {               /* SLCAN communication instance: */
     uint8_t buffer[BUFFER_SIZE];        /* - receive buffer (reception loop) */
     size_t index;                       /* - write index of the receive buffer */
     bool ack;                           /* - ACK/NACK feedback enabled/disabled */
+    timer_obj_t drained;                /* - time when all sent bytes are on the wire */
+    slcan_receiver_t receiver;          /* - receiver for CAN messages (optional) */
+    void *context;                      /* - context pointer of the receiver */
 } slcan_t;
 
 
@@ -183,13 +188,34 @@ static int send_command(slcan_t *slcan, const uint8_t *request, size_t nbytes,
 static bool encode_message(const slcan_message_t *message, uint8_t *buffer, size_t *nbytes);
 static bool decode_message(slcan_message_t *message, const uint8_t *buffer, size_t nbytes);
 static void reception_loop(const void *port, const uint8_t *buffer, size_t nbytes);
+static void reception_line(slcan_t *slcan, const uint8_t *line, size_t nbytes);
 
-static int wait_for_bytes_sent(slcan_t *slcan, int nbytes);  // for CANable devices only
+static int wait_for_bytes_sent(slcan_t *slcan, int nbytes, size_t backlog);  // for CANable devices only
 
 
 /*  -----------  variables  ----------------------------------------------
  */
 
+EXPORT
+const uint8_t slcan_hex_values[256] = {  /* ASCII hex digit to value (0xFF = invalid) */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
 
 /*  -----------  functions  ----------------------------------------------
  */
@@ -202,14 +228,7 @@ static inline uint8_t bcd2chr(uint8_t x) {
 }
 
 static inline uint8_t chr2bcd(uint8_t x) {
-    if (('0' <= x) && (x <= '9'))
-        return (uint8_t)(x - '0');
-    else if (('A' <= x) && (x <= 'F'))
-        return (uint8_t)(10 + x - 'A');
-    else if (('a' <= x) && (x <= 'f'))
-        return (uint8_t)(10 + x - 'a');
-    else
-        return (uint8_t)(0xFF);
+    return slcan_hex_values[x];
 }
 
 EXPORT
@@ -279,6 +298,41 @@ int slcan_destroy(slcan_port_t port) {
     return 0;
 }
 
+EXPORT
+int slcan_set_receiver(slcan_port_t port, slcan_receiver_t receiver, void *context) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* install the receiver (or uninstall it) */
+    slcan->context = context;
+    slcan->receiver = receiver;
+    return 0;
+}
+
+EXPORT
+int slcan_feed(slcan_port_t port, const uint8_t *buffer, size_t nbytes) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!buffer) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* hand the bytes to the reception loop */
+    reception_loop((const void*)slcan, buffer, nbytes);
+    return 0;
+}
+
 EXPORT
 int slcan_signal(slcan_port_t port) {
     slcan_t *slcan = (slcan_t*)port;
@@ -636,7 +690,7 @@ int slcan_write_message(slcan_port_t port, const slcan_message_t *message, uint1
              *       and data may be lost during bulk transmission, we have to
              *       wait until all data bytes has been certainly sent.
              */
-            res = wait_for_bytes_sent(slcan, nbytes);
+            res = wait_for_bytes_sent(slcan, nbytes, 0U);
         }
     } else if (nbytes >= 0) {
         /* note: Variable 'errno' is set by the called functions according to
@@ -651,6 +705,81 @@ int slcan_write_message(slcan_port_t port, const slcan_message_t *message, uint1
     return res;
 }
 
+EXPORT
+int slcan_write_messages(slcan_port_t port, const slcan_message_t *messages, size_t count, size_t *written, uint16_t timeout) {
+    slcan_t *slcan = (slcan_t*)port;
+    uint8_t buffer[TX_BUFFER_SIZE];
+    size_t length, first, n = 0U;
+    bool encoded = true;
+    int nbytes;
+    int res = 0;
+
+    /* sanity check */
+    errno = 0;
+    if (written)
+        *written = 0U;
+    if (!slcan || !slcan->port) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!messages && (count > 0U)) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* Lawicel SLCAN protocol (with ACK/NACK feedback) */
+    if (slcan->ack) {
+        /* note: Each message is acknowledged by the device separately,
+         *       so the messages have to be sent one after another.
+         */
+        for (n = 0U; n < count; n++) {
+            if ((res = slcan_write_message(port, &messages[n], timeout)) < 0)
+                break;
+            if (written)
+                *written += 1U;
+        }
+        SLCAN_DEBUG_INFO("slcan_write_messages (%i)\n", res);
+        return res;
+    }
+    /* CANable SLCAN protocol (w/o ACK/NACK feedback) */
+    while ((n < count) && encoded) {
+        /* encode as many CAN messages as fit into the transmit buffer */
+        for (length = 0U, first = n; (n < count) && ((length + BUFFER_SIZE) <= TX_BUFFER_SIZE); n++) {
+            size_t size;
+            if (!(encoded = encode_message(&messages[n], &buffer[length], &size)))
+                break;
+            length += size;
+        }
+        if (length == 0U)
+            break;
+        /* send them to the device via serial port at once */
+        nbytes = sio_transmit(slcan->port, buffer, length);
+        if (nbytes != (int)length) {
+            /* note: A wrong number of bytes transmitted is interpreted as
+             *       the sender or the receiver is busy (EBUSY).
+             */
+            if (nbytes >= 0)
+                errno = EBUSY;
+            res = -1;
+            break;
+        }
+        if (written)
+            *written += n - first;
+        /* note: Unlike 'slcan_write_message' the bytes are not waited for
+         *       one write at a time. Only when more than TX_BACKLOG_MAX
+         *       bytes are still on their way, we wait until enough of them
+         *       have been certainly sent.
+         */
+        if ((res = wait_for_bytes_sent(slcan, nbytes, TX_BACKLOG_MAX)) < 0)
+            break;
+    }
+    if ((res == 0) && !encoded) {
+        errno = EFAULT;
+        res = -99;
+    }
+    SLCAN_DEBUG_INFO("slcan_write_messages (%i)\n", res);
+    return res;
+}
+
 EXPORT
 int slcan_read_message(slcan_port_t port, slcan_message_t *message, uint16_t timeout) {
     slcan_t *slcan = (slcan_t*)port;
@@ -1007,9 +1136,11 @@ static int send_command(slcan_t *slcan, const uint8_t *request, size_t nbytes,
     return res;
 }
 
-static int wait_for_bytes_sent(slcan_t *slcan, int nbytes) {
+static int wait_for_bytes_sent(slcan_t *slcan, int nbytes, size_t backlog) {
     int baud = 57600; /* baud rate (in [bps]) */
     sio_attr_t attr;
+    timer_val_t byte_time;
+    timer_obj_t now;
 
     assert(slcan);
     assert(nbytes >= 0);
@@ -1018,13 +1149,23 @@ static int wait_for_bytes_sent(slcan_t *slcan, int nbytes) {
     if ((sio_get_attr(slcan->port, &attr) >= 0) && (attr.baudrate != 0U))
         baud = (int)attr.baudrate;
 
-    /* wait until all data bytes has been certainly sent */
     /* note: transmission time for one byte is:
      *
      *       tByte = (1sec / baud rate) * (1 + bits per byte + 1)
      */
+    byte_time = (timer_val_t)(10000000 / baud);
+
+    /* the bytes are sent after all bytes still on their way */
+    now = timer_new(0U);
+    if (slcan->drained < now)
+        slcan->drained = now;
+    slcan->drained += byte_time * (timer_val_t)nbytes;
+
+    /* wait until no more than 'backlog' bytes are on their way */
     errno = 0;
-    return timer_delay((timer_val_t)((10000000 / baud) * nbytes));
+    if (slcan->drained > (now + (byte_time * (timer_val_t)backlog)))
+        return timer_delay(slcan->drained - now - (byte_time * (timer_val_t)backlog));
+    return 0;
 }
 
 static bool encode_message(const slcan_message_t *message, uint8_t *buffer, size_t *nbytes) {
@@ -1139,44 +1280,73 @@ static bool decode_message(slcan_message_t *message, const uint8_t *buffer, size
 
 static void reception_loop(const void *port, const uint8_t *buffer, size_t nbytes) {
     slcan_t *slcan = (slcan_t*)port;
-    slcan_message_t message;
+    const uint8_t *line = buffer;
+    const uint8_t *end = buffer + nbytes;
+    const uint8_t *term;
+    size_t length;
 
     if (slcan && buffer) {
         assert(slcan->response);
         assert(slcan->messages);
-        for (size_t index = 0; index < nbytes; index++) {
-            /* get next byte (asynchronous reception) */
-            if ((slcan->index + 1) < BUFFER_SIZE)
-                slcan->buffer[slcan->index++] = buffer[index];
-            if (buffer[index] == '\r') {
-                /* positive ACKnowledge [CR] received */
-                if ((slcan->buffer[0] == 't') || (slcan->buffer[0] == 'T') ||
-                    (slcan->buffer[0] == 'r') || (slcan->buffer[0] == 'R')) {
-                    /* message indication or confirmation? */
-                    if (slcan->index > 2) {
-                        /* new message received (indication) */
-                        if (decode_message(&message, slcan->buffer, slcan->index))
-                            (void)queue_enqueue(slcan->messages, &message, sizeof(slcan_message_t));
-                    } else {
-                        /* confirmation of a sent message received */
-                        (void)buffer_put(slcan->response, slcan->buffer, slcan->index);
-                    }
-                } else {
-                    /* response of a sent request received */
-                    (void)buffer_put(slcan->response, slcan->buffer, slcan->index);
+        /* note: The whole buffer is scanned for line terminators at once.
+         *       Complete lines are processed in place, only a line split
+         *       across two buffers is copied into the reception buffer.
+         */
+        while (line < end) {
+            /* search for the next [CR] or [BEL] */
+            for (term = line; (term < end) && (*term != '\r') && (*term != '\a'); term++);
+            length = (term < end) ? (size_t)(term - line) + 1U : (size_t)(term - line);
+            if ((slcan->index > 0U) || (term == end)) {
+                /* append to the pending line (truncated at buffer size) */
+                if ((slcan->index + length) >= BUFFER_SIZE)
+                    length = (BUFFER_SIZE - 1U) - slcan->index;
+                (void)memcpy(&slcan->buffer[slcan->index], line, length);
+                slcan->index += length;
+                /* process the pending line when complete */
+                if (term < end) {
+                    if ((slcan->index > 0U) && (slcan->buffer[slcan->index - 1U] != *term))
+                        slcan->buffer[slcan->index++] = *term;
+                    reception_line(slcan, slcan->buffer, slcan->index);
+                    /* done: reset reception buffer */
+                    slcan->index = 0U;
                 }
-                /* done: reset reception buffer */
-                slcan->index = 0U;
-            } else if (buffer[index] == '\a') {
-                /* Negative ACKnowledge [BEL] received */
-                (void)buffer_put(slcan->response, slcan->buffer, slcan->index);
-                /* done: reset reception buffer */
-                slcan->index = 0U;
+            } else {
+                /* complete line in the buffer */
+                reception_line(slcan, line, length);
             }
+            line = term + 1;
         }
     }
 }
 
+static void reception_line(slcan_t *slcan, const uint8_t *line, size_t nbytes) {
+    slcan_message_t message;
+
+    if (line[nbytes - 1U] == '\r') {
+        /* positive ACKnowledge [CR] received */
+        if ((line[0] == 't') || (line[0] == 'T') ||
+            (line[0] == 'r') || (line[0] == 'R')) {
+            /* message indication or confirmation? */
+            if (nbytes > 2U) {
+                /* new message received (indication) */
+                if (slcan->receiver)
+                    slcan->receiver(slcan->context, line, nbytes);
+                else if (decode_message(&message, line, nbytes))
+                    (void)queue_enqueue(slcan->messages, &message, sizeof(slcan_message_t));
+            } else {
+                /* confirmation of a sent message received */
+                (void)buffer_put(slcan->response, line, nbytes);
+            }
+        } else {
+            /* response of a sent request received */
+            (void)buffer_put(slcan->response, line, nbytes);
+        }
+    } else {
+        /* Negative ACKnowledge [BEL] received */
+        (void)buffer_put(slcan->response, line, nbytes);
+    }
+}
+
 /*  ----------------------------------------------------------------------
  *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
  *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
@@ -147,6 +147,14 @@ typedef struct slcan_message_t_ {       /* SLCAN message: */
     uint8_t data[CAN_LEN_MAX];          /**< payload (max. 8 data bytes) */
 } slcan_message_t;
 
+/** @brief  Receiver for raw CAN message lines (see slcan_set_receiver)
+ *
+ *  @param[in]   context - context pointer given to slcan_set_receiver
+ *  @param[in]   line    - message line in ASCII (e.g. 't1232ABCD\r')
+ *  @param[in]   nbytes  - length of the line, including the terminator
+ */
+typedef void (*slcan_receiver_t)(void *context, const uint8_t *line, size_t nbytes);
+
 /** @brief  SLCAN status flags
  */
 typedef union slcan_flags_t_ {          /* SLACAN status flags */
@@ -167,6 +175,11 @@ typedef union slcan_flags_t_ {          /* SLACAN status flags */
 /*  -----------  variables  ----------------------------------------------
  */
 
+/** @brief  ASCII hex digit to value (0xFF = invalid), e.g. for decoding
+ *          the message lines handed to a receiver (see slcan_set_receiver)
+ */
+SLCANAPI const uint8_t slcan_hex_values[256];
+
 
 /*  -----------  prototypes  ---------------------------------------------
  */
@@ -399,6 +412,40 @@ SLCANAPI int slcan_close_channel(slcan_port_t port);
 SLCANAPI int slcan_write_message(slcan_port_t port, const slcan_message_t *message, uint16_t timeout);
 
 
+/** @brief       transmits several CAN messages at once.
+ *
+ *  @remarks     This command is only active if the CAN channel is open.
+ *
+ *  @remarks     With CANable devices (w/o ACK/NACK feedback) the messages
+ *               are encoded back-to-back and sent with as few serial writes
+ *               as possible. The time needed to put the bytes on the wire
+ *               is accounted for cumulatively, so the function returns when
+ *               the last write has been queued, not when it has been sent.
+ *               With Lawicel devices the messages are sent one by one, as
+ *               each of them has to be acknowledged.
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[in]   messages - pointer to the messages to be sent
+ *  @param[in]   count    - number of messages to be sent
+ *  @param[out]  written  - number of messages sent (optional)
+ *  @param[in]   timeout  - (not implemented yet)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (messages)
+ *  @retval      EBADF     - bad file descriptor (device not connected)
+ *  @retval      EBUSY     - device / resource busy (disturbance)
+ *  @retval      EBADMSG   - bad message (format or disturbance)
+ *  @retval      ETIMEDOUT - timed out (command not acknowledged)
+ *  @retval      'errno'   - error code from called system functions:
+ *                           'write', 'read', etc.
+ */
+SLCANAPI int slcan_write_messages(slcan_port_t port, const slcan_message_t *messages, size_t count, size_t *written, uint16_t timeout);
+
+
 /** @brief       read one message from the message queue, if any.
  *
  *  @param[in]   port     - pointer to a SLCAN instance
@@ -540,6 +587,43 @@ SLCANAPI int slcan_version_number(slcan_port_t port, uint8_t *hardware, uint8_t
 SLCANAPI int slcan_serial_number(slcan_port_t port, uint32_t *number);
 
 
+/** @brief       installs a receiver for CAN messages. When installed, each
+ *               received message line is handed to the receiver as-is,
+ *               bypassing the message decoder and the message queue.
+ *               Responses to commands are handled as usual.
+ *
+ *  @remarks     The receiver is called from the reception thread. It
+ *               should be installed before the CAN channel is opened.
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[in]   receiver - receiver to install, or NULL to uninstall
+ *  @param[in]   context  - context pointer handed to the receiver
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ */
+SLCANAPI int slcan_set_receiver(slcan_port_t port, slcan_receiver_t receiver, void *context);
+
+
+/** @brief       feeds bytes into the reception path as if they were
+ *               received from the serial port (e.g. to replay a
+ *               captured serial byte stream).
+ *
+ *  @remarks     Must not be called while the port is connected.
+ *
+ *  @param[in]   port   - pointer to a SLCAN instance
+ *  @param[in]   buffer - bytes to feed
+ *  @param[in]   nbytes - number of bytes to feed
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (buffer is NULL)
+ */
+SLCANAPI int slcan_feed(slcan_port_t port, const uint8_t *buffer, size_t nbytes);
+
+
 /** @brief       signal all waiting objects, if any.
  *
  *  @param[in]   port  - pointer to a SLCAN instance
@@ -767,6 +767,77 @@ int can_property(int handle, uint16_t param, void *value, uint32_t nbyte)
     return drv_parameter(handle, param, value, (size_t)nbyte);
 }
 
+EXPORT
+int can_sio_write_batch(int handle, const can_message_t *msgs, size_t count, size_t *written, uint16_t timeout)
+{
+    slcan_message_t slcan[CAN_SIO_BATCH_MAX];  // SLCAN messages
+    size_t n, i, sent;                  // counters
+    int rc = CANERR_NOERROR;            // return value
+
+    if (written != NULL)
+        *written = 0U;
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        return CANERR_HANDLE;
+    if ((msgs == NULL) && (count > 0U)) // check for null-pointer
+        return CANERR_NULLPTR;
+    if (can[handle].status.can_stopped) // must be running
+        return CANERR_OFFLINE;
+
+    for (n = 0U; (n < count) && (rc == CANERR_NOERROR); n += i) {
+        // map message layout (checked as in can_write)
+        for (i = 0U; (i < CAN_SIO_BATCH_MAX) && ((n + i) < count); i++) {
+            const can_message_t *msg = &msgs[n + i];
+            if ((msg->id > (uint32_t)(msg->xtd ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID)) ||
+                (msg->dlc > CAN_MAX_DLC) ||
+                (msg->xtd && can[handle].mode.nxtd) ||
+                (msg->rtr && can[handle].mode.nrtr) ||
+                (msg->sts)) {
+                rc = CANERR_ILLPARA;
+                break;
+            }
+            memset(&slcan[i], 0x00, sizeof(slcan_message_t));
+            slcan[i].can_id = msg->id & (msg->xtd ? CAN_XTD_MASK : CAN_STD_MASK);
+            slcan[i].can_id |= (msg->xtd ? CAN_XTD_FRAME : 0x00000000U);
+            slcan[i].can_id |= (msg->rtr ? CAN_RTR_FRAME : 0x00000000U);
+            slcan[i].can_dlc = msg->dlc;
+            memcpy(slcan[i].data, msg->data, slcan[i].can_dlc);
+        }
+        // transmit the CAN messages (all valid ones before an invalid one)
+        sent = 0U;
+        if (i > 0U) {
+            int res = slcan_write_messages(can[handle].port, slcan, i, &sent, timeout);
+            if (res != 0)
+                rc = slcan_error(res);
+        }
+        // update status and tx counter
+        can[handle].status.transmitter_busy = (rc != CANERR_NOERROR) ? 1 : 0;
+        can[handle].counters.tx += (uint64_t)sent;
+        if (written != NULL)
+            *written += sent;
+    }
+    return rc;
+}
+
+EXPORT
+int can_sio_receiver(int handle, can_sio_receiver_t receiver, void *context)
+{
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        return CANERR_HANDLE;
+
+    // note: the line format is the same, so the receiver is passed through
+    if (slcan_set_receiver(can[handle].port, (slcan_receiver_t)receiver, context) < 0)
+        return CANERR_FATAL;
+    return CANERR_NOERROR;
+}
+
 EXPORT
 char *can_hardware(int handle)
 {
@@ -902,6 +973,10 @@ static slcan_attr_t* slcan_attr(const can_sio_attr_t *attr)
     case CANSIO_EVENPARITY: slcan.parity = PARITYEVEN; break;
     default: slcan.parity = PARITYNONE; break;
     }
+    slcan.latency = attr->latency;
+    slcan.vmin = attr->vmin;
+    slcan.vtime = attr->vtime;
+    slcan.readsize = attr->readsize;
     return &slcan;
 }
 
@@ -932,11 +1007,19 @@ static int get_sio_attr(slcan_port_t port, can_sio_attr_t *attr)
         default: attr->bytesize = 0; break;
         }
         attr->baudrate = slcan.baudrate;// in bits per second
+        attr->latency = slcan.latency;
+        attr->vmin = slcan.vmin;
+        attr->vtime = slcan.vtime;
+        attr->readsize = slcan.readsize;
     } else {
         attr->baudrate = 0;
         attr->bytesize = 0;
         attr->stopbits = 0;
         attr->parity = 0;
+        attr->latency = 0;
+        attr->vmin = 0;
+        attr->vtime = 0;
+        attr->readsize = 0;
     }
     return rc;
 }
@@ -1227,6 +1310,10 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
             ((can_sio_param_t*)value)->attr.parity = can[handle].attr.parity;
             ((can_sio_param_t*)value)->attr.stopbits = can[handle].attr.stopbits;
             ((can_sio_param_t*)value)->attr.protocol = can[handle].attr.protocol;
+            ((can_sio_param_t*)value)->attr.latency = can[handle].attr.latency;
+            ((can_sio_param_t*)value)->attr.vmin = can[handle].attr.vmin;
+            ((can_sio_param_t*)value)->attr.vtime = can[handle].attr.vtime;
+            ((can_sio_param_t*)value)->attr.readsize = can[handle].attr.readsize;
             rc = CANERR_NOERROR;
         }
         break;
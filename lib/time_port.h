@@ -71,7 +71,7 @@ static inline struct timespec timespecAdd (const struct timespec* a, const struc
 		.tv_nsec = a->tv_nsec + b->tv_nsec
 	};
 
-	if (c.tv_nsec > 1e9)
+	if (c.tv_nsec >= 1e9)
 	{
 		c.tv_nsec -= 1e9;
 		c.tv_sec++;
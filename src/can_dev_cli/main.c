@@ -9,22 +9,118 @@
 // Includes
 #include "can_device/can_device.h"
 #include "can_device/can_device_stdio.h"
+#include "can_device/slcan.h"
 #include "debug.h"
+#include "error_codes.h"
+#include "histogram.h"
+#include "list.h"
 #include "options.h"
 #include "time_port.h"
 
+// POSIX
+#include <pthread.h>
+
 // C Standard Library
 #include <errno.h>
+#include <signal.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
+#include <time.h>
 
 // Constants ------------------------------------------------------------------------------------------------------------------
 
 /// @brief The maximum number of CAN IDs that can be filtered during receiving.
 const size_t MAX_CAN_ID_COUNT = 64;
 
+/// @brief The number of frames handed to the device at once when transmitting a burst.
+#define BURST_CHUNK_SIZE 256
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief An entry of a transmit schedule, that is, a frame to be transmitted periodically.
+typedef struct
+{
+	/// @brief The frame to transmit.
+	canFrame_t frame;
+
+	/// @brief The period to transmit the frame at.
+	struct timespec period;
+
+	/// @brief The absolute time (@c CLOCK_MONOTONIC ) of the next transmission.
+	struct timespec deadline;
+
+	/// @brief The number of times the frame has been transmitted.
+	size_t transmitCount;
+
+	/// @brief The number of transmissions that were late by more than a full period.
+	size_t overrunCount;
+
+	/// @brief The largest lateness of any transmission, in nanoseconds.
+	long long latenessMax;
+
+	/// @brief The time (@c CLOCK_MONOTONIC ) the frame was last transmitted, only valid if @c transmitCount is non-zero.
+	struct timespec transmitLast;
+
+	/// @brief The largest jitter of any transmission, that is, the deviation of the interval between two consecutive
+	/// transmissions from the period, in nanoseconds.
+	long long jitterMax;
+} scheduleEntry_t;
+
+listDefine (scheduleEntry_t);
+
+/// @brief Shared state of a round-trip benchmark.
+typedef struct
+{
+	/// @brief The device requests are transmitted on and responses are received from.
+	canDevice_t* device;
+
+	/// @brief The loopback device responses are echoed from, @c NULL if an external responder is used.
+	canDevice_t* loopback;
+
+	/// @brief The template of each request frame.
+	canFrame_t request;
+
+	/// @brief The ID of response frames.
+	uint32_t responseId;
+
+	/// @brief Whether or not the response ID is extended.
+	bool responseIde;
+
+	/// @brief Random tag identifying this benchmark run, used to discard stale responses.
+	uint32_t runTag;
+
+	/// @brief The number of requests to send.
+	size_t count;
+
+	/// @brief The transmission time of each request, in nanoseconds, indexed by sequence number. 0 if the request has not been
+	/// sent. Published with release ordering, so the receiver never sees a response before the time of its request.
+	atomic_llong* timesSentNs;
+
+	/// @brief Whether each request has received a response, indexed by sequence number.
+	atomic_bool* responded;
+
+	/// @brief Histogram of round-trip times, in nanoseconds. Only written by the thread receiving responses.
+	histogram_t rtt;
+
+	/// @brief The number of requests that have received a response.
+	atomic_size_t responseCount;
+
+	/// @brief The number of responses that were duplicates or did not match a request of this run.
+	atomic_size_t unmatchedCount;
+
+	/// @brief Flag indicating the benchmark threads should exit.
+	atomic_bool running;
+} benchmark_t;
+
+// Globals --------------------------------------------------------------------------------------------------------------------
+
+/// @brief Flag indicating a long-running command should stop, set by @c SIGINT .
+static volatile sig_atomic_t commandInterrupted = false;
+
 // Standard I/O ---------------------------------------------------------------------------------------------------------------
 
 /**
@@ -90,6 +186,45 @@ void fprintUsage (FILE* stream)
 	fprintf (stream, "Usage: can-dev-cli <Options> <Device Name>\n");
 }
 
+/// @brief Prints help about the format of a schedule file.
+void fprintScheduleFileHelp (FILE* stream, const char* indent)
+{
+	fprintf (stream, ""
+		"%s<Schedule File>       - A text file listing the frames to transmit, one per\n"
+		"%s                        line, in the following format:\n"
+		"%s    <CAN Frame> <Period Ms> [<Phase Ms>]\n"
+		"%s                        Where <Phase Ms> is the offset of the first\n"
+		"%s                        transmission relative to the start of the\n"
+		"%s                        schedule (default 0). Empty lines and lines starting\n"
+		"%s                        with '#' are ignored.\n"
+		"\n",
+		indent, indent, indent, indent, indent, indent, indent);
+}
+
+/// @brief Prints help about the round-trip benchmark.
+void fprintBenchmarkHelp (FILE* stream, const char* indent)
+{
+	fprintf (stream, ""
+		"%sRound-trip benchmark: Each request frame carries a 32-bit sequence number\n"
+		"%s(bytes 0 to 3) followed by a 32-bit run tag (bytes 4 to 7). A responder is\n"
+		"%sexpected to reply to each request with the response ID, echoing the request's\n"
+		"%spayload. The round-trip time (RTT) is measured from the transmission of the\n"
+		"%srequest to the reception of its response.\n"
+		"\n"
+		"%sIf a loopback device is specified, this program acts as the responder on said\n"
+		"%sdevice. For example, a 'vxcan' tunnel pair, or two adapters connected to the\n"
+		"%ssame bus. Otherwise, an external responder (ex. device firmware) is assumed.\n"
+		"\n"
+		"%sAn offered load (rate) of 0 Hz indicates closed-loop operation, that is each\n"
+		"%srequest is sent only after the previous response arrives (or times out).\n"
+		"%sOtherwise requests are sent at the rate regardless of responses, measuring\n"
+		"%sthe latency under the given load.\n"
+		"\n"
+		"%sNote the benchmark sets the receive timeout of the device(s) to 100 ms.\n"
+		"\n",
+		indent, indent, indent, indent, indent, indent, indent, indent, indent, indent, indent, indent, indent);
+}
+
 /// @brief Prints detailed help about the program.
 void fprintHelp (FILE* stream)
 {
@@ -108,6 +243,30 @@ void fprintHelp (FILE* stream)
 		"    -t=<CAN Frame>@<Count>,<Freq>\n"
 		"        Transmits <Count> CAN frames at the frequency of <Freq> Hertz.\n"
 		"\n"
+		"    -t=<CAN Frame>@<Count>,0\n"
+		"        Transmits <Count> CAN frames as a single burst, as fast as the device\n"
+		"        allows. Upon completion, the achieved frame rate is printed.\n"
+		"\n"
+		"    -s=<Schedule File>\n"
+		"        Transmits every frame in a schedule file periodically, each with its own\n"
+		"        period and phase offset, until interrupted (Ctrl+C). Upon exit,\n"
+		"        statistics of the transmission lateness (how late each transmission\n"
+		"        was relative to its deadline) and jitter (how far the interval between\n"
+		"        consecutive transmissions of a frame deviated from its period) are\n"
+		"        printed.\n"
+		"\n"
+		"    -s=<Schedule File>@<Duration S>\n"
+		"        Same as above, but stops after <Duration S> seconds.\n"
+		"\n"
+		"    -b=<Request ID>,<Response ID>@<Count>,<Rate Hz>\n"
+		"        Round-trip latency benchmark. Transmits <Count> request frames at an\n"
+		"        offered load of <Rate Hz> and matches each to its response. Prints the\n"
+		"        RTT percentiles and achieved throughput. See below for more details.\n"
+		"\n"
+		"    -b=<Request ID>,<Response ID>@<Count>,<Rate Hz>,<Loopback Device Name>\n"
+		"        Same as above, but responds to requests received on the loopback\n"
+		"        device.\n"
+		"\n"
 		"    -r  Receives the first available CAN message.\n"
 		"\n"
 		"    -r=@<Count>\n"
@@ -125,6 +284,11 @@ void fprintHelp (FILE* stream)
 		"    -d=<CAN ID 0>,<CAN ID 1>,...<CAN ID N>\n"
 		"        Dumps all received CAN messages matching any of the given IDs.\n"
 		"\n"
+		"    -l=<Count>\n"
+		"        Measures the inter-arrival time of <Count> received CAN messages, that\n"
+		"        is the time between consecutive frames being returned by the device.\n"
+		"        Upon completion (or Ctrl+C), the distribution is printed.\n"
+		"\n"
 		"    -m=<Timeout Ms>\n"
 		"        Sets the device's receive timeout to <Timeout Ms>, in milliseconds.\n"
 		"\n"
@@ -134,6 +298,26 @@ void fprintHelp (FILE* stream)
 		"\n"
 		"    -q  Query mode. Tests whether the device exists and can be initialized.\n"
 		"        Return code of 0 indicates success, any other value indicates failure.\n"
+		"\n"
+		"Serial Options (SLCAN devices only):\n"
+		"\n"
+		"    --serial-low-latency\n"
+		"        Enables low-latency tuning of the serial port (Linux only), reading it\n"
+		"        with blocking reads rather than polling it. By default, the port is\n"
+		"        polled with non-blocking reads.\n"
+		"\n"
+		"    --serial-read-size=<Bytes>\n"
+		"        Sets the maximum number of bytes read from the serial port at once.\n"
+		"        Default 1024, maximum 4096. Not supported on Windows.\n"
+		"\n"
+		"    --serial-vmin=<Bytes>\n"
+		"        Sets the minimum number of bytes a read waits for, in low-latency mode.\n"
+		"        Default 1, that is, each read returns as soon as any data is available.\n"
+		"\n"
+		"    --serial-vtime=<Deciseconds>\n"
+		"        Sets the inter-byte timeout of a read, in tenths of a second, in\n"
+		"        low-latency mode. Only relevant if the minimum is greater than 1.\n"
+		"        Default 0.\n"
 		"\n");
 	fprintOptionHelp (stream, "    ");
 
@@ -142,6 +326,8 @@ void fprintHelp (FILE* stream)
 	fprintCanDeviceNameHelp (stream, "    ");
 	fprintCanFrameHelp (stream, "    ");
 	fprintCanIdHelp (stream, "    ");
+	fprintScheduleFileHelp (stream, "    ");
+	fprintBenchmarkHelp (stream, "    ");
 
 	fprintf (stream,
 		"Examples:\n"
@@ -163,11 +349,60 @@ void fprintHelp (FILE* stream)
 		"\n"
 		"    Transmits a frame and listens for a specific response, with timeout:\n"
 		"        can-dev-cli -m=100 -t=0x123 -r=0x124 COM5@1000000\n"
+		"\n"
+		"    Measure the RTT of 10000 frames at 1 kHz through a vxcan pair:\n"
+		"        can-dev-cli -b=0x100,0x101@10000,1000,vxcan1 vxcan0\n"
+		"\n"
+		"    Transmit the frames of a schedule file for 60 seconds:\n"
+		"        can-dev-cli -s=schedule.txt@60 can0\n"
 		"\n");
 }
 
 // Command Handling -----------------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Transmits a burst of identical frames using batch transmission. Frames are not printed individually, rather the
+ * achieved frame rate is printed upon completion.
+ * @param device The device to transmit with.
+ * @param frame The frame to transmit.
+ * @param frameCount The number of frames to transmit.
+ */
+void transmitBurst (canDevice_t* device, canFrame_t* frame, size_t frameCount)
+{
+	// Frames are handed to the device in chunks, bounding the memory required for large bursts.
+	canFrame_t frames [BURST_CHUNK_SIZE];
+	for (size_t index = 0; index < BURST_CHUNK_SIZE; ++index)
+		frames [index] = *frame;
+
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+
+	size_t transmitCount = 0;
+	while (transmitCount < frameCount)
+	{
+		size_t chunkSize = frameCount - transmitCount;
+		if (chunkSize > BURST_CHUNK_SIZE)
+			chunkSize = BURST_CHUNK_SIZE;
+
+		size_t chunkCount = 0;
+		int code = canTransmitBatch (device, frames, chunkSize, &chunkCount);
+		transmitCount += chunkCount;
+		if (code != 0)
+		{
+			errorPrintf ("Failed to transmit CAN frame burst");
+			break;
+		}
+	}
+
+	struct timespec timeEnd;
+	clock_gettime (CLOCK_MONOTONIC, &timeEnd);
+	struct timespec elapsed = timespecSub (&timeEnd, &timeStart);
+	double elapsedS = timespecToNs (&elapsed) / 1e9;
+
+	printf ("Transmitted %lu of %lu frames in %.3f ms (%.0f frames/s).\n", (unsigned long) transmitCount,
+		(unsigned long) frameCount, elapsedS * 1e3, elapsedS > 0 ? transmitCount / elapsedS : 0);
+}
+
 /**
  * @brief Handles a transmit command.
  * @param device The CAN device to use.
@@ -177,12 +412,13 @@ void transmitFrame (canDevice_t* device, char* command)
 {
 	canFrame_t frame;
 
-	struct timeval period =
+	struct timespec period =
 	{
 		.tv_sec		= 1,
-		.tv_usec	= 0
+		.tv_nsec	= 0
 	};
 	size_t iterationCount = 1;
+	bool burst = false;
 
 	// Parse out the iteration count and frequency
 	strtok (command + 2, "@");
@@ -195,12 +431,23 @@ void transmitFrame (canDevice_t* device, char* command)
 		if (frequencyStr != NULL)
 		{
 			float frequency = strtof (frequencyStr, NULL);
-			long periodUs = (1e6 / frequency);
-			period = (struct timeval)
+			if (frequency < 0)
 			{
-				.tv_sec		= periodUs / 1000000,
-				.tv_usec	= periodUs % 1000000
-			};
+				fprintf (stderr, "Error: Invalid frequency.\n");
+				return;
+			}
+
+			// A frequency of 0 transmits the frames as fast as possible, so has no period.
+			burst = frequency == 0;
+			if (!burst)
+			{
+				long long periodNs = (1e9 / frequency);
+				period = (struct timespec)
+				{
+					.tv_sec		= periodNs / 1000000000,
+					.tv_nsec	= periodNs % 1000000000
+				};
+			}
 		}
 	}
 
@@ -217,15 +464,18 @@ void transmitFrame (canDevice_t* device, char* command)
 		promptFrame (&frame);
 	}
 
-	struct timeval timeCurrent;
-	struct timeval timeDeadline;
+	if (burst)
+	{
+		transmitBurst (device, &frame, iterationCount);
+		return;
+	}
+
+	// Deadlines are absolute, so time spent transmitting does not accumulate as drift.
+	struct timespec timeDeadline;
+	clock_gettime (CLOCK_MONOTONIC, &timeDeadline);
 
 	for (size_t index = 0; index < iterationCount; ++index)
 	{
-		// Start timer
-		gettimeofday (&timeCurrent, NULL);
-		timeradd (&timeCurrent, &period, &timeDeadline);
-
 		if (canTransmit (device, &frame) != 0)
 			errorPrintf ("Failed to transmit CAN frame");
 		else
@@ -238,11 +488,534 @@ void transmitFrame (canDevice_t* device, char* command)
 			break;
 
 		// Wait until deadline is reached
-		while (timercmp (&timeCurrent, &timeDeadline, <))
-			gettimeofday (&timeCurrent, NULL);
+		timeDeadline = timespecAdd (&timeDeadline, &period);
+		while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &timeDeadline, NULL) == EINTR);
 	}
 }
 
+/// @brief Signal handler for interrupting a long-running command.
+static void interruptHandler (int sig)
+{
+	(void) sig;
+	commandInterrupted = true;
+}
+
+/**
+ * @brief Loads a schedule file into a list of schedule entries. See @c fprintScheduleFileHelp for the format.
+ * @param schedule The list to load into. Must already be initialized.
+ * @param path The path of the file to load.
+ * @return 0 if successful, the error code otherwise.
+ */
+int loadSchedule (list_t (scheduleEntry_t)* schedule, const char* path)
+{
+	FILE* file = fopen (path, "r");
+	if (file == NULL)
+		return errno;
+
+	char line [512];
+	size_t lineNumber = 0;
+	while (fgets (line, sizeof (line), file) != NULL)
+	{
+		++lineNumber;
+		line [strcspn (line, "\r\n")] = '\0';
+
+		// Skip empty lines and comments
+		char* frameStr = strtok (line, " \t");
+		if (frameStr == NULL || frameStr [0] == '#')
+			continue;
+
+		char* periodStr = strtok (NULL, " \t");
+		char* phaseStr = strtok (NULL, " \t");
+
+		scheduleEntry_t entry = { 0 };
+		if (strToCanFrame (&entry.frame, frameStr) != 0)
+		{
+			fprintf (stderr, "Error: Invalid CAN frame on line %lu of schedule '%s'.\n", (unsigned long) lineNumber, path);
+			fclose (file);
+			return errno = EINVAL;
+		}
+
+		char* end;
+		double periodMs = periodStr == NULL ? 0 : strtod (periodStr, &end);
+		if (periodStr == NULL || end == periodStr || periodMs <= 0)
+		{
+			fprintf (stderr, "Error: Invalid period on line %lu of schedule '%s'.\n", (unsigned long) lineNumber, path);
+			fclose (file);
+			return errno = EINVAL;
+		}
+
+		double phaseMs = phaseStr == NULL ? 0 : strtod (phaseStr, &end);
+		if (phaseStr != NULL && (end == phaseStr || phaseMs < 0))
+		{
+			fprintf (stderr, "Error: Invalid phase on line %lu of schedule '%s'.\n", (unsigned long) lineNumber, path);
+			fclose (file);
+			return errno = EINVAL;
+		}
+
+		long long periodNs = periodMs * 1e6;
+		long long phaseNs = phaseMs * 1e6;
+		entry.period = (struct timespec)
+		{
+			.tv_sec		= periodNs / 1000000000,
+			.tv_nsec	= periodNs % 1000000000
+		};
+
+		// Store the phase in the deadline, it is made absolute once the schedule starts.
+		entry.deadline = (struct timespec)
+		{
+			.tv_sec		= phaseNs / 1000000000,
+			.tv_nsec	= phaseNs % 1000000000
+		};
+
+		if (listAppend (scheduleEntry_t) (schedule, entry) != 0)
+		{
+			fclose (file);
+			return errno;
+		}
+	}
+
+	fclose (file);
+
+	if (listSize (scheduleEntry_t) (schedule) == 0)
+	{
+		fprintf (stderr, "Error: Schedule '%s' is empty.\n", path);
+		return errno = EINVAL;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Handles a schedule command. All frames of the schedule are transmitted from a single loop, sleeping until the next
+ * absolute deadline of any frame. As each deadline is advanced by exactly one period, delays never accumulate into drift.
+ * @param device The CAN device to use.
+ * @param command The schedule command string. See @c fprintHelp for the format.
+ */
+void scheduleFrames (canDevice_t* device, char* command)
+{
+	char buffer [512];
+	char* path;
+	double durationS = 0;
+
+	if (command [1] == '=')
+	{
+		path = strtok (command + 2, "@");
+		char* durationStr = strtok (NULL, "@");
+		if (durationStr != NULL)
+			durationS = strtod (durationStr, NULL);
+	}
+	else
+	{
+		printf ("Schedule file: ");
+		fgets (buffer, sizeof (buffer), stdin);
+		buffer [strcspn (buffer, "\r\n")] = '\0';
+		path = buffer;
+	}
+
+	if (path == NULL)
+	{
+		fprintf (stderr, "Error: Missing schedule file.\n");
+		return;
+	}
+
+	list_t (scheduleEntry_t) schedule;
+	if (listInit (scheduleEntry_t) (&schedule, 16) != 0)
+	{
+		errorPrintf ("Failed to allocate schedule");
+		return;
+	}
+
+	if (loadSchedule (&schedule, path) != 0)
+	{
+		errorPrintf ("Failed to load schedule '%s'", path);
+		listDealloc (scheduleEntry_t) (&schedule);
+		return;
+	}
+
+	size_t entryCount = listSize (scheduleEntry_t) (&schedule);
+	scheduleEntry_t* entries = listArray (scheduleEntry_t) (&schedule);
+
+	histogram_t lateness;
+	histogramInit (&lateness);
+	histogram_t jitter;
+	histogramInit (&jitter);
+
+	// Catch SIGINT so the statistics can be printed upon exit.
+	commandInterrupted = false;
+	void (*handlerPrevious) (int) = signal (SIGINT, interruptHandler);
+
+	// Convert each phase into an absolute deadline.
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+	for (size_t index = 0; index < entryCount; ++index)
+		entries [index].deadline = timespecAdd (&timeStart, &entries [index].deadline);
+
+	long long durationNs = durationS * 1e9;
+	struct timespec timeEnd =
+	{
+		.tv_sec		= durationNs / 1000000000,
+		.tv_nsec	= durationNs % 1000000000
+	};
+	timeEnd = timespecAdd (&timeStart, &timeEnd);
+
+	printf ("Transmitting %lu scheduled frames. Press Ctrl+C to stop.\n", (unsigned long) entryCount);
+
+	size_t errorCount = 0;
+	while (!commandInterrupted)
+	{
+		// Find the entry with the earliest deadline.
+		scheduleEntry_t* next = &entries [0];
+		for (size_t index = 1; index < entryCount; ++index)
+			if (timespecCompare (&entries [index].deadline, &next->deadline, <))
+				next = &entries [index];
+
+		if (durationNs > 0 && !timespecCompare (&next->deadline, &timeEnd, <))
+			break;
+
+		// Sleep until the deadline. Interrupted by SIGINT if the user exits.
+		if (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &next->deadline, NULL) != 0)
+			continue;
+
+		// Measure how late the wakeup was.
+		struct timespec timeCurrent;
+		clock_gettime (CLOCK_MONOTONIC, &timeCurrent);
+		struct timespec delta = timespecSub (&timeCurrent, &next->deadline);
+		long long latenessNs = timespecToNs (&delta);
+		if (latenessNs < 0)
+			latenessNs = 0;
+
+		histogramRecord (&lateness, latenessNs);
+		if (latenessNs > next->latenessMax)
+			next->latenessMax = latenessNs;
+		if (latenessNs > timespecToNs (&next->period))
+			++next->overrunCount;
+
+		if (canTransmit (device, &next->frame) != 0)
+		{
+			++errorCount;
+			debugPrintf ("Failed to transmit scheduled frame: %s.\n", errorCodeToMessage (errno));
+		}
+
+		// Measure the jitter, that is how far the interval since the previous transmission deviated from the period.
+		struct timespec timeTransmit;
+		clock_gettime (CLOCK_MONOTONIC, &timeTransmit);
+		if (next->transmitCount != 0)
+		{
+			struct timespec interval = timespecSub (&timeTransmit, &next->transmitLast);
+			long long jitterNs = llabs (timespecToNs (&interval) - timespecToNs (&next->period));
+
+			histogramRecord (&jitter, jitterNs);
+			if (jitterNs > next->jitterMax)
+				next->jitterMax = jitterNs;
+		}
+		next->transmitLast = timeTransmit;
+
+		++next->transmitCount;
+		next->deadline = timespecAdd (&next->deadline, &next->period);
+	}
+
+	signal (SIGINT, handlerPrevious);
+
+	// Print the statistics
+	printf ("\nSchedule statistics:\n");
+	for (size_t index = 0; index < entryCount; ++index)
+	{
+		printf ("    ");
+		fprintCanFrame (stdout, &entries [index].frame);
+		printf (" - count=%lu overruns=%lu max lateness=%.3fus max jitter=%.3fus\n",
+			(unsigned long) entries [index].transmitCount, (unsigned long) entries [index].overrunCount,
+			entries [index].latenessMax / 1e3, entries [index].jitterMax / 1e3);
+	}
+	printf ("Transmit errors: %lu\n", (unsigned long) errorCount);
+	printf ("Lateness: ");
+	fprintHistogramSummary (stdout, &lateness, 1e3, "us");
+	printf ("\nJitter: ");
+	fprintHistogramSummary (stdout, &jitter, 1e3, "us");
+	printf ("\n");
+
+	listDealloc (scheduleEntry_t) (&schedule);
+}
+
+/**
+ * @brief Handles a frame received during a round-trip benchmark, checking whether it is the response to a pending request.
+ * @param bench The benchmark state.
+ * @param frame The received frame.
+ * @param timeReceived The time at which the frame was received.
+ * @return True if the frame was a response to a request, false otherwise.
+ */
+static bool benchmarkHandleResponse (benchmark_t* bench, canFrame_t* frame, struct timespec* timeReceived)
+{
+	if (frame->id != bench->responseId || frame->ide != bench->responseIde)
+		return false;
+
+	uint32_t sequence = frame->data [0] | frame->data [1] << 8 | frame->data [2] << 16 | (uint32_t) frame->data [3] << 24;
+	uint32_t runTag = frame->data [4] | frame->data [5] << 8 | frame->data [6] << 16 | (uint32_t) frame->data [7] << 24;
+	long long timeSentNs = 0;
+	if (frame->dlc == 8 && runTag == bench->runTag && sequence < bench->count)
+		timeSentNs = atomic_load_explicit (&bench->timesSentNs [sequence], memory_order_acquire);
+
+	// Note the response is only claimed if the request was sent, and has not already been responded to.
+	if (timeSentNs == 0 || atomic_exchange (&bench->responded [sequence], true))
+	{
+		atomic_fetch_add_explicit (&bench->unmatchedCount, 1, memory_order_relaxed);
+		return false;
+	}
+
+	histogramRecord (&bench->rtt, timespecToNs (timeReceived) - timeSentNs);
+	atomic_fetch_add (&bench->responseCount, 1);
+	return true;
+}
+
+/// @brief Thread receiving the responses of an open-loop benchmark.
+static void* benchmarkReceiveThread (void* arg)
+{
+	benchmark_t* bench = arg;
+
+	while (atomic_load (&bench->running) && atomic_load (&bench->responseCount) < bench->count)
+	{
+		canFrame_t frame;
+		if (canReceive (bench->device, &frame) != 0)
+			continue;
+
+		struct timespec timeReceived;
+		clock_gettime (CLOCK_MONOTONIC, &timeReceived);
+		benchmarkHandleResponse (bench, &frame, &timeReceived);
+	}
+
+	return NULL;
+}
+
+/// @brief Thread echoing requests received on the loopback device back as responses.
+static void* benchmarkLoopbackThread (void* arg)
+{
+	benchmark_t* bench = arg;
+
+	while (atomic_load (&bench->running))
+	{
+		canFrame_t frame;
+		if (canReceive (bench->loopback, &frame) != 0)
+			continue;
+
+		if (frame.id != bench->request.id || frame.ide != bench->request.ide)
+			continue;
+
+		frame.id = bench->responseId;
+		frame.ide = bench->responseIde;
+		if (canTransmit (bench->loopback, &frame) != 0)
+			debugPrintf ("Failed to transmit loopback response: %s.\n", errorCodeToMessage (errno));
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Handles a round-trip benchmark command.
+ * @param device The CAN device to use.
+ * @param command The benchmark command string. See @c fprintHelp for the format.
+ */
+void benchmarkRoundTrip (canDevice_t* device, char* command)
+{
+	if (command [1] != '=')
+	{
+		fprintf (stderr, "Error: Benchmark requires a request and response ID.\n");
+		return;
+	}
+
+	// Parse the IDs, count, rate and loopback device
+	char* idsStr = strtok (command + 2, "@");
+	char* countStr = strtok (NULL, ",");
+	char* rateStr = strtok (NULL, ",");
+	char* loopbackName = strtok (NULL, "");
+
+	char* requestIdStr = strtok (idsStr, ",");
+	char* responseIdStr = strtok (NULL, ",");
+
+	benchmark_t bench =
+	{
+		.device		= device,
+		.count		= countStr != NULL ? strtoul (countStr, NULL, 0) : 1000,
+		.running	= true
+	};
+	double rate = rateStr != NULL ? strtod (rateStr, NULL) : 0;
+
+	bool rtr;
+	if (requestIdStr == NULL || strToCanId (&bench.request.id, &bench.request.ide, &rtr, requestIdStr) != 0 ||
+		responseIdStr == NULL || strToCanId (&bench.responseId, &bench.responseIde, &rtr, responseIdStr) != 0)
+	{
+		fprintf (stderr, "Error: Invalid request / response ID.\n");
+		return;
+	}
+
+	if (bench.count == 0 || rate < 0)
+	{
+		fprintf (stderr, "Error: Invalid count / rate.\n");
+		return;
+	}
+
+	bench.timesSentNs = calloc (bench.count, sizeof (atomic_llong));
+	bench.responded = calloc (bench.count, sizeof (atomic_bool));
+	if (bench.timesSentNs == NULL || bench.responded == NULL)
+	{
+		errorPrintf ("Failed to allocate benchmark");
+		free (bench.timesSentNs);
+		free (bench.responded);
+		return;
+	}
+
+	histogramInit (&bench.rtt);
+	struct timespec timeSeed;
+	clock_gettime (CLOCK_MONOTONIC, &timeSeed);
+	srand (timeSeed.tv_nsec ^ timeSeed.tv_sec);
+	bench.runTag = (uint32_t) rand () << 16 ^ (uint32_t) rand ();
+
+	bench.request.dlc = 8;
+	bench.request.rtr = false;
+	bench.request.data [4] = bench.runTag;
+	bench.request.data [5] = bench.runTag >> 8;
+	bench.request.data [6] = bench.runTag >> 16;
+	bench.request.data [7] = bench.runTag >> 24;
+
+	if (canSetTimeout (device, 100) != 0)
+		errorPrintf ("Warning: Failed to set device timeout");
+
+	// Start the responder on the loopback device, if specified.
+	pthread_t loopbackThread;
+	if (loopbackName != NULL)
+	{
+		bench.loopback = canInit (loopbackName, NULL);
+		if (bench.loopback == NULL)
+		{
+			errorPrintf ("Failed to initialize loopback device '%s'", loopbackName);
+			free (bench.timesSentNs);
+			free (bench.responded);
+			return;
+		}
+
+		if (canSetTimeout (bench.loopback, 100) != 0)
+			errorPrintf ("Warning: Failed to set loopback device timeout");
+
+		pthread_create (&loopbackThread, NULL, benchmarkLoopbackThread, &bench);
+	}
+
+	// Catch SIGINT so the statistics can be printed upon exit.
+	commandInterrupted = false;
+	void (*handlerPrevious) (int) = signal (SIGINT, interruptHandler);
+
+	// Open-loop operation receives in parallel to transmission.
+	pthread_t receiveThread;
+	if (rate > 0)
+		pthread_create (&receiveThread, NULL, benchmarkReceiveThread, &bench);
+
+	long long periodNs = rate > 0 ? 1e9 / rate : 0;
+	struct timespec period =
+	{
+		.tv_sec		= periodNs / 1000000000,
+		.tv_nsec	= periodNs % 1000000000
+	};
+
+	size_t sentCount = 0;
+	size_t errorCount = 0;
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+	struct timespec timeDeadline = timeStart;
+
+	for (size_t sequence = 0; sequence < bench.count && !commandInterrupted; ++sequence)
+	{
+		if (rate > 0)
+		{
+			while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &timeDeadline, NULL) == EINTR);
+			timeDeadline = timespecAdd (&timeDeadline, &period);
+		}
+
+		bench.request.data [0] = sequence;
+		bench.request.data [1] = sequence >> 8;
+		bench.request.data [2] = sequence >> 16;
+		bench.request.data [3] = sequence >> 24;
+
+		// Publish the time before transmitting, as the response may be received before the transmission returns.
+		struct timespec timeSent;
+		clock_gettime (CLOCK_MONOTONIC, &timeSent);
+		atomic_store_explicit (&bench.timesSentNs [sequence], timespecToNs (&timeSent), memory_order_release);
+		if (canTransmit (device, &bench.request) != 0)
+		{
+			atomic_store_explicit (&bench.timesSentNs [sequence], 0, memory_order_relaxed);
+			++errorCount;
+			debugPrintf ("Failed to transmit request: %s.\n", errorCodeToMessage (errno));
+			continue;
+		}
+		++sentCount;
+
+		if (rate > 0)
+			continue;
+
+		// Closed-loop operation waits for the response, giving up after the device timeout.
+		struct timespec timeout = { .tv_sec = 0, .tv_nsec = 100000000 };
+		timeout = timespecAdd (&timeSent, &timeout);
+		while (!commandInterrupted)
+		{
+			canFrame_t frame;
+			int code = canReceive (device, &frame);
+
+			struct timespec timeReceived;
+			clock_gettime (CLOCK_MONOTONIC, &timeReceived);
+			if (code == 0 && benchmarkHandleResponse (&bench, &frame, &timeReceived) &&
+				atomic_load (&bench.responded [sequence]))
+				break;
+
+			if (!timespecCompare (&timeReceived, &timeout, <))
+				break;
+		}
+	}
+
+	struct timespec timeEnd;
+	clock_gettime (CLOCK_MONOTONIC, &timeEnd);
+
+	// Give late responses a chance to arrive before stopping.
+	if (rate > 0)
+	{
+		struct timespec drain = { .tv_sec = 1, .tv_nsec = 0 };
+		drain = timespecAdd (&timeEnd, &drain);
+		while (atomic_load (&bench.responseCount) < sentCount && !commandInterrupted &&
+			clock_nanosleep (CLOCK_MONOTONIC, 0, &(struct timespec) { .tv_sec = 0, .tv_nsec = 1000000 }, NULL) == 0)
+		{
+			struct timespec timeCurrent;
+			clock_gettime (CLOCK_MONOTONIC, &timeCurrent);
+			if (!timespecCompare (&timeCurrent, &drain, <))
+				break;
+		}
+	}
+
+	atomic_store (&bench.running, false);
+	if (rate > 0)
+		pthread_join (receiveThread, NULL);
+	if (bench.loopback != NULL)
+	{
+		pthread_join (loopbackThread, NULL);
+		canDealloc (bench.loopback);
+	}
+
+	signal (SIGINT, handlerPrevious);
+
+	// Print the statistics
+	struct timespec elapsed = timespecSub (&timeEnd, &timeStart);
+	double elapsedS = timespecToNs (&elapsed) / 1e9;
+	if (elapsedS <= 0)
+		elapsedS = 1e-9;
+
+	printf ("Requests sent:       %lu (%lu failed)\n", (unsigned long) sentCount, (unsigned long) errorCount);
+	size_t responseCount = atomic_load (&bench.responseCount);
+	printf ("Responses received:  %lu (%lu lost, %lu unmatched)\n", (unsigned long) responseCount,
+		(unsigned long) (sentCount - responseCount), (unsigned long) atomic_load (&bench.unmatchedCount));
+	printf ("Offered load:        %.1f frames/s\n", sentCount / elapsedS);
+	printf ("Throughput:          %.1f frames/s\n", responseCount / elapsedS);
+	printf ("RTT (us):            p50=%.1f p99=%.1f p99.9=%.1f max=%.1f\n",
+		histogramPercentile (&bench.rtt, 50) / 1e3, histogramPercentile (&bench.rtt, 99) / 1e3,
+		histogramPercentile (&bench.rtt, 99.9) / 1e3, bench.rtt.max / 1e3);
+
+	free (bench.timesSentNs);
+	free (bench.responded);
+}
+
 /**
  * @brief Handles a receive / dump command.
  * @param device The CAN device to use.
@@ -373,6 +1146,70 @@ void printInfo (canDevice_t* device)
 		printf ("Baudrate:    %u\n", baudrate);
 }
 
+/**
+ * @brief Measures the inter-arrival time of received frames. The time of arrival is taken as the time the device returns the
+ * frame, so this includes any latency introduced by the device's driver (ex. serial port buffering).
+ * @param device The CAN device to receive from.
+ * @param command The command to handle, in the format '-l=<Count>'.
+ */
+void measureArrivals (canDevice_t* device, char* command)
+{
+	size_t frameCount = 1000;
+	if (command [1] == '=')
+		frameCount = strtoul (command + 2, NULL, 0);
+
+	histogram_t hist;
+	histogramInit (&hist);
+
+	// Receive with a timeout, so SIGINT is noticed on a quiet bus. Note signal() does not interrupt a blocking receive.
+	if (canSetTimeout (device, 100) != 0)
+	{
+		errorPrintf ("Failed to set timeout");
+		return;
+	}
+
+	// Catch SIGINT so the statistics can be printed upon exit.
+	commandInterrupted = false;
+	void (*handlerPrevious) (int) = signal (SIGINT, interruptHandler);
+
+	printf ("Measuring the inter-arrival time of %lu frames. Press Ctrl+C to stop.\n", (unsigned long) frameCount);
+
+	struct timespec timePrevious;
+	size_t receiveCount = 0;
+	size_t errorCount = 0;
+	while (receiveCount < frameCount && !commandInterrupted)
+	{
+		canFrame_t frame;
+		if (canReceive (device, &frame) != 0)
+		{
+			// Timeouts are expected on a quiet bus, only count actual errors.
+			if (errno != ERRNO_CAN_DEVICE_TIMEOUT)
+				++errorCount;
+			continue;
+		}
+
+		struct timespec timeArrival;
+		clock_gettime (CLOCK_MONOTONIC, &timeArrival);
+
+		if (receiveCount != 0)
+		{
+			struct timespec delta = timespecSub (&timeArrival, &timePrevious);
+			histogramRecord (&hist, timespecToNs (&delta));
+		}
+
+		timePrevious = timeArrival;
+		++receiveCount;
+	}
+
+	signal (SIGINT, handlerPrevious);
+
+	printf ("\nFrames received: %lu\n", (unsigned long) receiveCount);
+	printf ("Receive errors:  %lu\n", (unsigned long) errorCount);
+	printf ("Inter-arrival:   ");
+	fprintHistogramSummary (stdout, &hist, 1e3, "us");
+	printf ("\n");
+}
+
 /**
  * @brief Handles a user-specified command from either the standard arguments or standard input.
  * @param device The CAN device to use.
@@ -389,6 +1226,14 @@ int processCommand (canDevice_t* device, char* command)
 		transmitFrame (device, command);
 		break;
 
+	case 's':
+		scheduleFrames (device, command);
+		break;
+
+	case 'b':
+		benchmarkRoundTrip (device, command);
+		break;
+
 	case 'r':
 		receiveFrame (device, command, false);
 		break;
@@ -402,6 +1247,10 @@ int processCommand (canDevice_t* device, char* command)
 			errorPrintf ("Failed to flush receive buffer");
 		break;
 
+	case 'l':
+		measureArrivals (device, command);
+		break;
+
 	case 'm':
 		setTimeout (device, command);
 		break;
@@ -432,6 +1281,7 @@ int main (int argc, char** argv)
 	// Check standard arguments
 	bool interactiveMode = true;
 	bool queryMode = false;
+	slcanSerialConfig_t serialConfig = SLCAN_SERIAL_CONFIG_DEFAULT;
 	for (int index = 1; index < argc; ++index)
 	{
 		const char* option;
@@ -449,6 +1299,18 @@ int main (int argc, char** argv)
 			interactiveMode = false;
 			break;
 
+		case OPTION_STRING:
+			// Serial options must be applied before the device is initialized.
+			if (strcmp (option, "serial-low-latency") == 0)
+				serialConfig.lowLatency = true;
+			else if (strncmp (option, "serial-read-size=", strlen ("serial-read-size=")) == 0)
+				serialConfig.readSize = strtoul (option + strlen ("serial-read-size="), NULL, 0);
+			else if (strncmp (option, "serial-vmin=", strlen ("serial-vmin=")) == 0)
+				serialConfig.vmin = strtoul (option + strlen ("serial-vmin="), NULL, 0);
+			else if (strncmp (option, "serial-vtime=", strlen ("serial-vtime=")) == 0)
+				serialConfig.vtime = strtoul (option + strlen ("serial-vtime="), NULL, 0);
+			break;
+
 		case OPTION_QUIT:
 			return 0;
 
@@ -465,6 +1327,7 @@ int main (int argc, char** argv)
 	}
 
 	// Initialize the CAN device
+	slcanSetSerialConfig (&serialConfig);
 	char* deviceName = argv [argc - 1];
 	canDevice_t* device = canInit (deviceName, NULL);
 	if (device == NULL)
@@ -484,6 +1347,11 @@ int main (int argc, char** argv)
 		for (int index = 1; index < argc - 1; ++index)
 		{
 			char* option = argv [index];
+
+			// String options were handled before initialization.
+			if (option [0] == '-' && option [1] == '-')
+				continue;
+
 			if (option [0] == '-')
 				processCommand (device, option + 1);
 			else
@@ -501,9 +1369,12 @@ int main (int argc, char** argv)
 
 		printf ("Enter an option:\n");
 		printf (" t - Transmit a CAN message.\n");
+		printf (" s - Transmit the CAN messages of a schedule file.\n");
+		printf (" b - Benchmark the round-trip latency of the CAN device.\n");
 		printf (" r - Receive a CAN message.\n");
 		printf (" d - Dump received CAN messages.\n");
 		printf (" f - Flush the receive buffer.\n");
+		printf (" l - Measure the inter-arrival time of received CAN messages.\n");
 		printf (" m - Set the device's timeout.\n");
 		printf (" i - Print info about the CAN device.\n");
 		printf (" h - Display the help page.\n");
@@ -5,15 +5,25 @@
 //
 // Description: See help page.
 
+// For asprintf. Note this must be the first include in this file.
+#define _GNU_SOURCE
+#include <stdio.h>
+
 // Includes -------------------------------------------------------------------------------------------------------------------
 
 // Includes
 #include "can_device/can_bus_load.h"
 #include "can_device/can_device.h"
 #include "can_device/can_device_stdio.h"
+#include "can_database/can_dbc.h"
 #include "cjson/cjson_util.h"
 #include "debug.h"
 #include "mdf/mdf_can_bus_logging.h"
+#include "mdf/mdf_can_replay.h"
+#include "mdf/mdf_capture.h"
+#include "mdf/mdf_pipeline.h"
+#include "mdf/mdf_record_queue.h"
+#include "mdf/mdf_retention.h"
 #include "options.h"
 #include "time_port.h"
 
@@ -24,17 +34,93 @@
 #include <math.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef ZRE_CANTOOLS_OS_linux
 #include <sys/vfs.h>
 #endif // ZRE_CANTOOLS_OS_linux
 
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The capacity of each channel's record queue, in records.
+#define RECORD_QUEUE_SIZE 65536
+
+/// @brief The default post-trigger window of the capture mode, in seconds.
+#define POST_TRIGGER_DEFAULT 10
+
+/// @brief The maximum number of stages of the post-processing pipeline.
+#define PIPELINE_STAGE_COUNT_MAX 8
+
+/// @brief The minimum number of bits a CAN frame occupies on the bus (including the interframe space). Used to size the
+/// pre-trigger ring for the maximum frame rate of the bus.
+#define FRAME_BIT_COUNT_MIN 47
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	TRIGGER_GREATER_EQUAL,
+	TRIGGER_LESS_EQUAL,
+	TRIGGER_EQUAL,
+	TRIGGER_NOT_EQUAL,
+	TRIGGER_GREATER,
+	TRIGGER_LESS
+} triggerOperator_t;
+
 // Globals --------------------------------------------------------------------------------------------------------------------
 
 bool logging = true;
 
 bool quiet = false;
 
+/// @brief Indicates the capture mode is enabled, that is only the windows around triggers are logged.
+bool captureMode = false;
+
+/// @brief The pre and post-trigger windows of the capture mode, in seconds.
+float preTrigger = 0;
+float postTrigger = POST_TRIGGER_DEFAULT;
+
+/// @brief The capture of the capture mode.
+mdfCapture_t capture;
+
+/// @brief The DBC file defining the trigger signal, if any.
+char* dbcPath = NULL;
+
+/// @brief The signal condition to trigger upon, if any.
+char* triggerCondition = NULL;
+canSignal_t* triggerSignal = NULL;
+triggerOperator_t triggerOperator;
+float triggerValue;
+
+/// @brief The number of error frames to trigger upon, if received within the window. 0 to disable.
+size_t errorBurstCount = 0;
+unsigned long errorBurstWindowMs = 0;
+
+/// @brief The messages and signals of the DBC file, if any.
+canMessage_t* messages = NULL;
+size_t messageCount = 0;
+canSignal_t* signals = NULL;
+size_t signalCount = 0;
+
+/// @brief The names of the DBC file's signals ('Message.Signal'), summarized in the catalog.
+char** signalNames = NULL;
+
+/// @brief Lookup table from CAN ID to DBC message, used to decode signals for the catalog and signal log. The size is a power
+/// of 2, empty slots are @c NULL .
+canMessage_t** messageTable = NULL;
+size_t messageTableSize = 0;
+
+/// @brief The groups of the signal log, one per DBC message, along with their channels, one per signal. Indexed the same as
+/// the messages and signals of the DBC file.
+mdfSignalLogGroup_t* signalLogGroups = NULL;
+mdfSignalLogChannel_t* signalLogChannels = NULL;
+
+/// @brief The stages of the post-processing pipeline, if any.
+mdfPipelineStage_t pipelineStages [PIPELINE_STAGE_COUNT_MAX];
+
+/// @brief The catalog builder of the pipeline's catalog stage, summarizing the DBC file's signals.
+mdfCatalogBuilder_t pipelineCatalogBuilder;
+
 // Functions ------------------------------------------------------------------------------------------------------------------
 
 void testSystemTick (char option, char* value)
@@ -59,6 +145,51 @@ void handleOptionQuiet (char* option, char* value)
 	quiet = true;
 }
 
+void handleOptionPreTrigger (char* option, char* value)
+{
+	(void) option;
+	if (value == NULL)
+		return;
+
+	captureMode = true;
+	preTrigger = strtof (value, NULL);
+}
+
+void handleOptionPostTrigger (char* option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		postTrigger = strtof (value, NULL);
+}
+
+void handleOptionDbc (char* option, char* value)
+{
+	(void) option;
+	dbcPath = value;
+}
+
+void handleOptionTrigger (char* option, char* value)
+{
+	(void) option;
+	triggerCondition = value;
+}
+
+void handleOptionErrorBurst (char* option, char* value)
+{
+	(void) option;
+	if (value == NULL)
+		return;
+
+	char* end;
+	errorBurstCount = strtoul (value, &end, 0);
+	if (*end != '/')
+	{
+		fprintf (stderr, "Invalid error burst '%s', expected '<Count>/<Window ms>'.\n", value);
+		exit (-1);
+	}
+	errorBurstWindowMs = strtoul (end + 1, NULL, 0);
+}
+
 void sigtermHandler (int sig)
 {
 	(void) sig;
@@ -67,6 +198,15 @@ void sigtermHandler (int sig)
 	logging = false;
 }
 
+void sigusr1Handler (int sig)
+{
+	(void) sig;
+
+	struct timespec timestamp;
+	if (mdfCanBusLogGetTimestamp (&timestamp) == 0)
+		mdfCaptureTrigger (&capture, &timestamp);
+}
+
 void fprintUsage (FILE* stream)
 {
 	fprintf (stream, ""
@@ -88,7 +228,47 @@ void fprintHelp (FILE* stream)
 	fprintf (stream, "\nParameters:\n\n");
 	fprintf (stream, ""
 		"    <MDF Directory>       - The directory to write MDF data logging sessions\n"
-		"                            into.\n\n");
+		"                            into.\n"
+		"    <Config JSON>         - The log's configuration. Optionally, the keys\n"
+		"                            'syncIntervalMs' and 'syncSize' specify how often\n"
+		"                            the log is synchronized to the storage device\n"
+		"                            (defaults %u ms, %u bytes). This bounds the data\n"
+		"                            lost on power loss. Use mdf-recover to repair\n"
+		"                            splits that were not closed. The optional key\n"
+		"                            'compress' (\"true\" / \"false\") enables\n"
+		"                            compression of the log. The optional keys\n"
+		"                            'retentionQuotaMb' and 'retentionFreeMb' limit the\n"
+		"                            space (in MiB) used by the sessions of the MDF\n"
+		"                            directory, and the minimum space to keep available\n"
+		"                            on the storage device. When exceeded, the oldest\n"
+		"                            completed sessions are deleted in the background.\n"
+		"                            If 'retentionCompress' is \"true\", sessions are\n"
+		"                            compressed before any are deleted. The key\n"
+		"                            'retentionRateKbps' limits the rate (in KiB/s) of\n"
+		"                            compression (default %u KiB/s). If the optional\n"
+		"                            key 'catalog' is \"true\", each split is summarized\n"
+		"                            in the MDF directory's catalog once closed (see\n"
+		"                            mdf-catalog). If '--dbc' is given, the range of\n"
+		"                            each of its signals is also summarized. If the\n"
+		"                            optional key 'signals' is \"true\", the signals of\n"
+		"                            '--dbc' are decoded and written alongside each\n"
+		"                            split ('signals_<N>.mf4'), one channel group per\n"
+		"                            message. The optional key 'pipeline' lists the\n"
+		"                            stages each split is passed through once closed,\n"
+		"                            separated by commas (ex.\n"
+		"                            \"recover,compress,index,catalog\"). The stages\n"
+		"                            run in the background at idle priority, and are\n"
+		"                            resumed on the next start if interrupted (see\n"
+		"                            '%s'). Stages are:\n"
+		"                              recover  - Repairs splits not closed properly.\n"
+		"                              compress - Compresses the split, at the rate of\n"
+		"                                         'retentionRateKbps'. Replaces\n"
+		"                                         'retentionCompress'.\n"
+		"                              index    - Caches the split's time index.\n"
+		"                              catalog  - Summarizes the split in the catalog.\n"
+		"                                         Replaces the 'catalog' key.\n\n",
+		MDF_CAN_BUS_LOG_SYNC_INTERVAL_DEFAULT, MDF_CAN_BUS_LOG_SYNC_SIZE_DEFAULT, MDF_RETENTION_RATE_LIMIT_DEFAULT / 1024,
+		MDF_PIPELINE_JOURNAL_FILE_NAME);
 	fprintCanDeviceNameHelp (stream, "    ");
 
 	fprintf (stream, ""
@@ -97,7 +277,28 @@ void fprintHelp (FILE* stream)
 		"                            and hardware dependent\n"
 		"    --quiet               - Disables printing periodic status message to\n"
 		"                            standard output.\n"
-		"\n");
+		"    --dbc=<DBC File>      - The DBC file defining the signal of '--trigger',\n"
+		"                            and the signals summarized in the catalog and\n"
+		"                            written by the 'signals' key.\n"
+		"\n"
+		"Capture Mode Options:\n\n"
+		"    --pre-trigger=<s>     - Enables the capture mode. Rather than logging\n"
+		"                            continuously, the last <s> seconds of traffic are\n"
+		"                            held in memory. When a trigger fires, the\n"
+		"                            pre-trigger and post-trigger windows are written to\n"
+		"                            a new split. SIGUSR1 always fires a trigger.\n"
+		"    --post-trigger=<s>    - The number of seconds to log after a trigger.\n"
+		"                            Triggers during this window extend it. Default %u.\n"
+		"    --trigger=<Condition> - Fires a trigger when a signal condition becomes\n"
+		"                            true. The condition is of the form\n"
+		"                            '<Signal><Operator><Value>', where the signal is\n"
+		"                            either 'Signal' or 'Message.Signal', and the\n"
+		"                            operator is one of '>=', '<=', '==', '!=', '>' or\n"
+		"                            '<' (ex. '--trigger=\"BMS_FAULT>=1\"').\n"
+		"    --error-burst=<N>/<ms>\n"
+		"                          - Fires a trigger when <N> error frames are received\n"
+		"                            within <ms> milliseconds.\n"
+		"\n", POST_TRIGGER_DEFAULT);
 	fprintOptionHelp (stream, "    ");
 }
 
@@ -107,10 +308,141 @@ typedef struct
 {
 	canDevice_t* device;
 	mdfCanBusLog_t* log;
-	pthread_mutex_t* logMutex;
+	mdfRecordQueue_t* queue;
 	uint8_t busChannel;
+
+	/// @brief The last state of the trigger condition, so only its rising edge fires a trigger.
+	bool triggerState;
 } loggingThreadArg_t;
 
+/**
+ * @brief Parses the trigger condition, finding the signal in the DBC file.
+ * @param messages The messages of the DBC file.
+ * @param messageCount The number of elements in @c messages .
+ * @return 0 if successful, the error code otherwise.
+ */
+static int parseTriggerCondition (canMessage_t* messages, size_t messageCount)
+{
+	static const char* OPERATORS [] = { ">=", "<=", "==", "!=", ">", "<" };
+
+	// Split the condition at its operator.
+	size_t nameLength = strcspn (triggerCondition, "<>=!");
+	char* operatorString = triggerCondition + nameLength;
+	size_t operatorLength = 0;
+	for (size_t index = 0; index < sizeof (OPERATORS) / sizeof (OPERATORS [0]); ++index)
+	{
+		size_t length = strlen (OPERATORS [index]);
+		if (strncmp (operatorString, OPERATORS [index], length) == 0)
+		{
+			triggerOperator = index;
+			operatorLength = length;
+			break;
+		}
+	}
+
+	char* end;
+	triggerValue = strtof (operatorString + operatorLength, &end);
+	if (nameLength == 0 || operatorLength == 0 || end == operatorString + operatorLength || *end != '\0')
+	{
+		fprintf (stderr, "Invalid trigger condition '%s'.\n", triggerCondition);
+		errno = EINVAL;
+		return errno;
+	}
+
+	// Find the signal, either by 'Signal' or 'Message.Signal'.
+	for (size_t messageIndex = 0; messageIndex < messageCount; ++messageIndex)
+	{
+		canMessage_t* message = &messages [messageIndex];
+		size_t messageNameLength = strlen (message->name);
+		for (size_t signalIndex = 0; signalIndex < message->signalCount; ++signalIndex)
+		{
+			canSignal_t* signal = &message->signals [signalIndex];
+			size_t signalNameLength = strlen (signal->name);
+			if ((nameLength == signalNameLength && strncmp (triggerCondition, signal->name, nameLength) == 0) ||
+				(nameLength == messageNameLength + 1 + signalNameLength &&
+				strncmp (triggerCondition, message->name, messageNameLength) == 0 &&
+				triggerCondition [messageNameLength] == '.' &&
+				strncmp (triggerCondition + messageNameLength + 1, signal->name, signalNameLength) == 0))
+			{
+				triggerSignal = signal;
+				return 0;
+			}
+		}
+	}
+
+	fprintf (stderr, "Unknown trigger signal '%.*s'.\n", (int) nameLength, triggerCondition);
+	errno = EINVAL;
+	return errno;
+}
+
+/**
+ * @brief Evaluates the trigger condition for a received frame, firing a trigger upon its rising edge.
+ * @param arg The channel the frame was received on.
+ * @param frame The received data frame.
+ * @param timestamp The timestamp of the frame.
+ */
+static void checkTrigger (loggingThreadArg_t* arg, canFrame_t* frame, struct timespec* timestamp)
+{
+	canMessage_t* message = triggerSignal->message;
+	if (frame->id != message->id || frame->ide != message->ide || frame->rtr)
+		return;
+
+	uint64_t payload;
+	memcpy (&payload, frame->data, sizeof (payload));
+	float value = signalDecode (triggerSignal, payload);
+
+	bool state;
+	switch (triggerOperator)
+	{
+	case TRIGGER_GREATER_EQUAL:
+		state = value >= triggerValue;
+		break;
+	case TRIGGER_LESS_EQUAL:
+		state = value <= triggerValue;
+		break;
+	case TRIGGER_EQUAL:
+		state = value == triggerValue;
+		break;
+	case TRIGGER_NOT_EQUAL:
+		state = value != triggerValue;
+		break;
+	case TRIGGER_GREATER:
+		state = value > triggerValue;
+		break;
+	default:
+		state = value < triggerValue;
+		break;
+	}
+
+	if (state && !arg->triggerState)
+		mdfCaptureTrigger (&capture, timestamp);
+	arg->triggerState = state;
+}
+
+/**
+ * @brief Encodes a frame into the channel's record queue. The queue must be marked busy before the timestamp is acquired.
+ * @param arg The channel to log to.
+ * @param frame The frame to log.
+ * @param code The code returned when receiving the frame, 0 for data / RTR frames.
+ * @param direction The direction of the frame. False => received, true => transmitted.
+ * @param timestamp The timestamp of the frame.
+ */
+static void logFrame (loggingThreadArg_t* arg, canFrame_t* frame, int code, bool direction, struct timespec* timestamp)
+{
+	mdfRecord_t* record = mdfRecordQueueReserve (arg->queue);
+	if (record == NULL)
+		return;
+
+	if (code != 0)
+		record->size = mdfCanBusLogEncodeErrorFrame (arg->log, record->data, frame, arg->busChannel, direction, code, timestamp);
+	else if (!frame->rtr)
+		record->size = mdfCanBusLogEncodeDataFrame (arg->log, record->data, frame, arg->busChannel, direction, timestamp);
+	else
+		record->size = mdfCanBusLogEncodeRemoteFrame (arg->log, record->data, frame, arg->busChannel, direction, timestamp);
+
+	mdfRecordQueuePublish (arg->queue, record, timestamp);
+}
+
 void* loggingThread (void* argPtr)
 {
 	loggingThreadArg_t* arg = argPtr;
@@ -135,12 +467,12 @@ void* loggingThread (void* argPtr)
 
 	while (logging)
 	{
-		// Receive a CAN frame. Due to its blocking nature, this must be outside the mutex guard.
+		// Receive a CAN frame. Due to its blocking nature, this must be outside the busy section of the queue.
 		canFrame_t frame;
 		int code = canReceive (arg->device, &frame);
 
-		// Acquire access to the log file. Note this must be before the timestamp is generated.
-		pthread_mutex_lock (arg->logMutex);
+		// Mark the queue busy. Note this must be before the timestamp is generated, see mdf_record_queue.h for details.
+		mdfRecordQueueBegin (arg->queue);
 
 		// Get a timestamp for the frame
 		struct timespec timeCurrent;
@@ -150,18 +482,11 @@ void* loggingThread (void* argPtr)
 		// Check for success
 		if (code == 0)
 		{
-			if (!frame.rtr)
-			{
-				// Log data frame
-				if (mdfCanBusLogWriteDataFrame (arg->log, &frame, arg->busChannel, false, &timeCurrent) != 0)
-					errorPrintf ("Warning, failed to log CAN data frame");
-			}
-			else
-			{
-				// Log RTR frame
-				if (mdfCanBusLogWriteRemoteFrame (arg->log, &frame, arg->busChannel, false, &timeCurrent) != 0)
-					errorPrintf ("Warning, failed to log CAN remote frame");
-			}
+			// Log data / RTR frame
+			logFrame (arg, &frame, 0, false, &timeCurrent);
+
+			if (triggerSignal != NULL)
+				checkTrigger (arg, &frame, &timeCurrent);
 
 			// Measure the frame's size
 			++frameCount;
@@ -171,15 +496,13 @@ void* loggingThread (void* argPtr)
 		else if (canCheckBusError (code))
 		{
 			// If an error frame was generated, log it
-			if (mdfCanBusLogWriteErrorFrame (arg->log, &frame, arg->busChannel, false, code, &timeCurrent) != 0)
-				errorPrintf ("Warning, failed to log CAN error frame");
+			logFrame (arg, &frame, code, false, &timeCurrent);
 
 			// Measure the error count
 			++errorCount;
 		}
 
-		// Release access to the log file.
-		pthread_mutex_unlock (arg->logMutex);
+		mdfRecordQueueEnd (arg->queue);
 
 		// Print status message
 		if (timespecCompare (&timeCurrent, &timeEnd, >))
@@ -194,10 +517,20 @@ void* loggingThread (void* argPtr)
 			// Print the status message
 			if (!quiet)
 				printf ("Channel %u,   Bus Load: [%6.2f%%, %6.2f%%],   CAN Frames Received: %5lu,   "
-					"Error Frames Received: %5lu,   Bits Received: [%7lu, %7lu]\n",
+					"Error Frames Received: %5lu,   Bits Received: [%7lu, %7lu],   Queue Overflows: %5lu\n",
 					arg->busChannel, minLoad * 100.0f, maxLoad * 100.0f,
 					(unsigned long) frameCount, (unsigned long) errorCount, (unsigned long) minBitCount,
-					(unsigned long) maxBitCount);
+					(unsigned long) maxBitCount, (unsigned long) mdfRecordQueueGetOverflowCount (arg->queue));
+
+			// Print the state of the log's write buffers, once for both channels.
+			if (!quiet && arg->busChannel == 1)
+			{
+				mdfCanBusLogStats_t stats;
+				mdfCanBusLogGetStats (arg->log, &stats);
+				printf ("Log Queue Depth: %5lu,   High-Water Mark: %5lu,   Records Dropped: %5lu\n",
+					(unsigned long) stats.queueDepth, (unsigned long) stats.queueHighWaterMark,
+					(unsigned long) stats.droppedCount);
+			}
 
 			uint32_t sessionNumber	= mdfCanBusLogGetSessionNumber (arg->log);
 			uint32_t splitNumber	= mdfCanBusLogGetSplitNumber (arg->log);
@@ -221,12 +554,12 @@ void* loggingThread (void* argPtr)
 				}
 			};
 
-			// Transmit the status message. Due to its blocking nature, this must be outside the mutex guard.
+			// Transmit the status message. Due to its blocking nature, this must be outside the busy section of the queue.
 			if (canTransmit (arg->device, &statusFrame) != 0 && !quiet)
 				errorPrintf ("Warning, failed to transmit status message");
 
-			// Acquire access to the log file. Note this must be before the timestamp is generated.
-			pthread_mutex_lock (arg->logMutex);
+			// Mark the queue busy. Note this must be before the timestamp is generated.
+			mdfRecordQueueBegin (arg->queue);
 
 			// Get a timestamp for the frame. We canot reuse the previous value, as it will have already been used if a frame
 			// was just received.
@@ -235,11 +568,8 @@ void* loggingThread (void* argPtr)
 				errorPrintf ("Warning, failed to get MDF timestamp");
 
 			// Log the status frame.
-			if (mdfCanBusLogWriteDataFrame (arg->log, &statusFrame, arg->busChannel, true, &timeCurrent) != 0)
-				errorPrintf ("Warning, failed to log CAN data frame");
-
-			// Release access to the log file.
-			pthread_mutex_unlock (arg->logMutex);
+			logFrame (arg, &statusFrame, 0, true, &timeCurrent);
+			mdfRecordQueueEnd (arg->queue);
 
 			// Reset the measurements (include the status frame, as we just transmitted that)
 			frameCount = 1;
@@ -253,10 +583,193 @@ void* loggingThread (void* argPtr)
 		}
 	}
 
+	// Signal the merger that no more records will be produced.
+	mdfRecordQueueClose (arg->queue);
 	return NULL;
 }
 
-int loadConfiguration (mdfCanBusLogConfig_t* config, const char* directory, const char* configPath, canDevice_t* channel1, canDevice_t* channel2)
+// Catalog --------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds the lookup table from CAN ID to DBC message, along with the names of the DBC file's signals.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int buildMessageTable (void)
+{
+	// Use a power of 2 at least twice the number of messages, so the table is at most half full.
+	messageTableSize = 16;
+	while (messageTableSize < messageCount * 2)
+		messageTableSize *= 2;
+
+	messageTable = calloc (messageTableSize, sizeof (canMessage_t*));
+	signalNames = calloc (signalCount, sizeof (char*));
+	if (messageTable == NULL || signalNames == NULL)
+		return errno;
+
+	for (size_t index = 0; index < messageCount; ++index)
+	{
+		canMessage_t* message = &messages [index];
+		size_t slot = message->id & (messageTableSize - 1);
+		while (messageTable [slot] != NULL && (messageTable [slot]->id != message->id || messageTable [slot]->ide != message->ide))
+			slot = (slot + 1) & (messageTableSize - 1);
+
+		// If the DBC file defines the same message twice, the first takes precedence.
+		if (messageTable [slot] == NULL)
+			messageTable [slot] = message;
+
+		for (size_t signalIndex = 0; signalIndex < message->signalCount; ++signalIndex)
+		{
+			canSignal_t* signal = &message->signals [signalIndex];
+			if (asprintf (&signalNames [signal - signals], "%s.%s", message->name, signal->name) < 0)
+				return errno;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Finds the DBC message of a record.
+ * @return The message, @c NULL if the record is not a data frame of a DBC message.
+ */
+static canMessage_t* findMessage (const mdfCanBusRecord_t* record)
+{
+	if (record->type != MDF_CAN_BUS_RECORD_DATA_FRAME)
+		return NULL;
+
+	size_t slot = record->id & (messageTableSize - 1);
+	while (messageTable [slot] != NULL && (messageTable [slot]->id != record->id || messageTable [slot]->ide != record->ide))
+		slot = (slot + 1) & (messageTableSize - 1);
+
+	return messageTable [slot];
+}
+
+/**
+ * @brief Catalog signal callback, decoding the DBC signals of a data frame. See @c mdfCatalogSignalCallback_t .
+ */
+static void summarizeSignals (mdfCatalogBuilder_t* builder, const mdfCanBusRecord_t* record, void* arg)
+{
+	(void) arg;
+
+	canMessage_t* message = findMessage (record);
+	if (message == NULL)
+		return;
+
+	uint64_t payload = 0;
+	memcpy (&payload, record->data, record->dlc < sizeof (payload) ? record->dlc : sizeof (payload));
+	for (size_t index = 0; index < message->signalCount; ++index)
+	{
+		canSignal_t* signal = &message->signals [index];
+		mdfCatalogBuilderUpdateSignal (builder, signal - signals, signalDecode (signal, payload));
+	}
+}
+
+// Signal Log -----------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds the groups of the signal log, one per DBC message.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int buildSignalLogGroups (void)
+{
+	signalLogGroups = calloc (messageCount, sizeof (mdfSignalLogGroup_t));
+	signalLogChannels = calloc (signalCount, sizeof (mdfSignalLogChannel_t));
+	if ((signalLogGroups == NULL && messageCount != 0) || (signalLogChannels == NULL && signalCount != 0))
+		return errno;
+
+	for (size_t index = 0; index < signalCount; ++index)
+	{
+		signalLogChannels [index] = (mdfSignalLogChannel_t)
+		{
+			.name		= signals [index].name,
+			.unit		= signals [index].unit,
+			.signedness	= signals [index].signedness,
+			.bitLength	= signals [index].bitLength,
+			.factor		= signals [index].scaleFactor,
+			.offset		= signals [index].offset
+		};
+	}
+
+	for (size_t index = 0; index < messageCount; ++index)
+	{
+		signalLogGroups [index] = (mdfSignalLogGroup_t)
+		{
+			.name			= messages [index].name,
+			.channels		= signalLogChannels + (messages [index].signals - signals),
+			.channelCount	= messages [index].signalCount
+		};
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Signal log callback, decoding the raw DBC signals of a data frame. See @c mdfSignalLogCallback_t .
+ */
+static bool decodeSignals (const mdfCanBusRecord_t* record, size_t* groupIndex, uint64_t* values, void* arg)
+{
+	(void) arg;
+
+	canMessage_t* message = findMessage (record);
+	if (message == NULL)
+		return false;
+
+	uint64_t payload = 0;
+	memcpy (&payload, record->data, record->dlc < sizeof (payload) ? record->dlc : sizeof (payload));
+	for (size_t index = 0; index < message->signalCount; ++index)
+		values [index] = signalDecodeRaw (&message->signals [index], payload);
+
+	*groupIndex = message - messages;
+	return true;
+}
+
+/**
+ * @brief Parses the stages of the post-processing pipeline, populating @c pipelineStages .
+ * @param stages The comma-separated list of stage names. Modified by this function.
+ * @param stageCount Written to the number of stages.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int parsePipelineStages (char* stages, size_t* stageCount)
+{
+	*stageCount = 0;
+
+	char* context;
+	for (char* name = strtok_r (stages, ",", &context); name != NULL; name = strtok_r (NULL, ",", &context))
+	{
+		const mdfPipelineStage_t* stage = mdfPipelineGetStage (name);
+		if (stage == NULL)
+		{
+			fprintf (stderr, "Unknown pipeline stage '%s'.\n", name);
+			errno = EINVAL;
+			return errno;
+		}
+
+		for (size_t index = 0; index < *stageCount; ++index)
+		{
+			if (pipelineStages [index].function == stage->function)
+			{
+				fprintf (stderr, "Duplicate pipeline stage '%s'.\n", name);
+				errno = EINVAL;
+				return errno;
+			}
+		}
+
+		if (*stageCount == PIPELINE_STAGE_COUNT_MAX)
+		{
+			errno = EINVAL;
+			return errno;
+		}
+
+		pipelineStages [*stageCount] = *stage;
+		++*stageCount;
+	}
+
+	return 0;
+}
+
+int loadConfiguration (mdfCanBusLogConfig_t* config, mdfRetentionConfig_t* retentionConfig,
+	mdfPipelineConfig_t* pipelineConfig, const char* directory, const char* configPath, canDevice_t* channel1,
+	canDevice_t* channel2)
 {
 	cJSON* configJson = jsonLoad (configPath);
 	if (configJson == NULL)
@@ -278,6 +791,62 @@ int loadConfiguration (mdfCanBusLogConfig_t* config, const char* directory, cons
 	if (jsonGetString (configJson, "serialNumber", &serialNumber) != 0)
 		return errno;
 
+	// The group-commit policy is optional, use the defaults if not specified.
+	unsigned syncIntervalMs;
+	if (jsonGetUnsigned (configJson, "syncIntervalMs", &syncIntervalMs) != 0)
+		syncIntervalMs = 0;
+
+	unsigned syncSize;
+	if (jsonGetUnsigned (configJson, "syncSize", &syncSize) != 0)
+		syncSize = 0;
+
+	// Compression is optional, disabled by default.
+	bool compress;
+	if (jsonGetBool (configJson, "compress", &compress) != 0)
+		compress = false;
+
+	// The retention policy is optional, disabled by default.
+	unsigned retentionQuotaMb;
+	if (jsonGetUnsigned (configJson, "retentionQuotaMb", &retentionQuotaMb) != 0)
+		retentionQuotaMb = 0;
+
+	unsigned retentionFreeMb;
+	if (jsonGetUnsigned (configJson, "retentionFreeMb", &retentionFreeMb) != 0)
+		retentionFreeMb = 0;
+
+	bool retentionCompress;
+	if (jsonGetBool (configJson, "retentionCompress", &retentionCompress) != 0)
+		retentionCompress = false;
+
+	unsigned retentionRateKbps;
+	if (jsonGetUnsigned (configJson, "retentionRateKbps", &retentionRateKbps) != 0)
+		retentionRateKbps = 0;
+
+	// The catalog is optional, disabled by default.
+	bool catalog;
+	if (jsonGetBool (configJson, "catalog", &catalog) != 0)
+		catalog = false;
+
+	// The signal log is optional, disabled by default.
+	bool signalLog;
+	if (jsonGetBool (configJson, "signals", &signalLog) != 0)
+		signalLog = false;
+
+	// The post-processing pipeline is optional, disabled by default.
+	char* pipeline;
+	size_t pipelineStageCount = 0;
+	if (jsonGetString (configJson, "pipeline", &pipeline) == 0 && parsePipelineStages (pipeline, &pipelineStageCount) != 0)
+		return errno;
+
+	// The pipeline's stages replace their equivalents of the log and retention policy, so no two threads write the same file.
+	for (size_t index = 0; index < pipelineStageCount; ++index)
+	{
+		if (strcmp (pipelineStages [index].name, "compress") == 0)
+			retentionCompress = false;
+		else if (strcmp (pipelineStages [index].name, "catalog") == 0)
+			catalog = false;
+	}
+
 	#ifdef ZRE_CANTOOLS_OS_linux
 
 	// Get the total size and remaining space in the destination filesystem.
@@ -313,7 +882,30 @@ int loadConfiguration (mdfCanBusLogConfig_t* config, const char* directory, cons
 		.channel2Baudrate	= channel2 == NULL ? 0 : canGetBaudrate (channel2),
 		.storageSize		= storageTotal,
 		.storageRemaining	= storageAvail,
-		.sessionNumber		= mdfCanBusLogFindSessionNumber (directory)
+		.sessionNumber		= mdfCanBusLogFindSessionNumber (directory),
+		.syncIntervalMs		= syncIntervalMs,
+		.syncSize			= syncSize,
+		.compress			= compress,
+		.catalog			= catalog,
+		.signalLog			= signalLog
+	};
+
+	*retentionConfig = (mdfRetentionConfig_t)
+	{
+		.directory				= directory,
+		.activeSessionNumber	= config->sessionNumber,
+		.quota					= (size_t) retentionQuotaMb << 20,
+		.freeMin				= (size_t) retentionFreeMb << 20,
+		.compress				= retentionCompress,
+		.rateLimit				= (size_t) retentionRateKbps << 10
+	};
+
+	*pipelineConfig = (mdfPipelineConfig_t)
+	{
+		.directory	= directory,
+		.stages		= pipelineStages,
+		.stageCount	= pipelineStageCount,
+		.rateLimit	= retentionRateKbps != 0 ? (size_t) retentionRateKbps << 10 : MDF_RETENTION_RATE_LIMIT_DEFAULT
 	};
 	return 0;
 }
@@ -332,14 +924,17 @@ int main (int argc, char** argv)
 		.charHandlers	= (optionCharCallback_t* []) { testSystemTick },
 		.chars			= (char []) { 'r' },
 		.charCount		= 1,
-		.stringHandlers	= (optionStringCallback_t* []) { handleOptionQuiet },
-		.strings		= (char* []) { "quiet" },
-		.stringCount	= 1
+		.stringHandlers	= (optionStringCallback_t* []) { handleOptionQuiet, handleOptionPreTrigger, handleOptionPostTrigger,
+			handleOptionDbc, handleOptionTrigger, handleOptionErrorBurst },
+		.strings		= (char* []) { "quiet", "pre-trigger", "post-trigger", "dbc", "trigger", "error-burst" },
+		.stringCount	= 6
 	}) != 0)
 		return errorPrintf ("Failed to handle options");
 
-	// Validate usage
-	if (argc < 3 || argc > 4)
+	// Validate usage. Note the trigger options are only meaningful in capture mode.
+	bool triggerOptions = triggerCondition != NULL || errorBurstCount != 0;
+	if (argc < 3 || argc > 4 || (triggerOptions && !captureMode) || (triggerCondition != NULL && dbcPath == NULL) ||
+		preTrigger < 0 || postTrigger < 0)
 	{
 		fprintUsage (stderr);
 		return -1;
@@ -348,6 +943,10 @@ int main (int argc, char** argv)
 	char* mdfDirectory = argv [0];
 	char* configPath = argv [1];
 
+	// Allow recorded sessions to be re-logged (ex. for benchmarking).
+	if (mdfCanReplayRegister () != 0)
+		return errorPrintf ("Failed to register MDF replay CAN device");
+
 	// Initialize the channel 1 CAN device
 	char* channel1DeviceName = argv [2];
 	canDevice_t* channel1 = canInit (channel1DeviceName, "Channel 1");
@@ -379,20 +978,134 @@ int main (int argc, char** argv)
 	}
 
 	mdfCanBusLogConfig_t config;
-	if (loadConfiguration (&config, mdfDirectory, configPath, channel1, channel2) != 0)
+	mdfRetentionConfig_t retentionConfig;
+	mdfPipelineConfig_t pipelineConfig;
+	if (loadConfiguration (&config, &retentionConfig, &pipelineConfig, mdfDirectory, configPath, channel1, channel2) != 0)
 		return errorPrintf ("Failed to load CAN bus MDF log configuration");
 
+	if (config.signalLog && dbcPath == NULL)
+	{
+		fprintf (stderr, "Logging signals requires a DBC file, see '--dbc'.\n");
+		return -1;
+	}
+
+	// Find the pipeline's catalog stage, if any.
+	mdfPipelineStage_t* catalogStage = NULL;
+	for (size_t index = 0; index < pipelineConfig.stageCount; ++index)
+		if (strcmp (pipelineStages [index].name, "catalog") == 0)
+			catalogStage = &pipelineStages [index];
+
+	if (dbcPath != NULL)
+	{
+		if (canDbcLoad (dbcPath, &messages, &messageCount, &signals, &signalCount) != 0)
+			return errorPrintf ("Failed to load DBC file '%s'", dbcPath);
+
+		if (triggerCondition != NULL && parseTriggerCondition (messages, messageCount) != 0)
+			return errorPrintf ("Failed to parse trigger condition");
+
+		if ((config.catalog || catalogStage != NULL || config.signalLog) && buildMessageTable () != 0)
+			return errorPrintf ("Failed to build DBC message table");
+
+		// Summarize the DBC file's signals in the catalog.
+		if (config.catalog)
+		{
+			config.catalogSignalNames	= (const char* const*) signalNames;
+			config.catalogSignalCount	= signalCount;
+			config.catalogCallback		= summarizeSignals;
+		}
+
+		// Likewise, if the pipeline summarizes the splits instead.
+		if (catalogStage != NULL)
+		{
+			if (mdfCatalogBuilderInit (&pipelineCatalogBuilder, (const char* const*) signalNames, signalCount, summarizeSignals,
+				NULL) != 0)
+				return errorPrintf ("Failed to initialize pipeline catalog builder");
+
+			catalogStage->arg = &pipelineCatalogBuilder;
+		}
+
+		// Log the DBC file's signals alongside the bus.
+		if (config.signalLog)
+		{
+			if (buildSignalLogGroups () != 0)
+				return errorPrintf ("Failed to build signal log groups");
+
+			config.signalLogGroups		= signalLogGroups;
+			config.signalLogGroupCount	= messageCount;
+			config.signalLogCallback	= decodeSignals;
+		}
+	}
+
+	// Start the pipeline before the log, so it is given the log's first split.
+	mdfPipeline_t pipeline;
+	bool pipelineEnabled = pipelineConfig.stageCount != 0;
+	if (pipelineEnabled)
+	{
+		if (mdfPipelineStart (&pipeline, &pipelineConfig) != 0)
+			return errorPrintf ("Failed to start MDF split pipeline");
+
+		config.splitCallback	= mdfPipelineSplitCallback;
+		config.splitArg			= &pipeline;
+	}
+
+	// In capture mode, size the ring to hold the pre-trigger window at the maximum frame rate of every channel. As the ring is
+	// flushed into the log all at once, the log's buffers must be able to hold the whole ring on top of their usual contents.
+	size_t captureCapacity = 0;
+	if (captureMode)
+	{
+		size_t frameRate = canGetBaudrate (channel1) / FRAME_BIT_COUNT_MIN;
+		if (channel2 != NULL)
+			frameRate += canGetBaudrate (channel2) / FRAME_BIT_COUNT_MIN;
+
+		captureCapacity = (size_t) (preTrigger * frameRate) + 1;
+		config.bufferSize = MDF_CAN_BUS_LOG_BUFFER_SIZE_DEFAULT + captureCapacity * MDF_CAN_BUS_LOG_RECORD_SIZE_MAX;
+	}
+
 	mdfCanBusLog_t log;
 	if (mdfCanBusLogInit (&log, &config) != 0)
 		return errorPrintf ("Failed to initialize CAN bus MDF log");
 
-	// Create a mutex guarding access to the log file. While single fwrite operations are thread-safe on their own, this mutex
-	// is used to guarantee the timestamp written to each record of the log is monotonic, as our data analysis software imposes
-	// said requirement. As a result of this, all timestamps written must be acquired inside the guard of this mutex.
-	pthread_mutex_t logMutex;
-	pthread_mutex_init (&logMutex, NULL);
+	// If limits are configured, start enforcing them upon the previous sessions in the background.
+	mdfRetention_t retention;
+	bool retentionEnabled = retentionConfig.quota != 0 || retentionConfig.freeMin != 0;
+	if (retentionEnabled && mdfRetentionStart (&retention, &retentionConfig) != 0)
+		return errorPrintf ("Failed to start MDF session retention");
+
+	// Create a record queue for each channel. Each channel's thread encodes records into its own queue, while a single merger
+	// writes them to the log. The merger guarantees the timestamp written to each record of the log is monotonic, as our data
+	// analysis software imposes said requirement, without the channels ever contending with each other.
+	mdfRecordQueue_t queues [2];
+	size_t queueCount = channel2 != NULL ? 2 : 1;
+	for (size_t index = 0; index < queueCount; ++index)
+		if (mdfRecordQueueInit (&queues [index], RECORD_QUEUE_SIZE) != 0)
+			return errorPrintf ("Failed to initialize record queue");
+
+	if (captureMode)
+	{
+		mdfCaptureConfig_t captureConfig =
+		{
+			.capacity			= captureCapacity,
+			.preTriggerNs		= (long long) (preTrigger * 1e9),
+			.postTriggerNs		= (long long) (postTrigger * 1e9),
+			.errorBurstCount	= errorBurstCount,
+			.errorBurstWindowNs	= (long long) errorBurstWindowMs * 1000000
+		};
+		if (mdfCaptureInit (&capture, &log, &captureConfig) != 0)
+			return errorPrintf ("Failed to initialize MDF capture");
+
+		#ifdef SIGUSR1
+		if (signal (SIGUSR1, sigusr1Handler) == SIG_ERR)
+			return errorPrintf ("Failed to bind SIGUSR1 handler");
+		#endif // SIGUSR1
+	}
+
+	mdfRecordMerger_t merger;
+	if (mdfRecordMergerStart (&merger, &log, captureMode ? &capture : NULL, queues, queueCount) != 0)
+		return errorPrintf ("Failed to start record merger");
 
 	printf ("Starting MDF log: File name '%s'.\n", mdfCanBusLogGetName (&log));
+	if (captureMode)
+		printf ("Capture mode: Logging %.1f s before and %.1f s after each trigger.\n", preTrigger, postTrigger);
 
 	if (signal (SIGTERM, sigtermHandler) == SIG_ERR)
 		return errorPrintf ("Failed to bind SIGTERM handler");
@@ -405,7 +1118,7 @@ int main (int argc, char** argv)
 	{
 		.device		= channel1,
 		.log		= &log,
-		.logMutex	= &logMutex,
+		.queue		= &queues [0],
 		.busChannel	= 1
 	};
 	pthread_t channel1Thread;
@@ -416,7 +1129,7 @@ int main (int argc, char** argv)
 	{
 		.device		= channel2,
 		.log		= &log,
-		.logMutex	= &logMutex,
+		.queue		= &queues [1],
 		.busChannel	= 2
 	};
 	pthread_t channel2Thread;
@@ -428,12 +1141,75 @@ int main (int argc, char** argv)
 		pthread_join (channel2Thread, NULL);
 	pthread_join (channel1Thread, NULL);
 
-	// Destroy the mutex.
-	pthread_mutex_destroy (&logMutex);
+	// Wait for the merger to write all remaining records.
+	mdfRecordMergerJoin (&merger);
+	for (size_t index = 0; index < queueCount; ++index)
+		mdfRecordQueueDealloc (&queues [index]);
+
+	if (captureMode)
+	{
+		// Stop accepting triggers before the capture is de-allocated.
+		#ifdef SIGUSR1
+		signal (SIGUSR1, SIG_IGN);
+		#endif // SIGUSR1
+
+		if (mdfCaptureClose (&capture) != 0)
+			errorPrintf ("Failed to close MDF capture");
+
+		mdfCaptureStats_t stats;
+		mdfCaptureGetStats (&capture, &stats);
+		printf ("Triggers: %lu, events captured: %lu, records captured: %lu, records discarded: %lu, records dropped: %lu.\n",
+			(unsigned long) stats.triggerCount, (unsigned long) stats.eventCount, (unsigned long) stats.writtenCount,
+			(unsigned long) stats.discardedCount, (unsigned long) stats.droppedCount);
+	}
+
+	if (retentionEnabled)
+	{
+		mdfRetentionStop (&retention);
+
+		// The retention thread has been joined, so the statistics may be read directly.
+		printf ("Retention: Splits compressed: %lu, sessions deleted: %lu, space freed: %.1f MiB, space used: %.1f MiB.\n",
+			(unsigned long) retention.stats.compressedCount, (unsigned long) retention.stats.deletedCount,
+			retention.stats.freedSize / 1048576.0, retention.stats.usedSize / 1048576.0);
+	}
 
 	// Terminate the log gracefully
 	printf ("Closing MDF file...\n");
-	mdfCanBusLogClose (&log);
+	if (mdfCanBusLogClose (&log) != 0)
+		errorPrintf ("Failed to close MDF file");
+
+	// The writer thread has been joined, so the statistics may be read directly.
+	printf ("Records written: %lu, records dropped: %lu, queue high-water mark: %lu.\n",
+		(unsigned long) log.stats.writtenCount, (unsigned long) log.stats.droppedCount,
+		(unsigned long) log.stats.queueHighWaterMark);
+	printf ("Syncs: %lu, longest sync: %.3f ms.\n", (unsigned long) log.stats.syncCount, log.stats.syncTimeMaxNs / 1e6);
+
+	// Stop the pipeline only once the log is closed, as the log's writer thread notifies it of each split up until then. Note
+	// a stage already running is completed first, any remaining stages are resumed on the next start.
+	if (pipelineEnabled)
+	{
+		mdfPipelineStop (&pipeline);
+
+		// The pipeline thread has been joined, so the statistics may be read directly.
+		printf ("Pipeline: Splits processed: %lu, splits failed: %lu, splits pending: %lu, splits dropped: %lu.\n",
+			(unsigned long) pipeline.stats.processedCount, (unsigned long) pipeline.stats.failedCount,
+			(unsigned long) pipeline.stats.pendingCount, (unsigned long) pipeline.stats.droppedCount);
+	}
+
+	// The signal names are referenced by the log, so the DBC file must outlive it.
+	if (messages != NULL)
+	{
+		for (size_t index = 0; signalNames != NULL && index < signalCount; ++index)
+			free (signalNames [index]);
+		free (signalNames);
+		free (messageTable);
+		free (signalLogGroups);
+		free (signalLogChannels);
+		if (catalogStage != NULL)
+			mdfCatalogBuilderDealloc (&pipelineCatalogBuilder);
+		canDbcsDealloc (messages, messageCount, signals);
+	}
+
 	if (channel2 != NULL)
 		canDealloc (channel2);
 	canDealloc (channel1);
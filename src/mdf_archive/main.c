@@ -0,0 +1,599 @@
+// MDF Archive ----------------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: See help page.
+
+// For asprintf. Note this must be the first include in this file.
+#define _GNU_SOURCE
+#include <stdio.h>
+
+// Includes
+#include "debug.h"
+#include "error_codes.h"
+#include "mdf/mdf_can_bus_archive.h"
+#include "mdf/mdf_can_bus_logging.h"
+#include "mdf/mdf_can_bus_reader.h"
+#include "options.h"
+#include "time_port.h"
+
+// POSIX
+#include <sys/stat.h>
+
+// C Standard Library
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of records read at a time.
+#define READ_BATCH_SIZE 1024
+
+/// @brief The time to wait for the log's writer when its buffers are full, in nanoseconds.
+#define OVERFLOW_WAIT_NS 1000000
+
+// Globals --------------------------------------------------------------------------------------------------------------------
+
+/// @brief Indicates an archive should be extracted, rather than created.
+bool extract = false;
+
+/// @brief Indicates a created archive should be decoded and compared against the session.
+bool verify = false;
+
+/// @brief Indicates extracted splits should be written as compressed data blocks.
+bool compress = false;
+
+/// @brief The deflate compression level of a created archive, 0 for the default.
+int level = 0;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void handleExtract (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+	extract = true;
+}
+
+void handleVerify (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+	verify = true;
+}
+
+void handleCompress (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+	compress = true;
+}
+
+void handleLevel (char* option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		level = strtol (value, NULL, 0);
+}
+
+void fprintUsage (FILE* stream)
+{
+	fprintf (stream, "Usage:\n"
+		"    mdf-archive <Options> <Session Directory> <Archive File>\n"
+		"    mdf-archive <Options> --extract <Archive File> <Log Directory>\n");
+}
+
+void fprintHelp (FILE* stream)
+{
+	fprintf (stream, ""
+		"mdf-archive - Converts a session of MDF CAN bus logs into a compact archive,\n"
+		"              or an archive back into a session. Archives store timestamps\n"
+		"              as deltas, frame headers in a dictionary, and payloads XOR-ed\n"
+		"              with the previous payload of their CAN ID, all deflated in\n"
+		"              blocks. Every record is preserved, in its original order and\n"
+		"              split. Note the metadata of the original log (configuration,\n"
+		"              hardware, serial number, baudrates) is not preserved.\n\n");
+
+	fprintUsage (stream);
+
+	fprintf (stream, "\nParameters:\n\n");
+	fprintf (stream, ""
+		"    <Session Directory>   - The session to archive (ex. logs/session_3).\n"
+		"    <Archive File>        - The archive to create or extract (ex.\n"
+		"                            session_3.zca).\n"
+		"    <Log Directory>       - The directory to extract the session into. The\n"
+		"                            session is re-created under its original number\n"
+		"                            (ex. <Log Directory>/session_3), which must not\n"
+		"                            already exist.\n\n");
+
+	fprintf (stream, ""
+		"Options:\n\n"
+		"    --extract             - Extracts an archive, rather than creating one.\n"
+		"    --level=<1-9>         - The deflate compression level of the archive.\n"
+		"                            Default %i.\n"
+		"    --verify              - Once created, decodes the archive and compares it\n"
+		"                            against the session, reporting the decoding speed.\n"
+		"    --compress            - Write the extracted splits as compressed data\n"
+		"                            blocks.\n"
+		"\n", MDF_CAN_BUS_ARCHIVE_LEVEL_DEFAULT);
+	fprintOptionHelp (stream, "    ");
+}
+
+/**
+ * @brief Gets the session number of a session directory, based on its name (ex. 'session_3').
+ * @param sessionDirectory The directory of the session.
+ * @return The session number, 0 if the name is not recognized.
+ */
+static uint32_t getSessionNumber (const char* sessionDirectory)
+{
+	// Ignore any trailing slashes.
+	size_t length = strlen (sessionDirectory);
+	while (length > 1 && sessionDirectory [length - 1] == '/')
+		--length;
+
+	size_t start = length;
+	while (start > 0 && sessionDirectory [start - 1] != '/')
+		--start;
+
+	uint32_t sessionNumber;
+	char* name = strndup (sessionDirectory + start, length - start);
+	if (name == NULL || sscanf (name, "session_%"SCNu32, &sessionNumber) != 1)
+		sessionNumber = 0;
+	free (name);
+	return sessionNumber;
+}
+
+/**
+ * @brief Opens a split of a session for reading.
+ * @param reader The reader to initialize.
+ * @param sessionDirectory The directory of the session.
+ * @param splitNumber The number of the split.
+ * @param size Written to the size of the split, in bytes. May be @c NULL .
+ * @return 0 if successful, @c ENOENT if the split does not exist (the end of the session), the error code otherwise.
+ */
+static int openSplit (mdfCanBusReader_t* reader, const char* sessionDirectory, uint32_t splitNumber, size_t* size)
+{
+	char* path;
+	if (asprintf (&path, "%s/split_%"PRIu32".mf4", sessionDirectory, splitNumber) < 0)
+		return errno;
+
+	struct stat splitStat;
+	int code = stat (path, &splitStat) == 0 ? 0 : errno;
+	if (code == 0)
+	{
+		if (size != NULL)
+			*size = splitStat.st_size;
+		code = mdfCanBusReaderInit (reader, path);
+	}
+
+	if (code != 0 && code != ENOENT)
+		errorPrintf ("Failed to open split '%s'", path);
+
+	free (path);
+	errno = code;
+	return code;
+}
+
+static bool recordsEqual (const mdfCanBusRecord_t* a, const mdfCanBusRecord_t* b)
+{
+	if (a->type != b->type || a->timestampNs != b->timestampNs || a->id != b->id || a->ide != b->ide || a->dlc != b->dlc ||
+		a->busChannel != b->busChannel || a->direction != b->direction || a->errorType != b->errorType)
+		return false;
+
+	if (a->type == MDF_CAN_BUS_RECORD_REMOTE_FRAME)
+		return true;
+
+	size_t size = a->dlc < MDF_CAN_BUS_ARCHIVE_PAYLOAD_SIZE ? a->dlc : MDF_CAN_BUS_ARCHIVE_PAYLOAD_SIZE;
+	return memcmp (a->data, b->data, size) == 0;
+}
+
+/**
+ * @brief Decodes an archive, comparing its records against those of a session.
+ * @param sessionDirectory The directory of the session.
+ * @param archivePath The path of the archive.
+ * @return 0 if the archive matches, the error code otherwise.
+ */
+static int verifyArchive (const char* sessionDirectory, const char* archivePath)
+{
+	// Time the decoding alone, separately from the reading of the session.
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+
+	mdfCanBusArchiveReader_t archive;
+	if (mdfCanBusArchiveReaderInit (&archive, archivePath) != 0)
+		return errorPrintf ("Failed to open archive '%s'", archivePath);
+
+	uint64_t recordCount = 0;
+	uint64_t firstTimestampNs = 0;
+	uint64_t lastTimestampNs = 0;
+	mdfCanBusRecord_t records [READ_BATCH_SIZE];
+	size_t count;
+	int code;
+	while ((code = mdfCanBusArchiveReaderRead (&archive, records, READ_BATCH_SIZE, &count)) == 0 && count != 0)
+	{
+		if (recordCount == 0)
+			firstTimestampNs = records [0].timestampNs;
+		lastTimestampNs = records [count - 1].timestampNs;
+		recordCount += count;
+	}
+	mdfCanBusArchiveReaderClose (&archive);
+	if (code != 0)
+	{
+		errno = code;
+		return errorPrintf ("Failed to decode archive '%s'", archivePath);
+	}
+
+	struct timespec timeEnd;
+	clock_gettime (CLOCK_MONOTONIC, &timeEnd);
+	struct timespec timeDecode = timespecSub (&timeEnd, &timeStart);
+	double decodeS = timespecToNs (&timeDecode) / 1e9;
+	double durationS = (lastTimestampNs - firstTimestampNs) / 1e9;
+
+	printf ("Decoded %"PRIu64" records in %.3f s (%.1f M records/s, %.0fx real time).\n", recordCount, decodeS,
+		recordCount / decodeS / 1e6, durationS / decodeS);
+
+	// Compare the archive against the session, split by split.
+	if (mdfCanBusArchiveReaderInit (&archive, archivePath) != 0)
+		return errorPrintf ("Failed to open archive '%s'", archivePath);
+
+	mdfCanBusRecord_t archiveRecords [READ_BATCH_SIZE];
+	size_t archiveCount = 0;
+	size_t archiveIndex = 0;
+	uint64_t recordIndex = 0;
+	code = 0;
+
+	for (uint32_t splitNumber = 0; code == 0; ++splitNumber)
+	{
+		mdfCanBusReader_t reader;
+		code = openSplit (&reader, sessionDirectory, splitNumber, NULL);
+		if (code != 0)
+			break;
+
+		while (code == 0)
+		{
+			if (mdfCanBusReaderRead (&reader, records, READ_BATCH_SIZE, &count) != 0)
+			{
+				code = errno;
+				break;
+			}
+			if (count == 0)
+				break;
+
+			for (size_t index = 0; index < count && code == 0; ++index, ++recordIndex)
+			{
+				if (archiveIndex == archiveCount)
+				{
+					archiveIndex = 0;
+					if (mdfCanBusArchiveReaderRead (&archive, archiveRecords, READ_BATCH_SIZE, &archiveCount) != 0)
+						code = errno;
+				}
+
+				if (code == 0 && (archiveCount == 0 || archive.splitNumber != splitNumber ||
+					!recordsEqual (&records [index], &archiveRecords [archiveIndex++])))
+				{
+					fprintf (stderr, "Record %"PRIu64" (split %"PRIu32") does not match the archive.\n", recordIndex,
+						splitNumber);
+					code = ERRNO_MDF_ARCHIVE_MALFORMED;
+				}
+			}
+		}
+
+		mdfCanBusReaderClose (&reader);
+	}
+
+	// The session ends at the first missing split, after which the archive should hold no further records.
+	if (code == ENOENT)
+	{
+		code = 0;
+		if (archiveIndex == archiveCount)
+		{
+			archiveIndex = 0;
+			if (mdfCanBusArchiveReaderRead (&archive, archiveRecords, READ_BATCH_SIZE, &archiveCount) != 0)
+				code = errno;
+		}
+
+		if (code == 0 && archiveIndex != archiveCount)
+		{
+			fprintf (stderr, "The archive holds more records than the session.\n");
+			code = ERRNO_MDF_ARCHIVE_MALFORMED;
+		}
+	}
+
+	mdfCanBusArchiveReaderClose (&archive);
+	if (code != 0)
+	{
+		errno = code;
+		return errorPrintf ("Failed to verify archive '%s'", archivePath);
+	}
+
+	printf ("Verified %"PRIu64" records.\n", recordIndex);
+	return 0;
+}
+
+/**
+ * @brief Creates an archive of a session.
+ * @param sessionDirectory The directory of the session.
+ * @param archivePath The path of the archive to create.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int createArchive (const char* sessionDirectory, const char* archivePath)
+{
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+
+	mdfCanBusArchiveWriter_t writer;
+	bool writerOpen = false;
+	uint64_t sessionSize = 0;
+	uint64_t recordCount = 0;
+	uint32_t splitNumber = 0;
+	int code = 0;
+
+	for (; code == 0; ++splitNumber)
+	{
+		mdfCanBusReader_t reader;
+		size_t splitSize;
+		code = openSplit (&reader, sessionDirectory, splitNumber, &splitSize);
+		if (code != 0)
+			break;
+
+		// The archive is created once the session's start time is known.
+		if (!writerOpen)
+		{
+			mdfCanBusArchiveConfig_t config =
+			{
+				.sessionNumber	= getSessionNumber (sessionDirectory),
+				.startTimeNs	= reader.startTimeNs,
+				.level			= level
+			};
+
+			if (mdfCanBusArchiveWriterInit (&writer, archivePath, &config) != 0)
+			{
+				code = errorPrintf ("Failed to create archive '%s'", archivePath);
+				mdfCanBusReaderClose (&reader);
+				break;
+			}
+			writerOpen = true;
+		}
+
+		code = mdfCanBusArchiveWriterSplit (&writer, splitNumber);
+
+		mdfCanBusRecord_t records [READ_BATCH_SIZE];
+		size_t count;
+		while (code == 0)
+		{
+			if (mdfCanBusReaderRead (&reader, records, READ_BATCH_SIZE, &count) != 0)
+			{
+				code = errorPrintf ("Failed to read split %"PRIu32, splitNumber);
+				break;
+			}
+			if (count == 0)
+				break;
+
+			for (size_t index = 0; index < count && code == 0; ++index)
+				code = mdfCanBusArchiveWriterWrite (&writer, &records [index]);
+			recordCount += count;
+		}
+
+		mdfCanBusReaderClose (&reader);
+		sessionSize += splitSize;
+	}
+
+	// The session ends at the first missing split, but should have at least one.
+	if (code == ENOENT)
+		code = splitNumber > 0 ? 0 : ENOENT;
+
+	if (writerOpen && mdfCanBusArchiveWriterClose (&writer) != 0 && code == 0)
+		code = errno;
+	uint64_t archiveSize = writerOpen ? writer.size : 0;
+
+	if (code != 0)
+	{
+		if (writerOpen)
+			remove (archivePath);
+		errno = code;
+		return errorPrintf ("Failed to archive session '%s'", sessionDirectory);
+	}
+
+	struct timespec timeEnd;
+	clock_gettime (CLOCK_MONOTONIC, &timeEnd);
+	struct timespec timeElapsed = timespecSub (&timeEnd, &timeStart);
+
+	printf ("Archived %"PRIu64" records of %"PRIu32" splits in %.3f s: %"PRIu64" bytes -> %"PRIu64" bytes (%.2fx, %.2f bytes "
+		"per record).\n", recordCount, splitNumber, timespecToNs (&timeElapsed) / 1e9, sessionSize, archiveSize,
+		(double) sessionSize / archiveSize, recordCount != 0 ? (double) archiveSize / recordCount : 0.0);
+
+	if (verify)
+		return verifyArchive (sessionDirectory, archivePath);
+
+	return 0;
+}
+
+/**
+ * @brief Writes a record to a log, waiting for the log's writer if its buffers are full.
+ * @param log The log to write to.
+ * @param record The record to write.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int writeRecord (mdfCanBusLog_t* log, const mdfCanBusRecord_t* record)
+{
+	canFrame_t frame =
+	{
+		.id		= record->id,
+		.ide	= record->ide,
+		.dlc	= record->dlc,
+		.rtr	= record->type == MDF_CAN_BUS_RECORD_REMOTE_FRAME
+	};
+	memcpy (frame.data, record->data, sizeof (frame.data));
+
+	// Records are timestamped relative to the start of the log.
+	struct timespec offset =
+	{
+		.tv_sec		= record->timestampNs / 1000000000,
+		.tv_nsec	= record->timestampNs % 1000000000
+	};
+	struct timespec timestamp = timespecAdd (&log->timeStart, &offset);
+
+	while (true)
+	{
+		int code;
+		switch (record->type)
+		{
+		case MDF_CAN_BUS_RECORD_DATA_FRAME:
+			code = mdfCanBusLogWriteDataFrame (log, &frame, record->busChannel, record->direction, &timestamp);
+			break;
+
+		case MDF_CAN_BUS_RECORD_REMOTE_FRAME:
+			code = mdfCanBusLogWriteRemoteFrame (log, &frame, record->busChannel, record->direction, &timestamp);
+			break;
+
+		case MDF_CAN_BUS_RECORD_ERROR_FRAME:
+		default:
+			code = mdfCanBusLogWriteErrorFrame (log, &frame, record->busChannel, record->direction,
+				mdfCanBusLogGetErrorCode (record->errorType), &timestamp);
+			break;
+		}
+
+		// Unlike a live log, nothing is lost by waiting for the writer to catch up.
+		if (code != ERRNO_MDF_LOG_OVERFLOW)
+			return code;
+
+		nanosleep (&(struct timespec) { .tv_nsec = OVERFLOW_WAIT_NS }, NULL);
+	}
+}
+
+/**
+ * @brief Extracts an archive into a session of MDF CAN bus logs.
+ * @param archivePath The path of the archive.
+ * @param logDirectory The directory to create the session in.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int extractArchive (const char* archivePath, const char* logDirectory)
+{
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+
+	mdfCanBusArchiveReader_t reader;
+	if (mdfCanBusArchiveReaderInit (&reader, archivePath) != 0)
+		return errorPrintf ("Failed to open archive '%s'", archivePath);
+
+	// Don't overwrite an existing session.
+	char* sessionDirectory;
+	if (asprintf (&sessionDirectory, "%s/session_%"PRIu32, logDirectory, reader.sessionNumber) < 0)
+	{
+		mdfCanBusArchiveReaderClose (&reader);
+		return errorPrintf ("Failed to extract archive");
+	}
+
+	struct stat sessionStat;
+	if (stat (sessionDirectory, &sessionStat) == 0)
+	{
+		fprintf (stderr, "Session '%s' already exists.\n", sessionDirectory);
+		free (sessionDirectory);
+		mdfCanBusArchiveReaderClose (&reader);
+		return -1;
+	}
+
+	mdfCanBusLogConfig_t config =
+	{
+		.directory			= logDirectory,
+		.configurationName	= "",
+		.softwareName		= ZRE_CANTOOLS_NAME,
+		.softwareVersion	= ZRE_CANTOOLS_VERSION_FULL,
+		.softwareVendor		= "ZRE",
+		.hardwareName		= "",
+		.hardwareVersion	= "",
+		.serialNumber		= "",
+		.sessionNumber		= reader.sessionNumber,
+		.dateStart			= reader.startTimeNs / 1000000000,
+		.compress			= compress
+	};
+
+	mdfCanBusLog_t log;
+	if (mdfCanBusLogInit (&log, &config) != 0)
+	{
+		free (sessionDirectory);
+		mdfCanBusArchiveReaderClose (&reader);
+		return errorPrintf ("Failed to create session in '%s'", logDirectory);
+	}
+
+	// The log starts in split 0, further splits are started as the archive's blocks move into them.
+	uint32_t splitNumber = 0;
+	uint64_t recordCount = 0;
+	mdfCanBusRecord_t records [READ_BATCH_SIZE];
+	size_t count;
+	int code;
+	while ((code = mdfCanBusArchiveReaderRead (&reader, records, READ_BATCH_SIZE, &count)) == 0 && count != 0)
+	{
+		if (reader.splitNumber != splitNumber)
+		{
+			splitNumber = reader.splitNumber;
+			if ((code = mdfCanBusLogSplit (&log)) != 0)
+				break;
+		}
+
+		for (size_t index = 0; index < count && code == 0; ++index)
+			code = writeRecord (&log, &records [index]);
+		if (code != 0)
+			break;
+
+		recordCount += count;
+	}
+
+	if (code != 0)
+	{
+		errno = code;
+		errorPrintf ("Failed to extract archive '%s'", archivePath);
+	}
+
+	if (mdfCanBusLogClose (&log) != 0 && code == 0)
+		code = errorPrintf ("Failed to close session '%s'", sessionDirectory);
+
+	mdfCanBusArchiveReaderClose (&reader);
+
+	if (code == 0)
+	{
+		struct timespec timeEnd;
+		clock_gettime (CLOCK_MONOTONIC, &timeEnd);
+		struct timespec timeElapsed = timespecSub (&timeEnd, &timeStart);
+
+		printf ("Extracted %"PRIu64" records into '%s' in %.3f s.\n", recordCount, sessionDirectory,
+			timespecToNs (&timeElapsed) / 1e9);
+	}
+
+	free (sessionDirectory);
+	return code;
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	// Debug initialization
+	debugInit ();
+
+	// Handle program options
+	if (handleOptions (&argc, &argv, &(handleOptionsParams_t)
+	{
+		.fprintHelp		= fprintHelp,
+		.stringHandlers	= (optionStringCallback_t* []) { handleExtract, handleVerify, handleCompress, handleLevel },
+		.strings		= (char* []) { "extract", "verify", "compress", "level" },
+		.stringCount	= 4
+	}) != 0)
+		return errorPrintf ("Failed to handle options");
+
+	// Validate usage
+	if (argc != 2 || level < 0 || level > 9)
+	{
+		fprintUsage (stderr);
+		return -1;
+	}
+
+	if (extract)
+		return extractArchive (argv [0], argv [1]);
+
+	return createArchive (argv [0], argv [1]);
+}
@@ -0,0 +1,627 @@
+// MDF Catalog ----------------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: See help page.
+
+// For asprintf. Note this must be the first include in this file.
+#define _GNU_SOURCE
+#include <stdio.h>
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "can_database/can_dbc.h"
+#include "debug.h"
+#include "error_codes.h"
+#include "mdf/mdf_catalog.h"
+#include "options.h"
+
+// POSIX
+#include <dirent.h>
+#include <sys/stat.h>
+
+// C Standard Library
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	CONDITION_GREATER_EQUAL,
+	CONDITION_LESS_EQUAL,
+	CONDITION_EQUAL,
+	CONDITION_NOT_EQUAL,
+	CONDITION_GREATER,
+	CONDITION_LESS
+} conditionOperator_t;
+
+// Globals --------------------------------------------------------------------------------------------------------------------
+
+/// @brief Indicates the catalog should be brought up to date before it is queried.
+bool build = false;
+
+/// @brief Indicates every split should be re-cataloged, rather than only new or modified ones.
+bool rebuild = false;
+
+/// @brief Indicates the matching splits of each session should be listed.
+bool listSplits = false;
+
+/// @brief The DBC file defining the signals to summarize when building, if any.
+char* dbcPath = NULL;
+
+/// @brief The CAN ID to filter by, if any.
+bool idFilter = false;
+uint32_t filterId;
+
+/// @brief Indicates only splits containing error frames match.
+bool errorFilter = false;
+
+/// @brief The signal condition to filter by, if any.
+char* signalCondition = NULL;
+char* conditionSignal;
+conditionOperator_t conditionOperator;
+float conditionValue;
+
+/// @brief The messages and signals of the DBC file, if any.
+canMessage_t* messages = NULL;
+size_t messageCount = 0;
+canSignal_t* signals = NULL;
+size_t signalCount = 0;
+
+/// @brief The names of the DBC file's signals ('Message.Signal').
+char** signalNames = NULL;
+
+/// @brief Lookup table from CAN ID to DBC message. The size is a power of 2, empty slots are @c NULL .
+canMessage_t** messageTable = NULL;
+size_t messageTableSize = 0;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void handleBuild (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+
+	build = true;
+}
+
+void handleRebuild (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+
+	build = true;
+	rebuild = true;
+}
+
+void handleSplits (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+
+	listSplits = true;
+}
+
+void handleDbc (char* option, char* value)
+{
+	(void) option;
+	dbcPath = value;
+}
+
+void handleId (char* option, char* value)
+{
+	(void) option;
+	if (value == NULL)
+		return;
+
+	// An 'x' suffix indicates an extended ID.
+	char* end;
+	filterId = strtoul (value, &end, 0);
+	if (*end == 'x' || *end == 'X')
+	{
+		filterId |= MDF_CATALOG_ID_IDE;
+		++end;
+	}
+
+	if (end == value || *end != '\0')
+	{
+		fprintf (stderr, "Invalid CAN ID '%s'.\n", value);
+		exit (-1);
+	}
+
+	idFilter = true;
+}
+
+void handleErrors (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+
+	errorFilter = true;
+}
+
+void handleSignal (char* option, char* value)
+{
+	(void) option;
+	signalCondition = value;
+}
+
+void fprintUsage (FILE* stream)
+{
+	fprintf (stream, "Usage:\n"
+		"    mdf-catalog <Options> <MDF Directory>\n");
+}
+
+void fprintHelp (FILE* stream)
+{
+	fprintf (stream, ""
+		"mdf-catalog - Searches the sessions of an MDF directory using its catalog,\n"
+		"              without opening any of the sessions' splits. The catalog\n"
+		"              summarizes each split's time range, the number of frames of\n"
+		"              each CAN ID, the number of error frames, and optionally the\n"
+		"              range of each signal of a DBC file. It is maintained by\n"
+		"              can-mdf-logger (see its 'catalog' key), or built from existing\n"
+		"              sessions by this application.\n\n");
+
+	fprintUsage (stream);
+
+	fprintf (stream, "\nParameters:\n\n");
+	fprintf (stream, ""
+		"    <MDF Directory>       - The directory containing the sessions (ex. logs).\n\n");
+
+	fprintf (stream, ""
+		"Options:\n\n"
+		"    --build               - Brings the catalog up to date before querying it.\n"
+		"                            Splits that are new, or have been modified (ex.\n"
+		"                            recovered or compressed), are read and cataloged.\n"
+		"                            Entries of deleted splits are removed.\n"
+		"    --rebuild             - Same as '--build', but re-catalogs every split.\n"
+		"    --dbc=<DBC File>      - When building, summarizes the range of each of the\n"
+		"                            DBC file's signals.\n"
+		"    --id=<CAN ID>         - Matches splits containing frames of the CAN ID.\n"
+		"                            Suffix the ID with 'x' if it is extended (ex.\n"
+		"                            '--id=0x18FF50E5x').\n"
+		"    --errors              - Matches splits containing error frames.\n"
+		"    --signal=<Condition>  - Matches splits where a signal's range satisfies a\n"
+		"                            condition. The condition is of the form\n"
+		"                            '<Signal><Operator><Value>', where the signal is\n"
+		"                            either 'Signal' or 'Message.Signal', and the\n"
+		"                            operator is one of '>=', '<=', '==', '!=', '>' or\n"
+		"                            '<' (ex. '--signal=\"BMS_FAULT>=1\"'). '==' matches\n"
+		"                            if the range includes the value, the others match if\n"
+		"                            any value of the range could satisfy them.\n"
+		"    --splits              - Lists the matching splits of each session.\n"
+		"\n"
+		"    Sessions with at least one matching split are listed. Without any filter,\n"
+		"    every cataloged session is listed.\n"
+		"\n");
+	fprintOptionHelp (stream, "    ");
+}
+
+/**
+ * @brief Parses the signal condition.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int parseSignalCondition (void)
+{
+	static const char* OPERATORS [] = { ">=", "<=", "==", "!=", ">", "<" };
+
+	// Split the condition at its operator.
+	size_t nameLength = strcspn (signalCondition, "<>=!");
+	char* operatorString = signalCondition + nameLength;
+	size_t operatorLength = 0;
+	for (size_t index = 0; index < sizeof (OPERATORS) / sizeof (OPERATORS [0]); ++index)
+	{
+		size_t length = strlen (OPERATORS [index]);
+		if (strncmp (operatorString, OPERATORS [index], length) == 0)
+		{
+			conditionOperator = index;
+			operatorLength = length;
+			break;
+		}
+	}
+
+	char* end;
+	conditionValue = strtof (operatorString + operatorLength, &end);
+	if (nameLength == 0 || operatorLength == 0 || end == operatorString + operatorLength || *end != '\0')
+	{
+		fprintf (stderr, "Invalid signal condition '%s'.\n", signalCondition);
+		errno = EINVAL;
+		return errno;
+	}
+
+	conditionSignal = strndup (signalCondition, nameLength);
+	return conditionSignal != NULL ? 0 : errno;
+}
+
+/**
+ * @brief Builds the lookup table from CAN ID to DBC message, along with the names of the DBC file's signals.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int buildMessageTable (void)
+{
+	// Use a power of 2 at least twice the number of messages, so the table is at most half full.
+	messageTableSize = 16;
+	while (messageTableSize < messageCount * 2)
+		messageTableSize *= 2;
+
+	messageTable = calloc (messageTableSize, sizeof (canMessage_t*));
+	signalNames = calloc (signalCount, sizeof (char*));
+	if (messageTable == NULL || signalNames == NULL)
+		return errno;
+
+	for (size_t index = 0; index < messageCount; ++index)
+	{
+		canMessage_t* message = &messages [index];
+		size_t slot = message->id & (messageTableSize - 1);
+		while (messageTable [slot] != NULL && (messageTable [slot]->id != message->id || messageTable [slot]->ide != message->ide))
+			slot = (slot + 1) & (messageTableSize - 1);
+
+		// If the DBC file defines the same message twice, the first takes precedence.
+		if (messageTable [slot] == NULL)
+			messageTable [slot] = message;
+
+		for (size_t signalIndex = 0; signalIndex < message->signalCount; ++signalIndex)
+		{
+			canSignal_t* signal = &message->signals [signalIndex];
+			if (asprintf (&signalNames [signal - signals], "%s.%s", message->name, signal->name) < 0)
+				return errno;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Catalog signal callback, decoding the DBC signals of a data frame. See @c mdfCatalogSignalCallback_t .
+ */
+static void summarizeSignals (mdfCatalogBuilder_t* builder, const mdfCanBusRecord_t* record, void* arg)
+{
+	(void) arg;
+
+	if (record->type != MDF_CAN_BUS_RECORD_DATA_FRAME)
+		return;
+
+	size_t slot = record->id & (messageTableSize - 1);
+	while (messageTable [slot] != NULL && (messageTable [slot]->id != record->id || messageTable [slot]->ide != record->ide))
+		slot = (slot + 1) & (messageTableSize - 1);
+
+	canMessage_t* message = messageTable [slot];
+	if (message == NULL)
+		return;
+
+	uint64_t payload = 0;
+	memcpy (&payload, record->data, record->dlc < sizeof (payload) ? record->dlc : sizeof (payload));
+	for (size_t index = 0; index < message->signalCount; ++index)
+	{
+		canSignal_t* signal = &message->signals [index];
+		mdfCatalogBuilderUpdateSignal (builder, signal - signals, signalDecode (signal, payload));
+	}
+}
+
+static int compareSessionNumbers (const void* a, const void* b)
+{
+	uint32_t numberA = *(const uint32_t*) a;
+	uint32_t numberB = *(const uint32_t*) b;
+	return (numberA > numberB) - (numberA < numberB);
+}
+
+/**
+ * @brief Lists the sessions of an MDF directory.
+ * @param directory The MDF directory.
+ * @param sessionNumbers Written to the numbers of the sessions, in ascending order. Must be freed.
+ * @param sessionCount Written to the number of sessions.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int listSessions (const char* directory, uint32_t** sessionNumbers, size_t* sessionCount)
+{
+	*sessionNumbers = NULL;
+	*sessionCount = 0;
+
+	DIR* dir = opendir (directory);
+	if (dir == NULL)
+		return errno;
+
+	struct dirent* ent;
+	while ((ent = readdir (dir)) != NULL)
+	{
+		uint32_t number;
+		char end;
+		if (sscanf (ent->d_name, "session_%"SCNu32"%c", &number, &end) != 1)
+			continue;
+
+		uint32_t* numbers = realloc (*sessionNumbers, sizeof (uint32_t) * (*sessionCount + 1));
+		if (numbers == NULL)
+		{
+			int code = errno;
+			closedir (dir);
+			free (*sessionNumbers);
+			errno = code;
+			return code;
+		}
+
+		*sessionNumbers = numbers;
+		numbers [*sessionCount] = number;
+		++*sessionCount;
+	}
+
+	closedir (dir);
+
+	qsort (*sessionNumbers, *sessionCount, sizeof (uint32_t), compareSessionNumbers);
+	return 0;
+}
+
+/**
+ * @brief Brings a catalog up to date with the splits of an MDF directory, then writes it.
+ * @param catalog The catalog to update.
+ * @param directory The MDF directory.
+ * @param builder The builder to catalog splits with.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int buildCatalog (mdfCatalog_t* catalog, const char* directory, mdfCatalogBuilder_t* builder)
+{
+	uint32_t* sessionNumbers;
+	size_t sessionCount;
+	if (listSessions (directory, &sessionNumbers, &sessionCount) != 0)
+		return errno;
+
+	// Build a new catalog, so entries of deleted splits are dropped.
+	mdfCatalog_t updated = {0};
+	size_t catalogedCount = 0;
+	int code = 0;
+	for (size_t sessionIndex = 0; sessionIndex < sessionCount && code == 0; ++sessionIndex)
+	{
+		uint32_t sessionNumber = sessionNumbers [sessionIndex];
+
+		// The session ends at its first missing split.
+		for (uint32_t splitNumber = 0; code == 0; ++splitNumber)
+		{
+			char* path;
+			if (asprintf (&path, "%s/session_%"PRIu32"/split_%"PRIu32".mf4", directory, sessionNumber, splitNumber) < 0)
+			{
+				code = errno;
+				break;
+			}
+
+			struct stat fileStat;
+			if (stat (path, &fileStat) != 0)
+			{
+				free (path);
+				break;
+			}
+
+			// Only re-catalog splits whose size has changed.
+			const mdfCatalogEntry_t* entry = mdfCatalogFind (catalog, sessionNumber, splitNumber);
+			if (rebuild || entry == NULL || entry->fileSize != (uint64_t) fileStat.st_size)
+			{
+				if (mdfCatalogBuilderReadSplit (builder, path, sessionNumber, splitNumber, &entry) == 0)
+					++catalogedCount;
+				else
+				{
+					// Skip splits that cannot be read (ex. being created, or in need of recovery), keeping their previous
+					// entry, if any.
+					errorPrintf ("Warning, failed to catalog '%s'", path);
+					entry = mdfCatalogFind (catalog, sessionNumber, splitNumber);
+				}
+			}
+
+			free (path);
+			if (entry != NULL)
+				code = mdfCatalogInsert (&updated, entry);
+		}
+	}
+
+	free (sessionNumbers);
+
+	if (code == 0)
+		code = mdfCatalogWrite (&updated, directory);
+
+	if (code != 0)
+	{
+		mdfCatalogDealloc (&updated);
+		errno = code;
+		return code;
+	}
+
+	fprintf (stderr, "Cataloged %lu splits, %lu entries total.\n", (unsigned long) catalogedCount,
+		(unsigned long) updated.entryCount);
+
+	mdfCatalogDealloc (catalog);
+	*catalog = updated;
+	return 0;
+}
+
+/**
+ * @brief Checks whether a split matches the filters.
+ * @param entry The entry of the split.
+ * @return True if the split matches, false otherwise.
+ */
+static bool matchEntry (const mdfCatalogEntry_t* entry)
+{
+	if (idFilter && mdfCatalogEntryGetIdCount (entry, filterId) == 0)
+		return false;
+
+	if (errorFilter && entry->errorFrameCount == 0)
+		return false;
+
+	if (signalCondition != NULL)
+	{
+		const mdfCatalogSignal_t* signal = mdfCatalogEntryGetSignal (entry, conditionSignal);
+		if (signal == NULL)
+			return false;
+
+		switch (conditionOperator)
+		{
+		case CONDITION_GREATER_EQUAL:
+			return signal->max >= conditionValue;
+		case CONDITION_LESS_EQUAL:
+			return signal->min <= conditionValue;
+		case CONDITION_EQUAL:
+			return signal->min <= conditionValue && signal->max >= conditionValue;
+		case CONDITION_NOT_EQUAL:
+			return signal->min != conditionValue || signal->max != conditionValue;
+		case CONDITION_GREATER:
+			return signal->max > conditionValue;
+		default:
+			return signal->min < conditionValue;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Prints a split of a matching session.
+ * @param entry The entry of the split.
+ */
+static void printSplit (const mdfCatalogEntry_t* entry)
+{
+	printf ("    split_%"PRIu32": %9.3f s - %9.3f s, %"PRIu64" frames, %"PRIu64" error frames", entry->splitNumber,
+		entry->firstTimestampNs / 1e9, entry->lastTimestampNs / 1e9, entry->recordCount - entry->errorFrameCount,
+		entry->errorFrameCount);
+
+	if (idFilter)
+		printf (", %"PRIu32" frames of ID", mdfCatalogEntryGetIdCount (entry, filterId));
+
+	const mdfCatalogSignal_t* signal = signalCondition != NULL ? mdfCatalogEntryGetSignal (entry, conditionSignal) : NULL;
+	if (signal != NULL)
+		printf (", %s: [%g, %g]", signal->name, signal->min, signal->max);
+
+	printf ("\n");
+}
+
+/**
+ * @brief Prints the sessions of a catalog with at least one matching split.
+ * @param catalog The catalog to query.
+ * @return The number of matching sessions.
+ */
+static size_t querySessions (const mdfCatalog_t* catalog)
+{
+	size_t matchCount = 0;
+
+	// Entries are ordered by session, so each session is a contiguous run of them.
+	for (size_t start = 0; start < catalog->entryCount;)
+	{
+		size_t end = start;
+		while (end < catalog->entryCount && catalog->entries [end].sessionNumber == catalog->entries [start].sessionNumber)
+			++end;
+
+		uint64_t frameCount = 0;
+		uint64_t errorFrameCount = 0;
+		uint64_t firstTimestampNs = UINT64_MAX;
+		uint64_t lastTimestampNs = 0;
+		size_t splitMatchCount = 0;
+		for (size_t index = start; index < end; ++index)
+		{
+			const mdfCatalogEntry_t* entry = &catalog->entries [index];
+			frameCount += entry->recordCount - entry->errorFrameCount;
+			errorFrameCount += entry->errorFrameCount;
+			if (entry->recordCount != 0 && entry->firstTimestampNs < firstTimestampNs)
+				firstTimestampNs = entry->firstTimestampNs;
+			if (entry->recordCount != 0 && entry->lastTimestampNs > lastTimestampNs)
+				lastTimestampNs = entry->lastTimestampNs;
+			if (matchEntry (entry))
+				++splitMatchCount;
+		}
+
+		if (splitMatchCount != 0)
+		{
+			++matchCount;
+
+			uint64_t durationNs = lastTimestampNs > firstTimestampNs ? lastTimestampNs - firstTimestampNs : 0;
+
+			char date [32] = "unknown date";
+			time_t startTime = catalog->entries [start].startTimeNs / 1000000000;
+			struct tm* startTm = localtime (&startTime);
+			if (startTm != NULL)
+				strftime (date, sizeof (date), "%Y-%m-%d %H:%M:%S", startTm);
+
+			printf ("session_%"PRIu32": %s, %.1f s, %lu splits (%lu matching), %"PRIu64" frames, %"PRIu64" error frames\n",
+				catalog->entries [start].sessionNumber, date, durationNs / 1e9, (unsigned long) (end - start),
+				(unsigned long) splitMatchCount, frameCount, errorFrameCount);
+
+			if (listSplits)
+				for (size_t index = start; index < end; ++index)
+					if (matchEntry (&catalog->entries [index]))
+						printSplit (&catalog->entries [index]);
+		}
+
+		start = end;
+	}
+
+	return matchCount;
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	// Debug initialization
+	debugInit ();
+
+	// Handle program options
+	if (handleOptions (&argc, &argv, &(handleOptionsParams_t)
+	{
+		.fprintHelp		= fprintHelp,
+		.stringHandlers	= (optionStringCallback_t* []) { handleBuild, handleRebuild, handleSplits, handleDbc, handleId,
+			handleErrors, handleSignal },
+		.strings		= (char* []) { "build", "rebuild", "splits", "dbc", "id", "errors", "signal" },
+		.stringCount	= 7
+	}) != 0)
+		return errorPrintf ("Failed to handle options");
+
+	// Validate usage
+	if (argc != 1 || (dbcPath != NULL && !build))
+	{
+		fprintUsage (stderr);
+		return -1;
+	}
+
+	char* directory = argv [0];
+
+	if (signalCondition != NULL && parseSignalCondition () != 0)
+		return errorPrintf ("Failed to parse signal condition");
+
+	mdfCatalog_t catalog;
+	if (mdfCatalogLoad (&catalog, directory) != 0)
+	{
+		// A malformed catalog can only be rebuilt.
+		if (errno != ERRNO_MDF_CATALOG_MALFORMED || !rebuild)
+			return errorPrintf ("Failed to load catalog of '%s'", directory);
+		catalog = (mdfCatalog_t) {0};
+	}
+
+	if (build)
+	{
+		if (dbcPath != NULL)
+		{
+			if (canDbcLoad (dbcPath, &messages, &messageCount, &signals, &signalCount) != 0)
+				return errorPrintf ("Failed to load DBC file '%s'", dbcPath);
+
+			if (buildMessageTable () != 0)
+				return errorPrintf ("Failed to build DBC message table");
+		}
+
+		mdfCatalogBuilder_t builder;
+		if (mdfCatalogBuilderInit (&builder, (const char* const*) signalNames, signalCount,
+			dbcPath != NULL ? summarizeSignals : NULL, NULL) != 0)
+			return errorPrintf ("Failed to initialize catalog builder");
+
+		if (buildCatalog (&catalog, directory, &builder) != 0)
+			return errorPrintf ("Failed to build catalog of '%s'", directory);
+
+		mdfCatalogBuilderDealloc (&builder);
+	}
+
+	size_t matchCount = querySessions (&catalog);
+	fprintf (stderr, "%lu matching sessions.\n", (unsigned long) matchCount);
+
+	mdfCatalogDealloc (&catalog);
+	return 0;
+}
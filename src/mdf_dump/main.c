@@ -351,8 +351,32 @@ int main (int argc, char** argv)
 			return errorPrintf ("Failed to read MDF block data section");
 
 		size_t dataSectionSize = mdfBlockDataSectionSize (&block);
-		for (size_t index = 0; index < dataSectionSize; ++index)
-			dataSectionByteHandler (&block, ((uint8_t*) block.dataSection) [index], &dataSectionByteArg);
+		if (block.header.blockId == MDF_BLOCK_ID_DZ)
+		{
+			// Compressed data block, decompress the data and interpret it as the original block type.
+			mdfDzDataSection_t* dzDataSection = mdfDzBlockDataSection (&block);
+			printf ("(Original block type = %.2s) | (Zip type = %u) | (Zip parameter = %"PRIu32") | (Original length = %"PRIu64") "
+				"| (Compressed length = %"PRIu64")\n\n", dzDataSection->originalBlockType, dzDataSection->zipType,
+				dzDataSection->zipParameter, dzDataSection->originalDataLength, dzDataSection->dataLength);
+
+			uint8_t* data;
+			size_t dataSize;
+			if (mdfDzBlockInflate (&block, &data, &dataSize) != 0)
+				return errorPrintf ("Failed to decompress MDF compressed data block");
+
+			mdfBlock_t originalBlock = block;
+			originalBlock.header.blockId = MDF_BLOCK_ID_STR_TO_VALUE ('#', '#', dzDataSection->originalBlockType [0],
+				dzDataSection->originalBlockType [1]);
+			for (size_t index = 0; index < dataSize; ++index)
+				dataSectionByteHandler (&originalBlock, data [index], &dataSectionByteArg);
+
+			free (data);
+		}
+		else
+		{
+			for (size_t index = 0; index < dataSectionSize; ++index)
+				dataSectionByteHandler (&block, ((uint8_t*) block.dataSection) [index], &dataSectionByteArg);
+		}
 
 		if (dataSectionSize == 0)
 		{
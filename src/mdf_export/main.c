@@ -0,0 +1,988 @@
+// MDF Export -----------------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: See help page.
+//
+// Columnar File Format:
+//   All values are little endian. The file starts with a header:
+//     char magic [8]            - "ZRECOL01"
+//     uint32_t columnCount      - The number of signal columns (excluding the timestamp).
+//     uint32_t reserved         - 0
+//   Followed by the description of each column:
+//     uint16_t nameLength, char name [nameLength]  - The name of the column ("Message.Signal").
+//     uint16_t unitLength, char unit [unitLength]  - The unit of the column.
+//   Followed by row groups, until the end of the file:
+//     uint32_t rowCount         - The number of rows in the group.
+//     uint32_t reserved         - 0
+//     uint64_t timestamps [rowCount]               - The timestamp of each row, relative to the start of the session, in ns.
+//     float values [columnCount][rowCount]         - The values of each column. NaN indicates a row has no value.
+
+// For asprintf. Note this must be the first include in this file.
+#define _GNU_SOURCE
+#include <stdio.h>
+
+// Includes
+#include "can_database/can_dbc.h"
+#include "debug.h"
+#include "mdf/mdf_can_bus_session_reader.h"
+#include "options.h"
+#include "time_port.h"
+
+// POSIX
+#include <pthread.h>
+#include <unistd.h>
+
+// C Standard Library
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of records read from the session at once.
+#define READ_BATCH_SIZE 4096
+
+/// @brief The number of records in each chunk handed to a formatting thread.
+#define CHUNK_SIZE 65536
+
+/// @brief The number of chunks in flight per formatting thread.
+#define CHUNKS_PER_THREAD 2
+
+/// @brief The maximum number of DBC files.
+#define DBC_COUNT_MAX 16
+
+/// @brief The size of the output file's buffer, in bytes.
+#define OUTPUT_BUFFER_SIZE (1 << 22)
+
+/// @brief The identification string of a columnar file. Note this string is not null-terminated.
+#define COLUMNAR_MAGIC {'Z', 'R', 'E', 'C', 'O', 'L', '0', '1'}
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	FORMAT_CSV		= 0,
+	FORMAT_COLUMNAR	= 1
+} format_t;
+
+/// @brief A selected signal, that is, a column of the output.
+typedef struct
+{
+	canSignal_t* signal;
+	size_t column;
+} column_t;
+
+/// @brief A message with at least one selected signal.
+typedef struct
+{
+	canMessage_t* message;
+
+	/// @brief The selected signals of the message, in order of their columns.
+	column_t* columns;
+	size_t columnCount;
+} exportMessage_t;
+
+/// @brief A data frame of a selected message.
+typedef struct
+{
+	uint64_t timestampNs;
+	uint32_t messageIndex;
+	uint8_t payload [8];
+} exportRecord_t;
+
+/// @brief A chunk of records, formatted into its part of the output by a formatting thread.
+typedef struct
+{
+	exportRecord_t* records;
+	size_t recordCount;
+
+	/// @brief For resampling, the payload of each message before the first record of the chunk.
+	uint64_t* payloads;
+
+	/// @brief For resampling, indicates the respective element of @c payloads has been received.
+	bool* payloadsValid;
+
+	/// @brief For resampling, the first grid point of the chunk, relative to the start of the session, in nanoseconds.
+	uint64_t gridNs;
+
+	/// @brief Indicates this is the last chunk of the output.
+	bool last;
+
+	/// @brief For resampling the last chunk, the timestamp of the last record of the output, in nanoseconds. Note this may
+	/// belong to a previous chunk, if the last chunk is empty.
+	uint64_t lastNs;
+
+	/// @brief Indicates the chunk has been formatted (or formatting it failed).
+	bool done;
+
+	/// @brief If formatting the chunk failed, the error code, 0 otherwise.
+	int code;
+
+	/// @brief The formatted output of the chunk.
+	char* output;
+	size_t outputSize;
+	size_t outputCapacity;
+
+	/// @brief The timestamp and values of each row, for columnar output.
+	uint64_t* rowTimestamps;
+	float* rowValues;
+	size_t rowCount;
+	size_t rowCapacity;
+} chunk_t;
+
+// Globals --------------------------------------------------------------------------------------------------------------------
+
+/// @brief The paths of the DBC files.
+char* dbcPaths [DBC_COUNT_MAX];
+size_t dbcCount = 0;
+
+/// @brief The names of the selected signals, empty to select every signal.
+char** signalNames = NULL;
+size_t signalNameCount = 0;
+
+/// @brief The format of the output.
+format_t format = FORMAT_CSV;
+
+/// @brief The period to resample the signals with, in nanoseconds. 0 to not resample.
+uint64_t resamplePeriodNs = 0;
+
+/// @brief The number of threads decoding records, and the number formatting the output. 0 to use one per CPU.
+unsigned long threadCount = 0;
+
+/// @brief The messages and signals of the DBC files.
+canMessage_t* messages;
+size_t messageCount;
+canSignal_t* signals;
+size_t signalCount;
+
+/// @brief The messages with selected signals.
+exportMessage_t* exportMessages = NULL;
+size_t exportMessageCount = 0;
+
+/// @brief The selected signals, in order of their columns.
+canSignal_t** columnSignals = NULL;
+size_t columnCount = 0;
+
+/// @brief Lookup table from CAN ID to export message index, see @c findExportMessage .
+int32_t* messageTable = NULL;
+uint64_t* messageTableKeys = NULL;
+size_t messageTableSize = 0;
+
+/// @brief The chunks in flight. The chunk of sequence number N is stored at index N modulo @c chunkCount .
+chunk_t* chunks;
+size_t chunkCount;
+
+/// @brief The number of chunks submitted for formatting.
+size_t chunksSubmitted = 0;
+
+/// @brief The sequence number of the next chunk to format.
+size_t chunksFormatted = 0;
+
+/// @brief Indicates no more chunks will be submitted.
+bool submitDone = false;
+
+pthread_mutex_t chunkMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/// @brief Signalled when a chunk is submitted (or no more will be).
+pthread_cond_t chunkSubmitted = PTHREAD_COND_INITIALIZER;
+
+/// @brief Signalled when a chunk is done being formatted.
+pthread_cond_t chunkDone = PTHREAD_COND_INITIALIZER;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void handleThreads (char option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		threadCount = strtoul (value, NULL, 0);
+}
+
+void handleDbc (char* option, char* value)
+{
+	(void) option;
+	if (value == NULL)
+		return;
+
+	if (dbcCount == DBC_COUNT_MAX)
+	{
+		fprintf (stderr, "Too many DBC files, at most %u are supported.\n", DBC_COUNT_MAX);
+		exit (-1);
+	}
+
+	dbcPaths [dbcCount] = value;
+	++dbcCount;
+}
+
+void handleSignal (char* option, char* value)
+{
+	(void) option;
+	if (value == NULL)
+		return;
+
+	char** names = realloc (signalNames, sizeof (char*) * (signalNameCount + 1));
+	if (names == NULL)
+	{
+		errorPrintf ("Failed to allocate signal list");
+		exit (errno);
+	}
+
+	signalNames = names;
+	signalNames [signalNameCount] = value;
+	++signalNameCount;
+}
+
+void handleFormat (char* option, char* value)
+{
+	(void) option;
+	if (value != NULL && strcmp (value, "csv") == 0)
+		format = FORMAT_CSV;
+	else if (value != NULL && strcmp (value, "columnar") == 0)
+		format = FORMAT_COLUMNAR;
+	else
+	{
+		fprintf (stderr, "Invalid format '%s'.\n", value != NULL ? value : "");
+		exit (-1);
+	}
+}
+
+void handleResample (char* option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		resamplePeriodNs = strtod (value, NULL) * 1e9;
+}
+
+void fprintUsage (FILE* stream)
+{
+	fprintf (stream, "Usage:\n"
+		"    mdf-export <Options> --dbc=<DBC File> <Session Directory> <Output File>\n");
+}
+
+void fprintHelp (FILE* stream)
+{
+	fprintf (stream, ""
+		"mdf-export - Decodes the signals of an MDF CAN bus log session using one or\n"
+		"             more DBC files, then exports them as CSV or as a compact binary\n"
+		"             columnar file. The splits of the session are decoded in\n"
+		"             parallel, as is the formatting of the output.\n\n");
+
+	fprintUsage (stream);
+
+	fprintf (stream, "\nParameters:\n\n");
+	fprintf (stream, ""
+		"    <Session Directory>   - The session to export (ex. logs/session_3).\n"
+		"    <Output File>         - The file to write, '-' for standard output.\n\n");
+
+	fprintf (stream, ""
+		"Options:\n\n"
+		"    --dbc=<Path>          - A DBC file to decode messages with. May be given\n"
+		"                            multiple times. Applies to every bus of the log.\n"
+		"    --signal=<Name>       - Exports a signal, either by its name or as\n"
+		"                            <Message>.<Signal>. May be given multiple times,\n"
+		"                            each becoming a column in the given order. If not\n"
+		"                            specified, every signal is exported.\n"
+		"    --format=<Format>     - The format of the output, either 'csv' (default) or\n"
+		"                            'columnar'. See the source of this application for\n"
+		"                            the columnar format.\n"
+		"    --resample=<Period>   - Resamples the signals onto a fixed time grid, in\n"
+		"                            seconds. Each row holds the latest value of every\n"
+		"                            signal. If not specified, each row is a received\n"
+		"                            message, holding only the values of its signals.\n"
+		"    -j=<Count>            - The number of threads decoding the log, and the\n"
+		"                            number formatting the output. Defaults to the\n"
+		"                            number of CPUs.\n"
+		"\n");
+	fprintOptionHelp (stream, "    ");
+}
+
+// Signal Selection -----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Checks whether a signal matches a name given by the user, either '<Signal>' or '<Message>.<Signal>'.
+ */
+static bool signalMatches (canSignal_t* signal, const char* name)
+{
+	if (strcmp (signal->name, name) == 0)
+		return true;
+
+	size_t messageNameLength = strlen (signal->message->name);
+	return strncmp (name, signal->message->name, messageNameLength) == 0 && name [messageNameLength] == '.' &&
+		strcmp (name + messageNameLength + 1, signal->name) == 0;
+}
+
+/**
+ * @brief Adds a signal to the columns of the output.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int selectSignal (canSignal_t* signal)
+{
+	// Find (or add) the signal's message.
+	exportMessage_t* exportMessage = NULL;
+	for (size_t index = 0; index < exportMessageCount; ++index)
+		if (exportMessages [index].message == signal->message)
+			exportMessage = &exportMessages [index];
+
+	if (exportMessage == NULL)
+	{
+		exportMessage_t* reallocated = realloc (exportMessages, sizeof (exportMessage_t) * (exportMessageCount + 1));
+		if (reallocated == NULL)
+			return errno;
+
+		exportMessages = reallocated;
+		exportMessage = &exportMessages [exportMessageCount];
+		++exportMessageCount;
+		*exportMessage = (exportMessage_t)
+		{
+			.message = signal->message
+		};
+	}
+
+	column_t* columns = realloc (exportMessage->columns, sizeof (column_t) * (exportMessage->columnCount + 1));
+	canSignal_t** reallocatedSignals = realloc (columnSignals, sizeof (canSignal_t*) * (columnCount + 1));
+	if (columns != NULL)
+		exportMessage->columns = columns;
+	if (reallocatedSignals != NULL)
+		columnSignals = reallocatedSignals;
+	if (columns == NULL || reallocatedSignals == NULL)
+		return errno;
+
+	exportMessage->columns [exportMessage->columnCount] = (column_t)
+	{
+		.signal = signal,
+		.column = columnCount
+	};
+	++exportMessage->columnCount;
+
+	columnSignals [columnCount] = signal;
+	++columnCount;
+	return 0;
+}
+
+/**
+ * @brief Selects the signals to export, based on the user's selection.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int selectSignals (void)
+{
+	if (signalNameCount == 0)
+	{
+		for (size_t index = 0; index < signalCount; ++index)
+			if (selectSignal (&signals [index]) != 0)
+				return errno;
+
+		return 0;
+	}
+
+	for (size_t nameIndex = 0; nameIndex < signalNameCount; ++nameIndex)
+	{
+		bool found = false;
+		for (size_t index = 0; index < signalCount; ++index)
+		{
+			if (!signalMatches (&signals [index], signalNames [nameIndex]))
+				continue;
+
+			if (selectSignal (&signals [index]) != 0)
+				return errno;
+			found = true;
+		}
+
+		if (!found)
+		{
+			fprintf (stderr, "Signal '%s' is not present in the DBC files.\n", signalNames [nameIndex]);
+			errno = EINVAL;
+			return errno;
+		}
+	}
+
+	return 0;
+}
+
+static inline uint64_t messageKey (uint32_t id, bool ide)
+{
+	return ((uint64_t) ide << 32) | id;
+}
+
+/**
+ * @brief Builds the lookup table from CAN ID to export message.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int buildMessageTable (void)
+{
+	// Use a power of 2 at least twice the number of messages, so the table is at most half full.
+	messageTableSize = 16;
+	while (messageTableSize < exportMessageCount * 2)
+		messageTableSize *= 2;
+
+	messageTable = malloc (sizeof (int32_t) * messageTableSize);
+	messageTableKeys = malloc (sizeof (uint64_t) * messageTableSize);
+	if (messageTable == NULL || messageTableKeys == NULL)
+		return errno;
+
+	for (size_t index = 0; index < messageTableSize; ++index)
+		messageTable [index] = -1;
+
+	for (size_t index = 0; index < exportMessageCount; ++index)
+	{
+		uint64_t key = messageKey (exportMessages [index].message->id, exportMessages [index].message->ide);
+		size_t slot = key & (messageTableSize - 1);
+		while (messageTable [slot] != -1 && messageTableKeys [slot] != key)
+			slot = (slot + 1) & (messageTableSize - 1);
+
+		// If multiple DBC files define the same message, the first takes precedence.
+		if (messageTable [slot] == -1)
+		{
+			messageTable [slot] = index;
+			messageTableKeys [slot] = key;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Finds the export message of a data frame.
+ * @return The index of the export message, -1 if the frame has no selected signals.
+ */
+static inline int32_t findExportMessage (const mdfCanBusRecord_t* record)
+{
+	uint64_t key = messageKey (record->id, record->ide);
+	size_t slot = key & (messageTableSize - 1);
+	while (messageTable [slot] != -1)
+	{
+		if (messageTableKeys [slot] == key)
+			return messageTable [slot];
+		slot = (slot + 1) & (messageTableSize - 1);
+	}
+
+	return -1;
+}
+
+// Formatting -----------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Ensures a chunk's output has space for a number of additional bytes.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int reserveOutput (chunk_t* chunk, size_t size)
+{
+	if (chunk->outputSize + size <= chunk->outputCapacity)
+		return 0;
+
+	size_t capacity = chunk->outputCapacity != 0 ? chunk->outputCapacity : 65536;
+	while (capacity < chunk->outputSize + size)
+		capacity *= 2;
+
+	char* output = realloc (chunk->output, capacity);
+	if (output == NULL)
+		return errno;
+
+	chunk->output = output;
+	chunk->outputCapacity = capacity;
+	return 0;
+}
+
+/**
+ * @brief Appends a row to a chunk's output.
+ * @param chunk The chunk to append to.
+ * @param timestampNs The timestamp of the row.
+ * @param values The value of each column, NaN if the row has no value.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int appendRow (chunk_t* chunk, uint64_t timestampNs, const float* values)
+{
+	if (format == FORMAT_COLUMNAR)
+	{
+		// Rows are transposed into columns once the chunk is complete.
+		if (chunk->rowCount == chunk->rowCapacity)
+		{
+			size_t capacity = chunk->rowCapacity != 0 ? chunk->rowCapacity * 2 : CHUNK_SIZE;
+			uint64_t* timestamps = realloc (chunk->rowTimestamps, sizeof (uint64_t) * capacity);
+			if (timestamps != NULL)
+				chunk->rowTimestamps = timestamps;
+
+			float* rowValues = realloc (chunk->rowValues, sizeof (float) * columnCount * capacity);
+			if (rowValues != NULL)
+				chunk->rowValues = rowValues;
+
+			if (timestamps == NULL || rowValues == NULL)
+				return errno;
+
+			chunk->rowCapacity = capacity;
+		}
+
+		chunk->rowTimestamps [chunk->rowCount] = timestampNs;
+		memcpy (chunk->rowValues + chunk->rowCount * columnCount, values, sizeof (float) * columnCount);
+		++chunk->rowCount;
+		return 0;
+	}
+
+	// Worst case for the timestamp is 30 characters, each value is 16 (including the separator).
+	if (reserveOutput (chunk, 32 + columnCount * 16) != 0)
+		return errno;
+
+	char* output = chunk->output + chunk->outputSize;
+	output += sprintf (output, "%"PRIu64".%09"PRIu64, timestampNs / 1000000000, timestampNs % 1000000000);
+	for (size_t index = 0; index < columnCount; ++index)
+	{
+		*output = ',';
+		++output;
+
+		if (!isnan (values [index]))
+			output += sprintf (output, "%.7g", values [index]);
+	}
+	*output = '\n';
+	++output;
+
+	chunk->outputSize = output - chunk->output;
+	return 0;
+}
+
+/**
+ * @brief Decodes the selected signals of a message's payload into the column values.
+ */
+static inline void decodeMessage (const exportMessage_t* exportMessage, uint64_t payload, float* values)
+{
+	for (size_t index = 0; index < exportMessage->columnCount; ++index)
+		values [exportMessage->columns [index].column] = signalDecode (exportMessage->columns [index].signal, payload);
+}
+
+/**
+ * @brief Formats a chunk, writing its output.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int formatChunk (chunk_t* chunk, float* values)
+{
+	chunk->outputSize = 0;
+	chunk->rowCount = 0;
+
+	for (size_t index = 0; index < columnCount; ++index)
+		values [index] = NAN;
+
+	if (resamplePeriodNs == 0)
+	{
+		// Each record is a row, holding only the values of its message.
+		for (size_t index = 0; index < chunk->recordCount; ++index)
+		{
+			const exportRecord_t* record = &chunk->records [index];
+			const exportMessage_t* exportMessage = &exportMessages [record->messageIndex];
+
+			uint64_t payload;
+			memcpy (&payload, record->payload, sizeof (payload));
+			decodeMessage (exportMessage, payload, values);
+
+			if (appendRow (chunk, record->timestampNs, values) != 0)
+				return errno;
+
+			for (size_t column = 0; column < exportMessage->columnCount; ++column)
+				values [exportMessage->columns [column].column] = NAN;
+		}
+	}
+	else
+	{
+		// Start with the state of every message before the chunk.
+		for (size_t index = 0; index < exportMessageCount; ++index)
+			if (chunk->payloadsValid [index])
+				decodeMessage (&exportMessages [index], chunk->payloads [index], values);
+
+		// Each grid point holds the latest values at or before it, so is only emitted once a later record is reached.
+		uint64_t gridNs = chunk->gridNs;
+		for (size_t index = 0; index < chunk->recordCount; ++index)
+		{
+			const exportRecord_t* record = &chunk->records [index];
+			for (; gridNs < record->timestampNs; gridNs += resamplePeriodNs)
+				if (appendRow (chunk, gridNs, values) != 0)
+					return errno;
+
+			uint64_t payload;
+			memcpy (&payload, record->payload, sizeof (payload));
+			decodeMessage (&exportMessages [record->messageIndex], payload, values);
+		}
+
+		// The last chunk also emits the grid points up to the last record.
+		if (chunk->last)
+			for (; gridNs <= chunk->lastNs; gridNs += resamplePeriodNs)
+				if (appendRow (chunk, gridNs, values) != 0)
+					return errno;
+	}
+
+	if (format == FORMAT_COLUMNAR && chunk->rowCount != 0)
+	{
+		// Row group header, followed by the timestamps, then each column.
+		size_t size = sizeof (uint32_t) * 2 + chunk->rowCount * (sizeof (uint64_t) + sizeof (float) * columnCount);
+		if (reserveOutput (chunk, size) != 0)
+			return errno;
+
+		uint32_t header [2] = { chunk->rowCount, 0 };
+		memcpy (chunk->output, header, sizeof (header));
+		memcpy (chunk->output + sizeof (header), chunk->rowTimestamps, sizeof (uint64_t) * chunk->rowCount);
+
+		float* columns = (float*) (chunk->output + sizeof (header) + sizeof (uint64_t) * chunk->rowCount);
+		for (size_t row = 0; row < chunk->rowCount; ++row)
+			for (size_t column = 0; column < columnCount; ++column)
+				columns [column * chunk->rowCount + row] = chunk->rowValues [row * columnCount + column];
+
+		chunk->outputSize = size;
+	}
+
+	return 0;
+}
+
+/// @brief Thread formatting submitted chunks, in order of submission. Failures are reported to the main thread through each
+/// chunk's error code, see @c writeChunk .
+void* formatterThread (void* arg)
+{
+	(void) arg;
+
+	float* values = malloc (sizeof (float) * columnCount);
+
+	pthread_mutex_lock (&chunkMutex);
+	while (true)
+	{
+		while (chunksFormatted == chunksSubmitted && !submitDone)
+			pthread_cond_wait (&chunkSubmitted, &chunkMutex);
+
+		if (chunksFormatted == chunksSubmitted)
+			break;
+
+		chunk_t* chunk = &chunks [chunksFormatted % chunkCount];
+		++chunksFormatted;
+		pthread_mutex_unlock (&chunkMutex);
+
+		int code = values != NULL ? formatChunk (chunk, values) : ENOMEM;
+
+		pthread_mutex_lock (&chunkMutex);
+		chunk->code = code;
+		chunk->done = true;
+		pthread_cond_broadcast (&chunkDone);
+	}
+	pthread_mutex_unlock (&chunkMutex);
+
+	free (values);
+	return NULL;
+}
+
+// Output ---------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Writes the header of the output.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int writeHeader (FILE* output)
+{
+	if (format == FORMAT_CSV)
+	{
+		fprintf (output, "Time [s]");
+		for (size_t index = 0; index < columnCount; ++index)
+			fprintf (output, ",%s.%s [%s]", columnSignals [index]->message->name, columnSignals [index]->name,
+				columnSignals [index]->unit != NULL ? columnSignals [index]->unit : "");
+		fprintf (output, "\n");
+		return ferror (output) ? errno : 0;
+	}
+
+	char magic [] = COLUMNAR_MAGIC;
+	uint32_t header [2] = { columnCount, 0 };
+	if (fwrite (magic, sizeof (magic), 1, output) != 1 || fwrite (header, sizeof (header), 1, output) != 1)
+		return errno;
+
+	for (size_t index = 0; index < columnCount; ++index)
+	{
+		char* name;
+		if (asprintf (&name, "%s.%s", columnSignals [index]->message->name, columnSignals [index]->name) < 0)
+			return errno;
+
+		const char* unit = columnSignals [index]->unit != NULL ? columnSignals [index]->unit : "";
+		uint16_t nameLength = strlen (name);
+		uint16_t unitLength = strlen (unit);
+
+		bool written = fwrite (&nameLength, sizeof (nameLength), 1, output) == 1 &&
+			fwrite (name, 1, nameLength, output) == nameLength &&
+			fwrite (&unitLength, sizeof (unitLength), 1, output) == 1 &&
+			fwrite (unit, 1, unitLength, output) == unitLength;
+
+		int code = written ? 0 : errno;
+		free (name);
+		if (code != 0)
+		{
+			errno = code;
+			return code;
+		}
+	}
+
+	return ferror (output) ? errno : 0;
+}
+
+/**
+ * @brief Waits for the chunk of a sequence number to be formatted, then writes it to the output.
+ * @return 0 if successful, the error code otherwise. Note this includes the chunk failing to be formatted.
+ */
+static int writeChunk (FILE* output, size_t sequence)
+{
+	chunk_t* chunk = &chunks [sequence % chunkCount];
+
+	pthread_mutex_lock (&chunkMutex);
+	while (!chunk->done)
+		pthread_cond_wait (&chunkDone, &chunkMutex);
+	pthread_mutex_unlock (&chunkMutex);
+
+	if (chunk->code != 0)
+	{
+		errno = chunk->code;
+		return errno;
+	}
+
+	if (fwrite (chunk->output, 1, chunk->outputSize, output) != chunk->outputSize)
+		return errno;
+
+	return 0;
+}
+
+/**
+ * @brief Submits a chunk for formatting.
+ */
+static void submitChunk (void)
+{
+	pthread_mutex_lock (&chunkMutex);
+	++chunksSubmitted;
+	pthread_cond_signal (&chunkSubmitted);
+	pthread_mutex_unlock (&chunkMutex);
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	// Debug initialization
+	debugInit ();
+
+	// Handle program options
+	if (handleOptions (&argc, &argv, &(handleOptionsParams_t)
+	{
+		.fprintHelp		= fprintHelp,
+		.charHandlers	= (optionCharCallback_t* []) { handleThreads },
+		.chars			= (char []) { 'j' },
+		.charCount		= 1,
+		.stringHandlers	= (optionStringCallback_t* []) { handleDbc, handleSignal, handleFormat, handleResample },
+		.strings		= (char* []) { "dbc", "signal", "format", "resample" },
+		.stringCount	= 4
+	}) != 0)
+		return errorPrintf ("Failed to handle options");
+
+	// Validate usage
+	if (argc != 2 || dbcCount == 0)
+	{
+		fprintUsage (stderr);
+		return -1;
+	}
+
+	char* sessionDirectory = argv [0];
+	char* outputPath = argv [1];
+
+	size_t dbcMessageIndices [DBC_COUNT_MAX];
+	if (canDbcsLoad (dbcPaths, dbcCount, &messages, &messageCount, &signals, &signalCount, dbcMessageIndices) != 0)
+		return errorPrintf ("Failed to load DBC files");
+
+	if (selectSignals () != 0)
+		return errorPrintf ("Failed to select signals");
+
+	if (buildMessageTable () != 0)
+		return errorPrintf ("Failed to build message table");
+
+	if (threadCount == 0)
+	{
+		long cpuCount = sysconf (_SC_NPROCESSORS_ONLN);
+		threadCount = cpuCount > 0 ? (unsigned long) cpuCount : 1;
+	}
+
+	FILE* output = strcmp (outputPath, "-") == 0 ? stdout : fopen (outputPath, "wb");
+	if (output == NULL)
+		return errorPrintf ("Failed to open output file '%s'", outputPath);
+	setvbuf (output, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+
+	if (writeHeader (output) != 0)
+		return errorPrintf ("Failed to write output header");
+
+	// Allocate the chunks in flight.
+	chunkCount = threadCount * CHUNKS_PER_THREAD;
+	chunks = calloc (chunkCount, sizeof (chunk_t));
+	if (chunks == NULL)
+		return errorPrintf ("Failed to allocate chunks");
+
+	for (size_t index = 0; index < chunkCount; ++index)
+	{
+		chunks [index].records = malloc (sizeof (exportRecord_t) * CHUNK_SIZE);
+		chunks [index].payloads = malloc (sizeof (uint64_t) * exportMessageCount);
+		chunks [index].payloadsValid = malloc (sizeof (bool) * exportMessageCount);
+		if (chunks [index].records == NULL || chunks [index].payloads == NULL || chunks [index].payloadsValid == NULL)
+			return errorPrintf ("Failed to allocate chunks");
+	}
+
+	// The latest payload of each message, for resampling.
+	uint64_t* payloads = calloc (exportMessageCount, sizeof (uint64_t));
+	bool* payloadsValid = calloc (exportMessageCount, sizeof (bool));
+	if (payloads == NULL || payloadsValid == NULL)
+		return errorPrintf ("Failed to allocate message state");
+
+	pthread_t* threads = malloc (sizeof (pthread_t) * threadCount);
+	if (threads == NULL)
+		return errorPrintf ("Failed to allocate formatting threads");
+
+	for (size_t index = 0; index < threadCount; ++index)
+	{
+		errno = pthread_create (&threads [index], NULL, formatterThread, NULL);
+		if (errno != 0)
+			return errorPrintf ("Failed to create formatting thread");
+	}
+
+	mdfCanBusSessionReader_t reader;
+	if (mdfCanBusSessionReaderInit (&reader, sessionDirectory, threadCount) != 0)
+		return errorPrintf ("Failed to open session '%s'", sessionDirectory);
+
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+
+	mdfCanBusRecord_t* records = malloc (sizeof (mdfCanBusRecord_t) * READ_BATCH_SIZE);
+	if (records == NULL)
+		return errorPrintf ("Failed to allocate records");
+
+	// Sequence numbers of the next chunk to fill and the next chunk to write.
+	size_t fillSequence = 0;
+	size_t writeSequence = 0;
+	chunk_t* chunk = NULL;
+	uint64_t lastTimestampNs = 0;
+	size_t recordTotal = 0;
+	size_t exportTotal = 0;
+
+	int code = 0;
+	while (code == 0)
+	{
+		size_t count;
+		if (mdfCanBusSessionReaderRead (&reader, records, READ_BATCH_SIZE, &count) != 0)
+		{
+			code = errorPrintf ("Failed to read session '%s'", sessionDirectory);
+			break;
+		}
+
+		if (count == 0)
+			break;
+
+		recordTotal += count;
+
+		for (size_t index = 0; index < count; ++index)
+		{
+			const mdfCanBusRecord_t* record = &records [index];
+			if (record->type != MDF_CAN_BUS_RECORD_DATA_FRAME)
+				continue;
+
+			int32_t messageIndex = findExportMessage (record);
+			if (messageIndex < 0)
+				continue;
+
+			if (chunk == NULL)
+			{
+				// Before re-using a chunk, the chunk previously using it must be written.
+				for (; writeSequence + chunkCount <= fillSequence; ++writeSequence)
+					if (writeChunk (output, writeSequence) != 0)
+						return errorPrintf ("Failed to format or write output");
+
+				chunk = &chunks [fillSequence % chunkCount];
+				chunk->recordCount = 0;
+				chunk->last = false;
+				chunk->done = false;
+
+				// The previous chunk emits the grid points before its last record, so this chunk starts at the first after.
+				if (resamplePeriodNs != 0)
+				{
+					uint64_t startNs = fillSequence != 0 ? lastTimestampNs : record->timestampNs;
+					chunk->gridNs = (startNs + resamplePeriodNs - 1) / resamplePeriodNs * resamplePeriodNs;
+					memcpy (chunk->payloads, payloads, sizeof (uint64_t) * exportMessageCount);
+					memcpy (chunk->payloadsValid, payloadsValid, sizeof (bool) * exportMessageCount);
+				}
+			}
+
+			exportRecord_t* exportRecord = &chunk->records [chunk->recordCount];
+			++chunk->recordCount;
+
+			exportRecord->timestampNs = record->timestampNs;
+			exportRecord->messageIndex = messageIndex;
+			memset (exportRecord->payload, 0, sizeof (exportRecord->payload));
+			memcpy (exportRecord->payload, record->data, record->dlc < 8 ? record->dlc : 8);
+
+			if (resamplePeriodNs != 0)
+			{
+				memcpy (&payloads [messageIndex], exportRecord->payload, sizeof (uint64_t));
+				payloadsValid [messageIndex] = true;
+			}
+
+			lastTimestampNs = record->timestampNs;
+			++exportTotal;
+
+			if (chunk->recordCount == CHUNK_SIZE)
+			{
+				submitChunk ();
+				++fillSequence;
+				chunk = NULL;
+			}
+		}
+	}
+
+	mdfCanBusSessionReaderClose (&reader);
+
+	// The last chunk is submitted even if empty, so the final grid points are emitted.
+	if (chunk == NULL && fillSequence != 0)
+	{
+		for (; writeSequence + chunkCount <= fillSequence; ++writeSequence)
+			if (writeChunk (output, writeSequence) != 0)
+				return errorPrintf ("Failed to format or write output");
+
+		chunk = &chunks [fillSequence % chunkCount];
+		chunk->recordCount = 0;
+		chunk->done = false;
+	}
+
+	if (chunk != NULL)
+	{
+		// Note an empty chunk only emits the grid point of the last record, which the previous chunk has not.
+		if (chunk->recordCount == 0 && resamplePeriodNs != 0)
+		{
+			chunk->gridNs = (lastTimestampNs + resamplePeriodNs - 1) / resamplePeriodNs * resamplePeriodNs;
+			memcpy (chunk->payloads, payloads, sizeof (uint64_t) * exportMessageCount);
+			memcpy (chunk->payloadsValid, payloadsValid, sizeof (bool) * exportMessageCount);
+		}
+
+		chunk->last = true;
+		chunk->lastNs = lastTimestampNs;
+		submitChunk ();
+		++fillSequence;
+	}
+
+	pthread_mutex_lock (&chunkMutex);
+	submitDone = true;
+	pthread_cond_broadcast (&chunkSubmitted);
+	pthread_mutex_unlock (&chunkMutex);
+
+	for (; writeSequence < fillSequence; ++writeSequence)
+		if (writeChunk (output, writeSequence) != 0)
+			return errorPrintf ("Failed to format or write output");
+
+	for (size_t index = 0; index < threadCount; ++index)
+		pthread_join (threads [index], NULL);
+
+	if (output != stdout && fclose (output) != 0)
+		return errorPrintf ("Failed to write output");
+	if (output == stdout)
+		fflush (stdout);
+
+	struct timespec timeEnd;
+	clock_gettime (CLOCK_MONOTONIC, &timeEnd);
+	double duration = (timeEnd.tv_sec - timeStart.tv_sec) + (timeEnd.tv_nsec - timeStart.tv_nsec) * 1e-9;
+
+	fprintf (stderr, "Exported %lu of %lu records (%lu signals) in %.3f s.\n", (unsigned long) exportTotal,
+		(unsigned long) recordTotal, (unsigned long) columnCount, duration);
+
+	return code;
+}
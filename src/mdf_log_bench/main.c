@@ -0,0 +1,618 @@
+// MDF Logging Benchmark ------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: See help page.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "can_device/can_device.h"
+#include "debug.h"
+#include "error_codes.h"
+#include "mdf/mdf_can_bus_logging.h"
+#include "mdf/mdf_can_bus_reader.h"
+#include "mdf/mdf_can_replay.h"
+#include "mdf/mdf_record_queue.h"
+#include "options.h"
+#include "time_port.h"
+
+// POSIX
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// C Standard Library
+#include <errno.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The capacity of each channel's record queue, in records. Matches the capacity used by can-mdf-logger.
+#define RECORD_QUEUE_SIZE 65536
+
+/// @brief The number of frames handed to the transmitting device at once.
+#define GENERATOR_CHUNK_SIZE 256
+
+/// @brief The number of channels logged.
+#define CHANNEL_COUNT 2
+
+/// @brief The number of records read from the log at once, when verifying it.
+#define VERIFY_BATCH_SIZE 1024
+
+/// @brief The number of frames encoded at once by the encoding benchmark.
+#define ENCODE_BATCH_SIZE 256
+
+// Globals --------------------------------------------------------------------------------------------------------------------
+
+/// @brief The duration of the benchmark, in seconds.
+unsigned long duration = 10;
+
+/// @brief Indicates frames should be generated by the logging threads, rather than received from CAN devices.
+bool synthetic = false;
+
+/// @brief Indicates records should be written through a shared mutex, rather than per-channel record queues.
+bool mutex = false;
+
+/// @brief Indicates the log should be compressed.
+bool compress = false;
+
+/// @brief Indicates the record encoders should be benchmarked, rather than the logging path.
+bool encode = false;
+
+/// @brief The mutex shared by all channels, if @c mutex is set.
+pthread_mutex_t logMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/// @brief Cleared to stop the benchmark.
+atomic_bool running = true;
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The device frames are received from, @c NULL in synthetic mode.
+	canDevice_t* rxDevice;
+
+	/// @brief The device frames are transmitted from, @c NULL in synthetic mode.
+	canDevice_t* txDevice;
+
+	mdfCanBusLog_t* log;
+	mdfRecordQueue_t* queue;
+	uint8_t busChannel;
+
+	size_t transmitCount;
+	size_t receiveCount;
+} channel_t;
+
+/**
+ * @brief Function encoding (or writing) a batch of frames, as measured by the encoding benchmark.
+ * @param log The log to encode for.
+ * @param records Buffer to encode the records into, if they are not written.
+ * @param frames The frames to encode, @c ENCODE_BATCH_SIZE elements.
+ * @param timestamps The timestamp of each frame.
+ */
+typedef void encodeMethod_t (mdfCanBusLog_t* log, uint8_t* records, canFrame_t* frames, struct timespec* timestamps);
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void handleDuration (char option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		duration = strtoul (value, NULL, 0);
+}
+
+void handleSynthetic (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+	synthetic = true;
+}
+
+void handleMutex (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+	mutex = true;
+}
+
+void handleCompress (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+	compress = true;
+}
+
+void handleEncode (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+	encode = true;
+}
+
+void fprintUsage (FILE* stream)
+{
+	fprintf (stream, "Usage:\n"
+		"    mdf-log-bench <Options> <Directory> <Device 1> <Device 2>\n"
+		"    mdf-log-bench <Options> --synthetic <Directory>\n"
+		"    mdf-log-bench <Options> --encode <Directory>\n");
+}
+
+void fprintHelp (FILE* stream)
+{
+	fprintf (stream, ""
+		"mdf-log-bench - Stress benchmark for the MDF logging path of can-mdf-logger.\n"
+		"                Two channels are logged into a single MDF log at full load,\n"
+		"                each through its own record queue. Afterwards, the log is\n"
+		"                read back to verify every record was written in timestamp\n"
+		"                order.\n\n");
+
+	fprintUsage (stream);
+
+	fprintf (stream, "\nParameters:\n\n");
+	fprintf (stream, ""
+		"    <Directory>           - The directory to write the log session into.\n"
+		"    <Device 1>            - The CAN device of channel 1 (ex. vcan0). A second\n"
+		"                            instance of the device is opened to generate the\n"
+		"                            load, so this should be a virtual interface.\n"
+		"    <Device 2>            - The CAN device of channel 2 (ex. vcan1).\n\n");
+
+	fprintf (stream, ""
+		"Options:\n\n"
+		"    -t=<Duration>         - The duration of the benchmark, in seconds. Default\n"
+		"                            10.\n"
+		"    --synthetic           - Generate frames directly in the logging threads,\n"
+		"                            rather than receiving them from CAN devices. Measures\n"
+		"                            the logging path in isolation.\n"
+		"    --mutex               - Write records through a mutex shared by both\n"
+		"                            channels, rather than per-channel record queues.\n"
+		"                            Used as a baseline for comparison.\n"
+		"    --compress            - Write the log as compressed data blocks.\n"
+		"    --encode              - Microbenchmark of the record encoders. Measures the\n"
+		"                            records/second of encoding (and writing) frames one\n"
+		"                            at a time, against encoding them in batches of %u,\n"
+		"                            each method for a quarter of the duration.\n"
+		"\n", ENCODE_BATCH_SIZE);
+	fprintOptionHelp (stream, "    ");
+}
+
+/// @brief Thread transmitting frames as fast as the device accepts them.
+void* generatorThread (void* argPtr)
+{
+	channel_t* channel = argPtr;
+
+	canFrame_t frames [GENERATOR_CHUNK_SIZE];
+	for (size_t index = 0; index < GENERATOR_CHUNK_SIZE; ++index)
+	{
+		frames [index] = (canFrame_t)
+		{
+			.id		= 0x100 + channel->busChannel,
+			.ide	= false,
+			.rtr	= false,
+			.dlc	= 8,
+			.data	= { index, index >> 8, 0, 0, 0, 0, 0, 0 }
+		};
+	}
+
+	while (atomic_load_explicit (&running, memory_order_relaxed))
+	{
+		size_t transmitCount = 0;
+		canTransmitBatch (channel->txDevice, frames, GENERATOR_CHUNK_SIZE, &transmitCount);
+		channel->transmitCount += transmitCount;
+	}
+
+	return NULL;
+}
+
+/// @brief Thread logging a channel, mirroring the logging thread of can-mdf-logger.
+void* loggingThread (void* argPtr)
+{
+	channel_t* channel = argPtr;
+
+	if (!synthetic)
+		canSetTimeout (channel->rxDevice, 10);
+
+	canFrame_t frame =
+	{
+		.id		= 0x200 + channel->busChannel,
+		.ide	= false,
+		.rtr	= false,
+		.dlc	= 8
+	};
+
+	while (atomic_load_explicit (&running, memory_order_relaxed))
+	{
+		int code = 0;
+		if (!synthetic)
+			code = canReceive (channel->rxDevice, &frame);
+		else
+			memcpy (frame.data, &channel->receiveCount, sizeof (channel->receiveCount));
+
+		if (code != 0)
+			continue;
+
+		if (mutex)
+		{
+			// Baseline, the timestamp must be acquired inside the mutex guard for the log to stay ordered.
+			pthread_mutex_lock (&logMutex);
+
+			struct timespec timeCurrent;
+			mdfCanBusLogGetTimestamp (&timeCurrent);
+			mdfCanBusLogWriteDataFrame (channel->log, &frame, channel->busChannel, false, &timeCurrent);
+
+			pthread_mutex_unlock (&logMutex);
+			++channel->receiveCount;
+			continue;
+		}
+
+		mdfRecordQueueBegin (channel->queue);
+
+		struct timespec timeCurrent;
+		mdfCanBusLogGetTimestamp (&timeCurrent);
+
+		mdfRecord_t* record = mdfRecordQueueReserve (channel->queue);
+		if (record != NULL)
+		{
+			record->size = mdfCanBusLogEncodeDataFrame (channel->log, record->data, &frame, channel->busChannel, false,
+				&timeCurrent);
+			mdfRecordQueuePublish (channel->queue, record, &timeCurrent);
+		}
+
+		mdfRecordQueueEnd (channel->queue);
+		++channel->receiveCount;
+	}
+
+	mdfRecordQueueClose (channel->queue);
+	return NULL;
+}
+
+static void encodeSingle (mdfCanBusLog_t* log, uint8_t* records, canFrame_t* frames, struct timespec* timestamps)
+{
+	for (size_t index = 0; index < ENCODE_BATCH_SIZE; ++index)
+	{
+		uint8_t* record = records + index * MDF_CAN_BUS_LOG_FRAME_RECORD_SIZE;
+		if (!frames [index].rtr)
+			mdfCanBusLogEncodeDataFrame (log, record, &frames [index], 1, false, &timestamps [index]);
+		else
+			mdfCanBusLogEncodeRemoteFrame (log, record, &frames [index], 1, false, &timestamps [index]);
+	}
+}
+
+static void encodeBatch (mdfCanBusLog_t* log, uint8_t* records, canFrame_t* frames, struct timespec* timestamps)
+{
+	mdfCanBusLogEncodeFrames (log, records, frames, timestamps, ENCODE_BATCH_SIZE, 1, false);
+}
+
+static void writeSingle (mdfCanBusLog_t* log, uint8_t* records, canFrame_t* frames, struct timespec* timestamps)
+{
+	(void) records;
+
+	for (size_t index = 0; index < ENCODE_BATCH_SIZE; ++index)
+	{
+		if (!frames [index].rtr)
+			mdfCanBusLogWriteDataFrame (log, &frames [index], 1, false, &timestamps [index]);
+		else
+			mdfCanBusLogWriteRemoteFrame (log, &frames [index], 1, false, &timestamps [index]);
+	}
+}
+
+static void writeBatch (mdfCanBusLog_t* log, uint8_t* records, canFrame_t* frames, struct timespec* timestamps)
+{
+	(void) records;
+	mdfCanBusLogWriteFrames (log, frames, timestamps, ENCODE_BATCH_SIZE, 1, false);
+}
+
+/**
+ * @brief Measures the rate of an encoding method.
+ * @param name The name of the method, to print.
+ * @param method The method to measure.
+ * @param durationNs The amount of time to run the method for, in nanoseconds.
+ */
+static void measureEncodeMethod (const char* name, encodeMethod_t* method, mdfCanBusLog_t* log, uint8_t* records,
+	canFrame_t* frames, struct timespec* timestamps, long long durationNs)
+{
+	size_t droppedCount = log->stats.droppedCount;
+
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+
+	size_t recordCount = 0;
+	long long elapsedNs = 0;
+	while (elapsedNs < durationNs)
+	{
+		method (log, records, frames, timestamps);
+		recordCount += ENCODE_BATCH_SIZE;
+
+		struct timespec timeCurrent;
+		clock_gettime (CLOCK_MONOTONIC, &timeCurrent);
+		struct timespec elapsed = timespecSub (&timeCurrent, &timeStart);
+		elapsedNs = timespecToNs (&elapsed);
+	}
+
+	// Dropped records are rejected without being encoded, so they are not counted. Note the log's statistics are guarded by
+	// its mutex, but the dropped count is only changed by this thread.
+	droppedCount = log->stats.droppedCount - droppedCount;
+	printf ("%-20s %12.0f records/s", name, (recordCount - droppedCount) / (elapsedNs / 1e9));
+	if (droppedCount != 0)
+		printf (" (%lu dropped, log buffers full)", (unsigned long) droppedCount);
+	printf ("\n");
+}
+
+/**
+ * @brief Benchmarks the record encoders, comparing encoding frames one at a time against encoding them in batches. Both
+ * encoding alone, and encoding plus writing into the log are measured. Note the rate of writing is bounded by that of the
+ * log's writer thread, as records are dropped once its buffers are full.
+ * @param log The log to encode for.
+ * @return 0 if both methods produce identical records, -1 otherwise.
+ */
+static int encodeBenchmark (mdfCanBusLog_t* log)
+{
+	// Mix of standard and extended IDs, varying DLCs, and the occasional RTR frame.
+	canFrame_t frames [ENCODE_BATCH_SIZE];
+	struct timespec timestamps [ENCODE_BATCH_SIZE];
+	mdfCanBusLogGetTimestamp (&timestamps [0]);
+	for (size_t index = 0; index < ENCODE_BATCH_SIZE; ++index)
+	{
+		bool ide = index % 4 == 0;
+		frames [index] = (canFrame_t)
+		{
+			.id		= ide ? 0x18FF0000 + index : 0x100 + index,
+			.ide	= ide,
+			.rtr	= index % 16 == 15,
+			.dlc	= index % 9,
+			.data	= { index, index >> 8, 0xA5, 0x5A, 0xFF, 0x00, 0x12, 0x34 }
+		};
+
+		timestamps [index] = timespecAdd (&timestamps [0], &(struct timespec) { .tv_nsec = index * 1000 });
+	}
+
+	uint8_t singleRecords [ENCODE_BATCH_SIZE * MDF_CAN_BUS_LOG_FRAME_RECORD_SIZE];
+	uint8_t batchRecords [ENCODE_BATCH_SIZE * MDF_CAN_BUS_LOG_FRAME_RECORD_SIZE];
+	encodeSingle (log, singleRecords, frames, timestamps);
+	encodeBatch (log, batchRecords, frames, timestamps);
+	bool match = memcmp (singleRecords, batchRecords, sizeof (singleRecords)) == 0;
+
+	long long durationNs = duration * 1000000000LL / 4;
+	printf ("Benchmarking record encoders for %lu s (batches of %u frames)...\n", duration, ENCODE_BATCH_SIZE);
+	measureEncodeMethod ("Encode, per-record:", encodeSingle, log, singleRecords, frames, timestamps, durationNs);
+	measureEncodeMethod ("Encode, batch:", encodeBatch, log, batchRecords, frames, timestamps, durationNs);
+	measureEncodeMethod ("Write, per-record:", writeSingle, log, singleRecords, frames, timestamps, durationNs);
+	measureEncodeMethod ("Write, batch:", writeBatch, log, batchRecords, frames, timestamps, durationNs);
+	printf ("Records match:       %s\n", match ? "yes" : "no");
+
+	return match ? 0 : -1;
+}
+
+/**
+ * @brief Reads the records of a log split back, checking their timestamps are monotonic.
+ * @param path The path of the split to read.
+ * @param lastTimestamp The timestamp of the last record read. Updated by this function.
+ * @param recordCount Incremented by the number of records read.
+ * @param violationCount Incremented by the number of records out of order.
+ * @return 0 if successful, the error code otherwise.
+ */
+int verifySplit (const char* path, uint64_t* lastTimestamp, size_t* recordCount, size_t* violationCount)
+{
+	mdfCanBusReader_t reader;
+	if (mdfCanBusReaderInit (&reader, path) != 0)
+		return errno;
+
+	mdfCanBusRecord_t records [VERIFY_BATCH_SIZE];
+	size_t count;
+	int code;
+	while ((code = mdfCanBusReaderRead (&reader, records, VERIFY_BATCH_SIZE, &count)) == 0 && count != 0)
+	{
+		for (size_t index = 0; index < count; ++index)
+		{
+			if (records [index].timestampNs < *lastTimestamp)
+				++*violationCount;
+
+			*lastTimestamp = records [index].timestampNs;
+		}
+
+		*recordCount += count;
+	}
+
+	mdfCanBusReaderClose (&reader);
+	if (code != 0)
+	{
+		errno = code;
+		return errno;
+	}
+
+	return 0;
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	// Debug initialization
+	debugInit ();
+
+	// Handle program options
+	if (handleOptions (&argc, &argv, &(handleOptionsParams_t)
+	{
+		.fprintHelp		= fprintHelp,
+		.charHandlers	= (optionCharCallback_t* []) { handleDuration },
+		.chars			= (char []) { 't' },
+		.charCount		= 1,
+		.stringHandlers	= (optionStringCallback_t* []) { handleSynthetic, handleMutex, handleCompress, handleEncode },
+		.strings		= (char* []) { "synthetic", "mutex", "compress", "encode" },
+		.stringCount	= 4
+	}) != 0)
+		return errorPrintf ("Failed to handle options");
+
+	// Validate usage
+	bool deviceless = synthetic || encode;
+	if ((deviceless && argc != 1) || (!deviceless && argc != 1 + CHANNEL_COUNT))
+	{
+		fprintUsage (stderr);
+		return -1;
+	}
+
+	char* directory = argv [0];
+
+	// Allow a recorded session to be used as a deterministic load source.
+	if (mdfCanReplayRegister () != 0)
+		return errorPrintf ("Failed to register MDF replay CAN device");
+
+	channel_t channels [CHANNEL_COUNT] = {0};
+	for (size_t index = 0; index < CHANNEL_COUNT; ++index)
+	{
+		channels [index].busChannel = index + 1;
+		if (deviceless)
+			continue;
+
+		channels [index].rxDevice = canInit (argv [index + 1], NULL);
+		if (channels [index].rxDevice == NULL)
+			return errorPrintf ("Failed to initialize CAN device '%s'", argv [index + 1]);
+
+		channels [index].txDevice = canInit (argv [index + 1], NULL);
+		if (channels [index].txDevice == NULL)
+			return errorPrintf ("Failed to initialize CAN device '%s'", argv [index + 1]);
+	}
+
+	mdfCanBusLogConfig_t config =
+	{
+		.directory			= directory,
+		.configurationName	= "mdf-log-bench",
+		.softwareName		= ZRE_CANTOOLS_NAME,
+		.softwareVersion	= ZRE_CANTOOLS_VERSION_FULL,
+		.softwareVendor		= "ZRE",
+		.hardwareName		= "",
+		.hardwareVersion	= "",
+		.serialNumber		= "",
+		.sessionNumber		= mdfCanBusLogFindSessionNumber (directory),
+		.compress			= compress
+	};
+
+	mdfCanBusLog_t log;
+	if (mdfCanBusLogInit (&log, &config) != 0)
+		return errorPrintf ("Failed to initialize CAN bus MDF log");
+
+	if (encode)
+	{
+		int code = encodeBenchmark (&log);
+		if (mdfCanBusLogClose (&log) != 0)
+			errorPrintf ("Failed to close MDF log");
+
+		printf ("Records written:     %lu\n", (unsigned long) log.stats.writtenCount);
+		return code;
+	}
+
+	mdfRecordQueue_t queues [CHANNEL_COUNT];
+	for (size_t index = 0; index < CHANNEL_COUNT; ++index)
+	{
+		channels [index].log = &log;
+		channels [index].queue = &queues [index];
+		if (mdfRecordQueueInit (&queues [index], RECORD_QUEUE_SIZE) != 0)
+			return errorPrintf ("Failed to initialize record queue");
+	}
+
+	mdfRecordMerger_t merger;
+	if (mdfRecordMergerStart (&merger, &log, NULL, queues, CHANNEL_COUNT) != 0)
+		return errorPrintf ("Failed to start record merger");
+
+	printf ("Logging %u channels for %lu s (%s, %s)...\n", CHANNEL_COUNT, duration,
+		synthetic ? "synthetic" : "CAN devices", mutex ? "shared mutex" : "record queues");
+
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+
+	pthread_t loggingThreads [CHANNEL_COUNT];
+	pthread_t generatorThreads [CHANNEL_COUNT];
+	for (size_t index = 0; index < CHANNEL_COUNT; ++index)
+	{
+		pthread_create (&loggingThreads [index], NULL, loggingThread, &channels [index]);
+		if (!synthetic)
+			pthread_create (&generatorThreads [index], NULL, generatorThread, &channels [index]);
+	}
+
+	sleep (duration);
+	atomic_store (&running, false);
+
+	for (size_t index = 0; index < CHANNEL_COUNT; ++index)
+	{
+		pthread_join (loggingThreads [index], NULL);
+		if (!synthetic)
+			pthread_join (generatorThreads [index], NULL);
+	}
+	mdfRecordMergerJoin (&merger);
+
+	struct timespec timeEnd;
+	clock_gettime (CLOCK_MONOTONIC, &timeEnd);
+
+	uint32_t splitCount = mdfCanBusLogGetSplitNumber (&log) + 1;
+	if (mdfCanBusLogClose (&log) != 0)
+		errorPrintf ("Failed to close MDF log");
+
+	struct timespec elapsed = timespecSub (&timeEnd, &timeStart);
+	double elapsedS = timespecToNs (&elapsed) / 1e9;
+
+	size_t written = mutex ? log.stats.writtenCount : atomic_load (&merger.mergedCount);
+	for (size_t index = 0; index < CHANNEL_COUNT; ++index)
+	{
+		if (!synthetic)
+			printf ("Channel %u: Frames transmitted: %lu, ", channels [index].busChannel,
+				(unsigned long) channels [index].transmitCount);
+		else
+			printf ("Channel %u: ", channels [index].busChannel);
+
+		printf ("Frames logged: %lu, Queue overflows: %lu\n", (unsigned long) channels [index].receiveCount,
+			(unsigned long) mdfRecordQueueGetOverflowCount (&queues [index]));
+	}
+	printf ("Records written:     %lu\n", (unsigned long) written);
+	printf ("Records dropped:     %lu (log buffers full)\n", (unsigned long) log.stats.droppedCount);
+	printf ("Buffer high-water:   %lu records\n", (unsigned long) log.stats.queueHighWaterMark);
+	printf ("Syncs:               %lu, longest %.3f ms\n", (unsigned long) log.stats.syncCount,
+		log.stats.syncTimeMaxNs / 1e6);
+	printf ("Elapsed time:        %.3f s\n", elapsedS);
+	printf ("Record rate:         %.0f records/s\n", written / elapsedS);
+
+	// Read the log back, checking the records are in timestamp order across all splits.
+	uint64_t lastTimestamp = 0;
+	size_t recordCount = 0;
+	size_t violationCount = 0;
+	size_t logSize = 0;
+	struct timespec verifyStart;
+	clock_gettime (CLOCK_MONOTONIC, &verifyStart);
+	for (uint32_t split = 0; split < splitCount; ++split)
+	{
+		char path [512];
+		snprintf (path, sizeof (path), "%s/session_%"PRIu32"/split_%"PRIu32".mf4", directory, config.sessionNumber, split);
+		if (verifySplit (path, &lastTimestamp, &recordCount, &violationCount) != 0)
+			errorPrintf ("Failed to verify split '%s'", path);
+
+		struct stat splitStat;
+		if (stat (path, &splitStat) == 0)
+			logSize += splitStat.st_size;
+	}
+	struct timespec verifyEnd;
+	clock_gettime (CLOCK_MONOTONIC, &verifyEnd);
+	struct timespec verifyElapsed = timespecSub (&verifyEnd, &verifyStart);
+	double verifyElapsedS = timespecToNs (&verifyElapsed) / 1e9;
+
+	printf ("Log size:            %.1f MiB (%.2f bytes/record)\n", logSize / 1048576.0,
+		recordCount != 0 ? (double) logSize / recordCount : 0.0);
+	printf ("Read back time:      %.3f s (%.0f records/s)\n", verifyElapsedS,
+		verifyElapsedS != 0 ? recordCount / verifyElapsedS : 0.0);
+	printf ("Records verified:    %lu in %lu splits, %lu out of order\n", (unsigned long) recordCount,
+		(unsigned long) splitCount, (unsigned long) violationCount);
+
+	for (size_t index = 0; index < CHANNEL_COUNT; ++index)
+	{
+		mdfRecordQueueDealloc (&queues [index]);
+		if (!synthetic)
+		{
+			canDealloc (channels [index].rxDevice);
+			canDealloc (channels [index].txDevice);
+		}
+	}
+
+	return violationCount == 0 ? 0 : -1;
+}
@@ -0,0 +1,88 @@
+// MDF Recover ----------------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: See help page.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "debug.h"
+#include "mdf/mdf_can_bus_logging.h"
+#include "options.h"
+
+// C Standard Library
+#include <stdio.h>
+#include <stdlib.h>
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void fprintUsage (FILE* stream)
+{
+	fprintf (stream, "Usage:\n"
+		"    mdf-recover <Options> <MDF File 1> <MDF File 2> ... <MDF File N>\n");
+}
+
+void fprintHelp (FILE* stream)
+{
+	fprintf (stream, ""
+		"mdf-recover - Repairs MDF log splits that were not closed properly, for\n"
+		"              instance due to power loss while logging. Each split is\n"
+		"              truncated to its last complete record, then finalized as if\n"
+		"              can-mdf-logger had closed it. Splits that are already\n"
+		"              finalized are left untouched.\n\n");
+
+	fprintUsage (stream);
+
+	fprintf (stream, "\nParameters:\n\n");
+	fprintf (stream, ""
+		"    <MDF File N>          - The split to repair (ex. session_3/split_0.mf4).\n\n");
+
+	fprintf (stream, "Options:\n\n");
+	fprintOptionHelp (stream, "    ");
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	// Debug initialization
+	debugInit ();
+
+	// Handle program options
+	if (handleOptions (&argc, &argv, &(handleOptionsParams_t)
+	{
+		.fprintHelp		= fprintHelp
+	}) != 0)
+		return errorPrintf ("Failed to handle options");
+
+	// Validate usage
+	if (argc < 1)
+	{
+		fprintUsage (stderr);
+		return -1;
+	}
+
+	int code = 0;
+	for (int index = 0; index < argc; ++index)
+	{
+		mdfCanBusLogRecovery_t recovery;
+		if (mdfCanBusLogRecoverSplit (argv [index], &recovery) != 0)
+		{
+			code = errorPrintf ("Failed to recover '%s'", argv [index]);
+			continue;
+		}
+
+		if (recovery.finalized)
+		{
+			printf ("%s: Already finalized.\n", argv [index]);
+			continue;
+		}
+
+		printf ("%s: Recovered %lu records, %lu bytes => %lu bytes.\n", argv [index], (unsigned long) recovery.recordCount,
+			(unsigned long) recovery.fileSize, (unsigned long) recovery.recoveredSize);
+	}
+
+	return code;
+}
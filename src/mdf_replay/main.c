@@ -0,0 +1,344 @@
+// MDF Replay -----------------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: See help page.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "can_device/can_device.h"
+#include "debug.h"
+#include "error_codes.h"
+#include "histogram.h"
+#include "mdf/mdf_can_bus_session_reader.h"
+#include "options.h"
+#include "time_port.h"
+
+// C Standard Library
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of records read from the session at once.
+#define READ_SIZE 1024
+
+/// @brief The number of threads decoding the session. Note 2 allows the next split to be decoded while the current is being
+/// replayed.
+#define THREAD_COUNT 2
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief A frame to replay.
+typedef struct
+{
+	canFrame_t frame;
+
+	/// @brief The time to transmit the frame at, in nanoseconds (CLOCK_MONOTONIC).
+	uint64_t deadlineNs;
+} replayFrame_t;
+
+// Globals --------------------------------------------------------------------------------------------------------------------
+
+/// @brief The bus channel to replay, -1 for every channel.
+long busChannel = -1;
+
+/// @brief The CAN IDs to replay, empty for every ID.
+uint32_t* ids = NULL;
+size_t idCount = 0;
+
+/// @brief The playback speed, relative to real-time.
+double speed = 1;
+
+/// @brief The maximum number of frames to transmit in one batch.
+size_t batchSize = 64;
+
+/// @brief Set by SIGINT to stop the replay.
+static volatile sig_atomic_t interrupted = false;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void handleBatchSize (char option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		batchSize = strtoul (value, NULL, 0);
+}
+
+void handleBus (char* option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		busChannel = strtol (value, NULL, 0);
+}
+
+void handleId (char* option, char* value)
+{
+	(void) option;
+	if (value == NULL)
+		return;
+
+	uint32_t* reallocated = realloc (ids, sizeof (uint32_t) * (idCount + 1));
+	if (reallocated == NULL)
+	{
+		errorPrintf ("Failed to allocate ID list");
+		exit (errno);
+	}
+
+	ids = reallocated;
+	ids [idCount] = strtoul (value, NULL, 0);
+	++idCount;
+}
+
+void handleSpeed (char* option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		speed = strtod (value, NULL);
+}
+
+void fprintUsage (FILE* stream)
+{
+	fprintf (stream, "Usage: mdf-replay <Options> <Session Directory> <Device Name>\n");
+}
+
+void fprintHelp (FILE* stream)
+{
+	fprintf (stream, ""
+		"mdf-replay - Replays a session of MDF CAN bus logs onto a CAN bus, reproducing\n"
+		"             the timing of the original recording. Each frame is scheduled at\n"
+		"             an absolute deadline, frames that are due at the same time are\n"
+		"             transmitted as a batch. Upon completion (or Ctrl+C), the\n"
+		"             lateness of each frame (once transmitted) relative to its\n"
+		"             recorded time is reported.\n\n");
+
+	fprintUsage (stream);
+
+	fprintf (stream, "\nParameters:\n\n");
+	fprintf (stream, ""
+		"    <Session Directory>   - The session to replay (ex. logs/session_3).\n"
+		"    <Device Name>         - The CAN device to transmit with.\n\n");
+
+	fprintf (stream, ""
+		"Options:\n\n"
+		"    --bus=<Channel>       - Only replays the frames of a single bus channel. By\n"
+		"                            default, frames of every channel are replayed.\n"
+		"    --id=<CAN ID>         - Only replays the frames of a CAN ID. May be given\n"
+		"                            multiple times. By default, every ID is replayed.\n"
+		"    --speed=<Speed>       - The playback speed, relative to real-time (ex. '2'\n"
+		"                            for 2x speed). Default 1.\n"
+		"    -b=<Batch Size>       - The maximum number of frames to transmit in one\n"
+		"                            batch. Default 64.\n"
+		"\n");
+	fprintOptionHelp (stream, "    ");
+}
+
+/// @brief Signal handler for stopping the replay.
+static void interruptHandler (int sig)
+{
+	(void) sig;
+	interrupted = true;
+}
+
+static uint64_t monotonicNs (void)
+{
+	struct timespec time;
+	clock_gettime (CLOCK_MONOTONIC, &time);
+	return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+/**
+ * @brief Checks whether a record should be replayed, based on the user's filters.
+ */
+static bool recordSelected (const mdfCanBusRecord_t* record)
+{
+	// Error frames cannot be transmitted.
+	if (record->type == MDF_CAN_BUS_RECORD_ERROR_FRAME)
+		return false;
+
+	if (busChannel >= 0 && record->busChannel != busChannel)
+		return false;
+
+	if (idCount == 0)
+		return true;
+
+	for (size_t index = 0; index < idCount; ++index)
+		if (ids [index] == record->id)
+			return true;
+
+	return false;
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	// Debug initialization
+	debugInit ();
+
+	// Handle program options
+	if (handleOptions (&argc, &argv, &(handleOptionsParams_t)
+	{
+		.fprintHelp		= fprintHelp,
+		.charHandlers	= (optionCharCallback_t* []) { handleBatchSize },
+		.chars			= (char []) { 'b' },
+		.charCount		= 1,
+		.stringHandlers	= (optionStringCallback_t* []) { handleBus, handleId, handleSpeed },
+		.strings		= (char* []) { "bus", "id", "speed" },
+		.stringCount	= 3
+	}) != 0)
+		return errorPrintf ("Failed to handle options");
+
+	// Validate usage
+	if (argc != 2 || speed <= 0 || batchSize == 0)
+	{
+		fprintUsage (stderr);
+		return -1;
+	}
+
+	char* sessionDirectory = argv [0];
+	char* deviceName = argv [1];
+
+	mdfCanBusSessionReader_t reader;
+	if (mdfCanBusSessionReaderInit (&reader, sessionDirectory, THREAD_COUNT) != 0)
+		return errorPrintf ("Failed to open session '%s'", sessionDirectory);
+
+	canDevice_t* device = canInit (deviceName, NULL);
+	if (device == NULL)
+		return errorPrintf ("Failed to initialize CAN device '%s'", deviceName);
+
+	mdfCanBusRecord_t* records = malloc (sizeof (mdfCanBusRecord_t) * READ_SIZE);
+	replayFrame_t* frames = malloc (sizeof (replayFrame_t) * READ_SIZE);
+	canFrame_t* batch = malloc (sizeof (canFrame_t) * batchSize);
+	if (records == NULL || frames == NULL || batch == NULL)
+		return errorPrintf ("Failed to allocate buffers");
+
+	histogram_t lateness;
+	histogramInit (&lateness);
+
+	// Catch SIGINT so the statistics can be printed upon exit.
+	signal (SIGINT, interruptHandler);
+
+	printf ("Replaying session '%s' onto '%s'. Press Ctrl+C to stop.\n", sessionDirectory, canGetDeviceName (device));
+
+	bool started = false;
+	uint64_t startNs = 0;
+	uint64_t firstTimestampNs = 0;
+
+	size_t frameCount = 0;
+	size_t frameIndex = 0;
+	size_t transmitCount = 0;
+	size_t errorCount = 0;
+	size_t batchCount = 0;
+
+	int code = 0;
+	while (!interrupted)
+	{
+		// Read and schedule the next frames of the session.
+		if (frameIndex == frameCount)
+		{
+			size_t recordCount;
+			if (mdfCanBusSessionReaderRead (&reader, records, READ_SIZE, &recordCount) != 0)
+			{
+				code = errorPrintf ("Failed to read session '%s'", sessionDirectory);
+				break;
+			}
+
+			if (recordCount == 0)
+				break;
+
+			frameIndex = 0;
+			frameCount = 0;
+			for (size_t index = 0; index < recordCount; ++index)
+			{
+				const mdfCanBusRecord_t* record = &records [index];
+				if (!recordSelected (record))
+					continue;
+
+				if (!started)
+				{
+					started = true;
+					startNs = monotonicNs ();
+					firstTimestampNs = record->timestampNs;
+				}
+
+				// Note records may be slightly out of order (ex. from multiple splits), so clamp the first ones.
+				uint64_t offsetNs = record->timestampNs > firstTimestampNs ? record->timestampNs - firstTimestampNs : 0;
+
+				replayFrame_t* frame = &frames [frameCount];
+				++frameCount;
+
+				frame->deadlineNs	= startNs + (uint64_t) (offsetNs / speed);
+				frame->frame.id		= record->id;
+				frame->frame.ide	= record->ide;
+				frame->frame.dlc	= record->dlc < sizeof (frame->frame.data) ? record->dlc : sizeof (frame->frame.data);
+				frame->frame.rtr	= record->type == MDF_CAN_BUS_RECORD_REMOTE_FRAME;
+				memset (frame->frame.data, 0, sizeof (frame->frame.data));
+				if (!frame->frame.rtr)
+					memcpy (frame->frame.data, record->data, frame->frame.dlc);
+			}
+
+			continue;
+		}
+
+		// Sleep until the deadline of the next frame. Interrupted by SIGINT if the user exits.
+		uint64_t deadlineNs = frames [frameIndex].deadlineNs;
+		struct timespec deadline =
+		{
+			.tv_sec		= deadlineNs / 1000000000,
+			.tv_nsec	= deadlineNs % 1000000000
+		};
+		if (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) != 0)
+			continue;
+
+		// Batch every frame that is now due.
+		uint64_t timeNs = monotonicNs ();
+		size_t count = 0;
+		for (; frameIndex < frameCount && count < batchSize && frames [frameIndex].deadlineNs <= timeNs; ++frameIndex)
+		{
+			batch [count] = frames [frameIndex].frame;
+			++count;
+		}
+
+		size_t batchTransmitCount = 0;
+		if (canTransmitBatch (device, batch, count, &batchTransmitCount) != 0)
+		{
+			errorCount += count - batchTransmitCount;
+			debugPrintf ("Failed to transmit batch: %s.\n", errorCodeToMessage (errno));
+		}
+
+		// Measure the lateness once the batch has been sent, so it includes the time taken by the transmission itself.
+		timeNs = monotonicNs ();
+		for (size_t index = frameIndex - count; index < frameIndex; ++index)
+			histogramRecord (&lateness, timeNs - frames [index].deadlineNs);
+
+		transmitCount += batchTransmitCount;
+		++batchCount;
+	}
+
+	double durationS = started ? (monotonicNs () - startNs) * 1e-9 : 0;
+
+	mdfCanBusSessionReaderClose (&reader);
+	canDealloc (device);
+
+	// Print the statistics
+	printf ("\nReplay statistics:\n");
+	printf ("    Frames transmitted: %lu (%.0f frames/s)\n", (unsigned long) transmitCount,
+		durationS > 0 ? transmitCount / durationS : 0);
+	printf ("    Transmit errors: %lu\n", (unsigned long) errorCount);
+	printf ("    Batches: %lu (%.2f frames/batch)\n", (unsigned long) batchCount,
+		batchCount != 0 ? (double) (transmitCount + errorCount) / batchCount : 0);
+	printf ("    Lateness: ");
+	fprintHistogramSummary (stdout, &lateness, 1e3, "us");
+	printf ("\n");
+
+	free (records);
+	free (frames);
+	free (batch);
+	free (ids);
+	return code;
+}
@@ -0,0 +1,641 @@
+// MDF Sort -------------------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: See help page.
+
+// For asprintf. Note this must be the first include in this file.
+#define _GNU_SOURCE
+#include <stdio.h>
+
+// Includes
+#include "can_database/can_dbc.h"
+#include "debug.h"
+#include "mdf/mdf_block_types.h"
+#include "mdf/mdf_can_bus_reader.h"
+#include "mdf/mdf_sorted_writer.h"
+#include "misc_port.h"
+#include "options.h"
+#include "time_port.h"
+
+// POSIX
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// C Standard Library
+#include <errno.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of records read from a split at once.
+#define READ_BATCH_SIZE 1024
+
+/// @brief The initial capacity of each split's group table. Must be a power of 2.
+#define GROUP_TABLE_SIZE 256
+
+/// @brief The size of each record of a raw frame group, in bytes.
+#define RAW_RECORD_SIZE 24
+
+// Layout of raw frame group records
+#define RAW_RECORD_ID_OFFSET			8
+#define RAW_RECORD_IDE_OFFSET			12
+#define RAW_RECORD_DLC_OFFSET			13
+#define RAW_RECORD_DIR_OFFSET			14
+#define RAW_RECORD_ERROR_TYPE_OFFSET	15
+#define RAW_RECORD_DATA_BYTES_OFFSET	16
+
+/// @brief The maximum number of signals of a decoded message group. Each signal is stored as a 32-bit float, and records are
+/// limited to 255 bytes (including the timestamp).
+#define DECODED_SIGNAL_COUNT_MAX ((UINT8_MAX - MDF_SORTED_WRITER_TIMESTAMP_SIZE) / sizeof (float))
+
+/// @brief The channels of raw frame group records. Note the order matters, see @c writeGroup .
+static const mdfSortedChannel_t RAW_CHANNELS [] =
+{
+	{
+		.name		= "ID",
+		.dataType	= MDF_DATA_TYPE_UNSIGNED_INTEL,
+		.byteOffset	= RAW_RECORD_ID_OFFSET,
+		.bitLength	= 29
+	},
+	{
+		.name		= "IDE",
+		.dataType	= MDF_DATA_TYPE_UNSIGNED_INTEL,
+		.byteOffset	= RAW_RECORD_IDE_OFFSET,
+		.bitLength	= 1
+	},
+	{
+		.name		= "DLC",
+		.dataType	= MDF_DATA_TYPE_UNSIGNED_INTEL,
+		.byteOffset	= RAW_RECORD_DLC_OFFSET,
+		.bitLength	= 4
+	},
+	{
+		.name		= "Dir",
+		.dataType	= MDF_DATA_TYPE_UNSIGNED_INTEL,
+		.byteOffset	= RAW_RECORD_DIR_OFFSET,
+		.bitLength	= 1
+	},
+	{
+		.name		= "DataBytes",
+		.dataType	= MDF_DATA_TYPE_BYTE_ARRAY,
+		.byteOffset	= RAW_RECORD_DATA_BYTES_OFFSET,
+		.bitLength	= 64
+	},
+	{
+		.name		= "ErrorType",
+		.dataType	= MDF_DATA_TYPE_UNSIGNED_INTEL,
+		.byteOffset	= RAW_RECORD_ERROR_TYPE_OFFSET,
+		.bitLength	= 6
+	}
+};
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief A group of the sorted output, holding the records of a single CAN ID (or message).
+typedef struct
+{
+	/// @brief The key identifying the group, see @c groupKey .
+	uint64_t key;
+
+	/// @brief The DBC message the group's records are decoded with, @c NULL for raw frames.
+	canMessage_t* message;
+
+	/// @brief The records of the group.
+	uint8_t* records;
+	size_t recordCount;
+	size_t recordCapacity;
+
+	/// @brief The size of each of the group's records, in bytes.
+	uint8_t recordSize;
+} group_t;
+
+/// @brief The groups of a split, in an open-addressing hash table.
+typedef struct
+{
+	group_t* groups;
+	size_t groupCount;
+	size_t groupCapacity;
+} groupTable_t;
+
+// Globals --------------------------------------------------------------------------------------------------------------------
+
+/// @brief The directory of the session to sort.
+char* sessionDirectory;
+
+/// @brief The directory to write the sorted splits into.
+char* outputDirectory;
+
+/// @brief The number of worker threads, 0 to use one per CPU.
+unsigned long threadCount = 0;
+
+/// @brief Indicates the sorted splits should be compressed.
+bool compress = false;
+
+/// @brief The path of the DBC file to decode messages with, @c NULL to not decode messages.
+char* dbcPath = NULL;
+
+/// @brief The messages of the DBC file, if any.
+canMessage_t* messages = NULL;
+size_t messageCount = 0;
+canSignal_t* signals = NULL;
+size_t signalCount = 0;
+
+/// @brief The number of splits in the session.
+uint32_t splitCount = 0;
+
+/// @brief The next split to be sorted by a worker.
+atomic_uint nextSplit = 0;
+
+/// @brief Set if any split failed to be sorted.
+atomic_bool failed = false;
+
+/// @brief The total number of records sorted, across all splits.
+atomic_ullong recordTotal = 0;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void handleThreads (char option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		threadCount = strtoul (value, NULL, 0);
+}
+
+void handleDbc (char* option, char* value)
+{
+	(void) option;
+	dbcPath = value;
+}
+
+void handleCompress (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+	compress = true;
+}
+
+void fprintUsage (FILE* stream)
+{
+	fprintf (stream, "Usage:\n"
+		"    mdf-sort <Options> <Session Directory> <Output Directory>\n");
+}
+
+void fprintHelp (FILE* stream)
+{
+	fprintf (stream, ""
+		"mdf-sort - Converts a session of MDF CAN bus logs into sorted MDF files.\n"
+		"           Each split of the session is sorted into its own file, holding\n"
+		"           one channel group per CAN ID (or per message, if a DBC file is\n"
+		"           given). Analysis tools can then read a single signal without\n"
+		"           reading every record of the log. Splits are sorted in parallel.\n\n");
+
+	fprintUsage (stream);
+
+	fprintf (stream, "\nParameters:\n\n");
+	fprintf (stream, ""
+		"    <Session Directory>   - The session to sort (ex. logs/session_3).\n"
+		"    <Output Directory>    - The directory to write the sorted splits into.\n"
+		"                            Created if it does not exist.\n\n");
+
+	fprintf (stream, ""
+		"Options:\n\n"
+		"    -j=<Count>            - The number of splits to sort in parallel. Defaults\n"
+		"                            to the number of CPUs.\n"
+		"    --dbc=<Path>          - Decode messages using a DBC file. Each message\n"
+		"                            becomes a channel group with one channel per\n"
+		"                            signal. Frames of unknown messages are kept raw.\n"
+		"    --compress            - Write the sorted splits as compressed data blocks.\n"
+		"\n");
+	fprintOptionHelp (stream, "    ");
+}
+
+/**
+ * @brief Gets the key identifying the group a record belongs to. Data frames are grouped by bus and CAN ID, remote and error
+ * frames are grouped by bus only.
+ */
+static uint64_t groupKey (const mdfCanBusRecord_t* record)
+{
+	uint64_t key = ((uint64_t) record->type << 40) | ((uint64_t) record->busChannel << 32);
+	if (record->type == MDF_CAN_BUS_RECORD_DATA_FRAME)
+		key |= ((uint64_t) record->ide << 31) | record->id;
+	return key;
+}
+
+/**
+ * @brief Finds the DBC message of a data frame, if any.
+ * @return The message, @c NULL if the frame is not in the DBC file (or its message cannot be decoded).
+ */
+static canMessage_t* findMessage (const mdfCanBusRecord_t* record)
+{
+	if (record->type != MDF_CAN_BUS_RECORD_DATA_FRAME)
+		return NULL;
+
+	for (size_t index = 0; index < messageCount; ++index)
+		if (messages [index].id == record->id && messages [index].ide == record->ide &&
+			messages [index].signalCount <= DECODED_SIGNAL_COUNT_MAX)
+			return &messages [index];
+
+	return NULL;
+}
+
+/**
+ * @brief Gets the group a record belongs to, creating it if it does not exist.
+ * @return The group if successful, @c NULL otherwise.
+ */
+static group_t* getGroup (groupTable_t* table, const mdfCanBusRecord_t* record)
+{
+	// Grow the table once it is half full.
+	if (table->groupCount * 2 >= table->groupCapacity)
+	{
+		size_t capacity = table->groupCapacity != 0 ? table->groupCapacity * 2 : GROUP_TABLE_SIZE;
+		group_t* groups = calloc (capacity, sizeof (group_t));
+		if (groups == NULL)
+			return NULL;
+
+		for (size_t index = 0; index < table->groupCapacity; ++index)
+		{
+			if (table->groups [index].recordSize == 0)
+				continue;
+
+			size_t slot = table->groups [index].key & (capacity - 1);
+			while (groups [slot].recordSize != 0)
+				slot = (slot + 1) & (capacity - 1);
+			groups [slot] = table->groups [index];
+		}
+
+		free (table->groups);
+		table->groups = groups;
+		table->groupCapacity = capacity;
+	}
+
+	uint64_t key = groupKey (record);
+	size_t slot = key & (table->groupCapacity - 1);
+	while (table->groups [slot].recordSize != 0)
+	{
+		if (table->groups [slot].key == key)
+			return &table->groups [slot];
+		slot = (slot + 1) & (table->groupCapacity - 1);
+	}
+
+	group_t* group = &table->groups [slot];
+	group->key = key;
+	group->message = findMessage (record);
+	group->recordSize = group->message != NULL ?
+		MDF_SORTED_WRITER_TIMESTAMP_SIZE + group->message->signalCount * sizeof (float) : RAW_RECORD_SIZE;
+	++table->groupCount;
+	return group;
+}
+
+/**
+ * @brief Appends a record to its group, decoding it if the group is a DBC message.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int appendRecord (group_t* group, const mdfCanBusRecord_t* record)
+{
+	if (group->recordCount == group->recordCapacity)
+	{
+		size_t capacity = group->recordCapacity != 0 ? group->recordCapacity * 2 : 64;
+		uint8_t* records = realloc (group->records, capacity * group->recordSize);
+		if (records == NULL)
+			return errno;
+
+		group->records = records;
+		group->recordCapacity = capacity;
+	}
+
+	uint8_t* data = group->records + group->recordCount * group->recordSize;
+	++group->recordCount;
+
+	memcpy (data, &record->timestampNs, sizeof (uint64_t));
+
+	// Note the payload is copied, as the record's data is not necessarily aligned.
+	uint64_t payload = 0;
+	if (record->type != MDF_CAN_BUS_RECORD_REMOTE_FRAME)
+		memcpy (&payload, record->data, record->dlc < sizeof (payload) ? record->dlc : sizeof (payload));
+
+	if (group->message != NULL)
+	{
+		for (size_t index = 0; index < group->message->signalCount; ++index)
+		{
+			float value = signalDecode (&group->message->signals [index], payload);
+			memcpy (data + MDF_SORTED_WRITER_TIMESTAMP_SIZE + index * sizeof (float), &value, sizeof (float));
+		}
+		return 0;
+	}
+
+	uint32_t id = record->id;
+	memcpy (data + RAW_RECORD_ID_OFFSET, &id, sizeof (id));
+	data [RAW_RECORD_IDE_OFFSET] = record->ide;
+	data [RAW_RECORD_DLC_OFFSET] = record->dlc;
+	data [RAW_RECORD_DIR_OFFSET] = record->direction;
+	data [RAW_RECORD_ERROR_TYPE_OFFSET] = record->errorType;
+	memcpy (data + RAW_RECORD_DATA_BYTES_OFFSET, &payload, sizeof (payload));
+	return 0;
+}
+
+static int compareGroups (const void* a, const void* b)
+{
+	uint64_t keyA = ((const group_t*) a)->key;
+	uint64_t keyB = ((const group_t*) b)->key;
+	return (keyA > keyB) - (keyA < keyB);
+}
+
+/**
+ * @brief Writes a group to a sorted split.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int writeGroup (mdfSortedWriter_t* writer, group_t* group)
+{
+	mdfCanBusRecordType_t type = group->key >> 40;
+	uint8_t busChannel = group->key >> 32;
+	bool ide = (group->key >> 31) & 1;
+	uint32_t id = group->key & 0x7FFFFFFF;
+
+	char* name;
+	int nameLength;
+	if (group->message != NULL)
+		nameLength = asprintf (&name, "CAN%u_%s", busChannel, group->message->name);
+	else if (type == MDF_CAN_BUS_RECORD_DATA_FRAME)
+		nameLength = asprintf (&name, ide ? "CAN%u_0x%08"PRIX32 : "CAN%u_0x%03"PRIX32, busChannel, id);
+	else
+		nameLength = asprintf (&name, type == MDF_CAN_BUS_RECORD_REMOTE_FRAME ? "CAN%u_RemoteFrames" : "CAN%u_ErrorFrames",
+			busChannel);
+	if (nameLength < 0)
+		return errno;
+
+	int code;
+	if (group->message != NULL)
+	{
+		// Decoded message, one channel per signal.
+		mdfSortedChannel_t channels [DECODED_SIGNAL_COUNT_MAX];
+		for (size_t index = 0; index < group->message->signalCount; ++index)
+		{
+			channels [index] = (mdfSortedChannel_t)
+			{
+				.name		= group->message->signals [index].name,
+				.unit		= group->message->signals [index].unit,
+				.dataType	= MDF_DATA_TYPE_FLOAT_INTEL,
+				.byteOffset	= MDF_SORTED_WRITER_TIMESTAMP_SIZE + index * sizeof (float),
+				.bitLength	= sizeof (float) * 8
+			};
+		}
+
+		code = mdfSortedWriterAddGroup (writer, name, channels, group->message->signalCount, group->recordSize,
+			group->records, group->recordCount);
+	}
+	else
+	{
+		// Raw frames. Remote frame groups exclude the data bytes, only error frame groups include the error type.
+		size_t channelCount = type == MDF_CAN_BUS_RECORD_ERROR_FRAME ? 6 : type == MDF_CAN_BUS_RECORD_DATA_FRAME ? 5 : 4;
+		code = mdfSortedWriterAddGroup (writer, name, RAW_CHANNELS, channelCount, group->recordSize, group->records,
+			group->recordCount);
+	}
+
+	free (name);
+	errno = code;
+	return code;
+}
+
+/**
+ * @brief Sorts a split of the session.
+ * @param splitNumber The number of the split to sort.
+ * @param recordCount Written to the number of records sorted.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int sortSplit (uint32_t splitNumber, size_t* recordCount)
+{
+	*recordCount = 0;
+
+	char* inputPath;
+	if (asprintf (&inputPath, "%s/split_%"PRIu32".mf4", sessionDirectory, splitNumber) < 0)
+		return errno;
+
+	mdfCanBusReader_t reader;
+	int code = mdfCanBusReaderInit (&reader, inputPath);
+	free (inputPath);
+	if (code != 0)
+		return code;
+
+	// Read every record of the split into its group.
+	groupTable_t table = { 0 };
+	mdfCanBusRecord_t records [READ_BATCH_SIZE];
+	while (code == 0)
+	{
+		size_t count;
+		if (mdfCanBusReaderRead (&reader, records, READ_BATCH_SIZE, &count) != 0)
+		{
+			code = errno;
+			break;
+		}
+
+		if (count == 0)
+			break;
+
+		for (size_t index = 0; index < count && code == 0; ++index)
+		{
+			group_t* group = getGroup (&table, &records [index]);
+			if (group == NULL)
+				code = errno;
+			else
+				code = appendRecord (group, &records [index]);
+		}
+
+		*recordCount += count;
+	}
+
+	uint64_t startTimeNs = reader.startTimeNs;
+	mdfCanBusReaderClose (&reader);
+
+	// Write the groups in order of their keys, so the output does not depend on the order frames were received in.
+	if (code == 0)
+	{
+		size_t groupCount = 0;
+		for (size_t index = 0; index < table.groupCapacity; ++index)
+			if (table.groups [index].recordSize != 0)
+				table.groups [groupCount++] = table.groups [index];
+		table.groupCapacity = groupCount;
+
+		qsort (table.groups, groupCount, sizeof (group_t), compareGroups);
+
+		char* outputPath;
+		if (asprintf (&outputPath, "%s/split_%"PRIu32".mf4", outputDirectory, splitNumber) < 0)
+			code = errno;
+		else
+		{
+			mdfSortedWriter_t writer;
+			code = mdfSortedWriterInit (&writer, outputPath, "ZREMDF", startTimeNs, compress);
+			free (outputPath);
+
+			if (code == 0)
+			{
+				for (size_t index = 0; index < groupCount && code == 0; ++index)
+					code = writeGroup (&writer, &table.groups [index]);
+
+				int closeCode = mdfSortedWriterClose (&writer);
+				if (code == 0)
+					code = closeCode;
+			}
+		}
+	}
+
+	for (size_t index = 0; index < table.groupCapacity; ++index)
+		free (table.groups [index].records);
+	free (table.groups);
+
+	errno = code;
+	return code;
+}
+
+/// @brief Thread sorting splits of the session until none are left.
+void* workerThread (void* arg)
+{
+	(void) arg;
+
+	while (true)
+	{
+		uint32_t splitNumber = atomic_fetch_add (&nextSplit, 1);
+		if (splitNumber >= splitCount)
+			return NULL;
+
+		size_t recordCount;
+		if (sortSplit (splitNumber, &recordCount) != 0)
+		{
+			errorPrintf ("Failed to sort split %"PRIu32, splitNumber);
+			atomic_store (&failed, true);
+			continue;
+		}
+
+		atomic_fetch_add (&recordTotal, recordCount);
+		printf ("split_%"PRIu32".mf4: Sorted %lu records.\n", splitNumber, (unsigned long) recordCount);
+	}
+}
+
+/**
+ * @brief Counts the splits of the session. The session ends at the first missing split.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int countSplits (void)
+{
+	while (true)
+	{
+		char* path;
+		if (asprintf (&path, "%s/split_%"PRIu32".mf4", sessionDirectory, splitCount) < 0)
+			return errno;
+
+		struct stat splitStat;
+		int code = stat (path, &splitStat);
+		free (path);
+		if (code != 0)
+			return errno == ENOENT ? 0 : errno;
+
+		++splitCount;
+	}
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	// Debug initialization
+	debugInit ();
+
+	// Handle program options
+	if (handleOptions (&argc, &argv, &(handleOptionsParams_t)
+	{
+		.fprintHelp		= fprintHelp,
+		.charHandlers	= (optionCharCallback_t* []) { handleThreads },
+		.chars			= (char []) { 'j' },
+		.charCount		= 1,
+		.stringHandlers	= (optionStringCallback_t* []) { handleDbc, handleCompress },
+		.strings		= (char* []) { "dbc", "compress" },
+		.stringCount	= 2
+	}) != 0)
+		return errorPrintf ("Failed to handle options");
+
+	// Validate usage
+	if (argc != 2)
+	{
+		fprintUsage (stderr);
+		return -1;
+	}
+
+	sessionDirectory = argv [0];
+	outputDirectory = argv [1];
+
+	if (dbcPath != NULL)
+	{
+		if (canDbcLoad (dbcPath, &messages, &messageCount, &signals, &signalCount) != 0)
+			return errorPrintf ("Failed to load DBC file '%s'", dbcPath);
+
+		for (size_t index = 0; index < messageCount; ++index)
+			if (messages [index].signalCount > DECODED_SIGNAL_COUNT_MAX)
+				fprintf (stderr, "Warning, message '%s' has too many signals to decode, its frames are kept raw.\n",
+					messages [index].name);
+	}
+
+	if (countSplits () != 0)
+		return errorPrintf ("Failed to read session directory '%s'", sessionDirectory);
+
+	if (splitCount == 0)
+	{
+		errno = ENOENT;
+		return errorPrintf ("Session directory '%s' has no splits", sessionDirectory);
+	}
+
+	if (mkdirPort (outputDirectory) != 0 && errno != EEXIST)
+		return errorPrintf ("Failed to create output directory '%s'", outputDirectory);
+
+	if (threadCount == 0)
+	{
+		long cpuCount = sysconf (_SC_NPROCESSORS_ONLN);
+		threadCount = cpuCount > 0 ? (unsigned long) cpuCount : 1;
+	}
+
+	// No more workers than splits are needed.
+	if (threadCount > splitCount)
+		threadCount = splitCount;
+
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+
+	pthread_t* threads = malloc (sizeof (pthread_t) * threadCount);
+	if (threads == NULL)
+		return errorPrintf ("Failed to allocate worker threads");
+
+	size_t threadsStarted = 0;
+	for (; threadsStarted < threadCount; ++threadsStarted)
+	{
+		errno = pthread_create (&threads [threadsStarted], NULL, workerThread, NULL);
+		if (errno != 0)
+		{
+			errorPrintf ("Failed to create worker thread");
+			break;
+		}
+	}
+
+	// If no workers could be started, sort the splits on this thread instead.
+	if (threadsStarted == 0)
+		workerThread (NULL);
+
+	for (size_t index = 0; index < threadsStarted; ++index)
+		pthread_join (threads [index], NULL);
+	free (threads);
+
+	struct timespec timeEnd;
+	clock_gettime (CLOCK_MONOTONIC, &timeEnd);
+	double duration = (timeEnd.tv_sec - timeStart.tv_sec) + (timeEnd.tv_nsec - timeStart.tv_nsec) * 1e-9;
+
+	printf ("Sorted %llu records from %"PRIu32" splits in %.3f s.\n", (unsigned long long) atomic_load (&recordTotal),
+		splitCount, duration);
+
+	if (messages != NULL)
+		canDbcsDealloc (messages, messageCount, signals);
+
+	return atomic_load (&failed) ? -1 : 0;
+}
@@ -0,0 +1,423 @@
+// MDF Stats ------------------------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: See help page.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "can_device/can_device.h"
+#include "can_device/can_device_stdio.h"
+#include "debug.h"
+#include "mdf/mdf_can_bus_session_reader.h"
+#include "mdf/mdf_can_replay.h"
+#include "mdf/mdf_can_bus_stats.h"
+#include "options.h"
+#include "time_port.h"
+
+// POSIX
+#include <unistd.h>
+
+// C Standard Library
+#include <errno.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of records read at a time.
+#define READ_BATCH_SIZE 4096
+
+// Globals --------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of threads decoding the session, 0 for the number of CPUs.
+unsigned long threadCount = 0;
+
+/// @brief Indicates the traffic of a CAN device should be analyzed, rather than a session.
+bool live = false;
+
+/// @brief Indicates each gap should be printed as it is detected.
+bool printGaps = false;
+
+/// @brief Indicates the inter-arrival time histogram of each ID should be printed.
+bool printHistograms = false;
+
+mdfCanBusStatsConfig_t config = {0};
+
+bool running = true;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void handleThreads (char option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		threadCount = strtoul (value, NULL, 0);
+}
+
+void handleLive (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+
+	live = true;
+}
+
+void handleGaps (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+
+	printGaps = true;
+}
+
+void handleHistogram (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+
+	printHistograms = true;
+}
+
+void handleGapFactor (char* option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		config.gapFactor = strtof (value, NULL);
+}
+
+void handleErrorBurst (char* option, char* value)
+{
+	(void) option;
+	if (value == NULL)
+		return;
+
+	char* end;
+	config.burstMin = strtoul (value, &end, 0);
+	if (*end != '/')
+	{
+		fprintf (stderr, "Invalid error burst '%s', expected '<Count>/<Gap ms>'.\n", value);
+		exit (-1);
+	}
+	config.burstGapNs = strtoull (end + 1, NULL, 0) * 1000000;
+}
+
+void sigtermHandler (int sig)
+{
+	(void) sig;
+
+	running = false;
+}
+
+void fprintUsage (FILE* stream)
+{
+	fprintf (stream, "Usage:\n"
+		"    mdf-stats <Options> <Session Directory>\n"
+		"    mdf-stats <Options> --live <CAN Device Name>\n");
+}
+
+void fprintHelp (FILE* stream)
+{
+	fprintf (stream, ""
+		"mdf-stats - Analyzes the traffic of an MDF CAN bus log session, or of a CAN\n"
+		"            bus live, in a single pass. For each CAN ID, reports the frame\n"
+		"            count and rate, the mean, jitter (standard deviation), minimum and\n"
+		"            maximum of the inter-arrival time, gaps (likely dropped frames),\n"
+		"            and DLC changes. For each bus, reports the error frames and their\n"
+		"            bursts. The report is ordered by bus, then CAN ID, so reports of\n"
+		"            different sessions can be diffed. Times are relative to the first\n"
+		"            record.\n\n");
+
+	fprintUsage (stream);
+
+	fprintf (stream, "\nParameters:\n\n");
+	fprintf (stream, ""
+		"    <Session Directory>   - The session to analyze (ex. logs/session_3).\n"
+		"    <CAN Device Name>     - The device to analyze, until terminated (SIGINT).\n\n");
+	fprintCanDeviceNameHelp (stream, "    ");
+
+	fprintf (stream, ""
+		"Options:\n\n"
+		"    --live                - Analyzes a CAN device rather than a session.\n"
+		"    --gap-factor=<x>      - The multiple of an ID's mean inter-arrival time\n"
+		"                            above which an interval is a gap. Default %.1f.\n"
+		"    --error-burst=<N>/<ms>\n"
+		"                          - The minimum number of error frames forming a\n"
+		"                            burst, and the maximum time between them. Default\n"
+		"                            %u/%u.\n"
+		"    --gaps                - Prints each gap as it is detected.\n"
+		"    --histogram           - Prints the inter-arrival time histogram of each ID.\n"
+		"    -j=<Count>            - The number of threads decoding the session.\n"
+		"                            Defaults to the number of CPUs.\n"
+		"\n", MDF_CAN_BUS_STATS_GAP_FACTOR_DEFAULT, MDF_CAN_BUS_STATS_BURST_MIN_DEFAULT,
+		MDF_CAN_BUS_STATS_BURST_GAP_DEFAULT / 1000000);
+	fprintOptionHelp (stream, "    ");
+}
+
+/**
+ * @brief Prints a CAN ID, padded to a fixed width.
+ * @param idStats The statistics of the ID.
+ */
+static void printId (const mdfCanBusIdStats_t* idStats)
+{
+	// Extended IDs are suffixed with 'x'.
+	char id [16];
+	snprintf (id, sizeof (id), idStats->ide ? "0x%08X%s" : "0x%03X%s", (unsigned) idStats->id, idStats->ide ? "x" : "");
+	printf ("%-12s", id);
+}
+
+/**
+ * @brief Statistics gap callback, printing the gap. See @c mdfCanBusStatsGapCallback_t .
+ */
+static void gapCallback (mdfCanBusStats_t* stats, const mdfCanBusIdStats_t* idStats, uint64_t startNs, uint64_t durationNs,
+	void* arg)
+{
+	(void) arg;
+
+	printf ("Gap: Bus %u, ID ", idStats->busChannel);
+	printId (idStats);
+	printf (" at %12.6f s, %10.3f ms (mean %.3f ms).\n", (startNs - stats->firstTimestampNs) / 1e9, durationNs / 1e6,
+		idStats->intervalMeanNs / 1e6);
+}
+
+/**
+ * @brief Prints the inter-arrival time histogram of an ID.
+ * @param idStats The statistics of the ID.
+ */
+static void printHistogram (const mdfCanBusIdStats_t* idStats)
+{
+	printf ("    Histogram (us):");
+	for (size_t index = 0; index < MDF_CAN_BUS_STATS_HISTOGRAM_SIZE; ++index)
+	{
+		if (idStats->histogram [index] == 0)
+			continue;
+
+		if (index == 0)
+			printf (" <2: %"PRIu32",", idStats->histogram [index]);
+		else if (index == MDF_CAN_BUS_STATS_HISTOGRAM_SIZE - 1)
+			printf (" >=%lu: %"PRIu32",", 1lu << index, idStats->histogram [index]);
+		else
+			printf (" %lu-%lu: %"PRIu32",", 1lu << index, 1lu << (index + 1), idStats->histogram [index]);
+	}
+	printf ("\n");
+}
+
+/**
+ * @brief Prints the report of finished statistics.
+ * @param stats The statistics to print.
+ */
+static void printReport (mdfCanBusStats_t* stats)
+{
+	uint64_t durationNs = stats->recordCount != 0 ? stats->lastTimestampNs - stats->firstTimestampNs : 0;
+	printf ("Records: %"PRIu64", Duration: %.3f s, IDs: %lu, Out of Order: %"PRIu64"\n\n", stats->recordCount,
+		durationNs / 1e9, (unsigned long) stats->idCount, stats->reorderedCount);
+
+	printf ("Bus ID           Frames Rate (Hz) Mean (ms) Jitter (ms) Min (ms)   Max (ms)  Max At (s)   Gaps Missed  DLC   "
+		"DLC Changes\n");
+
+	for (size_t index = 0; index < stats->idCount; ++index)
+	{
+		const mdfCanBusIdStats_t* idStats = &stats->ids [index];
+
+		uint64_t spanNs = idStats->lastTimestampNs - idStats->firstTimestampNs;
+		double rate = spanNs != 0 ? idStats->intervalCount / (spanNs / 1e9) : 0;
+
+		char dlc [8];
+		if (idStats->dlcMin == idStats->dlcMax)
+			snprintf (dlc, sizeof (dlc), "%u", idStats->dlcMin);
+		else
+			snprintf (dlc, sizeof (dlc), "%u-%u", idStats->dlcMin, idStats->dlcMax);
+
+		// Times are relative to the first record.
+		uint64_t maxStartNs = idStats->intervalCount != 0 ? idStats->intervalMaxStartNs - stats->firstTimestampNs : 0;
+
+		printf ("%3u ", idStats->busChannel);
+		printId (idStats);
+		printf (" %8"PRIu64" %9.2f %9.3f %11.3f %8.3f %10.3f %11.3f %6"PRIu64" %6"PRIu64" %-5s %11"PRIu64"\n",
+			idStats->frameCount, rate, idStats->intervalMeanNs / 1e6, mdfCanBusIdStatsGetJitterNs (idStats) / 1e6,
+			idStats->intervalCount != 0 ? idStats->intervalMinNs / 1e6 : 0.0, idStats->intervalMaxNs / 1e6,
+			maxStartNs / 1e9, idStats->gapCount, idStats->missedCount, dlc, idStats->dlcChangeCount);
+
+		if (printHistograms && idStats->intervalCount != 0)
+			printHistogram (idStats);
+	}
+
+	printf ("\n");
+	for (size_t index = 0; index < MDF_CAN_BUS_STATS_BUS_COUNT; ++index)
+	{
+		const mdfCanBusErrorStats_t* errors = &stats->errors [index];
+		if (errors->errorFrameCount == 0)
+			continue;
+
+		printf ("Bus %lu: Error Frames: %"PRIu64", Bursts: %"PRIu64"", (unsigned long) index, errors->errorFrameCount,
+			errors->burstCount);
+		if (errors->burstCount != 0)
+			printf (", Longest Burst: %"PRIu64" frames over %.3f ms at %.6f s", errors->longestBurstCount,
+				errors->longestBurstDurationNs / 1e6, (errors->longestBurstStartNs - stats->firstTimestampNs) / 1e9);
+		printf ("\n");
+	}
+}
+
+/**
+ * @brief Analyzes the records of a session.
+ * @param stats The statistics to add to.
+ * @param sessionDirectory The directory of the session.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int analyzeSession (mdfCanBusStats_t* stats, const char* sessionDirectory)
+{
+	if (threadCount == 0)
+	{
+		long cpuCount = sysconf (_SC_NPROCESSORS_ONLN);
+		threadCount = cpuCount > 0 ? (unsigned long) cpuCount : 1;
+	}
+
+	// The splits are decoded in parallel by the reader's worker threads, the statistics are accumulated in a single pass
+	// over the merged, time-ordered records.
+	mdfCanBusSessionReader_t reader;
+	if (mdfCanBusSessionReaderInit (&reader, sessionDirectory, threadCount) != 0)
+		return errno;
+
+	mdfCanBusRecord_t* records = malloc (sizeof (mdfCanBusRecord_t) * READ_BATCH_SIZE);
+	if (records == NULL)
+	{
+		int code = errno;
+		mdfCanBusSessionReaderClose (&reader);
+		errno = code;
+		return code;
+	}
+
+	int code = 0;
+	while (code == 0)
+	{
+		size_t count;
+		code = mdfCanBusSessionReaderRead (&reader, records, READ_BATCH_SIZE, &count);
+		if (code != 0 || count == 0)
+			break;
+
+		for (size_t index = 0; index < count && code == 0; ++index)
+			code = mdfCanBusStatsAddRecord (stats, &records [index]);
+	}
+
+	free (records);
+	mdfCanBusSessionReaderClose (&reader);
+
+	errno = code;
+	return code;
+}
+
+/**
+ * @brief Analyzes the traffic of a CAN device, until terminated.
+ * @param stats The statistics to add to.
+ * @param device The device to analyze.
+ * @return 0 if successful, the error code otherwise.
+ */
+static int analyzeDevice (mdfCanBusStats_t* stats, canDevice_t* device)
+{
+	// Set a receive timeout so we can check for the termination signal.
+	canSetTimeout (device, 100);
+
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+
+	while (running)
+	{
+		canFrame_t frame;
+		int code = canReceive (device, &frame);
+
+		struct timespec timeCurrent;
+		clock_gettime (CLOCK_MONOTONIC, &timeCurrent);
+		struct timespec timestamp = timespecSub (&timeCurrent, &timeStart);
+
+		mdfCanBusRecord_t record =
+		{
+			.timestampNs	= timespecToNs (&timestamp),
+			.busChannel		= 1
+		};
+
+		if (code == 0)
+		{
+			record.type	= frame.rtr ? MDF_CAN_BUS_RECORD_REMOTE_FRAME : MDF_CAN_BUS_RECORD_DATA_FRAME;
+			record.id	= frame.id;
+			record.ide	= frame.ide;
+			record.dlc	= frame.dlc;
+			record.data	= frame.data;
+		}
+		else if (canCheckBusError (code))
+			record.type = MDF_CAN_BUS_RECORD_ERROR_FRAME;
+		else
+			continue;
+
+		if (mdfCanBusStatsAddRecord (stats, &record) != 0)
+			return errno;
+	}
+
+	return 0;
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	// Debug initialization
+	debugInit ();
+
+	// Handle program options
+	if (handleOptions (&argc, &argv, &(handleOptionsParams_t)
+	{
+		.fprintHelp		= fprintHelp,
+		.charHandlers	= (optionCharCallback_t* []) { handleThreads },
+		.chars			= (char []) { 'j' },
+		.charCount		= 1,
+		.stringHandlers	= (optionStringCallback_t* []) { handleLive, handleGaps, handleHistogram, handleGapFactor,
+			handleErrorBurst },
+		.strings		= (char* []) { "live", "gaps", "histogram", "gap-factor", "error-burst" },
+		.stringCount	= 5
+	}) != 0)
+		return errorPrintf ("Failed to handle options");
+
+	// Validate usage
+	if (argc != 1 || config.gapFactor < 0)
+	{
+		fprintUsage (stderr);
+		return -1;
+	}
+
+	if (printGaps)
+		config.gapCallback = gapCallback;
+
+	mdfCanBusStats_t stats;
+	if (mdfCanBusStatsInit (&stats, &config) != 0)
+		return errorPrintf ("Failed to initialize statistics");
+
+	if (live)
+	{
+		if (mdfCanReplayRegister () != 0)
+			return errorPrintf ("Failed to register MDF replay CAN device");
+
+		canDevice_t* device = canInit (argv [0], NULL);
+		if (device == NULL)
+			return errorPrintf ("Failed to initialize CAN device '%s'", argv [0]);
+
+		if (signal (SIGINT, sigtermHandler) == SIG_ERR || signal (SIGTERM, sigtermHandler) == SIG_ERR)
+			return errorPrintf ("Failed to bind termination handlers");
+
+		if (analyzeDevice (&stats, device) != 0)
+			return errorPrintf ("Failed to analyze CAN device '%s'", argv [0]);
+
+		canDealloc (device);
+	}
+	else if (analyzeSession (&stats, argv [0]) != 0)
+		return errorPrintf ("Failed to analyze session '%s'", argv [0]);
+
+	mdfCanBusStatsFinish (&stats);
+	printReport (&stats);
+
+	mdfCanBusStatsDealloc (&stats);
+	return 0;
+}
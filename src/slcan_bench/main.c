@@ -0,0 +1,352 @@
+// SLCAN Reception Benchmark --------------------------------------------------------------------------------------------------
+//
+// Author: Cole Barach
+// Date Created: 2026.10.18
+//
+// Description: See help page.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "can_device/slcan_ring.h"
+#include "debug.h"
+#include "error_codes.h"
+#include "options.h"
+#include "time_port.h"
+
+// SerialCAN
+#include "slcan.h"
+
+// POSIX
+#include <pthread.h>
+
+// C Standard Library
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The capacity of the message queue / ring, in frames. Matches the capacity used by the CAN device library.
+#define QUEUE_SIZE 65536
+
+// Globals --------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of bytes to feed the reception path at once, that is, the size of each serial read.
+size_t chunkSize = 1024;
+
+/// @brief The number of times to replay the capture.
+size_t iterationCount = 10;
+
+/// @brief Indicates the legacy message queue path should be benchmarked, rather than the reception ring.
+bool legacy = false;
+
+/// @brief If non-zero, the number of frames to generate a synthetic capture with.
+size_t generateCount = 0;
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	slcan_port_t port;
+	const uint8_t* capture;
+	size_t captureSize;
+	atomic_bool done;
+} producerArg_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void handleChunkSize (char option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		chunkSize = strtoul (value, NULL, 0);
+}
+
+void handleIterations (char option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		iterationCount = strtoul (value, NULL, 0);
+}
+
+void handleLegacy (char* option, char* value)
+{
+	(void) option;
+	(void) value;
+	legacy = true;
+}
+
+void handleGenerate (char* option, char* value)
+{
+	(void) option;
+	if (value != NULL)
+		generateCount = strtoul (value, NULL, 0);
+}
+
+void fprintUsage (FILE* stream)
+{
+	fprintf (stream, "Usage: slcan-bench <Options> <Capture File>\n");
+}
+
+void fprintHelp (FILE* stream)
+{
+	fprintf (stream, ""
+		"slcan-bench - Benchmark for the SLCAN reception path. Replays a captured serial\n"
+		"              byte stream through the SerialCAN reception loop and measures\n"
+		"              the rate at which frames are decoded and received.\n\n");
+
+	fprintUsage (stream);
+
+	fprintf (stream, "\nParameters:\n\n");
+	fprintf (stream, ""
+		"    <Capture File>        - File containing the raw bytes received from an\n"
+		"                            SLCAN device (ex. 'cat /dev/ttyACM0 > capture').\n\n");
+
+	fprintf (stream, ""
+		"Options:\n\n"
+		"    -c=<Chunk Size>       - The number of bytes fed at once, that is, the size\n"
+		"                            of each serial read. Default 1024.\n"
+		"    -n=<Iterations>       - The number of times to replay the capture. Default\n"
+		"                            10.\n"
+		"    --legacy              - Benchmark the SerialCAN message queue, rather than\n"
+		"                            the reception ring.\n"
+		"    --generate=<Count>    - Generate a synthetic capture of <Count> frames into\n"
+		"                            <Capture File> before benchmarking.\n"
+		"\n");
+	fprintOptionHelp (stream, "    ");
+}
+
+/**
+ * @brief Generates a synthetic SLCAN capture. Contains a mix of standard, extended and RTR frames of random DLCs, along with
+ * the transmit acknowledgements a real device would send.
+ * @param path The path of the file to write.
+ * @param frameCount The number of frames to generate.
+ * @return 0 if successful, the error code otherwise.
+ */
+int generateCapture (const char* path, size_t frameCount)
+{
+	FILE* file = fopen (path, "wb");
+	if (file == NULL)
+		return errno;
+
+	srand (0);
+	for (size_t index = 0; index < frameCount; ++index)
+	{
+		int type = rand () % 16;
+		int dlc = rand () % 9;
+
+		if (type == 0)
+			fprintf (file, "r%03X%d\r", rand () & 0x7FF, dlc);
+		else if (type == 1)
+			fprintf (file, "T%08X%d", rand () & 0x1FFFFFFF, dlc);
+		else
+			fprintf (file, "t%03X%d", rand () & 0x7FF, dlc);
+
+		if (type != 0)
+		{
+			for (int byte = 0; byte < dlc; ++byte)
+				fprintf (file, "%02X", rand () & 0xFF);
+			fprintf (file, "\r");
+		}
+
+		// Transmit acknowledgement
+		if (type == 2)
+			fprintf (file, "z\r");
+	}
+
+	if (fclose (file) != 0)
+		return errno;
+
+	return 0;
+}
+
+/**
+ * @brief Loads a capture file into memory.
+ * @param path The path of the file to load.
+ * @param size Buffer to write the size of the capture into.
+ * @return The dynamically allocated capture if successful, @c NULL otherwise.
+ */
+uint8_t* loadCapture (const char* path, size_t* size)
+{
+	FILE* file = fopen (path, "rb");
+	if (file == NULL)
+		return NULL;
+
+	if (fseek (file, 0, SEEK_END) != 0)
+	{
+		fclose (file);
+		return NULL;
+	}
+
+	long fileSize = ftell (file);
+	rewind (file);
+
+	uint8_t* capture = malloc (fileSize > 0 ? fileSize : 1);
+	if (capture == NULL)
+	{
+		fclose (file);
+		return NULL;
+	}
+
+	*size = fread (capture, 1, fileSize, file);
+	fclose (file);
+	return capture;
+}
+
+/// @brief Thread replaying the capture into the reception path, acting as the serial reception thread.
+void* producerThread (void* argPtr)
+{
+	producerArg_t* arg = argPtr;
+
+	for (size_t iteration = 0; iteration < iterationCount; ++iteration)
+	{
+		for (size_t offset = 0; offset < arg->captureSize; offset += chunkSize)
+		{
+			size_t size = arg->captureSize - offset;
+			if (size > chunkSize)
+				size = chunkSize;
+
+			slcan_feed (arg->port, arg->capture + offset, size);
+		}
+	}
+
+	atomic_store (&arg->done, true);
+	return NULL;
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	// Debug initialization
+	debugInit ();
+
+	// Handle program options
+	if (handleOptions (&argc, &argv, &(handleOptionsParams_t)
+	{
+		.fprintHelp		= fprintHelp,
+		.charHandlers	= (optionCharCallback_t* []) { handleChunkSize, handleIterations },
+		.chars			= (char []) { 'c', 'n' },
+		.charCount		= 2,
+		.stringHandlers	= (optionStringCallback_t* []) { handleLegacy, handleGenerate },
+		.strings		= (char* []) { "legacy", "generate" },
+		.stringCount	= 2
+	}) != 0)
+		return errorPrintf ("Failed to handle options");
+
+	// Validate usage
+	if (argc != 1)
+	{
+		fprintUsage (stderr);
+		return -1;
+	}
+
+	if (chunkSize == 0)
+	{
+		fprintf (stderr, "Invalid chunk size.\n");
+		return -1;
+	}
+
+	char* capturePath = argv [0];
+
+	if (generateCount != 0 && generateCapture (capturePath, generateCount) != 0)
+		return errorPrintf ("Failed to generate capture '%s'", capturePath);
+
+	producerArg_t arg;
+	arg.capture = loadCapture (capturePath, &arg.captureSize);
+	if (arg.capture == NULL)
+		return errorPrintf ("Failed to load capture '%s'", capturePath);
+	atomic_init (&arg.done, false);
+
+	// Create an unconnected port, data is only ever fed to it.
+	arg.port = slcan_create (QUEUE_SIZE);
+	if (arg.port == NULL)
+		return errorPrintf ("Failed to create SLCAN port");
+
+	#ifdef ZRE_CANTOOLS_OS_linux
+
+	slcanRing_t ring;
+	if (!legacy)
+	{
+		if (slcanRingInit (&ring, QUEUE_SIZE) != 0)
+			return errorPrintf ("Failed to initialize reception ring");
+
+		slcan_set_receiver (arg.port, slcanRingReceive, &ring);
+	}
+
+	#else // ZRE_CANTOOLS_OS_linux
+
+	// The reception ring is only available on Linux.
+	legacy = true;
+
+	#endif // ZRE_CANTOOLS_OS_linux
+
+	printf ("Replaying %lu bytes %lu times in chunks of %lu bytes (%s)...\n", (unsigned long) arg.captureSize,
+		(unsigned long) iterationCount, (unsigned long) chunkSize, legacy ? "message queue" : "reception ring");
+
+	struct timespec timeStart;
+	clock_gettime (CLOCK_MONOTONIC, &timeStart);
+
+	pthread_t producer;
+	pthread_create (&producer, NULL, producerThread, &arg);
+
+	// Consume frames until the producer is done and no frames remain.
+	size_t frameCount = 0;
+	uint32_t checksum = 0;
+	while (true)
+	{
+		bool done = atomic_load (&arg.done);
+
+		canFrame_t frame;
+		int code;
+		if (legacy)
+		{
+			slcan_message_t message;
+			code = slcan_read_message (arg.port, &message, 1);
+			if (code == 0)
+			{
+				frame.id = message.can_id & 0x1FFFFFFF;
+				frame.dlc = message.can_dlc;
+				memcpy (frame.data, message.data, message.can_dlc);
+			}
+		}
+		#ifdef ZRE_CANTOOLS_OS_linux
+		else
+			code = slcanRingPop (&ring, &frame, 1);
+		#endif // ZRE_CANTOOLS_OS_linux
+
+		if (code == 0)
+		{
+			++frameCount;
+			checksum += frame.id + frame.data [0];
+		}
+		else if (done)
+			break;
+	}
+
+	struct timespec timeEnd;
+	clock_gettime (CLOCK_MONOTONIC, &timeEnd);
+	pthread_join (producer, NULL);
+
+	struct timespec elapsed = timespecSub (&timeEnd, &timeStart);
+	double elapsedS = timespecToNs (&elapsed) / 1e9;
+
+	printf ("Frames received:  %lu (checksum 0x%08X)\n", (unsigned long) frameCount, checksum);
+	#ifdef ZRE_CANTOOLS_OS_linux
+	if (!legacy)
+		printf ("Frames dropped:   %lu\n", (unsigned long) slcanRingGetOverflowCount (&ring));
+	#endif // ZRE_CANTOOLS_OS_linux
+	printf ("Elapsed time:     %.3f s\n", elapsedS);
+	printf ("Frame rate:       %.0f frames/s\n", frameCount / elapsedS);
+	printf ("Byte rate:        %.2f MB/s\n", arg.captureSize * iterationCount / elapsedS / 1e6);
+
+	slcan_destroy (arg.port);
+	#ifdef ZRE_CANTOOLS_OS_linux
+	if (!legacy)
+		slcanRingDealloc (&ring);
+	#endif // ZRE_CANTOOLS_OS_linux
+	free ((void*) arg.capture);
+	return 0;
+}